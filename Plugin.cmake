@@ -70,6 +70,24 @@ set(HDR_DASHBOARD
     ${CMAKE_SOURCE_DIR}/include/zone.h
     ${CMAKE_SOURCE_DIR}/include/displayscale.h
     ${CMAKE_SOURCE_DIR}/include/configvalidator.h
+    ${CMAKE_SOURCE_DIR}/include/dskraster.h
+    ${CMAKE_SOURCE_DIR}/include/fontcache.h
+    ${CMAKE_SOURCE_DIR}/include/renderpool.h
+    ${CMAKE_SOURCE_DIR}/include/valueformatter.h
+    ${CMAKE_SOURCE_DIR}/include/alarmengine.h
+    ${CMAKE_SOURCE_DIR}/include/deltalog.h
+    ${CMAKE_SOURCE_DIR}/include/clock.h
+    ${CMAKE_SOURCE_DIR}/include/loadgenerator.h
+    ${CMAKE_SOURCE_DIR}/include/instrumentstats.h
+    ${CMAKE_SOURCE_DIR}/include/tracer.h
+    ${CMAKE_SOURCE_DIR}/include/memoryreport.h
+    ${CMAKE_SOURCE_DIR}/include/contextevictor.h
+    ${CMAKE_SOURCE_DIR}/include/sourceregistry.h
+    ${CMAKE_SOURCE_DIR}/include/sourcearbiter.h
+    ${CMAKE_SOURCE_DIR}/include/filterservice.h
+    ${CMAKE_SOURCE_DIR}/include/historyservice.h
+    ${CMAKE_SOURCE_DIR}/include/derivedengine.h
+    ${CMAKE_SOURCE_DIR}/include/expression.h
     ${CMAKE_SOURCE_DIR}/include/pager.h)
 set(SRC_DASHBOARD
     ${CMAKE_SOURCE_DIR}/src/dashboardsk.cpp
@@ -85,6 +103,23 @@ set(SRC_DASHBOARD
     ${CMAKE_SOURCE_DIR}/src/dividerinstrument.cpp
     ${CMAKE_SOURCE_DIR}/src/spacerinstrument.cpp
     ${CMAKE_SOURCE_DIR}/src/configvalidator.cpp
+    ${CMAKE_SOURCE_DIR}/src/dskraster.cpp
+    ${CMAKE_SOURCE_DIR}/src/fontcache.cpp
+    ${CMAKE_SOURCE_DIR}/src/renderpool.cpp
+    ${CMAKE_SOURCE_DIR}/src/valueformatter.cpp
+    ${CMAKE_SOURCE_DIR}/src/alarmengine.cpp
+    ${CMAKE_SOURCE_DIR}/src/deltalog.cpp
+    ${CMAKE_SOURCE_DIR}/src/loadgenerator.cpp
+    ${CMAKE_SOURCE_DIR}/src/instrumentstats.cpp
+    ${CMAKE_SOURCE_DIR}/src/tracer.cpp
+    ${CMAKE_SOURCE_DIR}/src/memoryreport.cpp
+    ${CMAKE_SOURCE_DIR}/src/contextevictor.cpp
+    ${CMAKE_SOURCE_DIR}/src/sourceregistry.cpp
+    ${CMAKE_SOURCE_DIR}/src/sourcearbiter.cpp
+    ${CMAKE_SOURCE_DIR}/src/filterservice.cpp
+    ${CMAKE_SOURCE_DIR}/src/historyservice.cpp
+    ${CMAKE_SOURCE_DIR}/src/derivedengine.cpp
+    ${CMAKE_SOURCE_DIR}/src/expression.cpp
     ${CMAKE_SOURCE_DIR}/src/pager.cpp)
 
 set(SRC_GUI_DESKTOP ${CMAKE_SOURCE_DIR}/src/dashboardskgui.cpp
@@ -141,6 +176,9 @@ macro(add_plugin_libraries)
     endif()
   endif()
 
+  find_package(Threads REQUIRED)
+  target_link_libraries(${PACKAGE_NAME} Threads::Threads)
+
   add_subdirectory("${CMAKE_SOURCE_DIR}/opencpn-libs/plugin_dc")
   target_link_libraries(${PACKAGE_NAME} ocpn::plugin-dc)
 
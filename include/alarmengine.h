@@ -0,0 +1,245 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _ALARMENGINE_H_
+#define _ALARMENGINE_H_
+
+#include "clock.h"
+#include "pi_common.h"
+#include "zone.h"
+
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Change of the alarm state of a monitored path
+struct alarm_transition {
+    /// SignalK path of the value
+    wxString path;
+    /// State before the transition
+    Zone::state from;
+    /// State after the transition
+    Zone::state to;
+    /// Value which caused the transition, NaN if the path stopped being
+    /// monitored
+    double value;
+};
+
+/// Evaluates the values of the monitored SignalK paths against their zones
+/// as the data arrive, independently of whether any instrument showing them
+/// is displayed, and publishes the alarm state transitions to the listeners.
+///
+/// The zones of a path come from the configuration of the instruments
+/// subscribed to it or, if there are none, from the SignalK metadata. Leaving
+/// a zone towards a lower severity requires the value to get out of it by
+/// more than the hysteresis, and every new state has to persist for the
+/// debounce time before it is published. The work done per update only
+/// depends on the number of changed paths. GUI thread only.
+class AlarmEngine {
+public:
+    /// Clock used to time the debouncing
+    typedef Clock::base_clock clock;
+    /// Function called on every published state transition
+    typedef std::function<void(const alarm_transition&)> listener_t;
+#if wxCHECK_VERSION(3, 1, 0)
+    /// Key of the monitored paths
+    typedef wxString path_key_t;
+#else
+    /// Key of the monitored paths
+    typedef string path_key_t;
+#endif
+    /// Function converting a SignalK value to the units of the configured
+    /// zones
+    typedef std::function<double(double)> transform_t;
+    /// Configuration of a monitored path
+    struct watch {
+        /// Zones configured for the path, in the units the value is shown in
+        vector<Zone> zones;
+        /// Conversion of the values to the units of #zones, none if they are
+        /// in the SignalK units
+        transform_t transform;
+    };
+    /// The monitored paths
+    typedef std::unordered_map<path_key_t, watch> watches_t;
+
+    /// Default hysteresis as a fraction of the span of the zones of a path
+    static constexpr double DEFAULT_HYSTERESIS = 0.02;
+    /// Default debounce time in milliseconds
+    static constexpr int DEFAULT_DEBOUNCE_MS = 1000;
+
+private:
+    /// Alarm state of a single path
+    struct monitor {
+        /// SignalK path
+        wxString path;
+        /// Whether the path is monitored
+        bool watched = false;
+        /// Zones configured by the instruments
+        ZoneIndex config_zones;
+        /// Conversion of the values to the units of #config_zones
+        transform_t transform;
+        /// Zones received in the SignalK metadata
+        ZoneIndex meta_zones;
+        /// Published state
+        Zone::state state = Zone::state::nominal;
+        /// State waiting for the debounce time to pass
+        Zone::state pending = Zone::state::nominal;
+        /// Time the pending state was first seen
+        clock::time_point pending_since;
+        /// Last evaluated value
+        double value = 0.0;
+    };
+
+    /// State of the paths, including the unmonitored ones we have received
+    /// metadata zones for
+    std::unordered_map<path_key_t, monitor> m_monitors;
+    /// Paths with a state waiting for the debounce time to pass
+    std::unordered_set<path_key_t> m_pending;
+    /// Hysteresis as a fraction of the span of the zones of a path
+    double m_hysteresis;
+    /// Time a new state has to persist before it is published
+    clock::duration m_debounce;
+    /// Receivers of the state transitions
+    vector<listener_t> m_listeners;
+
+    /// Get the zones used to evaluate a path
+    ///
+    /// \param m The path state
+    /// \return The configured zones if there are any, the metadata ones
+    /// otherwise
+    static const ZoneIndex& ZonesOf(const monitor& m)
+    {
+        return m.config_zones.IsEmpty() ? m.meta_zones : m.config_zones;
+    };
+
+    /// Classify a value, applying the hysteresis when the state would drop
+    /// to a lower severity
+    ///
+    /// \param m The path state
+    /// \param value The value in the units of the zones of the path
+    /// \return The state the value is in
+    Zone::state Classify(const monitor& m, double value) const;
+
+    /// Publish the pending state of a path
+    ///
+    /// \param m The path state
+    void Commit(monitor& m);
+
+    /// Notify the listeners about a transition
+    ///
+    /// \param t The transition
+    void Publish(const alarm_transition& t);
+
+public:
+    /// Constructor
+    AlarmEngine()
+        : m_hysteresis(DEFAULT_HYSTERESIS)
+        , m_debounce(std::chrono::milliseconds(DEFAULT_DEBOUNCE_MS)) { };
+
+    /// Set the hysteresis
+    ///
+    /// \param fraction Fraction of the span of the zones of a path by which a
+    /// value has to leave a zone to drop to a lower severity
+    void SetHysteresis(double fraction)
+    {
+        m_hysteresis = std::max(0.0, fraction);
+    };
+
+    /// Get the hysteresis
+    ///
+    /// \return Fraction of the span of the zones of a path
+    double GetHysteresis() const { return m_hysteresis; };
+
+    /// Set the debounce time
+    ///
+    /// \param debounce Time a new state has to persist before it is published
+    void SetDebounce(clock::duration debounce)
+    {
+        m_debounce = std::max(clock::duration::zero(), debounce);
+    };
+
+    /// Get the debounce time
+    ///
+    /// \return Time a new state has to persist before it is published
+    clock::duration GetDebounce() const { return m_debounce; };
+
+    /// Add a receiver of the state transitions
+    ///
+    /// \param listener Function called on every published transition
+    void AddListener(listener_t listener)
+    {
+        m_listeners.emplace_back(std::move(listener));
+    };
+
+    /// Replace the set of monitored paths. Paths staying monitored keep their
+    /// state, paths no longer monitored get a transition to nominal published
+    /// if they were in any other state
+    ///
+    /// \param watches Monitored paths with the zones configured for them,
+    /// the metadata zones in the SignalK units are used for the paths with no
+    /// zones configured
+    void SetWatches(const watches_t& watches);
+
+    /// Set the zones received in the SignalK metadata of a path
+    ///
+    /// \param path SignalK path
+    /// \param zones The zones
+    void SetMetaZones(const wxString& path, const vector<Zone>& zones);
+
+    /// Evaluate a new value of a path. Does nothing if the path is not
+    /// monitored
+    ///
+    /// \param path SignalK path
+    /// \param value The value in the SignalK units
+    /// \param now Time of the update
+    void Update(const wxString& path, double value, clock::time_point now);
+
+    /// Publish the pending states whose debounce time has passed even if no
+    /// new data arrived for their paths
+    ///
+    /// \param now Current time
+    void Tick(clock::time_point now);
+
+    /// Check whether a path is monitored
+    ///
+    /// \param path SignalK path
+    /// \return true if the values of the path are evaluated
+    bool IsWatched(const wxString& path) const;
+
+    /// Get the published state of a path
+    ///
+    /// \param path SignalK path
+    /// \return The state, nominal for paths which are not monitored
+    Zone::state GetState(const wxString& path) const;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_ALARMENGINE_H_
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+#include "pi_common.h"
+
+#include <atomic>
+#include <chrono>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Source of the current time for the dashboards and instruments.
+///
+/// Everything depending on the passage of time (data timeouts, source locks,
+/// history buckets, alarm debouncing) asks the clock owned by #DashboardSK
+/// instead of the system clock, so that recorded data can be replayed faster
+/// than real time and the timing can be tested deterministically.
+/// Implementations have to be thread safe, the instruments may be rendered on
+/// worker threads.
+class Clock {
+public:
+    /// Clock the time points are compatible with
+    typedef std::chrono::system_clock base_clock;
+    /// Point in time
+    typedef base_clock::time_point time_point;
+
+    /// Destructor
+    virtual ~Clock() = default;
+
+    /// Get the current time
+    ///
+    /// \return The current time
+    virtual time_point Now() const = 0;
+
+    /// Get the clock following the system time
+    ///
+    /// \return The system clock
+    static const Clock& System();
+};
+
+/// Clock following the system time
+class SystemClock : public Clock {
+public:
+    time_point Now() const override { return base_clock::now(); };
+};
+
+inline const Clock& Clock::System()
+{
+    static const SystemClock clock;
+    return clock;
+}
+
+/// Clock which only moves when told to, used to replay recorded data faster
+/// than real time and in tests
+class ManualClock : public Clock {
+private:
+    /// Current time since the epoch of #base_clock
+    std::atomic<base_clock::rep> m_now;
+
+public:
+    /// Constructor
+    ///
+    /// \param now The initial time
+    explicit ManualClock(time_point now = base_clock::now())
+        : m_now(now.time_since_epoch().count()) { };
+
+    time_point Now() const override
+    {
+        return time_point(base_clock::duration(m_now.load()));
+    };
+
+    /// Set the current time
+    ///
+    /// \param now The new time
+    void Set(time_point now) { m_now = now.time_since_epoch().count(); };
+
+    /// Move the time forward
+    ///
+    /// \param by Duration to add to the current time
+    void Advance(base_clock::duration by) { m_now += by.count(); };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_CLOCK_H_
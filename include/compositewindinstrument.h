@@ -152,6 +152,12 @@ public:
     void SetChartRotation(double degrees) override;
 
 private:
+    /// Indexes of the typed settings, generated from DSK_CWI_SETTINGS
+    enum setting_index {
+#define X(key, value, label, control, parameters, json, getter) key##_IDX,
+        DSK_CWI_SETTINGS
+#undef X
+    };
     /// Identifiers for the subscribed Signal K inputs.
     enum class input {
         awa,
@@ -0,0 +1,178 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _CONTEXTEVICTOR_H_
+#define _CONTEXTEVICTOR_H_
+
+#include "clock.h"
+#include "pi_common.h"
+
+#include <json/json.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Removes the contexts (eg. AIS targets) which stopped sending data from the
+/// SignalK data tree, so that it does not grow for the whole session.
+///
+/// A context is evicted when it has not been updated for longer than the TTL,
+/// and the least recently updated contexts are evicted when the estimated size
+/// of all of them exceeds the memory limit. The own vessel is never evicted.
+/// The work is spread over the ticks, each of them only checks a batch of the
+/// contexts, and is cheap enough to be called on every frame. GUI thread only.
+class ContextEvictor {
+public:
+    /// Clock used to age the contexts
+    typedef Clock::base_clock clock;
+    /// Context identified by its group and id, eg. vessels and
+    /// urn:mrn:imo:mmsi:230035780
+    typedef std::pair<std::string, std::string> context_key_t;
+    /// Callback invoked for every evicted context
+    typedef std::function<void(const context_key_t&)> listener_t;
+
+    /// Default time without updates after which a context is evicted in
+    /// minutes
+    static constexpr int DEFAULT_TTL_MIN = 30;
+    /// Default limit of the estimated size of the contexts in kB
+    static constexpr int DEFAULT_MAX_MEMORY_KB = 65536;
+    /// Maximum number of the contexts checked or evicted per tick
+    static constexpr size_t BATCH = 64;
+    /// Minimum time between two ticks doing any work
+    static constexpr std::chrono::seconds TICK_INTERVAL { 1 };
+
+private:
+    /// A tracked context
+    struct context {
+        /// Time of the last update
+        clock::time_point last_update;
+        /// Estimated size of the context when it was last checked
+        size_t bytes = 0;
+    };
+
+    /// The tracked contexts
+    std::map<context_key_t, context> m_contexts;
+    /// The context the next tick starts checking at
+    context_key_t m_cursor;
+    /// Sum of the estimated sizes of the contexts
+    size_t m_total_bytes;
+    /// Time without updates after which a context is evicted, zero to keep the
+    /// contexts forever
+    clock::duration m_ttl;
+    /// Limit of the estimated size of the contexts in bytes, zero for none
+    size_t m_max_bytes;
+    /// Time of the last tick which did any work
+    clock::time_point m_last_tick;
+    /// Number of the contexts evicted so far
+    size_t m_evicted;
+    /// Callback invoked for every evicted context
+    listener_t m_listener;
+
+    /// Remove a context from the data tree and stop tracking it
+    ///
+    /// \param tree The SignalK data tree
+    /// \param it The context
+    /// \return Iterator to the next context
+    std::map<context_key_t, context>::iterator Evict(
+        Json::Value& tree, std::map<context_key_t, context>::iterator it);
+
+public:
+    /// Constructor
+    ContextEvictor();
+
+    /// Record an update of a context
+    ///
+    /// \param group Group of the context, eg. vessels
+    /// \param id Id of the context within the group
+    /// \param now Time of the update
+    void Touch(const std::string& group, const std::string& id,
+        clock::time_point now);
+
+    /// Check the next batch of the contexts and evict the expired ones and,
+    /// if over the memory limit, the least recently updated ones
+    ///
+    /// \param tree The SignalK data tree
+    /// \param self Id of the own vessel, which is never evicted
+    /// \param now Current time
+    /// \return Number of the contexts evicted by this tick
+    size_t Tick(Json::Value& tree, const std::string& self,
+        clock::time_point now);
+
+    /// Set the time without updates after which a context is evicted
+    ///
+    /// \param ttl The time, zero to keep the contexts forever
+    void SetTTL(clock::duration ttl) { m_ttl = ttl; };
+
+    /// Get the time without updates after which a context is evicted
+    ///
+    /// \return The time, zero if the contexts are kept forever
+    clock::duration GetTTL() const { return m_ttl; };
+
+    /// Set the limit of the estimated size of the contexts
+    ///
+    /// \param bytes The limit in bytes, zero for none
+    void SetMaxBytes(size_t bytes) { m_max_bytes = bytes; };
+
+    /// Get the limit of the estimated size of the contexts
+    ///
+    /// \return The limit in bytes, zero if there is none
+    size_t GetMaxBytes() const { return m_max_bytes; };
+
+    /// Get the number of the tracked contexts
+    ///
+    /// \return Number of the contexts
+    size_t GetContextCount() const { return m_contexts.size(); };
+
+    /// Get the estimated size of the tracked contexts
+    ///
+    /// \return Size in bytes
+    size_t GetTotalBytes() const { return m_total_bytes; };
+
+    /// Get the number of the contexts evicted so far
+    ///
+    /// \return Number of the evicted contexts
+    size_t GetEvictedCount() const { return m_evicted; };
+
+    /// Set the callback invoked for every evicted context, so that the data
+    /// referring to the removed part of the tree can be dropped as well
+    ///
+    /// \param listener The callback
+    void SetListener(listener_t listener)
+    {
+        m_listener = std::move(listener);
+    };
+
+    /// Stop tracking all the contexts
+    void Clear();
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_CONTEXTEVICTOR_H_
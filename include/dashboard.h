@@ -28,9 +28,13 @@
 #define _DASHBOARD_H
 
 #include "dskdc.h"
+#include "fontcache.h"
+#include "historyservice.h"
 #include "instrument.h"
 #include "ocpn_plugin.h"
 #include "pi_common.h"
+#include "sourcearbiter.h"
+#include "sourceregistry.h"
 #include <json/json.h>
 #include <map>
 #include <optional>
@@ -109,6 +113,33 @@ private:
     /// Have to be nulled by DashboardSK  calling \c ClearOffsets before each
     /// round of rendering
     static map<canvas_edge_anchor, wxCoord> m_offsets;
+    /// Bitmaps of the instruments rendered for the current frame of an own
+    /// ship anchored dashboard, kept to reuse the storage between the frames
+    vector<wxBitmap> m_frame_bitmaps;
+
+    /// Render an instrument and record the render in its statistics
+    ///
+    /// \param instrument The instrument
+    /// \return The rendered bitmap
+    wxBitmap RenderInstrument(Instrument* instrument);
+
+    /// Draw the rendered bitmap of an instrument on the device context
+    ///
+    /// \param dc The device context to draw on
+    /// \param instrument The instrument
+    /// \param bmp The bitmap rendered by #RenderInstrument
+    /// \param x Horizontal position of the bitmap
+    /// \param y Vertical position of the bitmap
+    void BlitInstrument(dskDC* dc, Instrument* instrument, const wxBitmap& bmp,
+        wxCoord x, wxCoord y);
+
+    /// Draw the statistics of an instrument over it if the HUD is enabled
+    ///
+    /// \param dc The device context to draw on
+    /// \param instrument The instrument
+    /// \param x Horizontal position of the instrument
+    /// \param y Vertical position of the instrument
+    void DrawStats(dskDC* dc, Instrument* instrument, wxCoord x, wxCoord y);
 
 public:
     /// Constructor
@@ -220,6 +251,13 @@ public:
     /// \param canvasIndex The chart canvas index
     void Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex);
 
+    /// Record the frames of the instruments about to be drawn which support
+    /// off-thread rasterization, see Instrument::PrepareRaster
+    ///
+    /// \param canvasIndex The chart canvas index
+    /// \param dirty Instruments with a recorded frame are appended to it
+    void PrepareRaster(int canvasIndex, vector<Instrument*>& dirty);
+
     /// Set the color scheme of the dashboard
     ///
     /// \param cs Integer parameter specifying the color scheme (0 - RGB, 1 -
@@ -252,6 +290,23 @@ public:
     /// \param instrument Pointer to the instrument to unsubscribe
     void Unsubscribe(Instrument* instrument);
 
+    /// Request the paths monitored by the alarm engine to be rebuilt
+    void InvalidateAlarmWatches();
+
+    /// Change the maximum rate of the notifications of an instrument
+    ///
+    /// \param instrument Pointer to the subscribed instrument
+    /// \param max_rate Maximum rate of the notifications in Hz, zero to notify
+    /// every update
+    void SetMaxRate(Instrument* instrument, double max_rate);
+
+    /// Change the allowed data age of an instrument in the arbitrations of
+    /// the sources it takes part in
+    ///
+    /// \param instrument Pointer to the subscribed instrument
+    /// \param timeout Allowed age of the data in seconds
+    void SetTimeout(Instrument* instrument, int timeout);
+
     /// Get list of all instruments
     ///
     /// \return Array of all instrument names
@@ -316,12 +371,42 @@ public:
         m_instruments.at(pos + steps) = old;
     }
 
+    /// Get the current time from the clock of the dashboards
+    ///
+    /// \return The current time
+    Clock::time_point Now() const;
+
     /// Get pointer to the SignalK object from the data tree
     ///
     /// \param path SignalK fully qualified path
     /// \return Pointer to the data object or NULL if not found
     const Json::Value* GetSKData(const wxString& path);
 
+    /// Subscribe an instrument to the central choice of the source of a path
+    ///
+    /// \param path SignalK path with an arbitrated source designation
+    /// \param instrument The instrument
+    /// \param listener Function notified about the changes of the source
+    /// \param preferred Source to choose if the path has none yet, nullptr
+    /// for the first available one
+    /// \return false if the path is not arbitrated
+    bool ArbitrateSource(const wxString& path, Instrument* instrument,
+        const SourceArbiter::listener_t& listener,
+        const wxString* preferred = nullptr);
+
+    /// Choose the source of an arbitrated path for all its instruments
+    ///
+    /// \param path SignalK path with an arbitrated source designation
+    /// \param source The source, empty for the value received without a
+    /// source
+    void LockSource(const wxString& path, const wxString& source);
+
+    /// Get the history of a key shared by all the instruments showing it
+    ///
+    /// \param path SignalK key
+    /// \return The history, nullptr if the dashboard has no parent
+    std::shared_ptr<const History> AcquireHistory(const wxString& path);
+
     /// Get OpenCPN's current magnetic variation.
     ///
     /// \return Variation in degrees, east positive
@@ -337,6 +422,12 @@ public:
     /// \return Magnetic heading in radians, or empty if unavailable
     std::optional<double> GetOwnShipHeadingMagnetic() const;
 
+    /// Get the font and text metrics cache shared by the instruments
+    ///
+    /// \return The cache of the parent DashboardSK, or a process wide one if
+    /// there is no parent
+    FontCache& GetFontCache();
+
     /// Force redraw of the instrument on the next overlay refresh
     void ForceRedraw()
     {
@@ -345,9 +436,24 @@ public:
         }
     };
 
+    /// Forget the rendering and update statistics of all the instruments
+    void ResetStats()
+    {
+        for (auto i : m_instruments) {
+            i->GetStats().Reset();
+        }
+    };
+
     /// Clear the cumulative offsets from the canvas edges, needs to be called
     /// every time before the dashboard rendering loop
-    static void ClearOffsets() { m_offsets.clear(); }
+    static void ClearOffsets()
+    {
+        // Reset the values instead of clearing the map, so that the nodes are
+        // not allocated again on every frame
+        for (auto& offset : m_offsets) {
+            offset.second = 0;
+        }
+    }
 
     /// Process SK data without drawing anything.
     void ProcessData();
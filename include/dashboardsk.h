@@ -27,11 +27,23 @@
 #ifndef _DASHBOARDSK_H_
 #define _DASHBOARDSK_H_
 
+#include "alarmengine.h"
+#include "clock.h"
+#include "contextevictor.h"
 #include "dashboard.h"
+#include "derivedengine.h"
 #include "dskdc.h"
+#include "expression.h"
+#include "filterservice.h"
+#include "fontcache.h"
+#include "historyservice.h"
+#include "memoryreport.h"
 #include "ocpn_plugin.h"
 #include "pager.h"
 #include "pi_common.h"
+#include "renderpool.h"
+#include "sourcearbiter.h"
+#include "sourceregistry.h"
 #include <json/json.h>
 #include <optional>
 #include <unordered_map>
@@ -88,13 +100,50 @@ private:
     bool m_frozen;
     /// Map of dashboard pages displayed on canvases
     std::unordered_map<int, Pager*> m_displayed_pages;
+    /// Subscription of an instrument to a path
+    struct subscription {
+        /// The subscribed instrument
+        Instrument* instrument;
+        /// Minimum time between two notifications, zero to notify every
+        /// update
+        Clock::base_clock::duration interval;
+        /// Time of the last notification
+        Clock::time_point last_notify;
+        /// The path was updated since the last notification
+        bool pending;
+    };
     /// Map of instrument subscription to the data paths. Only instruments
     /// interested in changed data are notified and poll them on next update
 #if wxCHECK_VERSION(3, 1, 0)
-    std::unordered_map<wxString, vector<Instrument*>> m_path_subscriptions;
+    std::unordered_map<wxString, vector<subscription>> m_path_subscriptions;
 #else
-    std::unordered_map<string, vector<Instrument*>> m_path_subscriptions;
+    std::unordered_map<string, vector<subscription>> m_path_subscriptions;
 #endif
+    /// Number of the subscriptions with a pending notification
+    size_t m_pending_notifications;
+    /// Update of a path buffered until the data tick when the deltas are
+    /// coalesced
+    struct pending_update {
+        /// Context of the delta
+        std::string context;
+        /// The update without its values, with the source and the timestamp
+        Json::Value header;
+        /// Path of the value
+        std::string path;
+        /// The last received value
+        Json::Value value;
+        /// Sum of the superseded numeric values, for the histories
+        double sum;
+        /// Number of the superseded numeric values
+        size_t superseded;
+    };
+    /// Whether the received values are buffered and only the last value per
+    /// path is applied at the data tick
+    bool m_coalesce_deltas;
+    /// The buffered updates in the order their paths were first received
+    vector<pending_update> m_pending_updates;
+    /// Index of the buffered updates by their context, source and path
+    std::unordered_map<std::string, size_t> m_pending_index;
     /// Color scheme to be used when rendering the dashboards on screen
     int m_color_scheme;
     /// Whether OpenCPN has supplied a valid own-ship position
@@ -112,6 +161,122 @@ private:
 
     /// Path to the directory with data
     wxString m_data_dir;
+    /// Rasterize the instruments on a pool of worker threads
+    bool m_parallel_rendering;
+    /// Number of rendering worker threads, 0 to derive it from the number of
+    /// CPU cores
+    int m_render_threads;
+    /// Rendering worker pool, created on first use
+    std::unique_ptr<RenderPool> m_render_pool;
+    /// Draw the statistics of the instruments over them
+    bool m_show_stats;
+    /// Fonts and text metrics shared by the instruments
+    FontCache m_font_cache;
+    /// Content scale factor the font cache was filled for
+    double m_font_cache_scale;
+    /// Source of the current time for the dashboards and instruments
+    std::shared_ptr<Clock> m_clock;
+    /// Alarm state evaluation of the subscribed paths
+    AlarmEngine m_alarm_engine;
+    /// The paths monitored by #m_alarm_engine have to be rebuilt from the
+    /// subscriptions before the next evaluation
+    bool m_alarm_watches_dirty;
+    /// Keys of the values evaluated by #m_alarm_engine, with the source
+    /// designation of the instrument showing them, by the monitored path
+#if wxCHECK_VERSION(3, 1, 0)
+    std::unordered_map<wxString, wxString> m_alarm_keys;
+#else
+    std::unordered_map<string, wxString> m_alarm_keys;
+#endif
+    /// Eviction of the stale contexts from #m_sk_data
+    ContextEvictor m_context_evictor;
+    /// Time the stale paths were last expired
+    Clock::time_point m_last_path_expiry;
+    /// Sources of the received paths
+    SourceRegistry m_sources;
+    /// Central choice of the sources of the arbitrated paths
+    SourceArbiter m_source_arbiter;
+    /// Filter pipelines of the subscribed paths
+    FilterService m_filters;
+    /// Histories of the paths shown by the histogram instruments
+    HistoryService m_histories;
+    /// Expressions shown by the instruments
+    ExpressionService m_expressions;
+    /// Values derived from the paths of the own vessel
+    DerivedEngine m_derived;
+    /// Depth of the deltas with the derived values being processed
+    int m_derived_depth;
+
+    /// Notify a subscribed instrument about the update of a path
+    ///
+    /// \param path The updated path
+    /// \param sub The subscription
+    /// \param now Current time
+    void Notify(const wxString& path, subscription& sub, Clock::time_point now);
+
+    /// Deliver the coalesced notifications whose interval has elapsed
+    ///
+    /// \param now Current time
+    void FlushNotifications(Clock::time_point now);
+
+    /// Buffer the values of a delta until the data tick, replacing the values
+    /// of the same paths received earlier. The updates without values are
+    /// processed right away.
+    ///
+    /// \param message JSON object representing SignalK delta message
+    void BufferDelta(const Json::Value& message);
+
+    /// Apply the buffered values to the data tree, as one delta per context
+    void ApplyPendingDeltas();
+
+    /// Process a SignalK delta message and update the data tree
+    ///
+    /// \param message JSON object representing SignalK delta message
+    /// \param superseded The buffered updates the delta was built from,
+    /// indexed like its updates, to account for the values they superseded.
+    /// nullptr for the received deltas.
+    void ProcessDelta(Json::Value& message,
+        const vector<const pending_update*>* superseded = nullptr);
+
+    /// Get the minimum time between two notifications of a subscription
+    ///
+    /// \param max_rate Maximum rate of the notifications in Hz
+    /// \return The time, zero to notify every update if the rate is not
+    /// positive
+    static Clock::base_clock::duration NotificationInterval(double max_rate)
+    {
+        if (max_rate <= 0.0) {
+            return Clock::base_clock::duration::zero();
+        }
+        return std::chrono::duration_cast<Clock::base_clock::duration>(
+            std::chrono::duration<double>(1.0 / max_rate));
+    }
+
+    /// Get the name of the source of an update of a delta
+    ///
+    /// \param update The update
+    /// \return Source name, empty if the update has no source
+    static wxString SourceOf(const Json::Value& update);
+
+    /// Rebuild the paths monitored by the alarm engine from the subscriptions
+    /// and the zones configured in the subscribed instruments if they changed
+    void UpdateAlarmWatches();
+
+    /// Evaluate the value of a monitored path by the alarm engine if the
+    /// updated node is the one shown by the instrument monitoring it
+    ///
+    /// \param path The updated path
+    /// \param node The updated node of the path
+    /// \param now Time of the update
+    void EvaluateAlarm(
+        const wxString& path, const Json::Value* node, Clock::time_point now);
+
+    /// Rasterize the instruments of the dashboards displayed on a canvas
+    /// which have new frames in parallel, so that drawing them afterwards only
+    /// blits the cached bitmaps
+    ///
+    /// \param canvasIndex The chart canvas index
+    void RasterizeDirty(int canvasIndex);
 
     /// Process the SK value and if it is an object, extend the data structure
     /// to make the actual values leaves
@@ -120,8 +285,34 @@ private:
     /// \param value Value to be processed
     /// \param ts Timestamp
     /// \param source Data source name
+    /// \param path Fully qualified SignalK path of the branch, empty if the
+    /// branch is the node of a source, where no paths are registered
     void ProcessComplexValue(Json::Value* parent, const Json::Value& value,
-        const wxDateTime& ts, const wxString& source);
+        const wxDateTime& ts, const wxString& source, const wxString& path);
+
+    /// Move the subscription of an instrument to another path, eg. when the
+    /// relative paths of an expression are qualified by a new context
+    ///
+    /// \param owner The subscribed instrument
+    /// \param from The path subscribed so far
+    /// \param to The new path
+    void MoveSubscription(
+        const void* owner, const wxString& from, const wxString& to);
+
+    /// Remove the paths of the other contexts which have not been updated for
+    /// longer than the TTL of the contexts from the data tree, a batch of the
+    /// paths per call
+    ///
+    /// \param now Current time
+    void ExpirePaths(Clock::time_point now);
+
+    /// Remove the value of a source of a path from the data tree, together
+    /// with the nodes left empty
+    ///
+    /// \param path Fully qualified SignalK path
+    /// \param source Name of the source, empty for the value received without
+    /// a source
+    void RemoveSourceNode(const wxString& path, const wxString& source);
 
 public:
     /// Get current log level
@@ -135,6 +326,7 @@ public:
     /// Constructor
     ~DashboardSK()
     {
+        Instrument::UnwatchSystemFontScalingFactor();
         for (auto db : m_dashboards) {
             delete db;
         }
@@ -224,11 +416,32 @@ public:
     ///\return Pointer to the data object or NULL if not found
     const Json::Value* GetSKData(const wxString& path);
 
-    /// Process a JSON object representing SignalK delta message
+    /// Process a JSON object representing SignalK delta message, or buffer
+    /// its values until the data tick if the deltas are coalesced
     ///
     /// \param message JSON object representing SignalK delta message
     void SendSKDelta(Json::Value& message);
 
+    /// Enable or disable coalescing of the deltas. When enabled, only the
+    /// last value received for a path between two data ticks is applied, so
+    /// that the cost of a burst scales with the number of the distinct paths
+    /// instead of the number of the messages. The buffered values are applied
+    /// right away when disabled.
+    ///
+    /// \param enabled Whether the deltas are coalesced
+    void SetCoalesceDeltas(bool enabled);
+
+    /// Check whether the deltas are coalesced
+    ///
+    /// \return true if only the last value per path is applied at the data
+    /// tick
+    bool GetCoalesceDeltas() const { return m_coalesce_deltas; }
+
+    /// Get the number of the values waiting for the data tick
+    ///
+    /// \return Number of the buffered paths
+    size_t GetPendingUpdateCount() const { return m_pending_updates.size(); }
+
     /// Return the SignalK context representing the generic "vessels.self"
     const wxString Self() { return m_self; };
 
@@ -241,6 +454,10 @@ public:
     {
         m_self = NormalizeID(self);
         m_self_ptr = &m_sk_data["vessels"][Self().ToStdString()];
+        m_derived.SetContext("vessels." + Self());
+        m_expressions.SetContext("vessels." + Self(),
+            [this](const void* owner, const wxString& from,
+                const wxString& to) { MoveSubscription(owner, from, to); });
     };
 
     /// Normalize the vessel id (MMSI, UUID, URL...)
@@ -273,13 +490,58 @@ public:
     }
 
     /// Subscribe the instrument to notifications about value updates of a path
+    /// and to the arbitration of its source if it is designated with a policy
     ///
     /// \param path SignalK path
     /// \param instrument Pointer to the subscribed instrument
-    void Subscribe(const wxString& path, Instrument* instrument)
+    /// \param max_rate Maximum rate of the notifications in Hz, the updates
+    /// coming faster are coalesced into one notification. Zero to notify
+    /// every update.
+    void Subscribe(
+        const wxString& path, Instrument* instrument, double max_rate = 0.0)
     {
-        wxString ps = path.Left(path.Find(SRC_MAGIC_STRING) - 1);
-        m_path_subscriptions[UNORDERED_KEY(ps)].push_back(instrument);
+        if (Expression::IsExpression(path)) {
+            // The instrument is notified about the updates of all the paths
+            // of the expression
+            if (m_expressions.Subscribe(path, instrument)) {
+                for (const auto& input : m_expressions.GetInputs(path)) {
+                    Subscribe(input, instrument, max_rate);
+                }
+            }
+            return;
+        }
+        wxString ps = FilterService::BasePath(path);
+        subscription sub { instrument, NotificationInterval(max_rate),
+            Clock::time_point(), false };
+        m_path_subscriptions[UNORDERED_KEY(ps)].push_back(sub);
+        if (FilterService::IsFiltered(path)) {
+            m_filters.Subscribe(path, instrument);
+        }
+        // The input of a pipeline takes part in the arbitration like an
+        // unfiltered path, once for all the reads of the instrument
+        instrument->ArbitrateSource(path.BeforeFirst(FILTER_SEPARATOR));
+        m_alarm_watches_dirty = true;
+    }
+
+    /// Change the maximum rate of the notifications of all the subscriptions
+    /// of an instrument
+    ///
+    /// \param instrument Pointer to the subscribed instrument
+    /// \param max_rate Maximum rate of the notifications in Hz, zero to notify
+    /// every update
+    void SetMaxRate(Instrument* instrument, double max_rate)
+    {
+        const Clock::base_clock::duration interval
+            = NotificationInterval(max_rate);
+        for (auto& subs : m_path_subscriptions) {
+            for (auto& sub : subs.second) {
+                if (sub.instrument == instrument) {
+                    // The pending notification is delivered by the next
+                    // FlushNotifications if the new interval has elapsed
+                    sub.interval = interval;
+                }
+            }
+        }
     }
 
     /// Unsubscribe instrument from all paths
@@ -288,17 +550,45 @@ public:
     void Unsubscribe(Instrument* instrument)
     {
         for (auto& sub : m_path_subscriptions) {
-            std::vector<Instrument*>::iterator it = sub.second.begin();
+            auto it = sub.second.begin();
             while (it != sub.second.end()) {
-                if (*it == instrument) {
+                if (it->instrument == instrument) {
+                    m_pending_notifications -= it->pending ? 1 : 0;
                     it = sub.second.erase(it);
                 } else {
                     ++it;
                 }
             }
         }
+        m_source_arbiter.Unsubscribe(instrument);
+        m_filters.Unsubscribe(instrument);
+        m_expressions.Unsubscribe(instrument);
+        m_alarm_watches_dirty = true;
     }
 
+    /// Request the paths monitored by the alarm engine to be rebuilt, has to
+    /// be called whenever the zones of a subscribed instrument change
+    void InvalidateAlarmWatches() { m_alarm_watches_dirty = true; }
+
+    /// Get the clock used by the dashboards and instruments
+    ///
+    /// \return The clock
+    const Clock& GetClock() const { return *m_clock; }
+
+    /// Replace the clock used by the dashboards and instruments, eg. with a
+    /// #ManualClock to replay recorded data faster than real time
+    ///
+    /// \param clock The clock, the system clock is used if nullptr
+    void SetClock(std::shared_ptr<Clock> clock)
+    {
+        m_clock = clock ? std::move(clock) : std::make_shared<SystemClock>();
+    }
+
+    /// Get the alarm engine evaluating the zones of the subscribed paths
+    ///
+    /// \return The alarm engine
+    AlarmEngine& GetAlarmEngine() { return m_alarm_engine; }
+
     /// Get list of all dashboards
     ///
     /// \return Array of all dashboard names
@@ -511,6 +801,88 @@ public:
     ///
     /// \return The scale factor
     double GetContentScaleFactor() const;
+
+    /// Get the font and text metrics cache shared by the instruments
+    ///
+    /// \return The cache
+    FontCache& GetFontCache() { return m_font_cache; }
+
+    /// Enable or disable rasterization of the instruments on worker threads
+    ///
+    /// \param enabled Whether the parallel rendering is used
+    /// \param threads Number of worker threads, 0 to derive it from the
+    /// number of CPU cores
+    void SetParallelRendering(bool enabled, int threads = 0);
+
+    /// Check whether the instruments are rasterized on worker threads
+    ///
+    /// \return true if parallel rendering is enabled
+    bool GetParallelRendering() const { return m_parallel_rendering; }
+
+    /// Get the configured number of rendering worker threads
+    ///
+    /// \return Number of threads, 0 means derived from the CPU core count
+    int GetRenderThreads() const { return m_render_threads; }
+
+    /// Show or hide the rendering and update statistics of the instruments
+    /// drawn over them on the canvas
+    ///
+    /// \param show Whether the statistics are shown
+    void SetShowStats(bool show) { m_show_stats = show; }
+
+    /// Check whether the statistics of the instruments are drawn on the canvas
+    ///
+    /// \return true if the statistics are shown
+    bool GetShowStats() const { return m_show_stats; }
+
+    /// Forget the rendering and update statistics of all the instruments
+    void ResetStats()
+    {
+        for (auto d : m_dashboards) {
+            d->ResetStats();
+        }
+    };
+
+    /// Estimate the memory used by the SignalK data, the histories and the
+    /// cached bitmaps of the instruments
+    ///
+    /// \return The breakdown of the memory use
+    MemoryReport GetMemoryReport();
+
+    /// Get the eviction of the stale contexts from the SignalK data
+    ///
+    /// \return The context evictor
+    ContextEvictor& GetContextEvictor() { return m_context_evictor; };
+
+    /// Get the registry of the sources of the received paths
+    ///
+    /// \return The source registry
+    const SourceRegistry& GetSources() const { return m_sources; };
+
+    /// Get the central choice of the sources of the arbitrated paths
+    ///
+    /// \return The source arbiter
+    SourceArbiter& GetSourceArbiter() { return m_source_arbiter; };
+
+    /// Get the filter pipelines of the subscribed paths
+    ///
+    /// \return The filter service
+    const FilterService& GetFilters() const { return m_filters; };
+
+    /// Get the histories of the paths shown by the instruments
+    ///
+    /// \return The history service
+    HistoryService& GetHistoryService() { return m_histories; };
+
+    /// Get the engine computing the derived values
+    ///
+    /// \return The derived value engine
+    DerivedEngine& GetDerivedEngine() { return m_derived; };
+
+    /// Get the expressions shown by the instruments
+    ///
+    /// \return The expression service
+    const ExpressionService& GetExpressions() const { return m_expressions; };
 };
 
 PLUGIN_END_NAMESPACE
@@ -29,8 +29,13 @@
 
 #include "config.h"
 #include "dashboardsk.h"
+#include "deltalog.h"
 #include "dskdc.h"
+#include "loadgenerator.h"
 #include "pi_common.h"
+#include "tracer.h"
+
+#include <wx/timer.h>
 
 constexpr int MY_API_VERSION_MAJOR = 1;
 constexpr int MY_API_VERSION_MINOR = 18;
@@ -38,6 +43,15 @@ constexpr int MY_API_VERSION_MINOR = 18;
 constexpr int DASHBOARDSK_TOOL_POSITION
     = -1; // Request default positioning of toolbar tool
 
+constexpr int REPLAY_INTERVAL_MS
+    = 50; // Period of feeding the replayed SignalK data to the dashboards
+
+constexpr int LOAD_INTERVAL_MS
+    = 20; // Period of feeding the generated SignalK data to the dashboards
+
+constexpr int TRACE_FLUSH_INTERVAL_MS
+    = 500; // Period of writing the recorded trace spans to the file
+
 PLUGIN_BEGIN_NAMESPACE
 
 //----------------------------------------------------------------------------------------------------------
@@ -62,10 +76,45 @@ private:
     dskDC* m_oDC;
     /// Path to the configuration file
     wxString m_config_file;
+    /// Recorder of the received SignalK messages, enabled by the
+    /// \c DASHBOARDSK_RECORD environment variable
+    DeltaRecorder m_recorder;
+    /// Player of a recorded delta log, enabled by the \c DASHBOARDSK_REPLAY
+    /// environment variable
+    DeltaReplayer m_replayer;
+    /// Timer driving the playback of #m_replayer
+    wxTimer m_replay_timer;
+    /// Generator of synthetic SignalK traffic, enabled by the
+    /// \c DASHBOARDSK_LOADGEN environment variable
+    std::unique_ptr<LoadGenerator> m_load_generator;
+    /// Timer driving #m_load_generator
+    wxTimer m_load_timer;
+    /// Timer flushing the trace spans, running while tracing is enabled by
+    /// the \c DASHBOARDSK_TRACE environment variable
+    wxTimer m_trace_timer;
 
     /// Load the configuration from disk
     void LoadConfig();
 
+    /// Start recording, replaying or generating the SignalK data or tracing if
+    /// requested by the environment
+    void SetupDeltaLog();
+
+    /// Feed the due messages of the replayed delta log to the dashboards
+    ///
+    /// \param event The timer event
+    void OnReplayTimer(wxTimerEvent& event);
+
+    /// Feed the due synthetic messages to the dashboards
+    ///
+    /// \param event The timer event
+    void OnLoadTimer(wxTimerEvent& event);
+
+    /// Write the recorded trace spans to the trace file
+    ///
+    /// \param event The timer event
+    void OnTraceTimer(wxTimerEvent& event);
+
 public:
     /// Constructor
     ///
@@ -52,6 +52,7 @@ protected:
     wxChoice* m_comboDashboard;
     wxButton* m_btnRenameDashboard;
     wxButton* m_btnNewDashboard;
+    wxButton* m_btnStats;
     wxButton* m_btnRemoveDashboard;
     wxPanel* m_panelList;
     wxScrolledWindow* m_scrolledWindowInstrumentList;
@@ -116,6 +117,10 @@ protected:
     {
         event.Skip();
     }
+    virtual void m_btnStatsOnButtonClick(wxCommandEvent& event)
+    {
+        event.Skip();
+    }
     virtual void m_btnRemoveDashboardOnButtonClick(wxCommandEvent& event)
     {
         event.Skip();
@@ -51,6 +51,7 @@ protected:
     wxChoice* m_comboDashboard;
     wxButton* m_btnRenameDashboard;
     wxButton* m_btnNewDashboard;
+    wxButton* m_btnStats;
     wxButton* m_btnRemoveDashboard;
     wxCheckBox* m_cbEnabled;
     wxStaticText* m_stCanvas;
@@ -116,6 +117,10 @@ protected:
     {
         event.Skip();
     }
+    virtual void m_btnStatsOnButtonClick(wxCommandEvent& event)
+    {
+        event.Skip();
+    }
     virtual void m_btnRemoveDashboardOnButtonClick(wxCommandEvent& event)
     {
         event.Skip();
@@ -135,6 +135,11 @@ protected:
     /// \param event The event object reference
     virtual void m_btnSignalKOnButtonClick(wxCommandEvent& event);
 
+    /// Event handler for displaying the statistics of the instruments
+    ///
+    /// \param event The event object reference
+    virtual void m_btnStatsOnButtonClick(wxCommandEvent& event);
+
     /// Event handler for dashboard selection in the combobox
     ///
     /// \param event The event object reference
@@ -443,7 +448,7 @@ private:
     wxTreeItemId m_self_item_id;
 
     /// Current source selection mode: "specific", "any", "lockfirst",
-    /// "lockpersist"
+    /// "lockpersist" or the designation configured by hand, eg. "freshest"
     wxString m_source_mode = "specific";
 
     /// Event handlers for source mode selection
@@ -0,0 +1,275 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _DELTALOG_H_
+#define _DELTALOG_H_
+
+#include "clock.h"
+#include "pi_common.h"
+
+#include <wx/string.h>
+#include <wx/wfstream.h>
+#include <wx/zstream.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+PLUGIN_BEGIN_NAMESPACE
+
+class DashboardSK;
+
+/// Single SignalK message stored in a delta log
+struct delta_record {
+    /// Time the message was received, in milliseconds since the Unix epoch
+    int64_t timestamp;
+    /// The message as received from OpenCPN
+    wxString message;
+};
+
+/// Delta log file layout shared by #DeltaRecorder and #DeltaReplayer.
+///
+/// The file starts with the 8 byte magic \c "DSKDELTA", a version byte and a
+/// flags byte. The records follow, zlib compressed as a single stream if the
+/// #COMPRESSED flag is set. Each record is the difference of its timestamp
+/// from the previous record in milliseconds as a zigzag encoded varint, the
+/// length of the message as a varint and the message in UTF-8.
+namespace DeltaLog {
+    /// File magic
+    constexpr char MAGIC[] = "DSKDELTA";
+    /// Length of the magic
+    constexpr size_t MAGIC_LEN = sizeof(MAGIC) - 1;
+    /// Current version of the format
+    constexpr uint8_t VERSION = 1;
+    /// The records are zlib compressed
+    constexpr uint8_t COMPRESSED = 0x01;
+    /// Sanity limit of the length of a single message
+    constexpr uint64_t MAX_MESSAGE_LEN = 64 * 1024 * 1024;
+
+    /// Get the current time as stored in the records
+    ///
+    /// \return Milliseconds since the Unix epoch
+    inline int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+}
+
+/// Writes the SignalK messages received by the plugin to a delta log, so
+/// that the exact stream from the boat can be replayed later. GUI thread only.
+class DeltaRecorder {
+private:
+    /// The log file
+    std::unique_ptr<wxFileOutputStream> m_file;
+    /// Compressing stream on top of #m_file, if enabled
+    std::unique_ptr<wxZlibOutputStream> m_zlib;
+    /// Stream the records are written to
+    wxOutputStream* m_out;
+    /// Timestamp of the last record
+    int64_t m_last_timestamp;
+    /// Number of records written
+    size_t m_count;
+
+    /// Write an unsigned varint
+    ///
+    /// \param val The value
+    void WriteVarint(uint64_t val);
+
+public:
+    /// Constructor
+    DeltaRecorder()
+        : m_out(nullptr)
+        , m_last_timestamp(0)
+        , m_count(0) { };
+
+    /// Destructor, closes the log
+    ~DeltaRecorder() { Close(); };
+
+    DeltaRecorder(const DeltaRecorder&) = delete;
+    DeltaRecorder& operator=(const DeltaRecorder&) = delete;
+
+    /// Create the log file, closing the previous one if open
+    ///
+    /// \param path Path to the log file, overwritten if it exists
+    /// \param compress Compress the records
+    /// \return true if the log is ready for writing
+    bool Open(const wxString& path, bool compress = true);
+
+    /// Finish and close the log
+    void Close();
+
+    /// Check whether a log is being written
+    ///
+    /// \return true if the log is open
+    bool IsRecording() const { return m_out != nullptr; };
+
+    /// Get the number of records written to the current log
+    ///
+    /// \return Number of records
+    size_t GetCount() const { return m_count; };
+
+    /// Append a message received now to the log
+    ///
+    /// \param message The message
+    void Record(const wxString& message) { Record(message, DeltaLog::Now()); };
+
+    /// Append a message to the log
+    ///
+    /// \param message The message
+    /// \param timestamp Time the message was received, in milliseconds since
+    /// the Unix epoch
+    void Record(const wxString& message, int64_t timestamp);
+};
+
+/// Reads a delta log and feeds the messages to #DashboardSK::SendSKDelta,
+/// either keeping the recorded timing scaled by a speed factor or as fast as
+/// possible. GUI thread only.
+class DeltaReplayer {
+public:
+    /// Clock used to schedule the playback
+    typedef std::chrono::steady_clock clock;
+
+private:
+    /// The log file
+    std::unique_ptr<wxFileInputStream> m_file;
+    /// Decompressing stream on top of #m_file, if the log is compressed
+    std::unique_ptr<wxZlibInputStream> m_zlib;
+    /// Stream the records are read from
+    wxInputStream* m_in;
+    /// Timestamp of the last record read
+    int64_t m_last_timestamp;
+    /// Timestamp of the first record played back
+    int64_t m_first_timestamp;
+    /// Record read ahead and waiting for its time to come
+    delta_record m_next;
+    /// #m_next holds a record
+    bool m_has_next;
+    /// Playback speed multiplier, 0 for as fast as possible
+    double m_speed;
+    /// Time the playback started
+    clock::time_point m_start;
+    /// The playback has started
+    bool m_started;
+    /// Clock set to the recorded time of each message played back, if any
+    std::shared_ptr<ManualClock> m_clock;
+
+    /// Read a single byte
+    ///
+    /// \param b The byte read
+    /// \return false at the end of the log
+    bool ReadByte(uint8_t& b);
+
+    /// Read an unsigned varint
+    ///
+    /// \param val The value read
+    /// \return false at the end of the log or if the varint is malformed
+    bool ReadVarint(uint64_t& val);
+
+    /// Get the time a record is due to be played back
+    ///
+    /// \param rec The record
+    /// \return Time of the playback, only meaningful with non-zero speed
+    clock::time_point Due(const delta_record& rec) const;
+
+public:
+    /// Maximum number of messages sent by a single #Pump call, so that the
+    /// GUI stays responsive when replaying as fast as possible
+    static constexpr size_t MAX_BATCH = 1000;
+
+    /// Constructor
+    DeltaReplayer()
+        : m_in(nullptr)
+        , m_last_timestamp(0)
+        , m_first_timestamp(0)
+        , m_has_next(false)
+        , m_speed(1.0)
+        , m_started(false) { };
+
+    DeltaReplayer(const DeltaReplayer&) = delete;
+    DeltaReplayer& operator=(const DeltaReplayer&) = delete;
+
+    /// Open a log for playback, closing the previous one if open
+    ///
+    /// \param path Path to the log file
+    /// \return true if the file is a valid delta log
+    bool Open(const wxString& path);
+
+    /// Close the log
+    void Close();
+
+    /// Check whether there may be more records to play back
+    ///
+    /// \return true if a log is open and its end was not reached yet
+    bool IsOpen() const { return m_in != nullptr || m_has_next; };
+
+    /// Set the playback speed
+    ///
+    /// \param speed Multiplier of the recorded pace, 0 or less to play back
+    /// as fast as possible
+    void SetSpeed(double speed) { m_speed = speed > 0.0 ? speed : 0.0; };
+
+    /// Get the playback speed
+    ///
+    /// \return Multiplier of the recorded pace, 0 for as fast as possible
+    double GetSpeed() const { return m_speed; };
+
+    /// Drive a clock by the recorded time of the played back messages. The
+    /// data of the dashboards is processed after each message, so that the
+    /// instruments see the recorded timing however fast the log is replayed.
+    /// The clock has to be the one set to the #DashboardSK receiving the data.
+    ///
+    /// \param clock The clock, nullptr to stop driving it
+    void SetClock(std::shared_ptr<ManualClock> clock)
+    {
+        m_clock = std::move(clock);
+    };
+
+    /// Read the next record from the log
+    ///
+    /// \param rec The record read
+    /// \return false at the end of the log
+    bool Next(delta_record& rec);
+
+    /// Send the messages which are due to the dashboard without blocking
+    ///
+    /// \param dsk The dashboard receiving the messages
+    /// \param now Current time, the playback starts at the first call
+    /// \return Number of messages sent
+    size_t Pump(DashboardSK& dsk, clock::time_point now);
+
+    /// Play back the rest of the log, sleeping between the messages as
+    /// needed by the playback speed
+    ///
+    /// \param dsk The dashboard receiving the messages
+    /// \return Number of messages sent
+    size_t Replay(DashboardSK& dsk);
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_DELTALOG_H_
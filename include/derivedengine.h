@@ -0,0 +1,168 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _DERIVEDENGINE_H_
+#define _DERIVEDENGINE_H_
+
+#include "pi_common.h"
+#include "sourceregistry.h"
+
+#include <json/json.h>
+
+#include <functional>
+#include <unordered_map>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Prefix of the paths computed by the derived value engine
+#define DERIVED_PATH_PREFIX "derived."
+
+/// Computes values derived from other SignalK paths of the own vessel, eg. the
+/// true wind from the apparent wind and the speed through water.
+///
+/// Every derivation declares the paths it is computed from and is recomputed
+/// only after one of them was updated, at most once per delta. The results
+/// are published by the caller into the data tree as normal paths under
+/// #DERIVED_PATH_PREFIX, so that any instrument can show them and they may
+/// themselves be inputs of further derivations. The inputs without a source
+/// designation are read from any source providing them (\c SRC:any), so
+/// values received with a \c $source are used as well. All the values are in
+/// the SignalK units. GUI thread only.
+class DerivedEngine {
+public:
+    /// Function reading a SignalK path from the data tree
+    typedef std::function<const Json::Value*(const wxString&)> reader_t;
+    /// Function computing a derived value from the values of its inputs in
+    /// the order they were declared, returns false if there is no result
+    typedef std::function<bool(const vector<double>&, double&)> compute_t;
+    /// Key of the paths
+    typedef SourceRegistry::path_key_t path_key_t;
+
+    /// Maximum length of a chain of derivations computed from one delta
+    static constexpr int MAX_DEPTH = 8;
+
+private:
+    /// A derived path
+    struct derivation {
+        /// The computed path relative to the vessel
+        wxString path;
+        /// The input paths relative to the vessel
+        vector<wxString> inputs;
+        /// The full paths the inputs are read from in the current context
+        vector<wxString> reads;
+        /// The computation
+        compute_t compute;
+        /// An input was updated since the last computation
+        bool dirty = false;
+    };
+
+    /// Function reading the inputs
+    reader_t m_reader;
+    /// Context of the own vessel the derivations are computed for
+    wxString m_context;
+    /// The derivations
+    vector<derivation> m_derivations;
+    /// Indexes of the derivations depending on each input, by the full key
+    std::unordered_map<path_key_t, vector<size_t>> m_by_input;
+    /// Indexes of the derivations to recompute
+    vector<size_t> m_dirty;
+
+    /// Rebuild #m_by_input for the current context
+    void Rebuild();
+
+    /// Register the derivations computed out of the box
+    void RegisterBuiltins();
+
+public:
+    /// Constructor
+    ///
+    /// \param reader Function reading the input paths from the data tree
+    explicit DerivedEngine(reader_t reader);
+
+    /// Register a derived path
+    ///
+    /// \param path The computed path relative to the vessel, should start with
+    /// #DERIVED_PATH_PREFIX
+    /// \param inputs The input paths relative to the vessel, optionally with
+    /// a source designation, eg. navigation.speedThroughWater.SRC:priority(a,b)
+    /// \param compute The computation
+    void Register(const wxString& path, const vector<wxString>& inputs,
+        const compute_t& compute);
+
+    /// Set the context of the own vessel
+    ///
+    /// \param context The context, eg. vessels.urn:mrn:imo:mmsi:265599691
+    void SetContext(const wxString& context);
+
+    /// Note the update of a path, the derivations depending on it are
+    /// recomputed by the next #Compute
+    ///
+    /// \param key Full key of the updated path
+    void Update(const path_key_t& key);
+
+    /// Check whether any derivation waits for #Compute
+    ///
+    /// \return true if an input was updated since the last computation
+    bool IsPending() const { return !m_dirty.empty(); };
+
+    /// Recompute the derivations whose inputs were updated
+    ///
+    /// \return SignalK delta values (path and value) of the results
+    Json::Value Compute();
+
+    /// Get the number of the registered derivations
+    ///
+    /// \return Number of the derivations
+    size_t GetDerivationCount() const { return m_derivations.size(); };
+
+    /// Compute the true wind relative to the water from the apparent wind,
+    /// ignoring the leeway
+    ///
+    /// \param awa Apparent wind angle in radians
+    /// \param aws Apparent wind speed
+    /// \param stw Speed through water in the same units as \c aws
+    /// \param twa Receives the true wind angle in radians, -PI to PI
+    /// \param tws Receives the true wind speed
+    static void TrueWind(
+        double awa, double aws, double stw, double& twa, double& tws);
+
+    /// Compute the current as the difference of the motion over ground and
+    /// through the water, ignoring the leeway
+    ///
+    /// \param cog Course over ground in radians
+    /// \param sog Speed over ground
+    /// \param hdg Heading in radians
+    /// \param stw Speed through water in the same units as \c sog
+    /// \param set Receives the direction the current flows to in radians,
+    /// 0 to 2PI
+    /// \param drift Receives the speed of the current
+    static void Current(double cog, double sog, double hdg, double stw,
+        double& set, double& drift);
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_DERIVEDENGINE_H_
@@ -0,0 +1,367 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _DSKRASTER_H_
+#define _DSKRASTER_H_
+
+#include "pi_common.h"
+
+#include <wx/bitmap.h>
+#include <wx/brush.h>
+#include <wx/font.h>
+#include <wx/pen.h>
+
+#include <memory>
+#include <vector>
+
+PLUGIN_BEGIN_NAMESPACE
+
+class FontCache;
+
+/// Straight (non-premultiplied) RGBA color used by the rasterizer
+struct raster_color {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+/// 8-bit coverage mask of a piece of text pre-rendered by wxWidgets
+struct raster_mask {
+    /// Width of the mask in pixels
+    int width;
+    /// Height of the mask in pixels
+    int height;
+    /// Row-major coverage values (0 - transparent, 255 - opaque)
+    vector<uint8_t> coverage;
+};
+
+/// Coverage mask of a piece of text in a given font and rotation
+struct text_mask {
+    /// Horizontal position of the mask relative to the text origin
+    int left;
+    /// Vertical position of the mask relative to the text origin
+    int top;
+    /// The mask
+    raster_mask mask;
+};
+
+/// RGBA pixel buffer with antialiased primitives.
+///
+/// The class does not touch any wxWidgets object, so independent instances
+/// can be drawn to from worker threads concurrently.
+class RasterImage {
+private:
+    /// Width in pixels
+    int m_width;
+    /// Height in pixels
+    int m_height;
+    /// Row-major RGBA pixels, 4 bytes per pixel
+    vector<uint8_t> m_pixels;
+
+    /// Blend color into a pixel using the source-over operator
+    ///
+    /// \param x Horizontal position of the pixel
+    /// \param y Vertical position of the pixel
+    /// \param c Color
+    /// \param coverage Fraction of the pixel covered by the shape (0..1)
+    void Blend(int x, int y, const raster_color& c, double coverage);
+
+public:
+    /// Constructor
+    ///
+    /// \param width Width in pixels
+    /// \param height Height in pixels
+    RasterImage(int width, int height);
+
+    /// Get the width of the image
+    ///
+    /// \return Width in pixels
+    int GetWidth() const { return m_width; }
+
+    /// Get the height of the image
+    ///
+    /// \return Height in pixels
+    int GetHeight() const { return m_height; }
+
+    /// Get the raw RGBA pixel data
+    ///
+    /// \return Row-major RGBA pixels
+    const vector<uint8_t>& GetPixels() const { return m_pixels; }
+
+    /// Get color of a single pixel
+    ///
+    /// \param x Horizontal position
+    /// \param y Vertical position
+    /// \return Color of the pixel
+    raster_color GetPixel(int x, int y) const;
+
+    /// Fill the whole image with a color, no blending is performed
+    ///
+    /// \param c Color
+    void Clear(const raster_color& c);
+
+    /// Fill an axis aligned rectangle
+    ///
+    /// \param x Left edge
+    /// \param y Top edge
+    /// \param w Width
+    /// \param h Height
+    /// \param c Color
+    void FillRect(
+        double x, double y, double w, double h, const raster_color& c);
+
+    /// Fill a circle
+    ///
+    /// \param xc Horizontal position of the center
+    /// \param yc Vertical position of the center
+    /// \param r Radius
+    /// \param c Color
+    void FillCircle(double xc, double yc, double r, const raster_color& c);
+
+    /// Stroke a circle
+    ///
+    /// \param xc Horizontal position of the center
+    /// \param yc Vertical position of the center
+    /// \param r Radius
+    /// \param width Width of the line
+    /// \param c Color
+    void StrokeCircle(
+        double xc, double yc, double r, double width, const raster_color& c);
+
+    /// Fill a circular sector (pie). The sector spans counterclockwise (as seen
+    /// on the screen) from \c start to \c end, equal angles fill the whole
+    /// circle.
+    ///
+    /// \param xc Horizontal position of the center
+    /// \param yc Vertical position of the center
+    /// \param r Radius
+    /// \param start Start angle in radians, 0 pointing right
+    /// \param end End angle in radians, 0 pointing right
+    /// \param c Color
+    void FillSector(double xc, double yc, double r, double start, double end,
+        const raster_color& c);
+
+    /// Stroke a line segment with round caps
+    ///
+    /// \param x0 Horizontal position of the start point
+    /// \param y0 Vertical position of the start point
+    /// \param x1 Horizontal position of the end point
+    /// \param y1 Vertical position of the end point
+    /// \param width Width of the line
+    /// \param c Color
+    void StrokeLine(double x0, double y0, double x1, double y1, double width,
+        const raster_color& c);
+
+    /// Fill a convex polygon
+    ///
+    /// \param xs Horizontal coordinates of the vertices
+    /// \param ys Vertical coordinates of the vertices
+    /// \param n Number of vertices
+    /// \param c Color
+    void FillConvexPolygon(
+        const double* xs, const double* ys, size_t n, const raster_color& c);
+
+    /// Draw a coverage mask tinted with a color
+    ///
+    /// \param mask The mask
+    /// \param x Horizontal position of the top left corner of the mask
+    /// \param y Vertical position of the top left corner of the mask
+    /// \param c Color
+    void DrawMask(const raster_mask& mask, int x, int y, const raster_color& c);
+};
+
+/// Device context recording the drawing operations into a display list which
+/// is later replayed into a RasterImage.
+///
+/// Exposes the subset of the wxDC interface used by the instruments so the
+/// drawing code can be shared between the wxDC and the raster path. All the
+/// methods except #Rasterize have to be called from the GUI thread, text is
+/// turned into coverage masks already while recording as the font rendering
+/// is not thread safe in wxWidgets. The masks and the text metrics come from
+/// the FontCache, so only the strings not drawn before are rendered.
+/// #Rasterize only touches the recorded data and may run on any thread.
+class dskRasterDC {
+private:
+    /// Recorded primitive type
+    enum class op_type {
+        clear,
+        fill_rect,
+        fill_circle,
+        stroke_circle,
+        fill_sector,
+        stroke_line,
+        fill_polygon,
+        mask
+    };
+
+    /// Recorded drawing operation
+    struct op {
+        /// Type of the operation
+        op_type type;
+        /// Color
+        raster_color color;
+        /// Geometry of the primitive, meaning depends on the type
+        double p[6];
+        /// Index of the first polygon vertex or of the text mask
+        size_t index;
+        /// Number of polygon vertices
+        size_t count;
+    };
+
+    /// Width of the canvas
+    int m_width;
+    /// Height of the canvas
+    int m_height;
+    /// Display list
+    vector<op> m_ops;
+    /// Horizontal coordinates of the recorded polygon vertices
+    vector<double> m_poly_x;
+    /// Vertical coordinates of the recorded polygon vertices
+    vector<double> m_poly_y;
+    /// Text rendered to coverage masks, shared with the cache
+    vector<std::shared_ptr<const text_mask>> m_masks;
+    /// Cache of the text masks and metrics
+    FontCache& m_fonts;
+    /// Current pen
+    wxPen m_pen;
+    /// Current brush
+    wxBrush m_brush;
+    /// Current background brush
+    wxBrush m_background;
+    /// Current font
+    wxFont m_font;
+    /// Current text color
+    wxColour m_text_color;
+    /// Result of the last #Rasterize call
+    RasterImage m_image;
+
+    /// Convert wxColour to raster color
+    static raster_color ToRaster(const wxColour& c);
+
+    /// Whether the current pen draws anything
+    bool HasPen() const;
+
+    /// Whether the current brush fills anything
+    bool HasBrush() const;
+
+    /// Width of the current pen, at least one pixel
+    double PenWidth() const;
+
+    /// Record text using its cached coverage mask
+    ///
+    /// \param text Text to draw
+    /// \param x Horizontal position of the text origin
+    /// \param y Vertical position of the text origin
+    /// \param angle Rotation in degrees, counterclockwise
+    void RecordText(const wxString& text, wxCoord x, wxCoord y, double angle);
+
+public:
+    /// Constructor
+    ///
+    /// \param width Width of the canvas
+    /// \param height Height of the canvas
+    /// \param fonts Cache providing the text masks and metrics
+    dskRasterDC(int width, int height, FontCache& fonts);
+
+    /// Get the size of the canvas
+    ///
+    /// \return Size in pixels
+    wxSize GetSize() const { return wxSize(m_width, m_height); }
+
+    /// \see wxDC::SetPen
+    void SetPen(const wxPen& pen) { m_pen = pen; }
+
+    /// \see wxDC::SetBrush
+    void SetBrush(const wxBrush& brush) { m_brush = brush; }
+
+    /// \see wxDC::SetBackground
+    void SetBackground(const wxBrush& brush) { m_background = brush; }
+
+    /// \see wxDC::SetFont
+    void SetFont(const wxFont& font) { m_font = font; }
+
+    /// \see wxDC::SetTextForeground
+    void SetTextForeground(const wxColour& c) { m_text_color = c; }
+
+    /// Fill the canvas with the background brush
+    void Clear();
+
+    /// \see wxDC::DrawRectangle
+    void DrawRectangle(wxCoord x, wxCoord y, wxCoord w, wxCoord h);
+
+    /// \see wxDC::DrawCircle
+    void DrawCircle(wxCoord x, wxCoord y, wxCoord r);
+
+    /// Draw a pie sector with the same semantics as wxDC::DrawArc
+    void DrawArc(wxCoord xStart, wxCoord yStart, wxCoord xEnd, wxCoord yEnd,
+        wxCoord xc, wxCoord yc);
+
+    /// \see wxDC::DrawLine
+    void DrawLine(wxCoord x1, wxCoord y1, wxCoord x2, wxCoord y2);
+
+    /// Draw a polygon, only convex polygons are filled correctly
+    void DrawPolygon(int n, const wxPoint points[], wxCoord xoffset = 0,
+        wxCoord yoffset = 0);
+
+    /// \see wxDC::DrawText
+    void DrawText(const wxString& text, wxCoord x, wxCoord y);
+
+    /// \see wxDC::DrawRotatedText
+    void DrawRotatedText(
+        const wxString& text, wxCoord x, wxCoord y, double angle);
+
+    /// Draw text aligned in a rectangle, supports the subset of the alignment
+    /// flags of wxDC::DrawLabel used by the instruments
+    void DrawLabel(const wxString& text, const wxRect& rect,
+        int alignment = wxALIGN_LEFT | wxALIGN_TOP);
+
+    /// \see wxDC::GetTextExtent
+    wxSize GetTextExtent(const wxString& text) const;
+
+    /// \see wxDC::GetTextExtent
+    void GetTextExtent(const wxString& text, wxCoord* w, wxCoord* h,
+        wxCoord* descent = nullptr, wxCoord* external_leading = nullptr,
+        const wxFont* font = nullptr) const;
+
+    /// Replay the display list into the pixel buffer. Thread safe with respect
+    /// to other instances and the GUI.
+    void Rasterize();
+
+    /// Get the rasterized image
+    ///
+    /// \return The image produced by the last #Rasterize call
+    const RasterImage& GetImage() const { return m_image; }
+
+    /// Convert the rasterized image to a bitmap, GUI thread only
+    ///
+    /// \return Bitmap with alpha channel
+    wxBitmap ToBitmap() const;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_DSKRASTER_H_
@@ -0,0 +1,285 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _EXPRESSION_H_
+#define _EXPRESSION_H_
+
+#include "pi_common.h"
+#include "sourceregistry.h"
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Prefix of the keys holding an expression instead of a SignalK path, eg.
+/// =environment.wind.speedTrue * 1.943844
+#define EXPRESSION_PREFIX '='
+
+/// Arithmetic expression over the values of SignalK paths compiled to a
+/// bytecode for a small stack machine.
+///
+/// The expressions support numbers, SignalK paths (with an optional source
+/// designation and filters), the + - * / operators, unary minus, parentheses
+/// and the functions abs, sqrt, sin, cos, tan, atan2, min and max. The paths
+/// are collected into a table on compilation and referenced by their index.
+///
+/// A source designation or filter runs up to the next whitespace or operator
+/// other than the minus, which is common in the names of the sources, so a
+/// subtraction from a designated path needs a space before the minus, eg.
+/// navigation.speedThroughWater.SRC:priority(GPS-GP-RMC, log) - 0.2 or
+/// navigation.headingTrue|ema(5) * 57.29578. Evaluation is not reentrant.
+class Expression {
+public:
+    /// Function reading the value of the path with the given index, returns
+    /// false if the value is not available
+    typedef std::function<bool(size_t, double&)> reader_t;
+
+private:
+    /// Instructions of the stack machine
+    enum class opcode : uint8_t {
+        /// Push #instruction::value
+        push,
+        /// Push the value of the path #instruction::index
+        load,
+        add,
+        sub,
+        mul,
+        div,
+        neg,
+        abs,
+        sqrt,
+        sin,
+        cos,
+        tan,
+        atan2,
+        min,
+        max
+    };
+
+    /// An instruction
+    struct instruction {
+        /// The operation
+        opcode op;
+        /// Index of the path of #opcode::load
+        uint32_t index;
+        /// Constant of #opcode::push
+        double value;
+    };
+
+    /// The compiled program
+    vector<instruction> m_program;
+    /// The paths referenced by the program
+    vector<wxString> m_paths;
+    /// Maximum depth of the stack needed by the program
+    size_t m_max_depth;
+    /// Stack of the evaluation, allocated on compilation
+    mutable vector<double> m_stack;
+
+    /// State of a compilation
+    struct parser {
+        /// The expression
+        wxString text;
+        /// Position of the next character
+        size_t pos;
+        /// Current depth of the stack
+        size_t depth;
+        /// Description of the error if any
+        wxString error;
+    };
+
+    /// Append an instruction to the program
+    ///
+    /// \param p The compilation
+    /// \param ins The instruction
+    /// \param pops Number of the values the instruction takes from the stack
+    void Emit(parser& p, const instruction& ins, size_t pops);
+
+    /// Parse a sum or difference of products
+    ///
+    /// \param p The compilation
+    /// \return false on error
+    bool ParseSum(parser& p);
+
+    /// Parse a product or quotient of factors
+    ///
+    /// \param p The compilation
+    /// \return false on error
+    bool ParseProduct(parser& p);
+
+    /// Parse a number, path, function call or parenthesized expression with
+    /// an optional unary minus
+    ///
+    /// \param p The compilation
+    /// \return false on error
+    bool ParseFactor(parser& p);
+
+    /// Find the function of a name
+    ///
+    /// \param name Name of the function
+    /// \param op Receives the instruction of the function
+    /// \param args Receives the number of the arguments of the function
+    /// \return false if there is no such function
+    static bool FindFunction(const wxString& name, opcode& op, int& args);
+
+public:
+    /// Constructor
+    Expression()
+        : m_max_depth(0) { };
+
+    /// Check whether a key holds an expression
+    ///
+    /// \param key The key
+    /// \return true if the key starts with #EXPRESSION_PREFIX
+    static bool IsExpression(const wxString& key)
+    {
+        return !key.IsEmpty() && key[0] == EXPRESSION_PREFIX;
+    };
+
+    /// Compile an expression, replacing the previous program
+    ///
+    /// \param text The expression, with or without #EXPRESSION_PREFIX
+    /// \param error Receives the description of the error if any
+    /// \return false if the expression is invalid
+    bool Compile(const wxString& text, wxString* error = nullptr);
+
+    /// Get the paths referenced by the expression
+    ///
+    /// \return The paths as written in the expression
+    const vector<wxString>& GetPaths() const { return m_paths; };
+
+    /// Evaluate the compiled expression, without any allocations
+    ///
+    /// \param read Function reading the values of the paths
+    /// \param result Receives the result
+    /// \return false if a value is not available or the result is not finite
+    bool Evaluate(const reader_t& read, double& result) const;
+};
+
+/// Keeps the compiled expressions used by the instruments and evaluates them
+/// only after one of their paths was updated. GUI thread only.
+class ExpressionService {
+public:
+    /// Function reading a SignalK path from the data tree
+    typedef std::function<const Json::Value*(const wxString&)> reader_t;
+    /// Key of the paths
+    typedef SourceRegistry::path_key_t path_key_t;
+    /// Function called for every subscriber of an input which was qualified
+    /// by another context, with the previous and the new path
+    typedef std::function<void(
+        const void* owner, const wxString& from, const wxString& to)>
+        relocator_t;
+
+private:
+    /// An expression in use
+    struct compiled {
+        /// The program
+        Expression expression;
+        /// Fully qualified paths of the expression, by their index
+        vector<wxString> inputs;
+        /// Node holding the result
+        Json::Value output;
+        /// An input was updated since the last evaluation
+        bool dirty = true;
+        /// The subscribers
+        vector<const void*> owners;
+    };
+
+    /// Function reading the inputs
+    reader_t m_reader;
+    /// Context of the own vessel the relative paths belong to
+    wxString m_context;
+    /// The expressions by their keys
+    std::unordered_map<path_key_t, compiled> m_expressions;
+    /// Expressions using each path, by the path without source designation
+    std::unordered_map<path_key_t, vector<compiled*>> m_by_input;
+
+    /// Qualify the paths of an expression by the context of the own vessel
+    /// and index the expression by them
+    ///
+    /// \param c The expression
+    void Qualify(compiled& c);
+
+public:
+    /// Constructor
+    ///
+    /// \param reader Function reading the input paths from the data tree
+    explicit ExpressionService(reader_t reader)
+        : m_reader(std::move(reader)) { };
+
+    /// Set the context of the own vessel, the paths not starting with
+    /// "vessels." are relative to it. The inputs of the subscribed expressions
+    /// are qualified again.
+    ///
+    /// \param context The context, eg. vessels.urn:mrn:imo:mmsi:265599691
+    /// \param relocate Function called for every subscriber of an input which
+    /// changed, so that it can subscribe to the new path, if not nullptr
+    void SetContext(
+        const wxString& context, const relocator_t& relocate = nullptr);
+
+    /// Subscribe to an expression, compiling it if needed
+    ///
+    /// \param key The expression key
+    /// \param owner Identity of the subscriber
+    /// \return false if the expression is invalid
+    bool Subscribe(const wxString& key, const void* owner);
+
+    /// Unsubscribe from all the expressions, the expressions without
+    /// subscribers are removed
+    ///
+    /// \param owner Identity of the subscriber
+    void Unsubscribe(const void* owner);
+
+    /// Get the fully qualified paths an expression is computed from
+    ///
+    /// \param key The expression key
+    /// \return The paths, empty if the expression is not subscribed
+    vector<wxString> GetInputs(const wxString& key) const;
+
+    /// Note the update of a path
+    ///
+    /// \param base Key of the updated path without the source designation
+    void Update(const path_key_t& base);
+
+    /// Get the value of an expression, evaluating it if its inputs changed
+    ///
+    /// \param key The expression key
+    /// \return Node with the value, nullptr if the expression is not
+    /// subscribed or can't be evaluated
+    const Json::Value* Get(const wxString& key);
+
+    /// Get the number of the compiled expressions
+    ///
+    /// \return Number of the expressions
+    size_t GetExpressionCount() const { return m_expressions.size(); };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_EXPRESSION_H_
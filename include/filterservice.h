@@ -0,0 +1,232 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _FILTERSERVICE_H_
+#define _FILTERSERVICE_H_
+
+#include "clock.h"
+#include "pi_common.h"
+#include "sourceregistry.h"
+
+#include <json/json.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Separator of the filters appended to a SignalK path, eg.
+/// navigation.speedOverGround|ema(5)|ratelimit(0.5)
+#define FILTER_SEPARATOR '|'
+
+/// Computes the filtered values of the SignalK paths once per delta, shared by
+/// all the instruments showing them.
+///
+/// A filtered key is a SignalK path, optionally with a source designation,
+/// followed by a pipeline of filters applied in order:
+///  - ema(n) exponential moving average over about n samples
+///  - median(n) moving median of the last n samples
+///  - circmean(n) mean of the last n angles in radians, correct across the
+///    wrap around, from -PI to PI if any of them is negative and from 0 to
+///    2PI otherwise
+///  - ratelimit(r) limits the change of the value to r units per second
+///  - mean(t), min(t), max(t) aggregate the samples of the last t seconds,
+///    to decimate fast paths for the subscriptions with a limited rate
+///
+/// The pipelines exist as long as anybody is subscribed to them and their
+/// output is a node with the value, so it is read like the path itself. The
+/// filters start over when the input has not been updated for #RESET_GAP.
+/// GUI thread only.
+class FilterService {
+public:
+    /// Function reading a SignalK path from the data tree
+    typedef std::function<const Json::Value*(const wxString&)> reader_t;
+    /// Key of the paths
+    typedef SourceRegistry::path_key_t path_key_t;
+
+    /// Time without input after which the filters start over
+    static constexpr std::chrono::seconds RESET_GAP { 3 };
+    /// Maximum number of samples in a filter window
+    static constexpr size_t MAX_WINDOW = 1000;
+
+private:
+    /// Sample of the aggregating filters
+    struct timed_sample {
+        /// Time the sample was received
+        Clock::time_point time;
+        /// The value
+        double value;
+        /// Sequence number of the sample since the filter started over
+        size_t seq;
+    };
+
+    /// A filter of a pipeline
+    struct stage {
+        /// Kind of the filter
+        enum class type {
+            ema,
+            median,
+            circmean,
+            ratelimit,
+            mean,
+            min,
+            max
+        } kind;
+        /// Parameter of the filter
+        double param;
+        /// Window of the last samples for the windowed filters
+        vector<double> window;
+        /// Timed samples of the aggregating filters, all the samples of the
+        /// time window for mean, only the candidates for the extreme in a
+        /// monotonic order for min and max
+        std::deque<timed_sample> samples;
+        /// Scratch copy of the window to find the median in
+        vector<double> sorted;
+        /// Position of the next sample in #window
+        size_t pos = 0;
+        /// Number of the samples in #window
+        size_t count = 0;
+        /// Number of the samples received by the aggregating filters since
+        /// they started over
+        size_t seq = 0;
+        /// Sum of the values in #samples for mean
+        double sum = 0.0;
+        /// Sum of the sines of the angles in #window
+        double sin_sum = 0.0;
+        /// Sum of the cosines of the angles in #window
+        double cos_sum = 0.0;
+        /// Number of the negative angles in #window
+        size_t negatives = 0;
+        /// Last output
+        double state = 0.0;
+        /// The filter has produced an output since it started over
+        bool primed = false;
+    };
+
+    /// Filters of a path
+    struct pipeline {
+        /// Path the input is read from
+        wxString input;
+        /// Key of the input path without the source designation
+        path_key_t base;
+        /// The filters
+        vector<stage> stages;
+        /// Node holding the filtered value
+        Json::Value output;
+        /// Time of the last input
+        Clock::time_point last_input;
+        /// The subscribers
+        vector<const void*> owners;
+    };
+
+    /// Function reading the input paths
+    reader_t m_reader;
+    /// The pipelines by their full keys
+    std::unordered_map<path_key_t, pipeline> m_pipelines;
+    /// Pipelines of every base path, for the lookup on update
+    std::unordered_map<path_key_t, vector<pipeline*>> m_by_base;
+
+    /// Parse a filter
+    ///
+    /// \param spec The filter, eg. ema(5)
+    /// \param s Receives the filter
+    /// \return true if the filter is valid
+    static bool ParseStage(const wxString& spec, stage& s);
+
+    /// Feed a sample to a filter
+    ///
+    /// \param s The filter
+    /// \param value The sample
+    /// \param dt Time since the previous sample
+    /// \param now Time of the sample
+    /// \return The output of the filter
+    static double Apply(stage& s, double value, Clock::base_clock::duration dt,
+        Clock::time_point now);
+
+public:
+    /// Constructor
+    ///
+    /// \param reader Function reading the input paths from the data tree
+    explicit FilterService(reader_t reader)
+        : m_reader(std::move(reader)) { };
+
+    /// Check whether a key has any filters
+    ///
+    /// \param key The key
+    /// \return true if the key has a filter pipeline
+    static bool IsFiltered(const wxString& key)
+    {
+        return key.Find(FILTER_SEPARATOR) != wxNOT_FOUND;
+    };
+
+    /// Get the SignalK path of a key without the filters and the source
+    /// designation
+    ///
+    /// \param key The key
+    /// \return The path the key receives its updates from
+    static wxString BasePath(const wxString& key);
+
+    /// Subscribe to a filtered key, creating its pipeline if needed
+    ///
+    /// \param key The filtered key
+    /// \param owner Identity of the subscriber
+    /// \return false if the key is not a valid filtered key
+    bool Subscribe(const wxString& key, const void* owner);
+
+    /// Unsubscribe from all the keys, the pipelines without subscribers are
+    /// removed
+    ///
+    /// \param owner Identity of the subscriber
+    void Unsubscribe(const void* owner);
+
+    /// Feed the pipelines of a path with its new value. Only the pipelines
+    /// whose input resolves to the updated node are fed, the updates of the
+    /// other sources of the path would repeat their last sample.
+    ///
+    /// \param base Key of the updated path without the source designation
+    /// \param node The updated node of the path
+    /// \param now Time of the update
+    void Update(
+        const path_key_t& base, const Json::Value* node, Clock::time_point now);
+
+    /// Get the output of a pipeline
+    ///
+    /// \param key The filtered key
+    /// \return Node with the filtered value, nullptr if there is no such
+    /// pipeline or it has no output yet
+    const Json::Value* Get(const wxString& key) const;
+
+    /// Get the number of the pipelines
+    ///
+    /// \return Number of the pipelines
+    size_t GetPipelineCount() const { return m_pipelines.size(); };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_FILTERSERVICE_H_
@@ -0,0 +1,149 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _FONTCACHE_H_
+#define _FONTCACHE_H_
+
+#include "dskraster.h"
+#include "pi_common.h"
+
+#include <wx/dcmemory.h>
+#include <wx/font.h>
+
+#include <map>
+#include <memory>
+#include <tuple>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Dimensions of a piece of text as reported by wxDC::GetTextExtent
+struct text_extent {
+    /// Width of the text
+    wxCoord width;
+    /// Height of the text
+    wxCoord height;
+    /// Descent of the font
+    wxCoord descent;
+};
+
+/// Cache of the fonts, text metrics and rendered text shared by all the
+/// instruments.
+///
+/// Creating wxFont objects, measuring and rendering text are comparatively
+/// expensive and the instruments do all of them with the same few fonts and
+/// strings on every redraw. The cache has to be cleared whenever the display
+/// scale or the theme changes. GUI thread only, the text masks it hands out
+/// may be read from any thread.
+class FontCache {
+private:
+    /// Font identification - point size, family, style and weight
+    typedef std::tuple<int, int, int, int> font_key;
+
+    /// Maximum number of cached text extents, the whole extent cache is
+    /// dropped once it is reached so that continuously changing values do not
+    /// grow it indefinitely
+    static constexpr size_t MAX_EXTENTS = 4096;
+    /// Maximum number of cached text masks, dropped all at once like the
+    /// extents
+    static constexpr size_t MAX_MASKS = 1024;
+
+    /// Cached fonts
+    std::map<font_key, wxFont> m_fonts;
+    /// Cached text extents
+    std::map<std::pair<font_key, wxString>, text_extent> m_extents;
+    /// Cached text masks by the font, rotation and text
+    std::map<std::tuple<font_key, double, wxString>,
+        std::shared_ptr<const text_mask>>
+        m_masks;
+    /// DC used to measure the text, created on first use
+    std::unique_ptr<wxMemoryDC> m_dc;
+
+    /// Build the key identifying a font
+    static font_key Key(const wxFont& font);
+
+public:
+    /// Get a font, creating it if it is not cached yet
+    ///
+    /// \param point_size Size of the font in points
+    /// \param family Font family
+    /// \param weight Font weight
+    /// \param style Font style
+    /// \return The font
+    const wxFont& GetFont(int point_size, wxFontFamily family,
+        wxFontWeight weight, wxFontStyle style = wxFONTSTYLE_NORMAL);
+
+    /// Get a font with the same family, style and weight as \c font, but
+    /// different size
+    ///
+    /// \param font Template font
+    /// \param point_size Size of the font in points
+    /// \return The font
+    const wxFont& GetFont(const wxFont& font, int point_size);
+
+    /// Measure text
+    ///
+    /// \param font Font used to draw the text
+    /// \param text The text
+    /// \return Dimensions of the text
+    text_extent GetTextExtent(const wxFont& font, const wxString& text);
+
+    /// Get the coverage mask of a piece of text, rendering it if it is not
+    /// cached yet. The mask does not depend on the color of the text.
+    ///
+    /// \param font Font used to draw the text
+    /// \param text The text
+    /// \param angle Rotation in degrees, counterclockwise
+    /// \return The mask, nullptr if the text has no extent
+    std::shared_ptr<const text_mask> GetTextMask(
+        const wxFont& font, const wxString& text, double angle);
+
+    /// Drop all the cached fonts and metrics
+    void Clear();
+
+    /// Get the number of cached fonts
+    ///
+    /// \return Number of fonts
+    size_t GetFontCount() const { return m_fonts.size(); }
+
+    /// Get the number of cached text extents
+    ///
+    /// \return Number of text extents
+    size_t GetExtentCount() const { return m_extents.size(); }
+
+    /// Get the number of cached text masks
+    ///
+    /// \return Number of text masks
+    size_t GetMaskCount() const { return m_masks.size(); }
+
+    /// Cache used by the instruments not attached to a dashboard
+    ///
+    /// \return The cache
+    static FontCache& Fallback();
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_FONTCACHE_H_
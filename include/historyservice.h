@@ -0,0 +1,229 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _HISTORYSERVICE_H_
+#define _HISTORYSERVICE_H_
+
+#include "clock.h"
+#include "pi_common.h"
+#include "sourceregistry.h"
+
+#include <json/json.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+/// Number of the values in the 1 second granularity buffer of the history
+#define HISTORY_1S 60
+/// Number of the values in the 10 second granularity buffer of the history
+#define HISTORY_10S 360
+/// Number of the values in the 5 minute granularity buffer of the history
+#define HISTORY_5M 864
+
+PLUGIN_BEGIN_NAMESPACE
+
+struct HistoryValue {
+    Clock::time_point ts;
+    size_t values;
+    double sum;
+
+    explicit HistoryValue(Clock::time_point now)
+        : ts(now)
+        , values(0)
+        , sum(0.0) { };
+    HistoryValue(const double& val, Clock::time_point now)
+        : ts(now)
+        , values(1)
+        , sum(val) { };
+    void Add(const double& val)
+    {
+        ++values;
+        sum += val;
+    };
+    void Add(const double& total, size_t count)
+    {
+        values += count;
+        sum += total;
+    };
+    double GetMean() const { return values > 0 ? sum / values : 0.0; };
+    bool OlderThan(
+        std::chrono::duration<int64_t> duration, Clock::time_point now) const
+    {
+        return ts + duration < now;
+    };
+    bool NewerThan(
+        std::chrono::duration<int64_t> duration, Clock::time_point now) const
+    {
+        return ts + duration > now;
+    };
+    bool OlderThan(const HistoryValue& other) const
+    {
+        return ts > other.ts;
+    };
+    bool NewerThan(const HistoryValue& other) const
+    {
+        return ts < other.ts;
+    };
+
+    bool operator!=(const HistoryValue& x) const { return x.ts != ts; }
+};
+
+class History {
+    friend class SimpleHistogramInstrument;
+
+protected:
+    /// @brief Buffer for the last minute with 1s granularity (60 values)
+    std::deque<HistoryValue> m_last_minute;
+    /// @brief Buffer for the last 1 hour with 10 second granularity (360
+    /// values)
+    std::deque<HistoryValue> m_last_hour;
+    /// @brief Buffer for the last 3 days with 5 minute granularity (864 values)
+    std::deque<HistoryValue> m_last_3days;
+
+public:
+    /// @brief Add a value to the history
+    /// @param value The value
+    /// @param now Time the value was received
+    void Add(const double& value, Clock::time_point now);
+
+    /// @brief Add several values at once to the history
+    /// @param sum Sum of the values
+    /// @param count Number of the values
+    /// @param now Time the values were received
+    void Add(const double& sum, size_t count, Clock::time_point now);
+
+    /// @brief Get the most recent value of the 1 second granularity buffer
+    /// @return The value, nullptr if the history is empty
+    const HistoryValue* GetLatest() const
+    {
+        return m_last_minute.empty() ? nullptr : &m_last_minute.back();
+    };
+
+    /// @brief Get the number of the stored values over all the buffers
+    /// @return Number of the values
+    size_t GetSampleCount() const
+    {
+        return m_last_minute.size() + m_last_hour.size() + m_last_3days.size();
+    };
+
+    /// @brief Get the estimated memory used by the stored values
+    /// @return Size in bytes
+    size_t GetMemoryUsage() const
+    {
+        return GetSampleCount() * sizeof(HistoryValue);
+    };
+};
+
+/// Keeps one history per SignalK key shared by all the instruments showing
+/// it, so that a newly added instrument has the data received so far.
+///
+/// The histories are fed with the raw values once per delta and live as long
+/// as anybody holds them. The key may contain a source designation and
+/// filters, its value is read the same way the instruments read it.
+/// GUI thread only.
+class HistoryService {
+public:
+    /// Function reading a SignalK path from the data tree
+    typedef std::function<const Json::Value*(const wxString&)> reader_t;
+    /// Key of the paths
+    typedef SourceRegistry::path_key_t path_key_t;
+
+private:
+    /// History of a key
+    struct entry {
+        /// Key the values are read from
+        wxString key;
+        /// Key of the path without the source designation and the filters
+        path_key_t base;
+        /// The key is the plain path, without the source designation and the
+        /// filters
+        bool plain;
+        /// The history, expires with its last holder
+        std::weak_ptr<History> history;
+    };
+
+    /// Function reading the values of the keys
+    reader_t m_reader;
+    /// The histories by their keys
+    std::unordered_map<path_key_t, entry> m_histories;
+    /// Histories of every base path, for the lookup on update
+    std::unordered_map<path_key_t, vector<entry*>> m_by_base;
+
+    /// Remove the history of a key from the lookups
+    ///
+    /// \param key The key
+    void Remove(const path_key_t& key);
+
+public:
+    /// Constructor
+    ///
+    /// \param reader Function reading the values of the keys from the data
+    /// tree
+    explicit HistoryService(reader_t reader)
+        : m_reader(std::move(reader)) { };
+
+    /// Get the history of a key, creating it if nobody holds it yet
+    ///
+    /// \param key SignalK key
+    /// \return The history, kept as long as anybody holds it
+    std::shared_ptr<const History> Acquire(const wxString& key);
+
+    /// Add the new value of a path to its histories
+    ///
+    /// \param base Key of the updated path without the source designation
+    /// \param now Time of the update
+    void Update(const path_key_t& base, Clock::time_point now);
+
+    /// Add the values of a path which were superseded before being applied
+    /// to the data tree, when the deltas are coalesced. Only the histories of
+    /// the plain path get them, the values read through a source designation
+    /// or a filter are not known.
+    ///
+    /// \param base Key of the path without the source designation
+    /// \param sum Sum of the superseded values
+    /// \param count Number of the superseded values
+    /// \param now Time of the update
+    void AddSuperseded(const path_key_t& base, double sum, size_t count,
+        Clock::time_point now);
+
+    /// Get the histories held by anybody
+    ///
+    /// \return The keys and their histories
+    vector<std::pair<wxString, std::shared_ptr<const History>>>
+    GetHistories() const;
+
+    /// Get the number of the histories held by anybody
+    ///
+    /// \return Number of the histories
+    size_t GetHistoryCount() const;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_HISTORYSERVICE_H_
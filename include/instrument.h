@@ -27,14 +27,24 @@
 #ifndef _INSTRUMENT_H_
 #define _INSTRUMENT_H_
 
+#include "clock.h"
+#include "dskraster.h"
+#include "expression.h"
+#include "filterservice.h"
+#include "fontcache.h"
+#include "instrumentstats.h"
 #include "pi_common.h"
+#include "sourcearbiter.h"
+#include "valueformatter.h"
 #include "zone.h"
 
 #include <wx/bitmap.h>
 #include <wx/dcgraph.h>
 
 #include <chrono>
+#include <functional>
 #include <json/json.h>
+#include <memory>
 #include <unordered_map>
 
 PLUGIN_BEGIN_NAMESPACE
@@ -168,8 +178,12 @@ PLUGIN_BEGIN_NAMESPACE
 /// Key-value pair unordered map for instrument configuration parameters
 #if wxCHECK_VERSION(3, 1, 0)
 typedef unordered_map<wxString, wxString> config_map_t;
+/// Map of configuration parameter keys to typed setting indexes
+typedef unordered_map<wxString, size_t> config_index_t;
 #else
 typedef unordered_map<string, wxString> config_map_t;
+/// Map of configuration parameter keys to typed setting indexes
+typedef unordered_map<string, size_t> config_index_t;
 #endif
 
 /// Instrument configuration controls type enum
@@ -184,6 +198,23 @@ enum class dskConfigCtrl {
     SignalKZonesCtrl
 };
 
+/// Instrument configuration parameter converted to the types used for
+/// rendering when it is set, so that the strings do not have to be parsed on
+/// every redraw
+struct typed_setting {
+    /// Value as string
+    wxString str;
+    /// Value as integer, 0 if it is not a number
+    int int_val = 0;
+    /// Value as double, 0 if it is not a number
+    double double_val = 0.0;
+    /// Value as color, cyan until the parameter is set. Only parsed for the
+    /// parameters configured with a color picker
+    wxColor color_val = *wxCYAN;
+    /// The parameter is a color
+    bool is_color = false;
+};
+
 /// Structure describing a single configuration control for the instrument
 struct config_control {
     /// String key identifying the control. Must not be localizable.
@@ -209,6 +240,7 @@ enum class alarmType {
 };
 
 class Dashboard;
+class History;
 
 /// Abstract parent class for all the instruments
 class Instrument {
@@ -315,6 +347,11 @@ protected:
     vector<config_control> m_config_controls;
     /// Configuration value map
     config_map_t m_config_vals;
+    /// Typed copies of the configuration values registered by the instrument
+    /// classes, indexed by the enums generated from their DSK_*_SETTINGS macros
+    vector<typed_setting> m_typed_vals;
+    /// Index of the registered configuration keys in #m_typed_vals
+    config_index_t m_typed_index;
     /// Color scheme
     int m_color_scheme;
     /// Timestamp of last update of the value displayed by the instrument
@@ -323,6 +360,9 @@ protected:
     /// Maximum allowed age of the displayed value before it is considered
     /// unusable
     int m_allowed_age_sec;
+    /// Maximum rate of the notifications about updates of the subscribed
+    /// paths in Hz, zero for unlimited
+    double m_max_rate;
     /// Pointer to the dashboard owning the instrument instance
     Dashboard* m_parent_dashboard;
     /// Horizontal position of the top left corner of the rendered instrument on
@@ -339,6 +379,9 @@ protected:
     bool m_new_data;
     /// Value zones  definitions
     vector<Zone> m_zones;
+    /// Index of #m_zones, has to be rebuilt with #ZonesChanged whenever they
+    /// are modified
+    ZoneIndex m_zone_index;
     /// Alarm state matrix
     unordered_map<Zone::state, vector<alarmType>> m_alarm_methods;
     /// Needs redraw on next overlay refresh
@@ -359,6 +402,71 @@ protected:
     /// Independent dynamic source locks indexed by configured path.
     std::map<wxString, source_lock> m_source_locks;
 
+    /// Follow a change of the source chosen for a locked path
+    ///
+    /// \param e The change
+    void SourceChanged(const source_event& e);
+    /// Frame recorded by #PrepareRaster waiting to be rasterized
+    std::unique_ptr<dskRasterDC> m_raster;
+    /// The cached bitmap was produced by #CommitRaster in this frame
+    bool m_raster_committed;
+    /// Rendering and update statistics
+    InstrumentStats m_stats;
+
+    /// Register a configuration parameter to be kept in #m_typed_vals
+    ///
+    /// \param index Index of the parameter generated from the DSK_*_SETTINGS
+    /// macro of the instrument class
+    /// \param key Identification key of the parameter
+    /// \param control Type of the control configuring the parameter, the
+    /// value is parsed as color only for #dskConfigCtrl::ColourPickerCtrl
+    void RegisterTypedSetting(
+        size_t index, const wxString& key, dskConfigCtrl control);
+
+    /// Update the typed copy of a configuration parameter if it is registered
+    ///
+    /// \param key Identification key of the parameter
+    /// \param value Value of the parameter as string
+    void UpdateTypedSetting(const wxString& key, const wxString& value);
+
+    /// Get a registered configuration parameter as color
+    ///
+    /// \param index Index of the parameter
+    /// \return Color parsed when the parameter was set
+    const wxColor& ColorSettingAt(size_t index) const
+    {
+        return m_typed_vals[index].color_val;
+    };
+
+    /// Get a registered configuration parameter as integer
+    ///
+    /// \param index Index of the parameter
+    /// \return Integer parsed when the parameter was set
+    int IntSettingAt(size_t index) const
+    {
+        return m_typed_vals[index].int_val;
+    };
+
+    /// Get a registered configuration parameter as double
+    ///
+    /// \param index Index of the parameter
+    /// \return Double parsed when the parameter was set
+    double DoubleSettingAt(size_t index) const
+    {
+        return m_typed_vals[index].double_val;
+    };
+
+    /// Get the font and text metrics cache shared by the instruments
+    ///
+    /// \return The cache of the dashboard, or a process wide one if the
+    /// instrument does not belong to any
+    FontCache& GetFontCache();
+
+    /// Convert the rasterized frame to a bitmap and drop the recording
+    ///
+    /// \return Bitmap produced from the raster frame
+    wxBitmap TakeRaster();
+
     /// Get version of a color adjusted to the current color scheme set for the
     /// instrument
     ///
@@ -380,12 +488,61 @@ protected:
         const wxColor& alert_color, const wxColor& warn_color,
         const wxColor& alarm_color, const wxColor& emergency_color);
 
+    /// Returns color corresponding to a zone state, to be used when several
+    /// colors are derived from the same value
+    ///
+    /// \param st The zone state of the value, see #GetZoneState
+    /// \param nominal_color Color corresponding to nominal value (Not in any
+    /// zone)
+    /// \param normal_color Color corresponding to normal value
+    /// \param alert_color Color corresponding to an alert
+    /// \param warn_color Color corresponding to a warning
+    /// \param alarm_color Color corresponding to an alarm
+    /// \param emergency_color Color corresponding to an emergency
+    /// \return Color
+    static const wxColor& AdjustColorForZone(const Zone::state st,
+        const wxColor& nominal_color, const wxColor& normal_color,
+        const wxColor& alert_color, const wxColor& warn_color,
+        const wxColor& alarm_color, const wxColor& emergency_color);
+
+    /// Get the zone state of a value. In case of overlapping zones the one
+    /// with highest severity takes precedence
+    ///
+    /// \param val The value
+    /// \return The zone state
+    Zone::state GetZoneState(const double& val) const
+    {
+        return m_zone_index.GetState(val);
+    };
+
+    /// Get the current time from the clock of the dashboards
+    ///
+    /// \return The current time
+    Clock::time_point Now() const;
+
+    /// Rebuild the zone index after #m_zones have been modified and let the
+    /// alarm engine know about the change
+    void ZonesChanged();
+
+    /// Let the alarm engine know that the units of the configured zones
+    /// changed with the transformation of the primary value
+    void TransformationChanged();
+
+    /// Let the subscriptions of the instrument know that #m_max_rate has been
+    /// modified
+    void MaxRateChanged();
+
+    /// Let the arbitrations of the sources the instrument takes part in know
+    /// that #m_allowed_age_sec has been modified
+    void TimeoutChanged();
+
     Instrument()
         : m_name(wxEmptyString)
         , m_title(wxEmptyString)
         , m_color_scheme(0)
-        , m_last_change(std::chrono::system_clock::now())
+        , m_last_change(Clock::System().Now())
         , m_allowed_age_sec(3)
+        , m_max_rate(0.0)
         , m_parent_dashboard(nullptr)
         , m_x(0)
         , m_y(0)
@@ -395,7 +552,8 @@ protected:
         , m_needs_redraw(true)
         , m_locked_source(wxEmptyString)
         , m_locked_source_path(wxEmptyString)
-        , m_locked_source_time(std::chrono::system_clock::now())
+        , m_locked_source_time(Clock::System().Now())
+        , m_raster_committed(false)
     {
     }
 
@@ -422,6 +580,8 @@ public:
         : Instrument()
     {
         m_parent_dashboard = parent;
+        m_last_change = Now();
+        m_locked_source_time = m_last_change;
     };
 
     /// Set the actual area occupied by the rendered instrument on the canvas
@@ -491,8 +651,29 @@ public:
     /// Gnome sucks as it applies scaling to the fonts after we have already
     /// scaled them as required \return the scaling factor for fonts set in the
     /// system
+    ///
+    /// The value is read from the system once and cached, changes are picked
+    /// up through #WatchSystemFontScalingFactor
     static double GetSystemFontScalingFactor();
 
+    /// Update the cached system font scaling factor
+    ///
+    /// \param factor The new scaling factor
+    /// \return true if the factor changed and the watcher has been notified
+    static bool SetSystemFontScalingFactor(double factor);
+
+    /// Start watching the system font scaling factor for changes
+    ///
+    /// Only one watcher is supported, registering a new one replaces the
+    /// previous one
+    ///
+    /// \param on_change Callback invoked on the GUI thread after the factor
+    /// changed
+    static void WatchSystemFontScalingFactor(std::function<void()> on_change);
+
+    /// Stop watching the system font scaling factor for changes
+    static void UnwatchSystemFontScalingFactor();
+
     /// Get name of the instrument
     ///
     /// \return The string containing the name of the instrument
@@ -509,6 +690,12 @@ public:
     /// considered outdated
     int GetTimeout() { return m_allowed_age_sec; };
 
+    /// Get the maximum rate of the notifications about data updates
+    ///
+    /// \return The maximum number of notifications per second, zero if
+    /// unlimited
+    double GetMaxRate() const { return m_max_rate; };
+
     /// Returns a list of controls to configure the appearance of the instrument
     /// to be used in the GUI.
     ///
@@ -551,6 +738,31 @@ public:
     /// \return Scaled bitmap
     virtual wxBitmap Render(double scale);
 
+    /// Process the data and record the next frame for off-thread
+    /// rasterization. Called on the GUI thread, instruments not supporting
+    /// the raster path keep the default and are rendered by #Render.
+    ///
+    /// \param scale Double variable representing the scale (1.0 = 100%)
+    /// \return true if a frame was recorded and has to be rasterized
+    virtual bool PrepareRaster(double scale)
+    {
+        (void)scale;
+        return false;
+    };
+
+    /// Rasterize the frame recorded by #PrepareRaster. Only touches the
+    /// recording, so it may run on a worker thread.
+    void Rasterize()
+    {
+        if (m_raster) {
+            m_raster->Rasterize();
+        }
+    };
+
+    /// Turn the rasterized frame into the bitmap the next #Render returns.
+    /// Called on the GUI thread after #Rasterize finished.
+    virtual void CommitRaster() { };
+
     /// Inform the instrument about the current chart canvas rotation so an
     /// instrument anchored to the own ship can align its drawing with the
     /// chart (course-up / head-up). Instruments that do not overlay the chart
@@ -654,6 +866,16 @@ public:
     /// Force redraw of the instrument on the next overlay refresh
     void ForceRedraw() { m_needs_redraw = true; };
 
+    /// Get the rendering and update statistics of the instrument
+    ///
+    /// \return The statistics
+    InstrumentStats& GetStats() { return m_stats; };
+
+    /// Get the history of the values shown by the instrument
+    ///
+    /// \return The history or nullptr if the instrument does not keep one
+    virtual const History* GetHistory() const { return nullptr; };
+
     /// Transform the value using function implemented for the value of
     /// #transformation. Every transformation defined in
     /// #Instrument::transformation and DSK_UNIT_TRANSFORMATIONS
@@ -674,6 +896,20 @@ public:
     /// \param key SignalK key
     virtual void ConfigureFromKey(const wxString& key);
 
+    /// Get the zones configured for the instrument
+    ///
+    /// \return The zones
+    const vector<Zone>& GetZones() const { return m_zones; };
+
+    /// Get the transformation of the primary value, the configured zones are
+    /// in its units
+    ///
+    /// \return The transformation
+    virtual transformation GetTransformation() const
+    {
+        return transformation::none;
+    };
+
     /// Get the most significant SignalK key used by the instrument.
     ///
     /// \return Dot separated SignalK path
@@ -685,31 +921,33 @@ public:
     /// Get SignalK data with support for magic source modes (lockfirst,
     /// lockpersist)
     ///
-    /// This helper method resolves the path considering lock modes and updates
-    /// the locked source if needed. For lockfirst/lockpersist modes, it ensures
-    /// the lock is established and persisted as appropriate.
+    /// For lockfirst/lockpersist modes the value of the source chosen
+    /// centrally by the SourceArbiter of the dashboards is returned, the
+    /// instrument takes part in the arbitration since it subscribed to the
+    /// path, see #ArbitrateSource.
     ///
     /// \param path SignalK fully qualified path with optional SRC: designation
     /// \return Pointer to the data object or NULL if not found
     const Json::Value* GetSKDataResolved(const wxString& path);
 
+    /// Take part in the arbitration of the source of a path designated with
+    /// an arbitration policy (lockfirst, lockpersist, freshest or priority),
+    /// offering the persisted lock of the instrument. Does nothing for the
+    /// other paths.
+    ///
+    /// \param path SignalK fully qualified path with a SRC: designation
+    void ArbitrateSource(const wxString& path);
+
     /// Get the locked source for this instrument (used by magic source values)
     ///
     /// \return The locked source designation, or empty string if not locked
     wxString GetLockedSource() const { return m_locked_source; }
 
-    /// Set the locked source for this instrument
+    /// Set the locked source for this instrument, the locked path switches to
+    /// it for all the instruments showing it
     ///
     /// \param source The source designation to lock to
-    void SetLockedSource(const wxString& source)
-    {
-        m_locked_source = source;
-        m_locked_source_time = std::chrono::system_clock::now();
-        if (!m_locked_source_path.IsEmpty()) {
-            m_source_locks[m_locked_source_path]
-                = { m_locked_source, m_locked_source_time };
-        }
-    }
+    void SetLockedSource(const wxString& source);
 
     /// Get the time when the source lock was established
     ///
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _INSTRUMENTSTATS_H_
+#define _INSTRUMENTSTATS_H_
+
+#include "pi_common.h"
+
+#include <wx/bitmap.h>
+
+#include <array>
+#include <chrono>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Rendering and data update statistics of a single instrument, used to find
+/// out which instrument makes a dashboard slow.
+///
+/// The render times are measured on a monotonic clock independent of the
+/// #Clock of the dashboards, the notification rate follows the clock of the
+/// dashboards so that it is meaningful also for the replayed data. Only
+/// accessed from the GUI thread, with the exception of #AddRasterTime which is
+/// called by the render worker owning the instrument for the frame.
+class InstrumentStats {
+public:
+    /// Clock the render times are measured with
+    typedef std::chrono::steady_clock timer;
+    /// Number of the most recent render times kept for the percentile
+    static constexpr size_t SAMPLES = 256;
+
+private:
+    /// Number of calls to render the instrument
+    size_t m_renders;
+    /// Number of the renders which returned the cached bitmap
+    size_t m_skipped;
+    /// Sum of the times of the renders which were not skipped in microseconds
+    double m_total_us;
+    /// Ring buffer of the most recent times of the renders which were not
+    /// skipped in microseconds
+    std::array<float, SAMPLES> m_samples;
+    /// Number of the valid samples in #m_samples
+    size_t m_sample_count;
+    /// Position of the next sample in #m_samples
+    size_t m_sample_pos;
+    /// Time spent rasterizing the frame in parallel, added to the next render
+    double m_raster_us;
+    /// Size of the last rendered bitmap in bytes
+    size_t m_bitmap_bytes;
+    /// Shared data of the last rendered bitmap, to recognize the cached one
+    /// being returned again. Only compared, never dereferenced, holding a
+    /// reference to the bitmap could force the instrument to copy it on the
+    /// next draw
+    const wxObjectRefData* m_last_bitmap;
+    /// Number of the data notifications
+    size_t m_notifications;
+    /// Start of the current notification rate window
+    std::chrono::system_clock::time_point m_window_start;
+    /// Number of notifications in the current window
+    size_t m_window_notifications;
+    /// Notifications per second in the last complete window
+    double m_notification_rate;
+
+public:
+    /// Constructor
+    InstrumentStats() { Reset(); };
+
+    /// Forget all the statistics
+    void Reset();
+
+    /// Record a render of the instrument
+    ///
+    /// \param elapsed Time the render took
+    /// \param bmp The bitmap returned by the render
+    void AddRender(timer::duration elapsed, const wxBitmap& bmp);
+
+    /// Record the time spent rasterizing the next frame outside of the render
+    ///
+    /// \param elapsed Time the rasterization took
+    void AddRasterTime(timer::duration elapsed);
+
+    /// Record a notification of new data for the instrument
+    ///
+    /// \param now Current time of the dashboards
+    void AddNotification(std::chrono::system_clock::time_point now);
+
+    /// Get the number of renders
+    ///
+    /// \return Number of renders
+    size_t GetRenderCount() const { return m_renders; };
+
+    /// Get the number of renders which returned the cached bitmap
+    ///
+    /// \return Number of skipped renders
+    size_t GetSkippedCount() const { return m_skipped; };
+
+    /// Get the mean time of the renders which were not skipped
+    ///
+    /// \return Mean render time in microseconds
+    double GetMeanRenderTime() const;
+
+    /// Get the 99th percentile of the recent render times
+    ///
+    /// \return Render time in microseconds
+    double GetP99RenderTime() const;
+
+    /// Get the size of the last rendered bitmap
+    ///
+    /// \return Size in bytes
+    size_t GetBitmapBytes() const { return m_bitmap_bytes; };
+
+    /// Get the number of data notifications
+    ///
+    /// \return Number of notifications
+    size_t GetNotificationCount() const { return m_notifications; };
+
+    /// Get the rate of the data notifications over the last complete second
+    ///
+    /// \return Notifications per second
+    double GetNotificationRate() const { return m_notification_rate; };
+
+    /// Get the statistics as a short single line text for the on-canvas HUD
+    ///
+    /// \return Text describing the statistics
+    wxString ToString() const;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_INSTRUMENTSTATS_H_
@@ -0,0 +1,206 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _LOADGENERATOR_H_
+#define _LOADGENERATOR_H_
+
+#include "clock.h"
+#include "pi_common.h"
+
+#include <json/json.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+PLUGIN_BEGIN_NAMESPACE
+
+class DashboardSK;
+
+/// Scale of the traffic produced by #LoadGenerator
+struct load_profile {
+    /// Number of vessels
+    int vessels = 1;
+    /// Number of paths per vessel
+    int paths = 12;
+    /// Number of sources providing each path
+    int sources = 1;
+    /// Number of updates of each path from each source per second
+    double rate = 1.0;
+    /// Interval of the metadata updates in seconds, 0 to only send them once
+    /// at the start
+    double meta_interval = 0.0;
+    /// Seed of the random value generator
+    unsigned int seed = 1;
+
+    /// Parse a profile from comma separated \c key=value pairs, eg.
+    /// \c "vessels=10,paths=50,sources=2,rate=10,meta=60,seed=3". Missing
+    /// keys keep their default values
+    ///
+    /// \param spec The profile specification
+    /// \return The profile
+    static load_profile Parse(const wxString& spec);
+};
+
+/// Generator of synthetic SignalK delta traffic fed directly to
+/// #DashboardSK::SendSKDelta, used to measure the ingest, memory growth and
+/// rendering cost at loads well above what a real boat produces.
+///
+/// Each tick sends one delta per vessel and source with the values of all
+/// the paths, alternating NMEA0183 and NMEA2000 source objects, and the
+/// metadata of the paths when due. The values follow a random walk within a
+/// plausible range of each path. GUI thread only.
+class LoadGenerator {
+public:
+    /// Maximum number of ticks generated by a single #Pump call
+    static constexpr size_t MAX_BATCH = 100;
+
+private:
+    /// Static description of a generated path
+    struct path_def {
+        /// SignalK path relative to the vessel
+        wxString path;
+        /// SignalK units
+        wxString units;
+        /// Lowest value
+        double min;
+        /// Highest value
+        double max;
+    };
+
+    /// The scale of the traffic
+    load_profile m_profile;
+    /// Paths generated for each vessel
+    vector<path_def> m_paths;
+    /// Current value of each vessel, source and path
+    vector<double> m_values;
+    /// Random generator of the value steps
+    std::mt19937 m_rng;
+    /// Time of the next tick
+    Clock::time_point m_next_tick;
+    /// Time of the next metadata update
+    Clock::time_point m_next_meta;
+    /// The generator has started
+    bool m_started;
+    /// Number of messages sent
+    size_t m_messages;
+    /// Number of values sent
+    size_t m_values_sent;
+    /// Number of ticks skipped because the generation fell behind
+    size_t m_dropped_ticks;
+    /// Clock set to the time of each tick generated, if any
+    std::shared_ptr<ManualClock> m_clock;
+
+    /// Get the time between two ticks
+    ///
+    /// \return The tick period
+    Clock::base_clock::duration Period() const;
+
+public:
+    /// Constructor
+    ///
+    /// \param profile The scale of the traffic
+    explicit LoadGenerator(const load_profile& profile);
+
+    /// Get the profile
+    ///
+    /// \return The scale of the traffic
+    const load_profile& GetProfile() const { return m_profile; };
+
+    /// Get the context of a vessel
+    ///
+    /// \param vessel Index of the vessel
+    /// \return SignalK context of the vessel
+    static wxString Context(int vessel);
+
+    /// Build the delta with the next values of all the paths of a vessel
+    /// from a single source
+    ///
+    /// \param vessel Index of the vessel
+    /// \param source Index of the source
+    /// \param ts Timestamp of the update
+    /// \return The delta message
+    Json::Value MakeDelta(int vessel, int source, Clock::time_point ts);
+
+    /// Build the delta with the metadata of all the paths of a vessel
+    ///
+    /// \param vessel Index of the vessel
+    /// \return The delta message
+    Json::Value MakeMeta(int vessel) const;
+
+    /// Send the deltas of a single tick
+    ///
+    /// \param dsk The dashboard receiving the messages
+    /// \param ts Time of the tick
+    /// \return Number of messages sent
+    size_t Tick(DashboardSK& dsk, Clock::time_point ts);
+
+    /// Send the ticks which are due without blocking. If the generation
+    /// falls more than a second behind, the missed ticks are dropped and
+    /// counted instead
+    ///
+    /// \param dsk The dashboard receiving the messages
+    /// \param now Current time, the generation starts at the first call
+    /// \return Number of messages sent
+    size_t Pump(DashboardSK& dsk, Clock::time_point now);
+
+    /// Generate the traffic of a period of time as fast as possible
+    ///
+    /// \param dsk The dashboard receiving the messages
+    /// \param start Time of the first tick
+    /// \param span Length of the generated period
+    /// \return Number of messages sent
+    size_t Run(DashboardSK& dsk, Clock::time_point start,
+        Clock::base_clock::duration span);
+
+    /// Drive a clock by the time of the generated ticks and process the data
+    /// of the dashboards after each of them, see #DeltaReplayer::SetClock
+    ///
+    /// \param clock The clock, nullptr to stop driving it
+    void SetClock(std::shared_ptr<ManualClock> clock)
+    {
+        m_clock = std::move(clock);
+    };
+
+    /// Get the number of messages sent
+    ///
+    /// \return Number of messages
+    size_t GetMessageCount() const { return m_messages; };
+
+    /// Get the number of values sent
+    ///
+    /// \return Number of values
+    size_t GetValueCount() const { return m_values_sent; };
+
+    /// Get the number of ticks dropped by #Pump
+    ///
+    /// \return Number of ticks
+    size_t GetDroppedTicks() const { return m_dropped_ticks; };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_LOADGENERATOR_H_
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _MEMORYREPORT_H_
+#define _MEMORYREPORT_H_
+
+#include "pi_common.h"
+
+#include <json/json.h>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Estimated memory used by a part of the data of the plugin
+struct memory_entry {
+    /// Description of the part, eg. the context or the instrument
+    wxString name;
+    /// Estimated size in bytes
+    size_t bytes;
+    /// Number of the items, eg. the JSON nodes or the history samples
+    size_t items;
+};
+
+/// Breakdown of the memory used by the SignalK data tree, the histories of
+/// the instruments and the bitmaps cached by the instruments.
+///
+/// The sizes are estimates computed from the sizes of the data structures and
+/// the lengths of the strings, the allocator overhead is not included. They
+/// are meant to find out which part grows, eg. the AIS targets filling the
+/// data tree on a long passage, not to account for every byte.
+class MemoryReport {
+public:
+    /// Part of the data of the plugin
+    enum class section {
+        /// Subtrees of the data tree per vessel (or other) context
+        contexts = 0,
+        /// Subtrees of the data tree per path group (eg. navigation) summed
+        /// over all the contexts
+        paths,
+        /// Histories kept by the instruments
+        histories,
+        /// Bitmaps cached by the instruments
+        bitmaps,
+        /// Number of the sections
+        count
+    };
+
+private:
+    /// Entries of the sections
+    vector<memory_entry> m_entries[static_cast<size_t>(section::count)];
+
+public:
+    /// Estimate the memory used by a JSON value and all its children
+    ///
+    /// \param value The value
+    /// \param nodes Incremented by the number of the nodes of the value
+    /// \return Estimated size in bytes
+    static size_t EstimateJSON(const Json::Value& value, size_t& nodes);
+
+    /// Add an entry to a section, entries with the same name are summed
+    ///
+    /// \param s The section
+    /// \param name Name of the entry
+    /// \param bytes Estimated size in bytes
+    /// \param items Number of the items
+    void Add(section s, const wxString& name, size_t bytes, size_t items);
+
+    /// Get the entries of a section, the largest first
+    ///
+    /// \param s The section
+    /// \return The entries
+    vector<memory_entry> GetEntries(section s) const;
+
+    /// Get the estimated size of a section
+    ///
+    /// \param s The section
+    /// \return Sum of the sizes of the entries in bytes
+    size_t GetBytes(section s) const;
+
+    /// Get the estimated size of everything in the report, the paths section
+    /// is not counted as it is a different view of the contexts
+    ///
+    /// \return Size in bytes
+    size_t GetTotalBytes() const;
+
+    /// Format the report as text
+    ///
+    /// \param max_entries Maximum number of the entries listed per section
+    /// \return The report
+    wxString ToString(size_t max_entries = 50) const;
+
+    /// Write the full report to a file
+    ///
+    /// \param path Path to the file
+    /// \return true if the file was written
+    bool Save(const wxString& path) const;
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_MEMORYREPORT_H_
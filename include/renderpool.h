@@ -0,0 +1,105 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _RENDERPOOL_H_
+#define _RENDERPOOL_H_
+
+#include "pi_common.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Small fixed pool of worker threads executing batches of independent jobs.
+///
+/// The pool is fork-join: #Run hands a batch to the workers, the calling
+/// thread helps processing it and the call returns only after all the jobs
+/// finished, so the jobs may safely reference data owned by the caller.
+class RenderPool {
+private:
+    /// Worker threads
+    vector<std::thread> m_threads;
+    /// Protects the batch state below
+    std::mutex m_mutex;
+    /// Signals the workers a new batch is available or the pool is stopping
+    std::condition_variable m_work_cv;
+    /// Signals the caller the batch is complete
+    std::condition_variable m_done_cv;
+    /// Batch being processed, nullptr when idle
+    const vector<std::function<void()>>* m_jobs;
+    /// Index of the next job to be picked up
+    size_t m_next;
+    /// Number of jobs not finished yet
+    size_t m_pending;
+    /// The pool is being destroyed
+    bool m_stop;
+
+    /// Pick up and execute jobs from the current batch until there are none
+    /// left, the mutex has to be held by the caller
+    ///
+    /// \param lock Lock holding #m_mutex
+    void Drain(std::unique_lock<std::mutex>& lock);
+
+    /// Worker thread main loop
+    void Worker();
+
+public:
+    /// Constructor
+    ///
+    /// \param threads Number of worker threads, 0 executes all the jobs on
+    /// the calling thread
+    explicit RenderPool(size_t threads);
+
+    /// Destructor, joins the worker threads
+    ~RenderPool();
+
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+
+    /// Get the number of worker threads
+    ///
+    /// \return Number of threads in the pool
+    size_t GetThreadCount() const { return m_threads.size(); }
+
+    /// Execute the jobs in parallel and wait for all of them to finish
+    ///
+    /// \param jobs Jobs to execute
+    void Run(const vector<std::function<void()>>& jobs);
+
+    /// Default number of worker threads for the machine, leaving one core to
+    /// the GUI thread which takes part in the work as well
+    ///
+    /// \return Number of threads
+    static size_t DefaultThreadCount();
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_RENDERPOOL_H_
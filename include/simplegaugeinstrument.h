@@ -141,6 +141,12 @@ PLUGIN_BEGIN_NAMESPACE
 class SimpleGaugeInstrument : public Instrument {
 
 protected:
+    /// Indexes of the typed settings, generated from DSK_SGI_SETTINGS
+    enum setting_index {
+#define X(a, b, c, d, e, f, g, h) b##_IDX,
+        DSK_SGI_SETTINGS
+#undef X
+    };
     /// Type of the gauge
     enum class gauge_type {
         /// Angle relative to the direction, -180..180 degrees
@@ -174,13 +180,15 @@ protected:
 
     /// Initialize the default parameters of the instrument
     void Init();
+
+    /// Derive #m_data_key from the SignalK key and the smoothing and
+    /// resubscribe to it if it changed
+    void UpdateDataKey();
     /// SignalK fully quakified path whose value is to be displayed by the
     /// instrument
     wxString m_sk_key;
     /// Array of names of supported formats
     wxArrayString m_supported_formats;
-    /// Array of formatting strings implementing the supported formats
-    wxArrayString m_format_strings;
     /// Active format
     int m_format_index;
     /// Array of names of supported data transformations
@@ -200,10 +208,12 @@ protected:
     /// tells over how many historic values with progressively declining
     /// importance we want to smooth our data. 0 means the newest value is used
     /// as is, while 9 means the newest value has only 10% influence on the
-    /// result. a(i+1) = (m_smoothing*a(i) +
-    /// (DSK_SGI_SMOOTHING_MAX-m_smoothing+1)*data(i+1)) /
-    /// (DSK_SGI_SMOOTHING_MAX + 1)
+    /// result. The smoothing is done by a filter pipeline shared with the
+    /// other instruments, see #UpdateDataKey
     size_t m_smoothing;
+    /// Key the displayed value is read from, #m_sk_key with the smoothing
+    /// filter if any
+    wxString m_data_key;
     /// Previous value displayed by the instrument
     double m_old_value;
     /// Maximum value recorded by the instrument
@@ -229,7 +239,8 @@ protected:
     /// \param xc Horizontal coordinate of the center
     /// \param yc Vertical coordinate of the center
     /// \param r Radius
-    void DrawArc(wxDC& dc, const int& start_angle, const int& end_angle,
+    template <class DC>
+    void DrawArc(DC& dc, const int& start_angle, const int& end_angle,
         const wxCoord& xc, const wxCoord& yc, const wxCoord& r);
 
     /// Draw tick marks on the perimeter of a circle
@@ -247,7 +258,8 @@ protected:
     /// draw_from Angular position of the first tick mark to draw \param draw_to
     /// Angular position of the last tick mark to draw \param labels_from
     /// Initial label value \param labels_step Step between labels
-    void DrawTicks(wxDC& dc, const int& start_angle, const int& angle_step,
+    template <class DC>
+    void DrawTicks(DC& dc, const int& start_angle, const int& angle_step,
         const wxCoord& xc, const wxCoord& yc, const wxCoord& r,
         const wxCoord& length, bool labels = false, int except_every = 0,
         bool relative = false, int draw_from = 0, int draw_to = 360,
@@ -262,54 +274,80 @@ protected:
     /// \param perc_length Length of the needle in percent of r
     /// \param perc_width Width of the base of the needle in percent of r
     /// \param start_angle Angle where the instrument scale starts
-    void DrawNeedle(wxDC& dc, const wxCoord& xc, const wxCoord& yc,
+    template <class DC>
+    void DrawNeedle(DC& dc, const wxCoord& xc, const wxCoord& yc,
         const wxCoord& r, const wxCoord& angle, const int& perc_length,
         const int& perc_width = 20, const int& start_angle = 270);
 
-    /// Render an instrument visualizing percentages (= value on the 0..100
-    /// scale) into a bitmap
+    /// Pick the value to be drawn in the center of the gauge for the next
+    /// frame
+    ///
+    /// \param value Formatted value or a placeholder if there is none
+    /// \param has_value Set to true if \c value holds real data
+    /// \return false if the cached bitmap is still valid and nothing has to
+    /// be drawn
+    bool TakeFrameValue(wxString& value, bool& has_value);
+
+    /// Size of the rendered gauge
     ///
     /// \param scale scale of the instrument to be rendered (1.0 = natural
     /// scale)
-    /// \return Instrument rendered into a bitmap with alpha channel
-    wxBitmap RenderPercent(double scale);
-
-    /// Render an instrument visualizing numerical value in a gauge with scale
-    /// automatically adapting to the values displayed The instrument adjusts
-    /// the range dynamically to be able to accomodate all the values
-    /// rhistorically received The scale uses nerarest power of 10 not to
-    /// fluctuate excessively and be able to label the ticks with integers
+    /// \return Size in pixels, zero for an unknown gauge type
+    wxSize FrameSize(double scale) const;
+
+    /// Draw the gauge of the configured type
     ///
-    /// \param scale scale of the instrument to be rendered (1.0 = natural
+    /// \param dc Canvas of #FrameSize to draw on
+    /// \param value Value to be drawn in the center of the gauge
+    /// \param has_value Whether \c value holds real data
+    template <class DC>
+    void Paint(DC& dc, const wxString& value, bool has_value);
+
+    /// Draw an instrument visualizing percentages (= value on the 0..100
     /// scale)
+    ///
+    /// \param dc Canvas to draw on
+    /// \param value Value to be drawn in the center of the gauge
+    template <class DC> void PaintPercent(DC& dc, const wxString& value);
+
+    /// Draw an instrument visualizing an angle in a gauge with a 360 degree
+    /// scale
+    ///
+    /// \param dc Canvas to draw on
+    /// \param value Value to be drawn in the center of the gauge
     /// \param relative True if the displayed angle value is relative to
     /// the vessel (-180..180), false if absolute (0.360)
-    /// \return Instrument
-    /// rendered into a bitmap with alpha channel
-    wxBitmap RenderAngle(double scale, bool relative = true);
-
-    /// Render the instrument with range adapting to the received values
+    template <class DC>
+    void PaintAngle(DC& dc, const wxString& value, bool relative = true);
+
+    /// Draw the instrument with range adapting to the received values. The
+    /// instrument adjusts the range dynamically to be able to accomodate all
+    /// the values historically received. The scale uses nearest power of 10
+    /// not to fluctuate excessively and be able to label the ticks with
+    /// integers
     ///
-    /// \param scale scale of the instrument to be rendered (1.0 = natural
-    /// scale)
-    /// \return Instrument rendered into a bitmap with alpha channel
-    wxBitmap RenderAdaptive(double scale);
+    /// \param dc Canvas to draw on
+    /// \param value Value to be drawn in the center of the gauge
+    /// \param has_value Whether \c value holds real data
+    template <class DC>
+    void PaintAdaptive(DC& dc, const wxString& value, bool has_value);
 
-    /// Render the instrument with range set from the zone list minimum/maximum
+    /// Draw the instrument with range set from the zone list minimum/maximum
     /// value
     ///
-    /// \param scale scale of the instrument to be rendered (1.0 = natural
-    /// scale)
-    /// \return Instrument rendered into a bitmap with alpha channel
-    wxBitmap RenderFixed(double scale);
+    /// \param dc Canvas to draw on
+    /// \param value Value to be drawn in the center of the gauge
+    /// \param has_value Whether \c value holds real data
+    template <class DC>
+    void PaintFixed(DC& dc, const wxString& value, bool has_value);
 
     /// Get color for a part of the instrument corresponding to a value to be
     /// displayed
     ///
-    /// \param val Duble value to be displayed
+    /// \param st Zone state of the value to be displayed, see #GetZoneState
     /// \param item Part of the instrument
     /// \return Color to be used
-    const wxColor GetColor(const double& val, const color_item item);
+    const wxColor GetColor(const Zone::state st, const color_item item);
 
     /// Format the value to be displayed in the center of the gauge.
     /// The base implementation formats the primary value (#m_old_value).
@@ -363,6 +401,10 @@ public:
 
     wxBitmap Render(double scale) override;
 
+    bool PrepareRaster(double scale) override;
+
+    void CommitRaster() override { m_bmp = TakeRaster(); };
+
     void ReadConfig(Json::Value& config) override;
 
     Json::Value GenerateJSONConfig() override;
@@ -370,6 +412,11 @@ public:
     void SetSetting(const wxString& key, const wxString& value) override;
     void SetSetting(const wxString& key, const int& value) override;
 
+    transformation GetTransformation() const override
+    {
+        return m_transformation;
+    };
+
     wxString GetPrimarySKKey() const override { return m_sk_key; };
 
     void ProcessData() override;
@@ -27,10 +27,10 @@
 #ifndef _SIMPLEHISTOGRAM_H
 #define _SIMPLEHISTOGRAM_H
 
+#include "historyservice.h"
 #include "instrument.h"
 #include "pi_common.h"
 #include <chrono>
-#include <deque>
 #include <json/json.h>
 #include <wx/clrpicker.h>
 
@@ -88,55 +88,6 @@
 
 PLUGIN_BEGIN_NAMESPACE
 
-struct HistoryValue {
-    std::chrono::time_point<std::chrono::system_clock> ts;
-    size_t values;
-    double sum;
-
-    HistoryValue()
-        : ts(std::chrono::system_clock::now())
-        , values(0)
-        , sum(0.0) { };
-    explicit HistoryValue(const double& val)
-        : ts(std::chrono::system_clock::now())
-        , values(1)
-        , sum(val) { };
-    void Add(const double& val)
-    {
-        ++values;
-        sum += val;
-    };
-    double GetMean() { return values > 0 ? sum / values : 0.0; };
-    bool OlderThan(std::chrono::duration<int64_t> duration)
-    {
-        return ts + duration < std::chrono::system_clock::now();
-    };
-    bool NewerThan(std::chrono::duration<int64_t> duration)
-    {
-        return ts + duration > std::chrono::system_clock::now();
-    };
-    bool OlderThan(const HistoryValue& other) { return ts > other.ts; };
-    bool NewerThan(const HistoryValue& other) { return ts < other.ts; };
-
-    bool operator!=(const HistoryValue& x) const { return x.ts != ts; }
-};
-
-class History {
-    friend class SimpleHistogramInstrument;
-
-protected:
-    /// @brief Buffer for the last minute with 1s granularity (60 values)
-    std::deque<HistoryValue> m_last_minute;
-    /// @brief Buffer for the last 1 hour with 10 second granularity (360
-    /// values)
-    std::deque<HistoryValue> m_last_hour;
-    /// @brief Buffer for the last 3 days with 5 minute granularity (864 values)
-    std::deque<HistoryValue> m_last_3days;
-
-public:
-    void Add(const double& value);
-};
-
 /// Simple instrument displaying a single value from one SignalK path
 class SimpleHistogramInstrument : public Instrument {
 
@@ -146,6 +97,12 @@ public:
     using Instrument::SetSetting;
 
 protected:
+    /// Indexes of the typed settings, generated from DSK_SHI_SETTINGS
+    enum setting_index {
+#define X(a, b, c, d, e, f, g, h) b##_IDX,
+        DSK_SHI_SETTINGS
+#undef X
+    };
     /// Enum to identify the part of the instrument graphical representation
     enum class color_item {
         /// Title background
@@ -173,8 +130,6 @@ protected:
     wxString m_sk_key;
     /// Array of names of supported formats
     wxArrayString m_supported_formats;
-    /// Array of formatting strings implementing the supported formats
-    wxArrayString m_format_strings;
     /// Active format
     int m_format_index;
     /// Array of names of supported data transformations
@@ -196,8 +151,9 @@ protected:
     bool m_timed_out;
     /// Previous value displayed by the instrument
     double m_old_value;
-    /// @brief Historical values
-    History m_history;
+    /// @brief Historical values of #m_sk_key shared with the other instruments
+    /// showing it
+    std::shared_ptr<const History> m_history;
     /// @brief Width  of the instrument
     wxCoord m_instrument_width;
     /// @brief Height of the instrument
@@ -221,13 +177,7 @@ protected:
     /// set for the instrument
     const wxString FormatValue(const double& value)
     {
-        wxString str
-            = wxString::Format(m_format_strings[m_format_index], abs(value));
-        if (value < 0
-            && !m_supported_formats[m_format_index].StartsWith("ABS")) {
-            str.Prepend("-");
-        }
-        return str;
+        return ValueFormatter::Get(m_format_index).Format(value);
     }
 
     /// @brief Formats the interval between historical value and current time
@@ -235,10 +185,10 @@ protected:
     /// @param val Timestamp in the past
     /// @return String representation of the difference bewenn current time and
     /// the provided timestamp
-    const wxString FormatTime(const std::chrono::system_clock::time_point& val)
+    const wxString FormatTime(const Clock::time_point& val)
     {
-        auto dur = std::chrono::duration_cast<std::chrono::seconds>(
-            std::chrono::system_clock::now() - val);
+        auto dur
+            = std::chrono::duration_cast<std::chrono::seconds>(Now() - val);
         wxString s;
         if (dur.count() < 120) {
             s = wxString::Format("-%ds", (int)dur.count());
@@ -309,8 +259,15 @@ public:
     /// \return Transformed value
     double Transform(const double& val);
 
+    transformation GetTransformation() const override
+    {
+        return m_transformation;
+    };
+
     wxString GetPrimarySKKey() const override { return m_sk_key; };
 
+    const History* GetHistory() const override { return m_history.get(); };
+
     /// Only process the SK data without drawing anything
     void ProcessData() override;
 };
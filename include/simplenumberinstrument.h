@@ -114,6 +114,12 @@ public:
     using Instrument::SetSetting;
 
 protected:
+    /// Indexes of the typed settings, generated from DSK_SNI_SETTINGS
+    enum setting_index {
+#define X(a, b, c, d, e, f, g, h) b##_IDX,
+        DSK_SNI_SETTINGS
+#undef X
+    };
     /// Enum to identify the part of the instrument graphical representation
     enum class color_item {
         /// Title background
@@ -139,8 +145,6 @@ protected:
     wxString m_sk_key;
     /// Array of names of supported formats
     wxArrayString m_supported_formats;
-    /// Array of formatting strings implementing the supported formats
-    wxArrayString m_format_strings;
     /// Active format
     int m_format_index;
     /// Array of names of supported data transformations
@@ -156,28 +160,91 @@ protected:
     /// tells over how many historic values with progressively declining
     /// importance we want to smooth our data. 0 means the newest value is used
     /// as is, while 9 means the newest value has only 10% influence on the
-    /// result. a(i+1) = (m_smoothing*a(i) +
-    /// (DSK_SNI_SMOOTHING_MAX-m_smoothing+1)*data(i+1)) /
-    /// (DSK_SNI_SMOOTHING_MAX + 1)
+    /// result. The smoothing is done by a filter pipeline shared with the
+    /// other instruments, see #UpdateDataKey
     size_t m_smoothing;
+    /// Key the displayed value is read from, #m_sk_key with the smoothing
+    /// filter if any
+    wxString m_data_key;
     /// add a suffix to the value if applicable
     wxString m_value_suffix;
     /// Previous value displayed by the instrument
     double m_old_value;
 
+    /// Layout and content of the frame to be drawn
+    struct frame {
+        /// Scale the frame was laid out for
+        double scale;
+        /// Text of the value
+        wxString value;
+        /// Title background color
+        wxColor ctb;
+        /// Title text color
+        wxColor ctf;
+        /// Body background color
+        wxColor cbb;
+        /// Body text color
+        wxColor cbf;
+        /// Border color
+        wxColor cb;
+        /// Scaled title font
+        wxFont tf;
+        /// Scaled suffix font
+        wxFont sf;
+        /// Scaled body font
+        wxFont bf;
+        /// Width of the instrument
+        wxCoord size_x;
+        /// Height of the instrument
+        wxCoord size_y;
+        /// Width of the title
+        wxCoord title_x;
+        /// Height of the title
+        wxCoord title_y;
+        /// Width of the value
+        wxCoord body_x;
+        /// Height of the value
+        wxCoord body_y;
+        /// Descent of the value font
+        wxCoord body_d;
+        /// Width of the suffix
+        wxCoord suffix_x;
+        /// Height of the suffix
+        wxCoord suffix_y;
+        /// Descent of the suffix font
+        wxCoord suffix_d;
+    };
+    /// Frame prepared by #PrepareFrame
+    frame m_frame;
+
     /// Constructor
     SimpleNumberInstrument() { Init(); };
 
+    /// Process the data and lay out the next frame into #m_frame
+    ///
+    /// \param scale Double variable representing the scale (1.0 = 100%)
+    /// \return false if the cached bitmap is still valid
+    bool PrepareFrame(double scale);
+
+    /// Draw the frame prepared by #PrepareFrame
+    ///
+    /// \param dc Canvas of the size of the frame to draw on
+    template <class DC> void Paint(DC& dc);
+
     /// Initialize the default parameters of the instrument
     void Init();
 
+    /// Derive #m_data_key from the SignalK key and the smoothing and
+    /// resubscribe to it if it changed
+    void UpdateDataKey();
+
     /// Get color for a part of the instrument corresponding to a value to be
     /// displayed
     ///
-    /// \param val Duble value to be displayed
+    /// \param st Zone state of the value to be displayed, see #GetZoneState
     /// \param item Part of the instrument
     /// \return Color to be used
-    const wxColor GetColor(const double& val, const color_item item);
+    const wxColor GetColor(const Zone::state st, const color_item item);
 
 public:
     /// Constructor
@@ -220,6 +287,10 @@ public:
 
     wxBitmap Render(double scale) override;
 
+    bool PrepareRaster(double scale) override;
+
+    void CommitRaster() override { m_bmp = TakeRaster(); };
+
     void ReadConfig(Json::Value& config) override;
 
     Json::Value GenerateJSONConfig() override;
@@ -234,6 +305,11 @@ public:
     /// \return Transformed value
     double Transform(const double& val);
 
+    transformation GetTransformation() const override
+    {
+        return m_transformation;
+    };
+
     wxString GetPrimarySKKey() const override { return m_sk_key; };
 
     void ProcessData() override;
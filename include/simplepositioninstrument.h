@@ -75,6 +75,12 @@ public:
     using Instrument::SetSetting;
 
 protected:
+    /// Indexes of the typed settings, generated from DSK_SPI_SETTINGS
+    enum setting_index {
+#define X(a, b, c, d, e, f, g, h) b##_IDX,
+        DSK_SPI_SETTINGS
+#undef X
+    };
     /// Enum to identify the part of the instrument graphical representation
     enum class color_item {
         /// Title background
@@ -115,10 +121,10 @@ protected:
     /// Get color for a part of the instrument corresponding to a value to be
     /// displayed
     ///
-    /// \param val Duble value to be displayed
+    /// \param st Zone state of the value to be displayed, see #GetZoneState
     /// \param item Part of the instrument
     /// \return Color to be used
-    const wxColor GetColor(const double& val, const color_item item);
+    const wxColor GetColor(const Zone::state st, const color_item item);
 
 public:
     /// Constructor
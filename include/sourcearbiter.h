@@ -0,0 +1,311 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _SOURCEARBITER_H_
+#define _SOURCEARBITER_H_
+
+#include "clock.h"
+#include "pi_common.h"
+#include "sourceregistry.h"
+
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Change of the source chosen for an arbitrated path
+struct source_event {
+    /// Kind of the change
+    enum class type {
+        /// The first source was chosen
+        locked,
+        /// The chosen source stopped sending data and another one replaced
+        /// it
+        failover,
+        /// A source preferred by the policy over the chosen one replaced it
+        switched
+    };
+    /// Kind of the change
+    type kind;
+    /// Arbitrated path including the source designation, eg.
+    /// vessels.urn:mrn:imo:mmsi:265599691.navigation.headingTrue.SRC:lockfirst
+    wxString path;
+    /// Previously chosen source, empty if there was none
+    wxString from;
+    /// Newly chosen source, empty for the value received without a source
+    wxString to;
+    /// Time of the change
+    Clock::time_point time;
+};
+
+/// Chooses the source of the paths with the SRC:lockfirst, SRC:lockpersist,
+/// SRC:priority(a,b,...) and SRC:freshest designations centrally, so that all
+/// the instruments showing the same arbitrated path use the same source.
+///
+/// The decisions are made as the updates arrive from the deltas, not when the
+/// instruments read the data, and the lock and failover events are pushed to
+/// the subscribers of the path and the listeners. A lockfirst path keeps the
+/// first source it locked to for the whole session, a lockpersist path fails
+/// over to the most recently updated other source when the chosen one has not
+/// been updated for longer than the grace period, which is the shortest
+/// allowed data age of its subscribers. Without a grace period only a chosen
+/// source which never sent any data is replaced.
+///
+/// A priority path uses the first listed source which is alive, falling back
+/// to the sources not listed, and returns to a better one when it comes back.
+/// A freshest path uses the source whose values are the most recent on
+/// average, judged by its update interval and the lag of the timestamps of
+/// its updates, and switches only to a source which is clearly better. A
+/// source is alive while it has not been silent for longer than the grace
+/// period or #STALE_INTERVALS of its own update intervals. GUI thread only.
+class SourceArbiter {
+public:
+    /// Clock used to time the grace periods
+    typedef Clock::base_clock clock;
+    /// Function called on every lock and failover
+    typedef std::function<void(const source_event&)> listener_t;
+    /// Key of the paths
+    typedef SourceRegistry::path_key_t path_key_t;
+
+    /// Arbitration policy
+    enum class policy {
+        /// Lock to the first available source for the session
+        first,
+        /// Lock to the first available source and fail over to another one
+        /// after the grace period
+        persist,
+        /// Use the first alive source of a list
+        priority,
+        /// Use the source with the highest update rate and lowest lag
+        freshest
+    };
+
+    /// Number of its own update intervals after which a silent source is no
+    /// longer alive
+    static constexpr int STALE_INTERVALS = 5;
+    /// Percentage by which a source has to be fresher than the chosen one to
+    /// replace it in the freshest mode
+    static constexpr int MIN_IMPROVEMENT_PCT = 20;
+
+private:
+    /// Party interested in the arbitration of a path
+    struct subscriber {
+        /// Identity of the subscriber, eg. the instrument
+        const void* owner;
+        /// Time in seconds after which the subscriber considers the data
+        /// stale, zero or less if never
+        int grace_sec;
+        /// Function notified about the changes of the chosen source
+        listener_t listener;
+    };
+
+    /// Arbitration state of a path
+    struct arbitration {
+        /// Arbitrated path including the source designation
+        wxString path;
+        /// Key of the path without the source designation in the registry
+        path_key_t base;
+        /// Arbitration policy
+        policy mode;
+        /// Sources in the order of preference for the priority policy
+        vector<wxString> priorities;
+        /// A source has been chosen
+        bool locked = false;
+        /// The chosen source, empty for the value received without a source
+        wxString source;
+        /// Last time the chosen source was seen updated, or the time it was
+        /// chosen
+        Clock::time_point last_seen;
+        /// Parties interested in the arbitration
+        vector<subscriber> subscribers;
+    };
+
+    /// Source registry the arbitrated sources are looked up in
+    const SourceRegistry& m_registry;
+    /// Arbitration state of the subscribed paths
+    std::unordered_map<path_key_t, arbitration> m_arbitrations;
+    /// Arbitrated paths of every base path, for the lookup on update
+    std::unordered_map<path_key_t, vector<arbitration*>> m_by_base;
+    /// Receivers of all the events
+    vector<listener_t> m_listeners;
+
+    /// Get the grace period of an arbitration
+    ///
+    /// \param a The arbitration
+    /// \return Shortest grace period of the subscribers
+    static clock::duration GracePeriod(const arbitration& a);
+
+    /// Check whether a source is alive
+    ///
+    /// \param s The source
+    /// \param grace The grace period, zero for none
+    /// \param now Current time
+    /// \return true if the source has data and has not been silent for too
+    /// long
+    static bool IsAlive(
+        const sk_source& s, clock::duration grace, Clock::time_point now);
+
+    /// Get the position of a source in the priority list of a path
+    ///
+    /// \param a The arbitration
+    /// \param s The source
+    /// \return Index in the list, the size of the list if it is not listed
+    static size_t Rank(const arbitration& a, const sk_source& s);
+
+    /// Get the average age of the values of a source at the time they are
+    /// shown
+    ///
+    /// \param s The source
+    /// \return Half the update interval plus the lag, the maximum duration
+    /// if the interval is not known yet
+    static clock::duration Staleness(const sk_source& s);
+
+    /// Find the best alive source according to the priority or freshest
+    /// policy
+    ///
+    /// \param a The arbitration
+    /// \param sources The sources of the path
+    /// \param grace The grace period, zero for none
+    /// \param now Current time
+    /// \return The source or nullptr if none is alive
+    static const sk_source* Best(const arbitration& a,
+        const SourceRegistry::sources_t& sources, clock::duration grace,
+        Clock::time_point now);
+
+    /// Re-evaluate the choice of the source of a path
+    ///
+    /// \param a The arbitration
+    /// \param now Current time
+    void Evaluate(arbitration& a, Clock::time_point now);
+
+    /// Choose a source and notify about it
+    ///
+    /// \param a The arbitration
+    /// \param kind Kind of the change
+    /// \param source The chosen source
+    /// \param now Current time
+    void Choose(arbitration& a, source_event::type kind,
+        const wxString& source, Clock::time_point now);
+
+public:
+    /// Constructor
+    ///
+    /// \param registry Source registry the arbitrated sources are looked up in
+    explicit SourceArbiter(const SourceRegistry& registry)
+        : m_registry(registry) { };
+
+    /// Parse the arbitration policy from a source designation
+    ///
+    /// \param designation The designation after the SRC: magic string
+    /// \param mode Receives the policy
+    /// \param priorities Receives the sources listed by the priority policy,
+    /// if not nullptr
+    /// \return true if the designation is arbitrated
+    static bool ParsePolicy(const wxString& designation, policy& mode,
+        vector<wxString>* priorities = nullptr);
+
+    /// Add a receiver of all the lock and failover events
+    ///
+    /// \param listener Function called on every event
+    void AddListener(listener_t listener)
+    {
+        m_listeners.emplace_back(std::move(listener));
+    };
+
+    /// Subscribe to the arbitration of a path, repeated calls by the same
+    /// owner only update its grace period
+    ///
+    /// \param path SignalK path with an arbitrated source designation
+    /// \param owner Identity of the subscriber
+    /// \param grace_sec Time in seconds after which the subscriber considers
+    /// the data stale, zero or less if never
+    /// \param listener Function notified about the changes of the chosen
+    /// source of the path, called right away if the path already has one
+    /// \param now Current time
+    /// \param preferred Source to choose if the path has none yet (eg. the
+    /// persisted one), empty for the value received without a source, nullptr
+    /// to choose the first available one
+    /// \return false if the path is not arbitrated
+    bool Subscribe(const wxString& path, const void* owner, int grace_sec,
+        const listener_t& listener, Clock::time_point now,
+        const wxString* preferred = nullptr);
+
+    /// Change the grace period of all the subscriptions of an owner
+    ///
+    /// \param owner Identity of the subscriber
+    /// \param grace_sec Time in seconds after which the subscriber considers
+    /// the data stale, zero or less if never
+    void SetGrace(const void* owner, int grace_sec);
+
+    /// Unsubscribe from all the paths, the paths without subscribers are no
+    /// longer arbitrated
+    ///
+    /// \param owner Identity of the subscriber
+    void Unsubscribe(const void* owner);
+
+    /// Choose the source of an arbitrated path
+    ///
+    /// \param path Arbitrated SignalK path
+    /// \param source The source, empty for the value received without a
+    /// source
+    /// \param now Current time
+    void Lock(
+        const wxString& path, const wxString& source, Clock::time_point now);
+
+    /// Re-evaluate the arbitrated paths after an update was recorded in the
+    /// source registry
+    ///
+    /// \param base Key of the updated path without the source designation
+    /// \param now Time of the update
+    void Update(const path_key_t& base, Clock::time_point now);
+
+    /// Get the chosen source of an arbitrated path
+    ///
+    /// \param path Arbitrated SignalK path
+    /// \return The chosen source, nullptr if it has no data or the path is
+    /// not arbitrated
+    const sk_source* Resolve(const wxString& path) const;
+
+    /// Check whether a path is arbitrated
+    ///
+    /// \param path SignalK path with the source designation
+    /// \return true if there is a subscriber to the arbitration of the path
+    bool IsArbitrated(const wxString& path) const
+    {
+        return m_arbitrations.find(UNORDERED_KEY(path))
+            != m_arbitrations.end();
+    };
+
+    /// Get the number of the arbitrated paths
+    ///
+    /// \return Number of the paths
+    size_t GetPathCount() const { return m_arbitrations.size(); };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_SOURCEARBITER_H_
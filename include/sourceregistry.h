@@ -0,0 +1,172 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _SOURCEREGISTRY_H_
+#define _SOURCEREGISTRY_H_
+
+#include "clock.h"
+#include "pi_common.h"
+
+#include <json/json.h>
+
+#include <unordered_map>
+#include <utility>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Source providing the value of a SignalK path
+struct sk_source {
+    /// Name of the source (eg. GPS-GP-RMC), empty for the value received
+    /// without a source, which is stored directly in the node of the path
+    wxString id;
+    /// Node of the SignalK data tree holding the latest value from the source
+    const Json::Value* node;
+    /// Time of the last update from the source
+    Clock::time_point last_update;
+    /// Smoothed time between the updates from the source, zero until the
+    /// second update
+    Clock::base_clock::duration interval;
+    /// Smoothed delay between the timestamp of the updates and their
+    /// reception
+    Clock::base_clock::duration lag;
+    /// Number of the updates received from the source
+    size_t updates;
+
+    /// Check whether the source has provided any data
+    ///
+    /// \return true if the node holds a value, or nested data for the
+    /// complex values like position with latitude and longitude
+    bool HasData() const
+    {
+        return id.IsEmpty() ? node->isMember("value")
+                            : node->isObject() && !node->empty();
+    };
+};
+
+/// Registry of the sources of every SignalK path, maintained as the deltas
+/// are received, so that choosing a source is a scan of a short array instead
+/// of a walk over the members of the node in the data tree.
+///
+/// The registered nodes stay valid as long as the data tree only grows, the
+/// contexts removed from the tree and the branches replaced by complex values
+/// have to be removed from the registry as well (see #RemoveContext and
+/// #RemoveSubtree). GUI thread only.
+class SourceRegistry {
+public:
+#if wxCHECK_VERSION(3, 1, 0)
+    /// Key of the paths
+    typedef wxString path_key_t;
+#else
+    /// Key of the paths
+    typedef string path_key_t;
+#endif
+    /// Sources of a path in the order they were first seen
+    typedef vector<sk_source> sources_t;
+
+    /// Source of a path, identified by the path and the name of the source
+    typedef std::pair<path_key_t, wxString> source_key_t;
+
+    /// Weight of the newest sample in the smoothed interval and lag is one
+    /// divided by this
+    static constexpr int STATS_SMOOTHING = 8;
+    /// Maximum number of the paths checked by one call of #Expire
+    static constexpr size_t EXPIRY_BATCH = 256;
+
+private:
+    /// Sources of the paths
+    std::unordered_map<path_key_t, sources_t> m_paths;
+    /// Bucket of #m_paths the next call of #Expire starts checking at
+    size_t m_cursor = 0;
+
+public:
+    /// Record an update of a path from a source
+    ///
+    /// \param path Fully qualified SignalK path
+    /// \param source Name of the source, empty if the value came without one
+    /// \param node Node of the data tree where the value was stored
+    /// \param now Time of the update
+    /// \param timestamp Timestamp of the update in the delta, used to measure
+    /// the lag of the source
+    void Update(const path_key_t& path, const wxString& source,
+        const Json::Value* node, Clock::time_point now,
+        Clock::time_point timestamp);
+
+    /// Get the sources of a path
+    ///
+    /// \param path Fully qualified SignalK path
+    /// \return The sources in the order they were first seen, nullptr if the
+    /// path has never been received
+    const sources_t* GetSources(const path_key_t& path) const;
+
+    /// Get the first source of a path which has any data, the value received
+    /// without a source is preferred
+    ///
+    /// \param path Fully qualified SignalK path
+    /// \return The source or nullptr if there is none with data
+    const sk_source* GetFirstAvailable(const path_key_t& path) const;
+
+    /// Forget all the paths of a context
+    ///
+    /// \param context The context, eg. vessels.urn:mrn:imo:mmsi:230035780
+    void RemoveContext(const wxString& context);
+
+    /// Forget the nodes of a branch of the data tree which is about to be
+    /// replaced, ie. the sources of the path and everything under it. The
+    /// value received without a source stays registered, as its node is
+    /// the root of the branch, which is kept.
+    ///
+    /// \param path Fully qualified SignalK path of the branch
+    void RemoveSubtree(const wxString& path);
+
+    /// Forget the sources which have not been updated for a long time. Every
+    /// call checks the next batch of the paths, so that the work is spread
+    /// over the data ticks.
+    ///
+    /// \param deadline The sources last updated before this time are
+    /// forgotten
+    /// \param keep Prefix of the paths which are never forgotten, eg. the
+    /// paths of the own vessel, empty for none
+    /// \param expired Receives the forgotten sources, so that their nodes can
+    /// be removed from the data tree
+    void Expire(Clock::time_point deadline, const path_key_t& keep,
+        vector<source_key_t>& expired);
+
+    /// Get the number of the registered paths
+    ///
+    /// \return Number of the paths
+    size_t GetPathCount() const { return m_paths.size(); };
+
+    /// Forget all the paths
+    void Clear()
+    {
+        m_paths.clear();
+        m_cursor = 0;
+    };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_SOURCEREGISTRY_H_
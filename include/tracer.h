@@ -0,0 +1,164 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _TRACER_H_
+#define _TRACER_H_
+
+#include "pi_common.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Writer of the Chrome trace event format (readable by chrome://tracing and
+/// https://ui.perfetto.dev) recording the time spent ingesting, processing
+/// and rendering the data.
+///
+/// The spans are recorded by #TraceSpan into a lock-free single producer,
+/// single consumer ring buffer owned by the recording thread, so the
+/// instrumented code never blocks and, while tracing is not started, only
+/// pays for a relaxed atomic load. The buffers are drained to the file by
+/// #Flush, which is called periodically from the GUI thread. When a buffer is
+/// full, the new spans are dropped and counted.
+class Tracer {
+public:
+    /// Number of spans each thread can buffer between two flushes
+    static constexpr size_t BUFFER_SIZE = 8192;
+    /// Maximum length of the detail of a span (eg. the instrument name)
+    static constexpr size_t DETAIL_LEN = 48;
+
+private:
+    /// Tracing is running
+    static std::atomic<bool> s_enabled;
+
+public:
+    /// Start writing the trace to a file, replacing its contents
+    ///
+    /// \param path Path to the trace file
+    /// \return true if the file was opened
+    static bool Start(const wxString& path);
+
+    /// Flush the pending spans and finish the trace file
+    static void Stop();
+
+    /// Check whether tracing is running
+    ///
+    /// \return true if the spans are being recorded
+    static bool IsEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    };
+
+    /// Write the spans recorded by all the threads so far to the file
+    ///
+    /// \return Number of the spans written
+    static size_t Flush();
+
+    /// Get the number of spans dropped because a buffer was full
+    ///
+    /// \return Number of the dropped spans
+    static size_t GetDroppedCount();
+
+    /// Get the current time of the trace
+    ///
+    /// \return Microseconds since an arbitrary fixed point
+    static int64_t Now()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    };
+
+    /// Record a complete span in the buffer of the calling thread
+    ///
+    /// \param name Name of the span, has to be a string literal
+    /// \param start Start of the span, see #Now
+    /// \param end End of the span, see #Now
+    /// \param canvas Index of the canvas, -1 if not related to a canvas
+    /// \param detail Additional description, eg. the instrument name, may be
+    /// empty
+    static void Record(const char* name, int64_t start, int64_t end,
+        int canvas, const wxString& detail);
+};
+
+/// Span of the trace covering the lifetime of the object. Does nothing unless
+/// #Tracer is running when the span starts.
+///
+/// \code
+/// TraceSpan span("Render", canvas);
+/// if (span.IsActive()) {
+///     span.SetDetail(instrument->GetName());
+/// }
+/// \endcode
+class TraceSpan {
+private:
+    /// Name of the span, a string literal
+    const char* m_name;
+    /// Index of the canvas, -1 if not related to a canvas
+    int m_canvas;
+    /// Start of the span, 0 if tracing is not running
+    int64_t m_start;
+    /// Additional description of the span
+    wxString m_detail;
+
+public:
+    /// Constructor
+    ///
+    /// \param name Name of the span, has to be a string literal
+    /// \param canvas Index of the canvas, -1 if not related to a canvas
+    explicit TraceSpan(const char* name, int canvas = -1)
+        : m_name(name)
+        , m_canvas(canvas)
+        , m_start(Tracer::IsEnabled() ? Tracer::Now() : 0) { };
+
+    /// Destructor, records the span
+    ~TraceSpan()
+    {
+        if (m_start) {
+            Tracer::Record(m_name, m_start, Tracer::Now(), m_canvas, m_detail);
+        }
+    };
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /// Check whether the span is being recorded, to avoid building the detail
+    /// when it is not
+    ///
+    /// \return true if the span will be recorded
+    bool IsActive() const { return m_start != 0; };
+
+    /// Set the additional description of the span
+    ///
+    /// \param detail The description
+    void SetDetail(const wxString& detail) { m_detail = detail; };
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_TRACER_H_
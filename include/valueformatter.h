@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _VALUEFORMATTER_H_
+#define _VALUEFORMATTER_H_
+
+#include "pi_common.h"
+
+#include <wx/string.h>
+
+#include <vector>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Numeric value formatter compiled from an entry of the DSK_VALUE_FORMATS
+/// table.
+///
+/// Produces the same text as \c wxString::Format with the printf style format
+/// of the entry applied to the absolute value, with "-" prepended to negative
+/// values unless the format is an ABS one, but uses \c std::to_chars (or a
+/// constant \c snprintf format where the standard library lacks the floating
+/// point overload) instead of parsing the format string on every call.
+/// Immutable, so it is safe to use from the rendering worker threads.
+class ValueFormatter {
+private:
+    /// Minimum width of the formatted absolute value
+    int m_width;
+    /// Number of decimal places
+    int m_precision;
+    /// Pad the absolute value to #m_width with zeros instead of spaces
+    bool m_zero_pad;
+    /// Do not show the sign of negative values
+    bool m_abs;
+
+    /// Get the formatters compiled from DSK_VALUE_FORMATS
+    ///
+    /// \return The formatters indexed like the table
+    static const vector<ValueFormatter>& Formats();
+
+public:
+    /// Size of the buffer large enough for any value formatted with precision
+    /// up to 3 decimal places
+    static constexpr size_t BUFFER_SIZE = 352;
+
+    /// Constructor
+    ///
+    /// \param width Minimum width of the formatted absolute value
+    /// \param precision Number of decimal places
+    /// \param zero_pad Pad the absolute value with zeros instead of spaces
+    /// \param abs Do not show the sign of negative values
+    ValueFormatter(int width, int precision, bool zero_pad, bool abs)
+        : m_width(width)
+        , m_precision(precision)
+        , m_zero_pad(zero_pad)
+        , m_abs(abs) { };
+
+    /// Compile a formatter from a DSK_VALUE_FORMATS entry
+    ///
+    /// \param label Label of the format, formats starting with "ABS" drop the
+    /// sign
+    /// \param format printf style format of the form %[0][width][.precision]f
+    /// \return The formatter
+    static ValueFormatter Compile(
+        const wxString& label, const wxString& format);
+
+    /// Format a value into a caller supplied buffer
+    ///
+    /// \param value The value
+    /// \param buf Buffer to write to, not NUL terminated
+    /// \param size Size of the buffer
+    /// \return Number of characters written, 0 if the buffer is too small
+    size_t Format(double value, char* buf, size_t size) const;
+
+    /// Format a value
+    ///
+    /// \param value The value
+    /// \return The formatted value
+    wxString Format(double value) const;
+
+    /// Get the minimum width of the formatted absolute value
+    int GetWidth() const { return m_width; };
+
+    /// Get the number of decimal places
+    int GetPrecision() const { return m_precision; };
+
+    /// Whether the absolute value is padded with zeros
+    bool IsZeroPadded() const { return m_zero_pad; };
+
+    /// Whether the sign of negative values is hidden
+    bool IsAbs() const { return m_abs; };
+
+    /// Get the formatter for an entry of DSK_VALUE_FORMATS, the table is
+    /// compiled on first use
+    ///
+    /// \param index Index of the format, out of range indexes give the first
+    /// format
+    /// \return The formatter
+    static const ValueFormatter& Get(int index);
+
+    /// Get the number of entries in DSK_VALUE_FORMATS
+    ///
+    /// \return Number of formats
+    static size_t Count();
+};
+
+PLUGIN_END_NAMESPACE
+
+#endif //_VALUEFORMATTER_H_
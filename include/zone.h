@@ -28,6 +28,7 @@
 #define _ZONE_H_
 
 #include "pi_common.h"
+#include <algorithm>
 #include <vector>
 #include <wx/tokenzr.h>
 
@@ -81,7 +82,7 @@ public:
     /// Get the lower limit
     ///
     /// \return The lower limit value
-    const double GetLowerLimit() { return m_lower_limit; };
+    const double GetLowerLimit() const { return m_lower_limit; };
 
     /// Set the upper limit
     ///
@@ -91,7 +92,7 @@ public:
     /// Get the upper limit
     ///
     /// \return The upper limit
-    const double GetUpperLimit() { return m_upper_limit; };
+    const double GetUpperLimit() const { return m_upper_limit; };
 
     /// Set the message assigned to the zone
     ///
@@ -111,7 +112,7 @@ public:
     /// Get the alarm state of the zone
     ///
     /// \return The alarm state of the zone
-    state GetState() { return m_state; };
+    state GetState() const { return m_state; };
 
     /// Get the localized text representation of the zone parameters for use in
     /// the GUI
@@ -226,6 +227,27 @@ public:
         return v;
     };
 
+    /// Parse the zones from SignalK metadata
+    ///
+    /// \param zones The \c zones array of the SignalK metadata
+    /// \return vector of Zone objects parsed from the JSON array
+    static const vector<Zone> ParseZonesFromJson(const Json::Value& zones)
+    {
+        vector<Zone> v;
+        if (!zones.isArray()) {
+            return v;
+        }
+        for (int i = 0; i < (int)zones.size(); i++) {
+            v.emplace_back(Zone(zones[i]["lower"].asDouble(),
+                zones[i]["upper"].asDouble(),
+                StateFromString(fromJsonVal(zones[i]["state"].asString())),
+                zones[i].isMember("message")
+                    ? fromJsonVal(zones[i]["message"].asString())
+                    : wxString()));
+        }
+        return v;
+    };
+
     /// Get a string representation of a vector of zones
     ///
     /// \param zones vector of zones
@@ -244,6 +266,97 @@ public:
     }
 };
 
+
+/// Zones compiled into sorted non-overlapping intervals, each carrying the
+/// highest severity state of all the zones covering it, so that the state of a
+/// value is found with a single binary search instead of scanning all the
+/// zones
+class ZoneIndex {
+private:
+    /// Sorted unique zone limits
+    vector<double> m_limits;
+    /// State of the value equal to the limit with the same index
+    vector<Zone::state> m_at_limit;
+    /// State of the values between the limit with the same index and the next
+    /// one
+    vector<Zone::state> m_above_limit;
+
+public:
+    /// Constructor
+    ZoneIndex() = default;
+
+    /// Constructor
+    ///
+    /// \param zones The zones to index
+    explicit ZoneIndex(const vector<Zone>& zones) { Build(zones); };
+
+    /// Rebuild the index
+    ///
+    /// \param zones The zones to index
+    void Build(const vector<Zone>& zones)
+    {
+        m_limits.clear();
+        for (const auto& zone : zones) {
+            m_limits.push_back(zone.GetLowerLimit());
+            m_limits.push_back(zone.GetUpperLimit());
+        }
+        std::sort(m_limits.begin(), m_limits.end());
+        m_limits.erase(
+            std::unique(m_limits.begin(), m_limits.end()), m_limits.end());
+        m_at_limit.assign(m_limits.size(), Zone::state::nominal);
+        m_above_limit.assign(m_limits.size(), Zone::state::nominal);
+        for (const auto& zone : zones) {
+            if (zone.GetLowerLimit() > zone.GetUpperLimit()) {
+                continue;
+            }
+            size_t first = std::lower_bound(m_limits.begin(), m_limits.end(),
+                               zone.GetLowerLimit())
+                - m_limits.begin();
+            size_t last = std::lower_bound(m_limits.begin(), m_limits.end(),
+                              zone.GetUpperLimit())
+                - m_limits.begin();
+            for (size_t i = first; i <= last; i++) {
+                m_at_limit[i] = std::max(m_at_limit[i], zone.GetState());
+                if (i < last) {
+                    m_above_limit[i]
+                        = std::max(m_above_limit[i], zone.GetState());
+                }
+            }
+        }
+    };
+
+    /// Get the state of a value
+    ///
+    /// \param val The value
+    /// \return Highest severity state of the zones containing the value,
+    /// nominal if there is none
+    Zone::state GetState(const double& val) const
+    {
+        auto it = std::lower_bound(m_limits.begin(), m_limits.end(), val);
+        size_t i = it - m_limits.begin();
+        if (it != m_limits.end() && *it == val) {
+            return m_at_limit[i];
+        }
+        if (i == 0 || it == m_limits.end()) {
+            return Zone::state::nominal;
+        }
+        return m_above_limit[i - 1];
+    };
+
+    /// Whether there are no zones indexed
+    ///
+    /// \return true if there are no zones
+    bool IsEmpty() const { return m_limits.empty(); };
+
+    /// Get the distance between the lowest and the highest zone limit
+    ///
+    /// \return The span of the zones, 0 if there are none
+    double GetSpan() const
+    {
+        return m_limits.empty() ? 0.0 : m_limits.back() - m_limits.front();
+    };
+};
+
 PLUGIN_END_NAMESPACE
 
 #endif //_ZONE_H_
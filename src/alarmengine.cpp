@@ -0,0 +1,172 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "alarmengine.h"
+
+#include <cmath>
+
+PLUGIN_BEGIN_NAMESPACE
+
+Zone::state AlarmEngine::Classify(const monitor& m, double value) const
+{
+    const ZoneIndex& zones = ZonesOf(m);
+    Zone::state st = zones.GetState(value);
+    if (st >= m.state || m_hysteresis <= 0.0) {
+        return st;
+    }
+    const double margin = m_hysteresis * zones.GetSpan();
+    if (!std::isfinite(margin) || margin <= 0.0) {
+        return st;
+    }
+    // Stay in the current state as long as a zone with it is within the
+    // margin from the value
+    Zone::state near = std::max(
+        zones.GetState(value - margin), zones.GetState(value + margin));
+    return std::max(st, std::min(m.state, near));
+}
+
+void AlarmEngine::Commit(monitor& m)
+{
+    alarm_transition t { m.path, m.state, m.pending, m.value };
+    m.state = m.pending;
+    Publish(t);
+}
+
+void AlarmEngine::Publish(const alarm_transition& t)
+{
+    for (const auto& listener : m_listeners) {
+        listener(t);
+    }
+}
+
+void AlarmEngine::SetWatches(const watches_t& watches)
+{
+    for (auto& entry : m_monitors) {
+        monitor& m = entry.second;
+        auto w = watches.find(entry.first);
+        if (w == watches.end()) {
+            if (!m.watched) {
+                continue;
+            }
+            m.watched = false;
+            m.config_zones.Build({});
+            m.transform = nullptr;
+            m.pending = Zone::state::nominal;
+            m_pending.erase(entry.first);
+            if (m.state != Zone::state::nominal) {
+                alarm_transition t { m.path, m.state, Zone::state::nominal,
+                    std::nan("") };
+                m.state = Zone::state::nominal;
+                Publish(t);
+            }
+        } else {
+            m.watched = true;
+            m.config_zones.Build(w->second.zones);
+            m.transform = w->second.transform;
+        }
+    }
+    for (const auto& w : watches) {
+        monitor& m = m_monitors[w.first];
+        if (!m.watched) {
+            m.path = w.first;
+            m.watched = true;
+            m.config_zones.Build(w.second.zones);
+            m.transform = w.second.transform;
+        }
+    }
+}
+
+void AlarmEngine::SetMetaZones(const wxString& path, const vector<Zone>& zones)
+{
+    monitor& m = m_monitors[UNORDERED_KEY(path)];
+    m.path = path;
+    m.meta_zones.Build(zones);
+}
+
+void AlarmEngine::Update(
+    const wxString& path, double value, clock::time_point now)
+{
+    auto it = m_monitors.find(UNORDERED_KEY(path));
+    if (it == m_monitors.end() || !it->second.watched || std::isnan(value)) {
+        return;
+    }
+    monitor& m = it->second;
+    m.value = value;
+    // The configured zones are in the units the instruments show the value
+    // in, the metadata ones in the SignalK units
+    const bool convert = m.transform && !m.config_zones.IsEmpty();
+    Zone::state st = Classify(m, convert ? m.transform(value) : value);
+    if (st == m.state) {
+        if (m.pending != m.state) {
+            m.pending = m.state;
+            m_pending.erase(it->first);
+        }
+        return;
+    }
+    if (st != m.pending) {
+        m.pending = st;
+        m.pending_since = now;
+    }
+    if (now - m.pending_since >= m_debounce) {
+        m_pending.erase(it->first);
+        Commit(m);
+    } else {
+        m_pending.insert(it->first);
+    }
+}
+
+void AlarmEngine::Tick(clock::time_point now)
+{
+    auto it = m_pending.begin();
+    while (it != m_pending.end()) {
+        monitor& m = m_monitors[*it];
+        if (m.pending == m.state) {
+            it = m_pending.erase(it);
+        } else if (now - m.pending_since >= m_debounce) {
+            it = m_pending.erase(it);
+            Commit(m);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool AlarmEngine::IsWatched(const wxString& path) const
+{
+    auto it = m_monitors.find(UNORDERED_KEY(path));
+    return it != m_monitors.end() && it->second.watched;
+}
+
+Zone::state AlarmEngine::GetState(const wxString& path) const
+{
+    auto it = m_monitors.find(UNORDERED_KEY(path));
+    if (it == m_monitors.end()) {
+        return Zone::state::nominal;
+    }
+    return it->second.state;
+}
+
+PLUGIN_END_NAMESPACE
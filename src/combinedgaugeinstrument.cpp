@@ -82,7 +82,7 @@ void CombinedGaugeInstrument::SubscribeAll()
     }
     m_parent_dashboard->Unsubscribe(this);
     if (!m_sk_key.IsEmpty()) {
-        m_parent_dashboard->Subscribe(m_sk_key, this);
+        m_parent_dashboard->Subscribe(m_data_key, this);
     }
     if (!m_center_sk_key.IsEmpty()) {
         m_parent_dashboard->Subscribe(m_center_sk_key, this);
@@ -111,6 +111,9 @@ void CombinedGaugeInstrument::SetSetting(const wxString& key, const int& value)
     SimpleGaugeInstrument::SetSetting(key, value);
     if (key.IsSameAs(DSK_CGI_CENTER_TRANSFORM)) {
         m_center_transformation = static_cast<transformation>(value);
+    } else if (key.IsSameAs(DSK_SETTING_SMOOTHING)) {
+        // The base resubscribed the smoothed primary key only
+        SubscribeAll();
     }
 }
 
@@ -137,13 +140,9 @@ wxString CombinedGaugeInstrument::FormatCenterValue()
     if (m_center_sk_key.IsEmpty()) {
         return "---";
     }
-    wxString value = wxString::Format(
-        m_format_strings[m_format_index], abs(m_center_value));
-    if (m_center_value < 0
-        && !m_supported_formats[m_format_index].StartsWith("ABS")) {
-        value.Prepend("-");
-    }
-    return value.Append(m_value_suffix);
+    return ValueFormatter::Get(m_format_index)
+        .Format(m_center_value)
+        .Append(m_value_suffix);
 }
 
 void CombinedGaugeInstrument::ReadConfig(Json::Value& config)
@@ -83,10 +83,14 @@ void CompositeWindInstrument::Init()
     m_gybe_angle = 150;
     m_show_laylines = true;
     m_instrument_size = 200;
-    const auto now = std::chrono::system_clock::now();
+    const auto now = Now();
     for (auto& datum : m_data) {
         datum.changed = now;
     }
+#define X(key, value, label, control, parameters, json, getter)                \
+    RegisterTypedSetting(key##_IDX, key, dskConfigCtrl::control);
+    DSK_CWI_SETTINGS
+#undef X
 #define X(key, value, label, control, parameters, json, getter)                \
     SetSetting(key, value);
     DSK_CWI_SETTINGS
@@ -178,7 +182,7 @@ void CompositeWindInstrument::SetSetting(const wxString& key, const int& value)
 
 void CompositeWindInstrument::NotifyNewData(const wxString& fullpath)
 {
-    const auto now = std::chrono::system_clock::now();
+    const auto now = Now();
     for (size_t i = 0; i < m_keys.size(); ++i) {
         if (BasePath(m_keys[i]).IsSameAs(fullpath)) {
             m_data[i].changed = now;
@@ -198,7 +202,7 @@ void CompositeWindInstrument::RefreshData()
             && (*value)["value"].isNumeric()) {
             m_data[i].value = (*value)["value"].asDouble();
             if (!m_data[i].received) {
-                m_data[i].changed = std::chrono::system_clock::now();
+                m_data[i].changed = Now();
                 m_data[i].received = true;
             }
         }
@@ -210,7 +214,7 @@ std::optional<double> CompositeWindInstrument::Current(input item) const
     const datum& datum = m_data[static_cast<size_t>(item)];
     if (datum.received && datum.value) {
         const auto age = std::chrono::duration_cast<std::chrono::seconds>(
-            std::chrono::system_clock::now() - datum.changed);
+            Now() - datum.changed);
         if (m_allowed_age_sec <= 0 || age.count() <= m_allowed_age_sec) {
             return datum.value;
         }
@@ -282,14 +286,14 @@ wxBitmap CompositeWindInstrument::Render(double scale)
     // The ring band can be made semi-transparent (255 = opaque, the default)
     // so the chart shows through it; the hollow center always stays empty.
     const int ring_opacity
-        = wxClip(GetIntSetting(DSK_CWI_RING_OPACITY), 0, 255);
-    const wxColor ring = GetDimedColor(GetColorSetting(DSK_CWI_RING_COLOR));
+        = wxClip(IntSettingAt(DSK_CWI_RING_OPACITY_IDX), 0, 255);
+    const wxColor ring = GetDimedColor(ColorSettingAt(DSK_CWI_RING_COLOR_IDX));
     dc.SetBrush(*wxTRANSPARENT_BRUSH);
     dc.SetPen(
         wxPen(wxColor(ring.Red(), ring.Green(), ring.Blue(), ring_opacity),
             size * 0.10));
     dc.DrawCircle(center, center, ring_mid);
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR)),
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX)),
         wxMax(1, size / 100)));
     dc.DrawCircle(center, center, radius);
     dc.DrawCircle(center, center, size * 0.375);
@@ -300,8 +304,9 @@ wxBitmap CompositeWindInstrument::Render(double scale)
     const double bow = (m_orientation == orientation::north_up ? heading : 0.0)
         + m_chart_rotation;
     for (int i = -30; i < 30; ++i) {
-        const wxColor color = i < 0 ? GetColorSetting(DSK_CWI_PORT_COLOR)
-                                    : GetColorSetting(DSK_CWI_STARBOARD_COLOR);
+        const wxColor color = i < 0
+            ? ColorSettingAt(DSK_CWI_PORT_COLOR_IDX)
+            : ColorSettingAt(DSK_CWI_STARBOARD_COLOR_IDX);
         dc.SetPen(wxPen(GetDimedColor(color), wxMax(2, size / 50)));
         dc.DrawLine(Point(center, center, radius, bow + i),
             Point(center, center, radius, bow + i + 1));
@@ -310,7 +315,7 @@ wxBitmap CompositeWindInstrument::Render(double scale)
     const double dial_rotation
         = (m_orientation == orientation::heading_up ? -heading : 0.0)
         + m_chart_rotation;
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_CWI_TICK_COLOR)),
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_CWI_TICK_COLOR_IDX)),
         wxMax(1, size / 200)));
     for (int angle = 0; angle < 360; angle += 10) {
         const double length = angle % 30 == 0 ? size * 0.03 : size * 0.02;
@@ -320,9 +325,9 @@ wxBitmap CompositeWindInstrument::Render(double scale)
                 angle + dial_rotation));
     }
 
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_CWI_TEXT_COLOR)));
-    dc.SetFont(wxFont(size / 22 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetTextForeground(GetDimedColor(ColorSettingAt(DSK_CWI_TEXT_COLOR_IDX)));
+    dc.SetFont(GetFontCache().GetFont(size / 22 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     const wxString cardinals[] { "N", "E", "S", "W" };
     for (int i = 0; i < 4; ++i) {
         const wxPoint point
@@ -358,15 +363,15 @@ wxBitmap CompositeWindInstrument::Render(double scale)
         const auto stw = Current(input::stw);
         const auto set = Current(input::current_set);
         const auto drift = Current(input::current_drift);
-        const bool correct = GetIntSetting(DSK_CWI_LAYLINE_REF) == 1 && stw
+        const bool correct = IntSettingAt(DSK_CWI_LAYLINE_REF_IDX) == 1 && stw
             && *stw > 0.05 && set && drift;
         const double set_dial = correct
             ? Normalize(rad2deg(*set)
                   - (m_orientation == orientation::heading_up ? heading : 0.0)
                   + m_chart_rotation)
             : 0.0;
-        const wxColor port = GetColorSetting(DSK_CWI_PORT_COLOR);
-        const wxColor starboard = GetColorSetting(DSK_CWI_STARBOARD_COLOR);
+        const wxColor port = ColorSettingAt(DSK_CWI_PORT_COLOR_IDX);
+        const wxColor starboard = ColorSettingAt(DSK_CWI_STARBOARD_COLOR_IDX);
         dc.SetBrush(*wxTRANSPARENT_BRUSH);
         for (const double side : { -1.0, 1.0 }) {
             // tw - angle heads left of the wind, so it is the starboard tack.
@@ -383,7 +388,7 @@ wxBitmap CompositeWindInstrument::Render(double scale)
     if (awa && (has_heading || m_orientation == orientation::heading_up)) {
         const double bearing = Normalize(wind_offset + rad2deg(*awa));
         DrawTriangle(dc, center, center, bearing, size * 0.3375, size * 0.445,
-            size * 0.045, GetDimedColor(GetColorSetting(DSK_CWI_AWA_COLOR)));
+            size * 0.045, GetDimedColor(ColorSettingAt(DSK_CWI_AWA_COLOR_IDX)));
         const wxPoint label = Point(center, center, size * 0.405, bearing);
         dc.SetTextForeground(*wxWHITE);
         DrawCenteredText(dc, "A", label.x, label.y);
@@ -391,7 +396,8 @@ wxBitmap CompositeWindInstrument::Render(double scale)
     if (twa && (has_heading || m_orientation == orientation::heading_up)) {
         const double bearing = Normalize(wind_offset + rad2deg(*twa));
         DrawTriangle(dc, center, center, bearing, size * 0.3375, size * 0.445,
-            size * 0.0425, GetDimedColor(GetColorSetting(DSK_CWI_TWA_COLOR)));
+            size * 0.0425,
+            GetDimedColor(ColorSettingAt(DSK_CWI_TWA_COLOR_IDX)));
         const wxPoint label = Point(center, center, size * 0.405, bearing);
         dc.SetTextForeground(*wxWHITE);
         DrawCenteredText(dc, "T", label.x, label.y);
@@ -401,11 +407,11 @@ wxBitmap CompositeWindInstrument::Render(double scale)
             - (m_orientation == orientation::heading_up ? heading : 0.0)
             + m_chart_rotation);
         DrawTriangle(dc, center, center, bearing, radius, size * 0.39,
-            size * 0.025, GetDimedColor(GetColorSetting(DSK_CWI_COG_COLOR)));
+            size * 0.025, GetDimedColor(ColorSettingAt(DSK_CWI_COG_COLOR_IDX)));
     }
     if (has_heading) {
         DrawTriangle(dc, center, center, bow, radius, size * 0.39, size * 0.025,
-            GetDimedColor(GetColorSetting(DSK_CWI_HEADING_COLOR)));
+            GetDimedColor(ColorSettingAt(DSK_CWI_HEADING_COLOR_IDX)));
     }
 
     const auto angleText = [](const wxString& prefix,
@@ -428,8 +434,8 @@ wxBitmap CompositeWindInstrument::Render(double scale)
             ? wxString::Format("%s %.1f kn", prefix.c_str(), *value * 1.943844)
             : prefix + " --.- kn";
     };
-    dc.SetFont(wxFont(size / 28 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetFont(GetFontCache().GetFont(size / 28 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     // Label positions are relative to the dial, which sits at the margin offset
     // inside the enlarged bitmap.
     const wxString awa_s = angleText("AWA", awa);
@@ -444,10 +450,10 @@ wxBitmap CompositeWindInstrument::Render(double scale)
         margin + size * 0.785, panel_bg);
     DrawLabelPanel(dc, twa_s, tws_s, margin + size * 0.61, margin + size * 0.73,
         margin + size * 0.785, panel_bg);
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_CWI_AWA_COLOR)));
+    dc.SetTextForeground(GetDimedColor(ColorSettingAt(DSK_CWI_AWA_COLOR_IDX)));
     DrawCenteredText(dc, awa_s, margin + size * 0.39, margin + size * 0.73);
     DrawCenteredText(dc, aws_s, margin + size * 0.39, margin + size * 0.785);
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_CWI_TWA_COLOR)));
+    dc.SetTextForeground(GetDimedColor(ColorSettingAt(DSK_CWI_TWA_COLOR_IDX)));
     DrawCenteredText(dc, twa_s, margin + size * 0.61, margin + size * 0.73);
     DrawCenteredText(dc, tws_s, margin + size * 0.61, margin + size * 0.785);
 
@@ -0,0 +1,151 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "contextevictor.h"
+#include "memoryreport.h"
+
+#include <algorithm>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Find a member of a JSON object without creating it
+///
+/// \param parent The object
+/// \param name Name of the member
+/// \return The member or nullptr if the parent is not an object or the member
+/// does not exist
+static const Json::Value* FindMember(
+    const Json::Value* parent, const std::string& name)
+{
+    if (!parent || !parent->isObject()) {
+        return nullptr;
+    }
+    return parent->find(name.data(), name.data() + name.size());
+}
+
+ContextEvictor::ContextEvictor()
+    : m_total_bytes(0)
+    , m_ttl(std::chrono::minutes(DEFAULT_TTL_MIN))
+    , m_max_bytes(static_cast<size_t>(DEFAULT_MAX_MEMORY_KB) * 1024)
+    , m_evicted(0)
+{
+}
+
+void ContextEvictor::Touch(
+    const std::string& group, const std::string& id, clock::time_point now)
+{
+    m_contexts[context_key_t(group, id)].last_update = now;
+}
+
+std::map<ContextEvictor::context_key_t, ContextEvictor::context>::iterator
+ContextEvictor::Evict(
+    Json::Value& tree, std::map<context_key_t, context>::iterator it)
+{
+    const context_key_t& key = it->first;
+    if (FindMember(&tree, key.first)) {
+        tree[key.first].removeMember(key.second);
+    }
+    if (m_listener) {
+        m_listener(key);
+    }
+    m_total_bytes -= it->second.bytes;
+    m_evicted++;
+    return m_contexts.erase(it);
+}
+
+size_t ContextEvictor::Tick(
+    Json::Value& tree, const std::string& self, clock::time_point now)
+{
+    if (m_contexts.empty() || now - m_last_tick < TICK_INTERVAL) {
+        return 0;
+    }
+    m_last_tick = now;
+    const size_t evicted = m_evicted;
+    const auto is_self = [&self](const context_key_t& key) {
+        return key.first == "vessels" && key.second == self;
+    };
+
+    // Continue where the previous tick stopped, wrapping around at the end
+    size_t remaining = std::min(BATCH, m_contexts.size());
+    auto it = m_contexts.lower_bound(m_cursor);
+    while (remaining-- > 0 && !m_contexts.empty()) {
+        if (it == m_contexts.end()) {
+            it = m_contexts.begin();
+        }
+        if (is_self(it->first)) {
+            ++it;
+            continue;
+        }
+        if (m_ttl > clock::duration::zero()
+            && now - it->second.last_update > m_ttl) {
+            it = Evict(tree, it);
+            continue;
+        }
+        const Json::Value* node
+            = FindMember(FindMember(&tree, it->first.first), it->first.second);
+        if (!node) {
+            // Removed from the tree by someone else
+            m_total_bytes -= it->second.bytes;
+            it = m_contexts.erase(it);
+            continue;
+        }
+        size_t nodes = 0;
+        const size_t bytes = MemoryReport::EstimateJSON(*node, nodes);
+        m_total_bytes += bytes - it->second.bytes;
+        it->second.bytes = bytes;
+        ++it;
+    }
+    m_cursor = it == m_contexts.end() ? context_key_t() : it->first;
+
+    if (m_max_bytes > 0 && m_total_bytes > m_max_bytes) {
+        // Over the limit, evict the least recently updated contexts
+        vector<std::map<context_key_t, context>::iterator> lru;
+        lru.reserve(m_contexts.size());
+        for (auto c = m_contexts.begin(); c != m_contexts.end(); ++c) {
+            if (!is_self(c->first)) {
+                lru.push_back(c);
+            }
+        }
+        const size_t count = std::min(BATCH, lru.size());
+        std::partial_sort(lru.begin(), lru.begin() + count, lru.end(),
+            [](const auto& a, const auto& b) {
+                return a->second.last_update < b->second.last_update;
+            });
+        for (size_t i = 0; i < count && m_total_bytes > m_max_bytes; i++) {
+            Evict(tree, lru[i]);
+        }
+    }
+    return m_evicted - evicted;
+}
+
+void ContextEvictor::Clear()
+{
+    m_contexts.clear();
+    m_cursor = context_key_t();
+    m_total_bytes = 0;
+}
+
+PLUGIN_END_NAMESPACE
@@ -26,6 +26,7 @@
 
 #include "dashboard.h"
 #include "dashboardsk.h"
+#include "tracer.h"
 #include <wx/menu.h>
 
 #include <cmath>
@@ -33,6 +34,7 @@
 PLUGIN_BEGIN_NAMESPACE
 
 #define ID_INSTR_CONFIG 3001
+#define ID_INSTR_STATS 3002
 #define ID_INSTR_ACTION_BASE 3100
 
 vector<wxString> Dashboard::AnchorEdgeLabels { _("Bottom"), _("Top"), _("Left"),
@@ -70,15 +72,79 @@ void Dashboard::ProcessData()
         return;
     }
     for (auto& instrument : m_instruments) {
+        TraceSpan span("Instrument::ProcessData", m_canvas_nr);
+        if (span.IsActive()) {
+            span.SetDetail(instrument->GetName());
+        }
         instrument->ProcessData();
     }
 }
 
+void Dashboard::PrepareRaster(int canvasIndex, vector<Instrument*>& dirty)
+{
+    if (!m_enabled || m_canvas_nr != canvasIndex) {
+        return;
+    }
+    for (auto& instrument : m_instruments) {
+        const auto start = InstrumentStats::timer::now();
+        if (instrument->PrepareRaster(m_parent->GetContentScaleFactor())) {
+            instrument->GetStats().AddRasterTime(
+                InstrumentStats::timer::now() - start);
+            dirty.emplace_back(instrument);
+        }
+    }
+}
+
+wxBitmap Dashboard::RenderInstrument(Instrument* instrument)
+{
+    TraceSpan span("Render", m_canvas_nr);
+    if (span.IsActive()) {
+        span.SetDetail(instrument->GetName());
+    }
+    const auto start = InstrumentStats::timer::now();
+    wxBitmap bmp = instrument->Render(m_parent->GetContentScaleFactor());
+    instrument->GetStats().AddRender(
+        InstrumentStats::timer::now() - start, bmp);
+    return bmp;
+}
+
+void Dashboard::BlitInstrument(dskDC* dc, Instrument* instrument,
+    const wxBitmap& bmp, wxCoord x, wxCoord y)
+{
+    TraceSpan span("Blit", m_canvas_nr);
+    if (span.IsActive()) {
+        span.SetDetail(instrument->GetName());
+    }
+    dc->DrawBitmap(bmp, x, y, bmp.HasAlpha());
+}
+
+void Dashboard::DrawStats(
+    dskDC* dc, Instrument* instrument, wxCoord x, wxCoord y)
+{
+    if (!m_parent->GetShowStats()) {
+        return;
+    }
+    const wxString text = instrument->GetStats().ToString();
+    dc->SetFont(*wxSMALL_FONT);
+    wxCoord w;
+    wxCoord h;
+    dc->GetTextExtent(text, &w, &h);
+    dc->SetPen(*wxTRANSPARENT_PEN);
+    dc->SetBrush(wxBrush(wxColour(0, 0, 0, 160)));
+    dc->DrawRectangle(x, y, w + 4, h + 2);
+    dc->SetTextForeground(*wxYELLOW);
+    dc->DrawText(text, x + 2, y + 1);
+}
+
 void Dashboard::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
 {
     if (!m_enabled || m_canvas_nr != canvasIndex) {
         return;
     }
+    TraceSpan span("Dashboard::Draw", canvasIndex);
+    if (span.IsActive()) {
+        span.SetDetail(m_name);
+    }
 
     if (m_anchor == anchor_edge::own_ship) {
         double lat;
@@ -99,12 +165,12 @@ void Dashboard::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
         // stay upright.
         const double chart_rotation = vp->rotation * 180.0 / M_PI;
 
-        vector<wxBitmap> bitmaps;
+        vector<wxBitmap>& bitmaps = m_frame_bitmaps;
+        bitmaps.clear();
         wxCoord width = 0;
         for (auto instrument : m_instruments) {
             instrument->SetChartRotation(chart_rotation);
-            bitmaps.emplace_back(
-                instrument->Render(m_parent->GetContentScaleFactor()));
+            bitmaps.emplace_back(RenderInstrument(instrument));
             if (!bitmaps.back().IsOk()) {
                 continue;
             }
@@ -126,11 +192,14 @@ void Dashboard::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
             const wxCoord off_x = (bmp.GetWidth() - content.GetWidth()) / 2;
             const wxCoord off_y = (bmp.GetHeight() - content.GetHeight()) / 2;
             wxCoord y = ship.y - content.GetHeight() / 2;
-            dc->DrawBitmap(bmp, x - off_x, y - off_y, bmp.HasAlpha());
+            BlitInstrument(dc, m_instruments[i], bmp, x - off_x, y - off_y);
             m_instruments[i]->SetPlacement(
                 x, y, content.GetWidth(), content.GetHeight());
+            DrawStats(dc, m_instruments[i], x, y);
             x += content.GetWidth() + m_parent->ToPhys(m_spacing_h);
         }
+        // Keep the storage, but do not hold the bitmaps until the next frame
+        bitmaps.clear();
         return;
     }
 
@@ -179,8 +248,7 @@ void Dashboard::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
         // Edge-anchored dashboards are not chart overlays; clear any rotation a
         // previous own-ship anchoring may have left on the instrument.
         instrument->SetChartRotation(0.0);
-        const wxBitmap bmp(
-            instrument->Render(m_parent->GetContentScaleFactor()));
+        const wxBitmap bmp(RenderInstrument(instrument));
         // Lay out by the content footprint; draw the (possibly larger) bitmap
         // centered on it so decorative overflow does not reserve layout space.
         const wxSize content = instrument->ContentSize(bmp);
@@ -200,8 +268,9 @@ void Dashboard::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
                 }
                 y = start_pos + dir * row_offset + dir * row_nr * height;
                 current_row_size = wxMax(current_row_size, height);
-                dc->DrawBitmap(bmp, x - off_x, y - off_y, bmp.HasAlpha());
+                BlitInstrument(dc, instrument, bmp, x - off_x, y - off_y);
                 instrument->SetPlacement(x, y, width, height);
+                DrawStats(dc, instrument, x, y);
                 x += width + m_spacing_h;
             } else if (m_anchor == anchor_edge::left
                 || m_anchor == anchor_edge::right) {
@@ -218,8 +287,9 @@ void Dashboard::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
                 }
                 x = start_pos - row_offset - row_nr * width;
                 current_row_size = wxMax(current_row_size, width);
-                dc->DrawBitmap(bmp, x - off_x, y - off_y, bmp.HasAlpha());
+                BlitInstrument(dc, instrument, bmp, x - off_x, y - off_y);
                 instrument->SetPlacement(x, y, width, height);
+                DrawStats(dc, instrument, x, y);
                 y += height + m_parent->ToPhys(m_spacing_v);
             }
         }
@@ -243,6 +313,8 @@ bool Dashboard::ProcessMouseEvent(wxMouseEvent& event, int dashboard_idx)
         wxMenu mnu;
         mnu.Append(ID_INSTR_CONFIG,
             wxString::Format(_("Configure %s..."), instr->GetName()));
+        mnu.AppendCheckItem(ID_INSTR_STATS, _("Show performance statistics"));
+        mnu.Check(ID_INSTR_STATS, m_parent->GetShowStats());
         wxArrayString actions = instr->GetContextMenuActions();
         for (size_t a = 0; a < actions.GetCount(); ++a) {
             mnu.Append(ID_INSTR_ACTION_BASE + static_cast<int>(a), actions[a]);
@@ -251,6 +323,8 @@ bool Dashboard::ProcessMouseEvent(wxMouseEvent& event, int dashboard_idx)
             = m_parent->GetParentWindow()->GetPopupMenuSelectionFromUser(mnu);
         if (sel == ID_INSTR_CONFIG) {
             m_parent->ShowPreferencesDialog(dashboard_idx, static_cast<int>(i));
+        } else if (sel == ID_INSTR_STATS) {
+            m_parent->SetShowStats(!m_parent->GetShowStats());
         } else if (sel >= ID_INSTR_ACTION_BASE) {
             instr->DoContextMenuAction(sel - ID_INSTR_ACTION_BASE);
         }
@@ -345,7 +419,7 @@ void Dashboard::Subscribe(const wxString& path, Instrument* instrument)
     if (!m_parent) {
         return;
     }
-    m_parent->Subscribe(path, instrument);
+    m_parent->Subscribe(path, instrument, instrument->GetMaxRate());
 }
 
 void Dashboard::Unsubscribe(Instrument* instrument)
@@ -356,6 +430,38 @@ void Dashboard::Unsubscribe(Instrument* instrument)
     m_parent->Unsubscribe(instrument);
 }
 
+Clock::time_point Dashboard::Now() const
+{
+    if (!m_parent) {
+        return Clock::System().Now();
+    }
+    return m_parent->GetClock().Now();
+}
+
+void Dashboard::InvalidateAlarmWatches()
+{
+    if (!m_parent) {
+        return;
+    }
+    m_parent->InvalidateAlarmWatches();
+}
+
+void Dashboard::SetMaxRate(Instrument* instrument, double max_rate)
+{
+    if (!m_parent) {
+        return;
+    }
+    m_parent->SetMaxRate(instrument, max_rate);
+}
+
+void Dashboard::SetTimeout(Instrument* instrument, int timeout)
+{
+    if (!m_parent) {
+        return;
+    }
+    m_parent->GetSourceArbiter().SetGrace(instrument, timeout);
+}
+
 wxArrayString Dashboard::GetInstrumentNames()
 {
     wxArrayString as;
@@ -370,6 +476,37 @@ const Json::Value* Dashboard::GetSKData(const wxString& path)
     return m_parent->GetSKData(path);
 }
 
+bool Dashboard::ArbitrateSource(const wxString& path, Instrument* instrument,
+    const SourceArbiter::listener_t& listener, const wxString* preferred)
+{
+    if (!m_parent) {
+        return false;
+    }
+    return m_parent->GetSourceArbiter().Subscribe(path, instrument,
+        instrument->GetTimeout(), listener, Now(), preferred);
+}
+
+void Dashboard::LockSource(const wxString& path, const wxString& source)
+{
+    if (!m_parent) {
+        return;
+    }
+    m_parent->GetSourceArbiter().Lock(path, source, Now());
+}
+
+std::shared_ptr<const History> Dashboard::AcquireHistory(const wxString& path)
+{
+    if (!m_parent) {
+        return nullptr;
+    }
+    return m_parent->GetHistoryService().Acquire(path);
+}
+
+FontCache& Dashboard::GetFontCache()
+{
+    return m_parent ? m_parent->GetFontCache() : FontCache::Fallback();
+}
+
 double Dashboard::GetMagneticVariation() const
 {
     return m_parent ? m_parent->GetMagneticVariation() : 0.0;
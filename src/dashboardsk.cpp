@@ -26,7 +26,9 @@
 
 #include "dashboardsk.h"
 #include "dashboardsk_pi.h"
+#include "tracer.h"
 #include <cmath>
+#include <cstdio>
 #include <wx/tokenzr.h>
 
 PLUGIN_BEGIN_NAMESPACE
@@ -37,35 +39,298 @@ DashboardSK::DashboardSK(const wxString& data_path)
     , m_self(wxEmptyString)
     , m_self_ptr(nullptr)
     , m_frozen(false)
+    , m_pending_notifications(0)
+    , m_coalesce_deltas(false)
     , m_color_scheme(0)
     , m_own_ship_position_valid(false)
     , m_own_ship_lat(0.0)
     , m_own_ship_lon(0.0)
     , m_magnetic_variation(0.0)
     , m_data_dir(data_path)
+    , m_parallel_rendering(false)
+    , m_render_threads(0)
+    , m_show_stats(false)
+    , m_font_cache_scale(0.0)
+    , m_clock(std::make_shared<SystemClock>())
+    , m_alarm_watches_dirty(false)
+    , m_source_arbiter(m_sources)
+    , m_filters([this](const wxString& path) { return GetSKData(path); })
+    , m_histories([this](const wxString& path) { return GetSKData(path); })
+    , m_expressions([this](const wxString& path) { return GetSKData(path); })
+    , m_derived([this](const wxString& path) { return GetSKData(path); })
+    , m_derived_depth(0)
 {
     for (int i = 0; i < GetCanvasCount(); i++) {
         m_displayed_pages.insert({ i, new Pager(this) });
     }
     m_sk_data["vessels"] = Json::Value(Json::objectValue);
+    Instrument::WatchSystemFontScalingFactor([this]() {
+        m_font_cache.Clear();
+        ForceRedraw();
+    });
+    m_context_evictor.SetListener(
+        [this](const ContextEvictor::context_key_t& context) {
+            m_sources.RemoveContext(fromJsonVal(context.first) + "."
+                + NormalizeID(fromJsonVal(context.second)));
+        });
+    m_source_arbiter.AddListener([](const source_event& e) {
+        if (e.kind == source_event::type::failover) {
+            LOG_VERBOSE("DashboardSK_pi: Source of " + e.path
+                + " failed over from " + e.from + " to " + e.to);
+        }
+    });
+    m_alarm_engine.AddListener([](const alarm_transition& t) {
+        LOG_VERBOSE("DashboardSK_pi: Alarm state of " + t.path
+            + " changed from " + Zone::StringFromState(t.from) + " to "
+            + Zone::StringFromState(t.to));
+    });
+}
+
+/// Check whether a node of the data tree has other members than the fields of
+/// a value, ie. nested paths or the nodes of the sources
+///
+/// \param node The node
+/// \return true if there are nested nodes
+static bool HasNestedNodes(const Json::Value& node)
+{
+    if (!node.isObject()) {
+        return false;
+    }
+    Json::ArrayIndex fields = 0;
+    for (const char* field : { "value", "timestamp", "source", "meta" }) {
+        fields += node.isMember(field) ? 1 : 0;
+    }
+    return node.size() > fields;
 }
 
 void DashboardSK::ProcessData()
 {
+    ApplyPendingDeltas();
+    const Clock::time_point now = m_clock->Now();
+    FlushNotifications(now);
     for (auto dashboard : m_dashboards) {
         dashboard->ProcessData();
     }
+    UpdateAlarmWatches();
+    m_alarm_engine.Tick(now);
+    const size_t evicted
+        = m_context_evictor.Tick(m_sk_data, Self().ToStdString(), now);
+    if (evicted > 0) {
+        LOG_VERBOSE("DashboardSK_pi: Evicted %zu stale contexts, %zu remain",
+            evicted, m_context_evictor.GetContextCount());
+    }
+    ExpirePaths(now);
+}
+
+void DashboardSK::ExpirePaths(Clock::time_point now)
+{
+    const Clock::base_clock::duration ttl = m_context_evictor.GetTTL();
+    if (ttl <= Clock::base_clock::duration::zero()
+        || now - m_last_path_expiry < ContextEvictor::TICK_INTERVAL) {
+        return;
+    }
+    m_last_path_expiry = now;
+    vector<SourceRegistry::source_key_t> expired;
+    // The paths of the own vessel are never removed, like the vessel itself
+    const wxString self_prefix = "vessels." + Self() + ".";
+    m_sources.Expire(now - ttl, UNORDERED_KEY(self_prefix), expired);
+    for (const auto& source : expired) {
+        RemoveSourceNode(wxString(source.first), source.second);
+    }
+    if (!expired.empty()) {
+        LOG_VERBOSE("DashboardSK_pi: Removed %zu stale sources of the paths",
+            expired.size());
+    }
+}
+
+void DashboardSK::RemoveSourceNode(const wxString& path, const wxString& source)
+{
+    // The nodes along the path with the names of their members on the path
+    vector<std::pair<Json::Value*, std::string>> branch;
+    Json::Value* ptr = &m_sk_data;
+    wxStringTokenizer tokenizer(path, ".");
+    while (tokenizer.HasMoreTokens()) {
+        const std::string key = tokenizer.GetNextToken().ToStdString();
+        if (!ptr->isObject() || !ptr->isMember(key)) {
+            return;
+        }
+        branch.emplace_back(ptr, key);
+        ptr = &(*ptr)[key];
+    }
+    if (!ptr->isObject()) {
+        return;
+    }
+    if (source.IsEmpty()) {
+        for (const char* field : { "value", "timestamp", "source" }) {
+            ptr->removeMember(field);
+        }
+        // The members of a complex value which are not paths themselves
+        for (const std::string& member : ptr->getMemberNames()) {
+            const wxString name = fromJsonVal(member);
+            if (name.StartsWith(SRC_MAGIC_STRING) || name == "meta"
+                || HasNestedNodes((*ptr)[member])) {
+                continue;
+            }
+            const wxString member_path = path + "." + name;
+            if (!m_sources.GetSources(UNORDERED_KEY(member_path))) {
+                ptr->removeMember(member);
+            }
+        }
+    } else {
+        wxString src_key = SRC_MAGIC_STRING + source;
+        src_key.Replace(".", "-", true);
+        ptr->removeMember(src_key.ToStdString());
+    }
+    if (m_sources.GetSources(UNORDERED_KEY(path))) {
+        // The path still has sources, which may use this node
+        return;
+    }
+    // Remove the branches left empty, the contexts are left to the evictor
+    while (branch.size() > 2 && ptr->empty()) {
+        branch.back().first->removeMember(branch.back().second);
+        ptr = branch.back().first;
+        branch.pop_back();
+    }
+}
+
+void DashboardSK::MoveSubscription(
+    const void* owner, const wxString& from, const wxString& to)
+{
+    auto subs = m_path_subscriptions.find(
+        UNORDERED_KEY(FilterService::BasePath(from)));
+    if (subs == m_path_subscriptions.end()) {
+        return;
+    }
+    for (auto it = subs->second.begin(); it != subs->second.end(); ++it) {
+        if (it->instrument == owner) {
+            Instrument* instrument = it->instrument;
+            m_pending_notifications -= it->pending ? 1 : 0;
+            subs->second.erase(it);
+            Subscribe(to, instrument, instrument->GetMaxRate());
+            return;
+        }
+    }
+}
+
+void DashboardSK::Notify(
+    const wxString& path, subscription& sub, Clock::time_point now)
+{
+    if (sub.pending) {
+        sub.pending = false;
+        --m_pending_notifications;
+    }
+    sub.last_notify = now;
+    sub.instrument->NotifyNewData(path);
+    sub.instrument->GetStats().AddNotification(now);
+}
+
+void DashboardSK::FlushNotifications(Clock::time_point now)
+{
+    if (m_pending_notifications == 0) {
+        return;
+    }
+    for (auto& subs : m_path_subscriptions) {
+        for (auto& sub : subs.second) {
+            if (sub.pending && now - sub.last_notify >= sub.interval) {
+                Notify(wxString(subs.first), sub, now);
+            }
+        }
+    }
 }
 
-int DashboardSK::ToPhys(int x) { return m_parent_plugin->ToPhys(x); }
+void DashboardSK::UpdateAlarmWatches()
+{
+    if (!m_alarm_watches_dirty) {
+        return;
+    }
+    m_alarm_watches_dirty = false;
+    AlarmEngine::watches_t watches;
+    m_alarm_keys.clear();
+    for (const auto& sub : m_path_subscriptions) {
+        if (sub.second.empty()) {
+            continue;
+        }
+        // Subscribed paths are monitored even without configured zones so
+        // that the zones from the SignalK metadata apply to them
+        AlarmEngine::watch& w = watches[sub.first];
+        wxString& shown = m_alarm_keys[sub.first];
+        for (const auto& s : sub.second) {
+            const Instrument* instr = s.instrument;
+            // The configured zones belong to the primary value of the
+            // instrument. The instruments may show it in different units,
+            // the first one with any zones configured defines them.
+            const wxString primary = instr->GetPrimarySKKey();
+            if (UNORDERED_KEY(FilterService::BasePath(primary)) != sub.first
+                || (!shown.IsEmpty() && !w.zones.empty())) {
+                continue;
+            }
+            if (shown.IsEmpty() || !instr->GetZones().empty()) {
+                shown = primary;
+                w.zones = instr->GetZones();
+                w.transform = nullptr;
+                const Instrument::transformation t
+                    = instr->GetTransformation();
+                if (t != Instrument::transformation::none) {
+                    w.transform
+                        = [t](double v) { return Instrument::Transform(v, t); };
+                }
+            }
+        }
+        if (shown.IsEmpty()) {
+            // Not shown as a primary value, any source will do
+            shown = wxString(sub.first) + "." SRC_MAGIC_STRING "any";
+        }
+    }
+    m_alarm_engine.SetWatches(watches);
+}
+
+void DashboardSK::EvaluateAlarm(
+    const wxString& path, const Json::Value* node, Clock::time_point now)
+{
+    const auto it = m_alarm_keys.find(UNORDERED_KEY(path));
+    if (it == m_alarm_keys.end()) {
+        return;
+    }
+    // The other sources of the path do not change what the instrument shows,
+    // the filtered values only change with the input of their pipeline
+    const wxString& key = it->second;
+    const bool filtered = FilterService::IsFiltered(key);
+    if (GetSKData(filtered ? key.BeforeFirst(FILTER_SEPARATOR) : key) != node) {
+        return;
+    }
+    const Json::Value* shown = filtered ? GetSKData(key) : node;
+    if (!shown) {
+        return;
+    }
+    const Json::Value& value = shown->get("value", *shown);
+    if (value.isNumeric()) {
+        m_alarm_engine.Update(path, value.asDouble(), now);
+    }
+}
+
+int DashboardSK::ToPhys(int x)
+{
+    return m_parent_plugin ? m_parent_plugin->ToPhys(x) : x;
+}
 
 void DashboardSK::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
 {
+    // The dashboards process their data while drawing when they are shown,
+    // this is the data tick then
+    ApplyPendingDeltas();
+    FlushNotifications(m_clock->Now());
     if (m_displayed_pages.find(canvasIndex) == m_displayed_pages.end()) {
         m_displayed_pages[canvasIndex] = new Pager(this);
     }
+    if (GetContentScaleFactor() != m_font_cache_scale) {
+        m_font_cache.Clear();
+        m_font_cache_scale = GetContentScaleFactor();
+    }
     m_displayed_pages[canvasIndex]->Draw(dc, vp, canvasIndex);
     Dashboard::ClearOffsets();
+    if (m_parallel_rendering && !m_frozen) {
+        RasterizeDirty(canvasIndex);
+    }
     bool drawn = false;
     for (auto dashboard : m_dashboards) {
         if (!m_frozen
@@ -83,6 +348,54 @@ void DashboardSK::Draw(dskDC* dc, PlugIn_ViewPort* vp, int canvasIndex)
     }
 }
 
+void DashboardSK::RasterizeDirty(int canvasIndex)
+{
+    vector<Instrument*> dirty;
+    for (auto dashboard : m_dashboards) {
+        if (static_cast<size_t>(
+                m_displayed_pages[canvasIndex]->GetCurrentPage())
+            == dashboard->GetPageNr()) {
+            dashboard->PrepareRaster(canvasIndex, dirty);
+        }
+    }
+    if (dirty.empty()) {
+        return;
+    }
+    if (!m_render_pool) {
+        m_render_pool = std::make_unique<RenderPool>(m_render_threads > 0
+                ? static_cast<size_t>(m_render_threads)
+                : RenderPool::DefaultThreadCount());
+    }
+    vector<std::function<void()>> jobs;
+    jobs.reserve(dirty.size());
+    for (auto instrument : dirty) {
+        jobs.emplace_back([instrument, canvasIndex]() {
+            TraceSpan span("Rasterize", canvasIndex);
+            if (span.IsActive()) {
+                span.SetDetail(instrument->GetName());
+            }
+            const auto start = InstrumentStats::timer::now();
+            instrument->Rasterize();
+            instrument->GetStats().AddRasterTime(
+                InstrumentStats::timer::now() - start);
+        });
+    }
+    m_render_pool->Run(jobs);
+    for (auto instrument : dirty) {
+        instrument->CommitRaster();
+    }
+}
+
+void DashboardSK::SetParallelRendering(bool enabled, int threads)
+{
+    threads = wxMax(threads, 0);
+    if (threads != m_render_threads || !enabled) {
+        m_render_pool.reset();
+    }
+    m_parallel_rendering = enabled;
+    m_render_threads = threads;
+}
+
 void DashboardSK::ReadConfig(Json::Value& config)
 {
     LOG_VERBOSE("DashboardSK_pi: Reading DashboardSK config");
@@ -93,6 +406,33 @@ void DashboardSK::ReadConfig(Json::Value& config)
     if (config["signalk"].isMember("self")) {
         SetSelf(fromJsonVal(config["signalk"]["self"].asString()));
     }
+    SetCoalesceDeltas(config["signalk"].get("coalesce", false).asBool());
+    if (config.isMember("rendering") && config["rendering"].isObject()) {
+        SetParallelRendering(
+            config["rendering"].get("parallel", false).asBool(),
+            config["rendering"].get("threads", 0).asInt());
+        SetShowStats(config["rendering"].get("stats_hud", false).asBool());
+    } else {
+        SetParallelRendering(false);
+        SetShowStats(false);
+    }
+    int ttl = ContextEvictor::DEFAULT_TTL_MIN;
+    int max_memory = ContextEvictor::DEFAULT_MAX_MEMORY_KB;
+    if (config.isMember("store") && config["store"].isObject()) {
+        ttl = config["store"].get("context_ttl", ttl).asInt();
+        max_memory = config["store"].get("max_memory", max_memory).asInt();
+    }
+    m_context_evictor.SetTTL(std::chrono::minutes(std::max(ttl, 0)));
+    m_context_evictor.SetMaxBytes(
+        static_cast<size_t>(std::max(max_memory, 0)) * 1024);
+    if (config.isMember("alarms") && config["alarms"].isObject()) {
+        m_alarm_engine.SetHysteresis(config["alarms"]
+                .get("hysteresis", AlarmEngine::DEFAULT_HYSTERESIS)
+                .asDouble());
+        m_alarm_engine.SetDebounce(std::chrono::milliseconds(config["alarms"]
+                .get("debounce", AlarmEngine::DEFAULT_DEBOUNCE_MS)
+                .asInt()));
+    }
     if (!config.isMember("dashboards")) {
         LOG_VERBOSE("DashboardSK_pi: No dashboards node in JSON");
     }
@@ -134,6 +474,21 @@ Json::Value DashboardSK::GenerateJSONConfig()
 {
     Json::Value v;
     v["signalk"]["self"] = toJson(m_self);
+    v["signalk"]["coalesce"] = m_coalesce_deltas;
+    v["rendering"]["parallel"] = m_parallel_rendering;
+    v["rendering"]["threads"] = m_render_threads;
+    v["rendering"]["stats_hud"] = m_show_stats;
+    v["store"]["context_ttl"] = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::minutes>(
+            m_context_evictor.GetTTL())
+            .count());
+    v["store"]["max_memory"]
+        = static_cast<int>(m_context_evictor.GetMaxBytes() / 1024);
+    v["alarms"]["hysteresis"] = m_alarm_engine.GetHysteresis();
+    v["alarms"]["debounce"] = static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            m_alarm_engine.GetDebounce())
+            .count());
     for (auto dashboard : m_dashboards) {
         v["dashboards"].append(dashboard->GenerateJSONConfig());
     }
@@ -149,6 +504,7 @@ Json::Value DashboardSK::GenerateJSONConfig()
 void DashboardSK::SetColorScheme(int cs)
 {
     m_color_scheme = cs;
+    m_font_cache.Clear();
     for (auto dashboard : m_dashboards) {
         dashboard->SetColorScheme(cs);
     }
@@ -188,7 +544,14 @@ void DashboardSK::SetMagneticVariation(double variation)
 
 const Json::Value* DashboardSK::GetSKData(const wxString& path)
 {
-    // Handle magic source values (SRC:any, SRC:lockfirst, SRC:lockpersist)
+    if (Expression::IsExpression(path)) {
+        return m_expressions.Get(path);
+    }
+    // Filtered values are computed by the pipelines on update
+    if (FilterService::IsFiltered(path)) {
+        return m_filters.Get(path);
+    }
+
     int srcPos = path.Find(SRC_MAGIC_STRING);
     wxString basePath = path;
     wxString srcDesignation;
@@ -198,6 +561,24 @@ const Json::Value* DashboardSK::GetSKData(const wxString& path)
         srcDesignation = path.Mid(srcPos + strlen(SRC_MAGIC_STRING));
     }
 
+    // Handle magic source values (SRC:any, SRC:lockfirst, SRC:lockpersist)
+    // from the source registry of the path without walking the tree
+    SourceArbiter::policy mode;
+    if (srcDesignation == "any"
+        || SourceArbiter::ParsePolicy(srcDesignation, mode)) {
+        // The arbitrated sources are chosen by the arbiter once an instrument
+        // subscribes to them
+        if (m_source_arbiter.IsArbitrated(path)) {
+            const sk_source* src = m_source_arbiter.Resolve(path);
+            return src ? src->node : nullptr;
+        }
+        // ponytail: first available source, may jump if multiple sources
+        // exist
+        const sk_source* src
+            = m_sources.GetFirstAvailable(UNORDERED_KEY(basePath));
+        return src ? src->node : nullptr;
+    }
+
     // Navigate to the base path first
     wxStringTokenizer tokenizer(basePath, ".");
     Json::Value* ptr = &m_sk_data;
@@ -218,87 +599,36 @@ const Json::Value* DashboardSK::GetSKData(const wxString& path)
         return ptr;
     }
 
-    // Handle magic source values
-    if (srcDesignation == "any") {
-        // ponytail: scan first available source, may jump if multiple sources
-        // exist Prefer direct value if available, then first SRC: entry
-        if (ptr->isMember("value")) {
-            return ptr;
-        }
-        for (const auto& name : ptr->getMemberNames()) {
-            if (name.find("SRC:") == 0) {
-                const Json::Value* candidate = &(*ptr)[name];
-                // Return this source container if it has any data (value for
-                // scalars, or nested data for complex types like position with
-                // latitude/longitude)
-                if (candidate->isMember("value")
-                    || !candidate->getMemberNames().empty()) {
-                    return candidate;
-                }
-            }
-        }
-        return nullptr;
-    } else if (srcDesignation == "lockfirst") {
-        // ponytail: session lock to first available source, no persistence
-        // This requires access to the calling Instrument, which we don't have
-        // here So we'll implement this at the Instrument level in ProcessData
-        // instead. For now, treat as "any" and log a note about limitation
-        if (ptr->isMember("value")) {
-            return ptr;
-        }
-        for (const auto& name : ptr->getMemberNames()) {
-            if (name.find("SRC:") == 0) {
-                const Json::Value* candidate = &(*ptr)[name];
-                // Return this source container if it has any data (value for
-                // scalars, or nested data for complex types)
-                if (candidate->isMember("value")
-                    || !candidate->getMemberNames().empty()) {
-                    return candidate;
-                }
-            }
-        }
-        return nullptr;
-    } else if (srcDesignation == "lockpersist") {
-        // ponytail: persistent lock with grace period fallback
-        // Similar limitation - needs Instrument context
-        // Treat as "any" for now
-        if (ptr->isMember("value")) {
-            return ptr;
-        }
-        for (const auto& name : ptr->getMemberNames()) {
-            if (name.find("SRC:") == 0) {
-                const Json::Value* candidate = &(*ptr)[name];
-                // Return this source container if it has any data (value for
-                // scalars, or nested data for complex types)
-                if (candidate->isMember("value")
-                    || !candidate->getMemberNames().empty()) {
-                    return candidate;
-                }
-            }
-        }
-        return nullptr;
-    } else {
-        // Exact source designation - navigate to it
-        // Convert dots to dashes as done in ProcessComplexValue
-        wxString src_key = SRC_MAGIC_STRING + srcDesignation;
-        src_key.Replace(".", "-", true);
-        const std::string sk = src_key.ToStdString();
+    // Exact source designation - navigate to it
+    // Convert dots to dashes as done in ProcessComplexValue
+    wxString src_key = SRC_MAGIC_STRING + srcDesignation;
+    src_key.Replace(".", "-", true);
+    const std::string sk = src_key.ToStdString();
 
-        if (ptr->isMember(sk)) {
-            return &(*ptr)[sk];
-        }
-        return nullptr;
+    if (ptr->isMember(sk)) {
+        return &(*ptr)[sk];
     }
+    return nullptr;
 }
 
 void DashboardSK::ProcessComplexValue(Json::Value* parent,
-    const Json::Value& value, const wxDateTime& ts, const wxString& source)
+    const Json::Value& value, const wxDateTime& ts, const wxString& source,
+    const wxString& path)
 {
     if (value.isObject()) {
         for (const std::string& val : value.getMemberNames()) {
+            wxString member_path;
+            if (!path.IsEmpty()) {
+                member_path = path + "." + fromJsonVal(val);
+                if (parent->isMember(val) && HasNestedNodes((*parent)[val])) {
+                    // Replacing the member destroys the nodes nested in it,
+                    // the registry must not keep pointing to them
+                    m_sources.RemoveSubtree(member_path);
+                }
+            }
             (*parent)[val] = Json::Value();
-            ProcessComplexValue(
-                &(*parent)[val], value.get(val, Json::Value()), ts, source);
+            ProcessComplexValue(&(*parent)[val], value.get(val, Json::Value()),
+                ts, source, member_path);
         }
     } else {
         (*parent)["value"] = value;
@@ -307,8 +637,179 @@ void DashboardSK::ProcessComplexValue(Json::Value* parent,
     }
 }
 
+/// Convert a time point of the dashboard clock to wxDateTime
+///
+/// \param tp The time point
+/// \return The same time as wxDateTime
+static wxDateTime ToDateTime(const Clock::time_point& tp)
+{
+    const int64_t ms = tp.time_since_epoch() / std::chrono::milliseconds(1);
+    wxDateTime dt(static_cast<time_t>(ms / 1000));
+    dt.SetMillisecond(static_cast<wxDateTime::wxDateTime_t>(ms % 1000));
+    return dt;
+}
+
+/// Parse a SignalK timestamp, which is in UTC (eg. 2024-01-01T12:00:00.250Z)
+///
+/// \param str The timestamp
+/// \param tp Receives the time
+/// \return true if the timestamp was parsed
+static bool ParseTimestamp(const char* str, Clock::time_point& tp)
+{
+    int y, mon, d, h, min;
+    double sec;
+    if (sscanf(str, "%4d-%2d-%2dT%2d:%2d:%lf", &y, &mon, &d, &h, &min, &sec)
+            != 6
+        || mon < 1 || mon > 12) {
+        return false;
+    }
+    // Days since the epoch of the proleptic Gregorian date
+    y -= mon <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (mon + (mon > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const int64_t days = era * 146097 + doe - 719468;
+    tp = Clock::time_point(std::chrono::round<Clock::base_clock::duration>(
+        std::chrono::seconds(days * 86400 + h * 3600 + min * 60)
+        + std::chrono::duration<double>(sec)));
+    return true;
+}
+
 void DashboardSK::SendSKDelta(Json::Value& message)
 {
+    if (!m_coalesce_deltas) {
+        ProcessDelta(message);
+        return;
+    }
+    TraceSpan span("BufferDelta");
+    LOG_RECEIVE("Received SK message: " + DumpJSON(message));
+    if (m_self.IsEmpty() && message.isMember("self")) {
+        LOG_RECEIVE_DEBUG("Message contains self indentifier "
+            + fromJsonVal(message["self"].asString()));
+        SetSelf(fromJsonVal(message["self"].asString()));
+    }
+    BufferDelta(message);
+}
+
+void DashboardSK::SetCoalesceDeltas(bool enabled)
+{
+    m_coalesce_deltas = enabled;
+    if (!enabled) {
+        ApplyPendingDeltas();
+    }
+}
+
+wxString DashboardSK::SourceOf(const Json::Value& update)
+{
+    wxString source = wxEmptyString;
+    if (update.isMember("$source")) {
+        source = fromJsonVal(update["$source"].asString());
+    } else if (update.isMember("source")) {
+        if (update["source"]["type"].asString() == "NMEA0183") {
+            source.Append(update["source"]["label"].asString())
+                .Append("-")
+                .Append(update["source"]["talker"].asString())
+                .Append("-")
+                .Append(update["source"]["sentence"].asString());
+        } else if (update["source"]["type"].asString() == "NMEA2000") {
+            source.Append(update["source"]["label"].asString())
+                .Append("-")
+                .Append(update["source"]["pgn"].asString());
+        } else {
+            source.Append(update["source"]["label"].asString());
+        }
+    }
+    return source;
+}
+
+void DashboardSK::BufferDelta(const Json::Value& message)
+{
+    if (!message.isMember("updates") || !message["updates"].isArray()) {
+        LOG_RECEIVE("Message does not look OK");
+        return; // Invalid SK delta
+    }
+    const std::string context
+        = message.get("context", "vessels.self").asString();
+    Json::Value immediate;
+    for (const auto& update : message["updates"]) {
+        if (!update.isMember("values")) {
+            immediate["updates"].append(update);
+            continue;
+        }
+        Json::Value header;
+        for (const char* member : { "timestamp", "$source", "source" }) {
+            if (update.isMember(member)) {
+                header[member] = update[member];
+            }
+        }
+        std::string key = context;
+        key.append(1, '\n').append(SourceOf(update).ToStdString());
+        const size_t prefix = key.length();
+        for (const auto& value : update["values"]) {
+            if (value["value"].isNull()) {
+                // Ignored by ProcessDelta anyway
+                continue;
+            }
+            key.resize(prefix);
+            key.append(1, '\n').append(value["path"].asString());
+            auto it = m_pending_index.find(key);
+            if (it == m_pending_index.end()) {
+                m_pending_index.emplace(key, m_pending_updates.size());
+                m_pending_updates.push_back({ context, header,
+                    value["path"].asString(), value["value"], 0.0, 0 });
+                continue;
+            }
+            pending_update& pending = m_pending_updates[it->second];
+            if (pending.value.isNumeric()) {
+                pending.sum += pending.value.asDouble();
+                ++pending.superseded;
+            }
+            pending.header = header;
+            pending.value = value["value"];
+        }
+    }
+    if (!immediate.empty()) {
+        immediate["context"] = context;
+        ProcessDelta(immediate);
+    }
+}
+
+void DashboardSK::ApplyPendingDeltas()
+{
+    if (m_pending_updates.empty()) {
+        return;
+    }
+    TraceSpan span("ApplyPendingDeltas");
+    vector<Json::Value> deltas;
+    vector<vector<const pending_update*>> batches;
+    std::unordered_map<std::string, size_t> by_context;
+    for (auto& pending : m_pending_updates) {
+        const size_t idx
+            = by_context.emplace(pending.context, deltas.size()).first->second;
+        if (idx == deltas.size()) {
+            deltas.emplace_back();
+            deltas.back()["context"] = pending.context;
+            batches.emplace_back();
+        }
+        Json::Value& update
+            = deltas[idx]["updates"].append(std::move(pending.header));
+        Json::Value& value = update["values"].append(Json::Value());
+        value["path"] = pending.path;
+        value["value"] = std::move(pending.value);
+        batches[idx].push_back(&pending);
+    }
+    for (size_t i = 0; i < deltas.size(); i++) {
+        ProcessDelta(deltas[i], &batches[i]);
+    }
+    m_pending_updates.clear();
+    m_pending_index.clear();
+}
+
+void DashboardSK::ProcessDelta(
+    Json::Value& message, const vector<const pending_update*>* superseded)
+{
+    TraceSpan span("SendSKDelta");
     LOG_RECEIVE("Received SK message: " + DumpJSON(message));
     if (m_self.IsEmpty() && message.isMember("self")) {
         // If we still don't have Self ID set, we accept it from the core
@@ -351,6 +852,10 @@ void DashboardSK::SendSKDelta(Json::Value& message)
         fromJsonVal(message["context"].asString()), ".");
     int token_nr = 0;
     wxString token;
+    // Contexts other than our own are tracked to evict them when they go stale
+    const bool track_context = ptr == &m_sk_data;
+    std::string ctx_group;
+    std::string ctx_id;
     while (ctx_tokenizer.HasMoreTokens()) {
         ++token_nr;
         token = ctx_tokenizer.GetNextToken();
@@ -366,6 +871,11 @@ void DashboardSK::SendSKDelta(Json::Value& message)
             }
 
             const std::string tkey = token.ToStdString();
+            if (track_context && token_nr == 1) {
+                ctx_group = tkey;
+            } else if (track_context && token_nr == 2) {
+                ctx_id = tkey;
+            }
             if (!ptr->isMember(tkey)) {
                 LOG_RECEIVE_DEBUG(
                     "Node does NOT have member " + token + ", adding it");
@@ -381,45 +891,32 @@ void DashboardSK::SendSKDelta(Json::Value& message)
         }
     }
     LOG_RECEIVE_DEBUG("Full key after parsing: " + fullKey);
+    UpdateAlarmWatches();
+    const Clock::time_point now = m_clock->Now();
+    if (!ctx_id.empty()) {
+        m_context_evictor.Touch(ctx_group, ctx_id, now);
+    }
     wxDateTime ts;
     for (int i = 0; i < (int)message["updates"].size(); i++) {
         LOG_RECEIVE_DEBUG("processing update #%i", i);
+        // Time the update was produced, to measure the lag of the source
+        Clock::time_point stamp = now;
         if (message["updates"][i].isMember("timestamp")) {
             if (!ts.ParseISOCombined(fromJsonVal(
                     message["updates"][i]["timestamp"].asString()))) {
-                ts = wxDateTime::Now();
+                ts = ToDateTime(now);
+            }
+            if (message["updates"][i]["timestamp"].isString()) {
+                ParseTimestamp(
+                    message["updates"][i]["timestamp"].asCString(), stamp);
             }
         } else {
-            ts = wxDateTime::Now();
+            ts = ToDateTime(now);
         }
         // TODO: Some deltas may contain timestamp also as a value (ex.
         // position.timestamp), we could sometimes use or maybe even prefer them
         wxString fullKeyWithPath;
-        wxString source = wxEmptyString;
-        if (message["updates"][i].isMember("$source")) {
-            source = fromJsonVal(message["updates"][i]["$source"].asString());
-        } else if (message["updates"][i].isMember("source")) {
-            if (message["updates"][i]["source"]["type"].asString()
-                == "NMEA0183") {
-                source
-                    .Append(message["updates"][i]["source"]["label"].asString())
-                    .Append("-")
-                    .Append(
-                        message["updates"][i]["source"]["talker"].asString())
-                    .Append("-")
-                    .Append(
-                        message["updates"][i]["source"]["sentence"].asString());
-            } else if (message["updates"][i]["source"]["type"].asString()
-                == "NMEA2000") {
-                source
-                    .Append(message["updates"][i]["source"]["label"].asString())
-                    .Append("-")
-                    .Append(message["updates"][i]["source"]["pgn"].asString());
-            } else {
-                source.Append(
-                    message["updates"][i]["source"]["label"].asString());
-            }
-        }
+        const wxString source = SourceOf(message["updates"][i]);
         wxString utoken;
         if (message["updates"][i].isMember("values")) {
             for (int j = 0; j < (int)message["updates"][i]["values"].size();
@@ -465,16 +962,43 @@ void DashboardSK::SendSKDelta(Json::Value& message)
                         (*val_ptr)[sk] = Json::Value();
                         val_ptr = &(*val_ptr)[sk];
                     }
+                    // Nothing is registered under the node of a source
                     ProcessComplexValue(val_ptr,
                         message["updates"][i]["values"][j]["value"], ts,
-                        source);
+                        source,
+                        source.IsEmpty() ? fullKeyWithPath : wxString());
+                    m_sources.Update(UNORDERED_KEY(fullKeyWithPath), source,
+                        val_ptr, now, stamp);
+                    m_source_arbiter.Update(
+                        UNORDERED_KEY(fullKeyWithPath), now);
+                    m_filters.Update(
+                        UNORDERED_KEY(fullKeyWithPath), val_ptr, now);
+                    if (superseded && (*superseded)[i]->superseded > 0) {
+                        // The values coalesced into this one still count in
+                        // the histories
+                        m_histories.AddSuperseded(
+                            UNORDERED_KEY(fullKeyWithPath),
+                            (*superseded)[i]->sum,
+                            (*superseded)[i]->superseded, now);
+                    }
+                    m_histories.Update(UNORDERED_KEY(fullKeyWithPath), now);
+                    m_expressions.Update(UNORDERED_KEY(fullKeyWithPath));
+                    m_derived.Update(UNORDERED_KEY(fullKeyWithPath));
 
                     LOG_RECEIVE_DEBUG(
                         "Notifying update to path " + fullKeyWithPath);
-                    for (auto instr :
+                    for (auto& sub :
                         m_path_subscriptions[UNORDERED_KEY(fullKeyWithPath)]) {
-                        instr->NotifyNewData(fullKeyWithPath);
+                        if (now - sub.last_notify >= sub.interval) {
+                            Notify(fullKeyWithPath, sub, now);
+                        } else if (!sub.pending) {
+                            // Delivered by FlushNotifications once the
+                            // interval of the subscription elapses
+                            sub.pending = true;
+                            ++m_pending_notifications;
+                        }
                     }
+                    EvaluateAlarm(fullKeyWithPath, val_ptr, now);
                 }
             }
         } else if (message["updates"][i].isMember("meta")) {
@@ -512,16 +1036,88 @@ void DashboardSK::SendSKDelta(Json::Value& message)
                 if (!message["updates"][i]["meta"][j].isNull()) {
                     (*val_ptr)["meta"]
                         = message["updates"][i]["meta"][j]["value"];
+                    if ((*val_ptr)["meta"].isObject()
+                        && (*val_ptr)["meta"].isMember("zones")) {
+                        m_alarm_engine.SetMetaZones(fullKeyWithPath,
+                            Zone::ParseZonesFromJson(
+                                (*val_ptr)["meta"]["zones"]));
+                    }
                 }
             }
         }
     }
+    // The values derived from the updated paths are published as our own
+    // delta, which may in turn update the inputs of further derivations
+    if (m_derived.IsPending() && m_derived_depth < DerivedEngine::MAX_DEPTH) {
+        Json::Value derived;
+        derived["context"] = "vessels.self";
+        derived["updates"][0]["values"] = m_derived.Compute();
+        if (!derived["updates"][0]["values"].empty()) {
+            ++m_derived_depth;
+            ProcessDelta(derived);
+            --m_derived_depth;
+        }
+    }
 }
 
 wxString DashboardSK::GetSignalKTreeText() { return DumpJSON(m_sk_data); }
 
 Json::Value* DashboardSK::GetSignalKTree() { return &m_sk_data; }
 
+MemoryReport DashboardSK::GetMemoryReport()
+{
+    MemoryReport report;
+    for (auto group = m_sk_data.begin(); group != m_sk_data.end(); ++group) {
+        const wxString group_name = fromJsonVal(group.name());
+        if (!group->isObject()) {
+            size_t nodes = 0;
+            const size_t bytes = MemoryReport::EstimateJSON(*group, nodes);
+            report.Add(MemoryReport::section::contexts, group_name, bytes,
+                nodes);
+            continue;
+        }
+        // Eg. vessels.urn:mrn:imo:mmsi:230035780
+        for (auto ctx = group->begin(); ctx != group->end(); ++ctx) {
+            size_t nodes = 0;
+            const size_t bytes = MemoryReport::EstimateJSON(*ctx, nodes);
+            report.Add(MemoryReport::section::contexts,
+                group_name + "." + fromJsonVal(ctx.name()), bytes, nodes);
+            if (!ctx->isObject()) {
+                continue;
+            }
+            // Eg. vessels.*.navigation
+            for (auto path = ctx->begin(); path != ctx->end(); ++path) {
+                nodes = 0;
+                const size_t path_bytes
+                    = MemoryReport::EstimateJSON(*path, nodes);
+                report.Add(MemoryReport::section::paths,
+                    group_name + ".*." + fromJsonVal(path.name()), path_bytes,
+                    nodes);
+            }
+        }
+    }
+    // The histories are shared by the instruments showing the same key
+    for (const auto& history : m_histories.GetHistories()) {
+        report.Add(MemoryReport::section::histories, history.first,
+            history.second->GetMemoryUsage(), history.second->GetSampleCount());
+    }
+    for (auto dashboard : m_dashboards) {
+        const wxArrayString names = dashboard->GetInstrumentNames();
+        for (size_t i = 0; i < names.size(); i++) {
+            Instrument* instrument
+                = dashboard->GetInstrument(static_cast<int>(i));
+            const wxString name = dashboard->GetName() + " / " + names[i];
+            const size_t bmp_bytes = instrument->GetStats().GetBitmapBytes();
+            if (bmp_bytes > 0) {
+                // The bitmaps are 32 bits per pixel
+                report.Add(MemoryReport::section::bitmaps, name, bmp_bytes,
+                    bmp_bytes / 4);
+            }
+        }
+    }
+    return report;
+}
+
 const wxString DashboardSK::SelfTranslate(const wxString& path)
 {
     if (Self().IsEmpty()) {
@@ -650,7 +1246,7 @@ bool DashboardSK::IsVisible() { return m_parent_plugin->IsVisible(); }
 
 double DashboardSK::GetContentScaleFactor() const
 {
-    return m_parent_plugin->GetContentScaleFactor();
+    return m_parent_plugin ? m_parent_plugin->GetContentScaleFactor() : 1.0;
 }
 
 PLUGIN_END_NAMESPACE
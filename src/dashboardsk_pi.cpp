@@ -29,6 +29,7 @@
 #include "dashboardskguiimpl.h"
 #include <wx/ffile.h>
 #include <wx/filename.h>
+#include <wx/utils.h>
 #include <wx/wfstream.h>
 
 #include <cmath>
@@ -86,6 +87,7 @@ int dashboardsk_pi::Init()
     m_dsk->SetParentWindow(m_parent_window);
     m_dsk->SetParentPlugin(this);
     LoadConfig();
+    SetupDeltaLog();
 
     wxString _svg_dashboardsk = GetDataDir() + "dashboardsk_pi.svg";
     wxString _svg_dashboardsk_rollover
@@ -116,6 +118,24 @@ int dashboardsk_pi::Init()
 bool dashboardsk_pi::DeInit()
 {
     SaveConfig();
+    m_replay_timer.Stop();
+    m_replayer.Close();
+    m_load_timer.Stop();
+    if (m_load_generator) {
+        LOG_VERBOSE("DashboardSK_pi: Load generator sent %zu messages with %zu "
+                    "values, dropped %zu ticks",
+            m_load_generator->GetMessageCount(),
+            m_load_generator->GetValueCount(),
+            m_load_generator->GetDroppedTicks());
+        m_load_generator.reset();
+    }
+    m_recorder.Close();
+    m_trace_timer.Stop();
+    if (Tracer::IsEnabled()) {
+        Tracer::Stop();
+        LOG_VERBOSE("DashboardSK_pi: Trace finished, dropped %zu spans",
+            Tracer::GetDroppedCount());
+    }
     delete m_oDC;
     m_oDC = nullptr;
     delete m_dsk;
@@ -232,6 +252,63 @@ void dashboardsk_pi::LoadConfig()
         m_dsk->ReadConfig(config["dashboardsk"]);
     }
 }
+
+void dashboardsk_pi::SetupDeltaLog()
+{
+    wxString path;
+    if (wxGetEnv("DASHBOARDSK_RECORD", &path) && !path.IsEmpty()) {
+        wxString compress;
+        m_recorder.Open(path,
+            !wxGetEnv("DASHBOARDSK_RECORD_COMPRESS", &compress)
+                || compress != "0");
+    }
+    if (wxGetEnv("DASHBOARDSK_REPLAY", &path) && m_replayer.Open(path)) {
+        wxString speed;
+        double s;
+        if (wxGetEnv("DASHBOARDSK_REPLAY_SPEED", &speed)
+            && speed.ToCDouble(&s)) {
+            m_replayer.SetSpeed(s);
+        }
+        LOG_VERBOSE("DashboardSK_pi: Replaying " + path);
+        m_replay_timer.Bind(wxEVT_TIMER, &dashboardsk_pi::OnReplayTimer, this);
+        m_replay_timer.Start(REPLAY_INTERVAL_MS);
+    }
+    wxString profile;
+    if (wxGetEnv("DASHBOARDSK_LOADGEN", &profile)) {
+        m_load_generator
+            = std::make_unique<LoadGenerator>(load_profile::Parse(profile));
+        LOG_VERBOSE("DashboardSK_pi: Generating synthetic load " + profile);
+        m_load_timer.Bind(wxEVT_TIMER, &dashboardsk_pi::OnLoadTimer, this);
+        m_load_timer.Start(LOAD_INTERVAL_MS);
+    }
+    if (wxGetEnv("DASHBOARDSK_TRACE", &path) && !path.IsEmpty()
+        && Tracer::Start(path)) {
+        LOG_VERBOSE("DashboardSK_pi: Tracing to " + path);
+        m_trace_timer.Bind(wxEVT_TIMER, &dashboardsk_pi::OnTraceTimer, this);
+        m_trace_timer.Start(TRACE_FLUSH_INTERVAL_MS);
+    }
+}
+
+void dashboardsk_pi::OnReplayTimer(wxTimerEvent& event)
+{
+    if (m_dsk) {
+        m_replayer.Pump(*m_dsk, DeltaReplayer::clock::now());
+    }
+    if (!m_replayer.IsOpen()) {
+        LOG_VERBOSE("DashboardSK_pi: Replay finished");
+        m_replay_timer.Stop();
+    }
+}
+
+void dashboardsk_pi::OnLoadTimer(wxTimerEvent& event)
+{
+    if (m_dsk && m_load_generator) {
+        m_load_generator->Pump(*m_dsk, Clock::base_clock::now());
+    }
+}
+
+void dashboardsk_pi::OnTraceTimer(wxTimerEvent& event) { Tracer::Flush(); }
+
 void dashboardsk_pi::SaveConfig()
 {
     Json::Value config;
@@ -285,6 +362,7 @@ bool dashboardsk_pi::RenderOverlayMultiCanvas(
     }
 
     if (m_dsk) {
+        TraceSpan span("DC overlay", canvasIndex);
         m_dsk->Draw(m_oDC, vp, canvasIndex);
     }
 
@@ -332,6 +410,7 @@ bool dashboardsk_pi::RenderGLOverlayMultiCanvas(
     glEnable(GL_BLEND);
 
     if (m_dsk) {
+        TraceSpan span("GL overlay", canvasIndex);
         m_dsk->Draw(m_oDC, vp, canvasIndex);
     }
 
@@ -345,9 +424,17 @@ void dashboardsk_pi::SetPluginMessage(
             "_SIGNALK")) { // From the core application we receive
                            // "OCPN_CORE_SIGNALK", be prepared for other future
                            // sources following common naming convention
+        if (m_recorder.IsRecording()) {
+            m_recorder.Record(message_body);
+        }
         if (m_dsk) {
             Json::Value v;
-            if (ParseJSON(message_body, v)) {
+            bool parsed;
+            {
+                TraceSpan span("ParseJSON");
+                parsed = ParseJSON(message_body, v);
+            }
+            if (parsed) {
                 m_dsk->SendSKDelta(v);
             }
         }
@@ -78,7 +78,9 @@ MainConfigFrame::MainConfigFrame(wxWindow* parent, wxWindowID id,
 
     fgSizerDashboards->Add(0, 0, 1, wxEXPAND, 5);
 
-    fgSizerDashboards->Add(0, 0, 1, wxEXPAND, 5);
+    m_btnStats = new wxButton(
+        this, wxID_ANY, _("Statistics"), wxDefaultPosition, wxDefaultSize, 0);
+    fgSizerDashboards->Add(m_btnStats, 0, wxALIGN_CENTER_VERTICAL | wxALL, 5);
 
     m_btnRemoveDashboard = new wxButton(
         this, wxID_ANY, _("Remove"), wxDefaultPosition, wxDefaultSize, 0);
@@ -383,6 +385,9 @@ MainConfigFrame::MainConfigFrame(wxWindow* parent, wxWindowID id,
     m_btnNewDashboard->Connect(wxEVT_COMMAND_BUTTON_CLICKED,
         wxCommandEventHandler(MainConfigFrame::m_btnNewDashboardOnButtonClick),
         NULL, this);
+    m_btnStats->Connect(wxEVT_COMMAND_BUTTON_CLICKED,
+        wxCommandEventHandler(MainConfigFrame::m_btnStatsOnButtonClick), NULL,
+        this);
     m_btnRemoveDashboard->Connect(wxEVT_COMMAND_BUTTON_CLICKED,
         wxCommandEventHandler(
             MainConfigFrame::m_btnRemoveDashboardOnButtonClick),
@@ -464,6 +469,9 @@ MainConfigFrame::~MainConfigFrame()
     m_btnNewDashboard->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED,
         wxCommandEventHandler(MainConfigFrame::m_btnNewDashboardOnButtonClick),
         NULL, this);
+    m_btnStats->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED,
+        wxCommandEventHandler(MainConfigFrame::m_btnStatsOnButtonClick), NULL,
+        this);
     m_btnRemoveDashboard->Disconnect(wxEVT_COMMAND_BUTTON_CLICKED,
         wxCommandEventHandler(
             MainConfigFrame::m_btnRemoveDashboardOnButtonClick),
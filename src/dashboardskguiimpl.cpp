@@ -29,7 +29,10 @@
 #include "dashboardsk.h"
 #include "dashboardsk_pi.h"
 #include <wx/choicdlg.h>
+#include <wx/checkbox.h>
 #include <wx/dialog.h>
+#include <wx/filedlg.h>
+#include <wx/listctrl.h>
 #include <wx/msgdlg.h>
 #include <wx/sizer.h>
 #include <wx/stattext.h>
@@ -71,6 +74,135 @@ static void ShowSchemaErrorDialog(wxWindow* parent, const wxString& title,
     dlg.ShowModal();
 }
 
+/// Fill a report list with the rendering and update statistics of all the
+/// instruments
+///
+/// \param list The list to fill
+/// \param dsk The dashboards
+static void FillInstrumentStats(wxListCtrl* list, DashboardSK* dsk)
+{
+    list->DeleteAllItems();
+    const wxArrayString dashboards = dsk->GetDashboardNames();
+    long row = 0;
+    for (size_t d = 0; d < dashboards.size(); d++) {
+        Dashboard* dashboard = dsk->GetDashboard(static_cast<int>(d));
+        const wxArrayString instruments = dashboard->GetInstrumentNames();
+        for (size_t i = 0; i < instruments.size(); i++) {
+            const InstrumentStats& stats
+                = dashboard->GetInstrument(static_cast<int>(i))->GetStats();
+            list->InsertItem(row, dashboards[d]);
+            list->SetItem(row, 1, instruments[i]);
+            list->SetItem(
+                row, 2, wxString::Format("%zu", stats.GetRenderCount()));
+            list->SetItem(
+                row, 3, wxString::Format("%zu", stats.GetSkippedCount()));
+            list->SetItem(row, 4,
+                wxString::Format("%.2f", stats.GetMeanRenderTime() / 1000.0));
+            list->SetItem(row, 5,
+                wxString::Format("%.2f", stats.GetP99RenderTime() / 1000.0));
+            list->SetItem(
+                row, 6, wxString::Format("%zu", stats.GetBitmapBytes() / 1024));
+            list->SetItem(
+                row, 7, wxString::Format("%.1f", stats.GetNotificationRate()));
+            row++;
+        }
+    }
+}
+
+/// Show the rendering and update statistics of the instruments in a table
+///
+/// \param parent Parent window
+/// \param dsk The dashboards
+static void ShowInstrumentStatsDialog(wxWindow* parent, DashboardSK* dsk)
+{
+    wxDialog dlg(parent, wxID_ANY, _("Instrument statistics"),
+        wxDefaultPosition, wxDefaultSize,
+        wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER);
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    const int border = DskFromDIP(&dlg, 8);
+    auto* list = new wxListCtrl(
+        &dlg, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxLC_REPORT);
+    list->AppendColumn(_("Dashboard"));
+    list->AppendColumn(_("Instrument"));
+    list->AppendColumn(_("Renders"), wxLIST_FORMAT_RIGHT);
+    list->AppendColumn(_("Skipped"), wxLIST_FORMAT_RIGHT);
+    list->AppendColumn(_("Mean [ms]"), wxLIST_FORMAT_RIGHT);
+    list->AppendColumn(_("P99 [ms]"), wxLIST_FORMAT_RIGHT);
+    list->AppendColumn(_("Bitmap [kB]"), wxLIST_FORMAT_RIGHT);
+    list->AppendColumn(_("Updates/s"), wxLIST_FORMAT_RIGHT);
+    FillInstrumentStats(list, dsk);
+    sizer->Add(list, 1, wxEXPAND | wxALL, border);
+    auto* buttons = new wxBoxSizer(wxHORIZONTAL);
+    auto* hud = new wxCheckBox(&dlg, wxID_ANY, _("Show on the chart"));
+    hud->SetValue(dsk->GetShowStats());
+    hud->Bind(wxEVT_CHECKBOX,
+        [dsk](wxCommandEvent& event) { dsk->SetShowStats(event.IsChecked()); });
+    buttons->Add(hud, 0, wxALIGN_CENTER_VERTICAL | wxRIGHT, border);
+    auto* refresh = new wxButton(&dlg, wxID_ANY, _("Refresh"));
+    refresh->Bind(wxEVT_BUTTON,
+        [list, dsk](wxCommandEvent&) { FillInstrumentStats(list, dsk); });
+    buttons->Add(refresh, 0, wxRIGHT, border);
+    auto* reset = new wxButton(&dlg, wxID_ANY, _("Reset"));
+    reset->Bind(wxEVT_BUTTON, [list, dsk](wxCommandEvent&) {
+        dsk->ResetStats();
+        FillInstrumentStats(list, dsk);
+    });
+    buttons->Add(reset, 0, wxRIGHT, border);
+    buttons->AddStretchSpacer();
+    buttons->Add(dlg.CreateButtonSizer(wxOK));
+    sizer->Add(buttons, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, border);
+    dlg.SetSizer(sizer);
+    dlg.SetMinSize(DskFromDIP(&dlg, wxSize(480, 240)));
+    dlg.SetSize(DskFromDIP(&dlg, wxSize(760, 400)));
+    dlg.CentreOnParent();
+    dlg.ShowModal();
+}
+
+/// Show the estimated memory use of the data, histories and cached bitmaps
+///
+/// \param parent Parent window
+/// \param dsk The dashboards
+static void ShowMemoryReportDialog(wxWindow* parent, DashboardSK* dsk)
+{
+    wxDialog dlg(parent, wxID_ANY, _("Memory usage"), wxDefaultPosition,
+        wxDefaultSize, wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER);
+    auto* sizer = new wxBoxSizer(wxVERTICAL);
+    const int border = DskFromDIP(&dlg, 8);
+    auto* text = new wxTextCtrl(&dlg, wxID_ANY,
+        dsk->GetMemoryReport().ToString(), wxDefaultPosition, wxDefaultSize,
+        wxTE_MULTILINE | wxTE_READONLY | wxTE_DONTWRAP);
+    text->SetFont(wxFont(wxFontInfo().Family(wxFONTFAMILY_TELETYPE)));
+    sizer->Add(text, 1, wxEXPAND | wxALL, border);
+    auto* buttons = new wxBoxSizer(wxHORIZONTAL);
+    auto* refresh = new wxButton(&dlg, wxID_ANY, _("Refresh"));
+    refresh->Bind(wxEVT_BUTTON, [text, dsk](wxCommandEvent&) {
+        text->SetValue(dsk->GetMemoryReport().ToString());
+    });
+    buttons->Add(refresh, 0, wxRIGHT, border);
+    auto* save = new wxButton(&dlg, wxID_ANY, _("Save..."));
+    save->Bind(wxEVT_BUTTON, [&dlg, dsk](wxCommandEvent&) {
+        wxFileDialog fdlg(&dlg, _("Save memory report to file"), "",
+            "dashboardsk_memory.txt", "Text files (*.txt)|*.txt",
+            wxFD_SAVE | wxFD_OVERWRITE_PROMPT);
+        if (fdlg.ShowModal() == wxID_OK
+            && !dsk->GetMemoryReport().Save(fdlg.GetPath())) {
+            wxMessageBox(
+                wxString::Format(_("The file %s could not be written."),
+                    fdlg.GetPath().c_str()),
+                _("Error"), wxOK | wxICON_ERROR);
+        }
+    });
+    buttons->Add(save, 0, wxRIGHT, border);
+    buttons->AddStretchSpacer();
+    buttons->Add(dlg.CreateButtonSizer(wxOK));
+    sizer->Add(buttons, 0, wxEXPAND | wxLEFT | wxRIGHT | wxBOTTOM, border);
+    dlg.SetSizer(sizer);
+    dlg.SetMinSize(DskFromDIP(&dlg, wxSize(400, 240)));
+    dlg.SetSize(DskFromDIP(&dlg, wxSize(700, 500)));
+    dlg.CentreOnParent();
+    dlg.ShowModal();
+}
+
 //====================================
 // MainConfigFrameImpl
 //====================================
@@ -818,6 +950,11 @@ void MainConfigFrameImpl::m_btnSignalKOnButtonClick(wxCommandEvent& event)
     });
 }
 
+void MainConfigFrameImpl::m_btnStatsOnButtonClick(wxCommandEvent& event)
+{
+    ShowInstrumentStatsDialog(this, m_dsk_pi->GetDSK());
+}
+
 void MainConfigFrameImpl::m_cbEnabledOnCheckBox(wxCommandEvent& event)
 {
     UpdateEditedDashboard();
@@ -1115,6 +1252,12 @@ SKDataTreeImpl::SKDataTreeImpl(wxWindow* parent)
 void SKDataTreeImpl::SetCodeSKTree(DashboardSK* dsk)
 {
     m_sdbSizerBtnsCancel->Hide();
+    auto* memory = new wxButton(this, wxID_ANY, _("Memory usage..."));
+    memory->Bind(wxEVT_BUTTON,
+        [this, dsk](wxCommandEvent&) { ShowMemoryReportDialog(this, dsk); });
+    m_sdbSizerBtns->Insert(0, memory, 0, wxALL, DskFromDIP(this, 5));
+    m_sdbSizerBtns->InsertStretchSpacer(1);
+    Layout();
 #if !__WXQT__
     m_scintillaCode->SetReadOnly(false);
     m_scintillaCode->SetText(dsk->GetSignalKTreeText());
@@ -1180,12 +1323,17 @@ wxString SKPathBrowserImpl::GetSKPath()
         path.Append(".SRC:lockfirst");
     } else if (m_source_mode == "lockpersist") {
         path.Append(".SRC:lockpersist");
-    } else if (m_source_mode == "specific"
-        && m_choiceSources->GetSelection() != wxNOT_FOUND) {
-        wxString selected_source = m_choiceSources->GetStringSelection();
-        if (!selected_source.IsEmpty()) {
-            path.Append(".SRC:").Append(selected_source);
+    } else if (m_source_mode == "specific") {
+        if (m_choiceSources->GetSelection() != wxNOT_FOUND) {
+            wxString selected_source = m_choiceSources->GetStringSelection();
+            if (!selected_source.IsEmpty()) {
+                path.Append(".SRC:").Append(selected_source);
+            }
         }
+    } else if (!m_source_mode.IsEmpty()) {
+        // Designations without a radio button (priority list, freshest) are
+        // kept as they were configured
+        path.Append(".SRC:").Append(m_source_mode);
     }
 
     return path;
@@ -1268,6 +1416,8 @@ void SKPathBrowserImpl::SetInitialPath(const wxString& path)
             source_mode = "lockfirst";
         } else if (src_part == "lockpersist") {
             source_mode = "lockpersist";
+        } else if (src_part == "freshest" || src_part.StartsWith("priority(")) {
+            source_mode = src_part;
         } else {
             source_mode = "specific";
             selected_source = src_part;
@@ -1328,6 +1478,13 @@ void SKPathBrowserImpl::SetInitialPath(const wxString& path)
         m_rbLockFirst->SetValue(false);
         m_source_mode = "lockpersist";
         m_choiceSources->Enable(false);
+    } else if (source_mode != "specific") {
+        m_rbSpecific->SetValue(false);
+        m_rbAny->SetValue(false);
+        m_rbLockFirst->SetValue(false);
+        m_rbLockPersist->SetValue(false);
+        m_source_mode = source_mode;
+        m_choiceSources->Enable(false);
     } else {
         // Specific mode - dropdown should already be populated by tree
         // selection handler
@@ -0,0 +1,256 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "deltalog.h"
+#include "dashboardsk.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Map a signed value to an unsigned one keeping small magnitudes small
+static uint64_t ZigZag(int64_t val)
+{
+    return (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+}
+
+/// Inverse of #ZigZag
+static int64_t UnZigZag(uint64_t val)
+{
+    return static_cast<int64_t>(val >> 1) ^ -static_cast<int64_t>(val & 1);
+}
+
+void DeltaRecorder::WriteVarint(uint64_t val)
+{
+    uint8_t buf[10];
+    size_t len = 0;
+    do {
+        buf[len] = val & 0x7f;
+        val >>= 7;
+        if (val) {
+            buf[len] |= 0x80;
+        }
+        len++;
+    } while (val);
+    m_out->Write(buf, len);
+}
+
+bool DeltaRecorder::Open(const wxString& path, bool compress)
+{
+    Close();
+    m_file = std::make_unique<wxFileOutputStream>(path);
+    if (!m_file->IsOk()) {
+        LOG_INFO("DashboardSK_pi: Can't create delta log " + path);
+        m_file.reset();
+        return false;
+    }
+    const uint8_t header[] = { DeltaLog::VERSION,
+        static_cast<uint8_t>(compress ? DeltaLog::COMPRESSED : 0) };
+    m_file->Write(DeltaLog::MAGIC, DeltaLog::MAGIC_LEN);
+    m_file->Write(header, sizeof(header));
+    if (compress) {
+        m_zlib = std::make_unique<wxZlibOutputStream>(
+            *m_file, -1, wxZLIB_ZLIB);
+        m_out = m_zlib.get();
+    } else {
+        m_out = m_file.get();
+    }
+    m_last_timestamp = 0;
+    m_count = 0;
+    LOG_VERBOSE("DashboardSK_pi: Recording SignalK deltas to " + path);
+    return true;
+}
+
+void DeltaRecorder::Close()
+{
+    if (!m_out) {
+        return;
+    }
+    if (m_zlib) {
+        m_zlib->Close();
+        m_zlib.reset();
+    }
+    m_file->Close();
+    m_file.reset();
+    m_out = nullptr;
+}
+
+void DeltaRecorder::Record(const wxString& message, int64_t timestamp)
+{
+    if (!m_out) {
+        return;
+    }
+    const std::string s = DSK_TO_STDSTRING_UTF8(message);
+    WriteVarint(ZigZag(timestamp - m_last_timestamp));
+    WriteVarint(s.size());
+    m_out->Write(s.data(), s.size());
+    m_last_timestamp = timestamp;
+    m_count++;
+    if (!m_out->IsOk()) {
+        LOG_INFO("DashboardSK_pi: Writing the delta log failed, stopping");
+        Close();
+    }
+}
+
+bool DeltaReplayer::Open(const wxString& path)
+{
+    Close();
+    m_file = std::make_unique<wxFileInputStream>(path);
+    char magic[DeltaLog::MAGIC_LEN];
+    uint8_t header[2];
+    if (!m_file->IsOk()
+        || m_file->Read(magic, sizeof(magic)).LastRead() != sizeof(magic)
+        || memcmp(magic, DeltaLog::MAGIC, sizeof(magic)) != 0
+        || m_file->Read(header, sizeof(header)).LastRead() != sizeof(header)
+        || header[0] != DeltaLog::VERSION) {
+        LOG_INFO("DashboardSK_pi: " + path + " is not a delta log");
+        m_file.reset();
+        return false;
+    }
+    if (header[1] & DeltaLog::COMPRESSED) {
+        m_zlib = std::make_unique<wxZlibInputStream>(*m_file, wxZLIB_ZLIB);
+        m_in = m_zlib.get();
+    } else {
+        m_in = m_file.get();
+    }
+    return true;
+}
+
+void DeltaReplayer::Close()
+{
+    m_in = nullptr;
+    m_zlib.reset();
+    m_file.reset();
+    m_last_timestamp = 0;
+    m_has_next = false;
+    m_started = false;
+}
+
+bool DeltaReplayer::ReadByte(uint8_t& b)
+{
+    return m_in->Read(&b, 1).LastRead() == 1;
+}
+
+bool DeltaReplayer::ReadVarint(uint64_t& val)
+{
+    val = 0;
+    uint8_t b;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (!ReadByte(b)) {
+            return false;
+        }
+        val |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DeltaReplayer::Next(delta_record& rec)
+{
+    if (!m_in) {
+        return false;
+    }
+    uint64_t diff;
+    uint64_t len;
+    if (!ReadVarint(diff) || !ReadVarint(len)
+        || len > DeltaLog::MAX_MESSAGE_LEN) {
+        // End of the log, or a truncated one if the recording was not
+        // finished properly
+        m_in = nullptr;
+        return false;
+    }
+    std::vector<char> buf(len);
+    if (len > 0 && m_in->Read(buf.data(), len).LastRead() != len) {
+        m_in = nullptr;
+        return false;
+    }
+    m_last_timestamp += UnZigZag(diff);
+    rec.timestamp = m_last_timestamp;
+    rec.message = wxString::FromUTF8(buf.data(), len);
+    return true;
+}
+
+DeltaReplayer::clock::time_point DeltaReplayer::Due(
+    const delta_record& rec) const
+{
+    return m_start
+        + std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double, std::milli>(
+                (rec.timestamp - m_first_timestamp) / m_speed));
+}
+
+size_t DeltaReplayer::Pump(DashboardSK& dsk, clock::time_point now)
+{
+    size_t sent = 0;
+    while (sent < MAX_BATCH) {
+        if (!m_has_next) {
+            if (!Next(m_next)) {
+                break;
+            }
+            m_has_next = true;
+        }
+        if (!m_started) {
+            m_started = true;
+            m_start = now;
+            m_first_timestamp = m_next.timestamp;
+        }
+        if (m_speed > 0.0 && Due(m_next) > now) {
+            break;
+        }
+        if (m_clock) {
+            m_clock->Set(Clock::time_point(
+                std::chrono::milliseconds(m_next.timestamp)));
+        }
+        Json::Value v;
+        if (ParseJSON(m_next.message, v)) {
+            dsk.SendSKDelta(v);
+        }
+        if (m_clock) {
+            dsk.ProcessData();
+        }
+        m_has_next = false;
+        sent++;
+    }
+    return sent;
+}
+
+size_t DeltaReplayer::Replay(DashboardSK& dsk)
+{
+    size_t sent = 0;
+    while (IsOpen()) {
+        sent += Pump(dsk, clock::now());
+        if (m_has_next && m_speed > 0.0) {
+            std::this_thread::sleep_until(Due(m_next));
+        }
+    }
+    return sent;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,208 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "derivedengine.h"
+#include "dashboardsk.h"
+
+#include <cmath>
+
+PLUGIN_BEGIN_NAMESPACE
+
+DerivedEngine::DerivedEngine(reader_t reader)
+    : m_reader(std::move(reader))
+{
+    RegisterBuiltins();
+}
+
+void DerivedEngine::TrueWind(
+    double awa, double aws, double stw, double& twa, double& tws)
+{
+    // Components of the wind along and across the bow
+    const double along = aws * cos(awa) - stw;
+    const double across = aws * sin(awa);
+    twa = atan2(across, along);
+    tws = sqrt(along * along + across * across);
+}
+
+void DerivedEngine::Current(double cog, double sog, double hdg, double stw,
+    double& set, double& drift)
+{
+    const double east = sog * sin(cog) - stw * sin(hdg);
+    const double north = sog * cos(cog) - stw * cos(hdg);
+    set = atan2(east, north);
+    if (set < 0.0) {
+        set += 2.0 * M_PI;
+    }
+    drift = sqrt(east * east + north * north);
+}
+
+void DerivedEngine::RegisterBuiltins()
+{
+    const wxString awa("environment.wind.angleApparent");
+    const wxString aws("environment.wind.speedApparent");
+    const wxString stw("navigation.speedThroughWater");
+    const wxString hdg("navigation.headingTrue");
+    const wxString cog("navigation.courseOverGroundTrue");
+    const wxString sog("navigation.speedOverGround");
+    const wxString twa(DERIVED_PATH_PREFIX "environment.wind.angleTrueWater");
+
+    Register(twa, { awa, aws, stw }, [](const vector<double>& in, double& out) {
+        double tws;
+        TrueWind(in[0], in[1], in[2], out, tws);
+        return true;
+    });
+    Register(DERIVED_PATH_PREFIX "environment.wind.speedTrue",
+        { awa, aws, stw }, [](const vector<double>& in, double& out) {
+            double angle;
+            TrueWind(in[0], in[1], in[2], angle, out);
+            return true;
+        });
+    Register(DERIVED_PATH_PREFIX "environment.wind.directionTrue",
+        { awa, aws, stw, hdg }, [](const vector<double>& in, double& out) {
+            double angle;
+            double speed;
+            TrueWind(in[0], in[1], in[2], angle, speed);
+            out = fmod(in[3] + angle, 2.0 * M_PI);
+            if (out < 0.0) {
+                out += 2.0 * M_PI;
+            }
+            return true;
+        });
+    // Chained on the derived true wind angle
+    Register(DERIVED_PATH_PREFIX "performance.velocityMadeGood", { stw, twa },
+        [](const vector<double>& in, double& out) {
+            out = in[0] * cos(in[1]);
+            return true;
+        });
+    Register(DERIVED_PATH_PREFIX "environment.current.setTrue",
+        { cog, sog, hdg, stw }, [](const vector<double>& in, double& out) {
+            double drift;
+            Current(in[0], in[1], in[2], in[3], out, drift);
+            return true;
+        });
+    Register(DERIVED_PATH_PREFIX "environment.current.drift",
+        { cog, sog, hdg, stw }, [](const vector<double>& in, double& out) {
+            double set;
+            Current(in[0], in[1], in[2], in[3], set, out);
+            return true;
+        });
+}
+
+void DerivedEngine::Register(const wxString& path,
+    const vector<wxString>& inputs, const compute_t& compute)
+{
+    derivation d;
+    d.path = path;
+    d.inputs = inputs;
+    d.compute = compute;
+    m_derivations.push_back(std::move(d));
+    Rebuild();
+}
+
+void DerivedEngine::SetContext(const wxString& context)
+{
+    if (context.IsSameAs(m_context)) {
+        return;
+    }
+    m_context = context;
+    Rebuild();
+}
+
+void DerivedEngine::Rebuild()
+{
+    m_by_input.clear();
+    for (auto& d : m_derivations) {
+        d.reads.clear();
+    }
+    if (m_context.IsEmpty()) {
+        return;
+    }
+    for (size_t i = 0; i < m_derivations.size(); i++) {
+        derivation& d = m_derivations[i];
+        for (const auto& input : d.inputs) {
+            const int src = input.Find("." SRC_MAGIC_STRING);
+            if (src == wxNOT_FOUND) {
+                d.reads.push_back(
+                    m_context + "." + input + "." SRC_MAGIC_STRING "any");
+                m_by_input[UNORDERED_KEY(m_context + "." + input)].push_back(i);
+            } else {
+                d.reads.push_back(m_context + "." + input);
+                m_by_input[UNORDERED_KEY(m_context + "." + input.Left(src))]
+                    .push_back(i);
+            }
+        }
+    }
+}
+
+void DerivedEngine::Update(const path_key_t& key)
+{
+    auto it = m_by_input.find(key);
+    if (it == m_by_input.end()) {
+        return;
+    }
+    for (size_t i : it->second) {
+        if (!m_derivations[i].dirty) {
+            m_derivations[i].dirty = true;
+            m_dirty.push_back(i);
+        }
+    }
+}
+
+Json::Value DerivedEngine::Compute()
+{
+    Json::Value values(Json::arrayValue);
+    vector<size_t> dirty;
+    dirty.swap(m_dirty);
+    vector<double> in;
+    for (size_t i : dirty) {
+        derivation& d = m_derivations[i];
+        d.dirty = false;
+        in.clear();
+        for (const auto& read : d.reads) {
+            const Json::Value* node = m_reader(read);
+            if (!node) {
+                break;
+            }
+            const Json::Value& value = node->get("value", *node);
+            if (!value.isNumeric()) {
+                break;
+            }
+            in.push_back(value.asDouble());
+        }
+        double out;
+        if (in.size() < d.inputs.size() || !d.compute(in, out)
+            || !std::isfinite(out)) {
+            continue;
+        }
+        Json::Value v;
+        v["path"] = d.path.ToStdString();
+        v["value"] = out;
+        values.append(v);
+    }
+    return values;
+}
+
+PLUGIN_END_NAMESPACE
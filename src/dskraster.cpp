@@ -0,0 +1,540 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "dskraster.h"
+#include "fontcache.h"
+
+#include <algorithm>
+#include <cmath>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Coverage of a pixel by a shape given the signed distance of the pixel
+/// center from the shape edge (negative inside)
+static inline double EdgeCoverage(double distance)
+{
+    return std::min(1.0, std::max(0.0, 0.5 - distance));
+}
+
+/// Coverage of a point relative to the center by a sector spanning
+/// counterclockwise from \c start to \c end (screen orientation)
+static double SectorCoverage(double dx, double dy, double start, double end)
+{
+    double sweep = fmod(end - start, 2 * PI);
+    if (sweep < 0) {
+        sweep += 2 * PI;
+    }
+    if (sweep < 1e-9) {
+        return 1.0;
+    }
+    // Work in the mathematical orientation with the vertical axis pointing up
+    const double px = dx;
+    const double py = -dy;
+    // Distance to the start ray, positive on its counterclockwise side
+    const double s1 = cos(start) * py - sin(start) * px;
+    // Distance to the end ray, positive on its clockwise side
+    const double s2 = px * sin(end) - py * cos(end);
+    const double c1 = EdgeCoverage(-s1);
+    const double c2 = EdgeCoverage(-s2);
+    return sweep <= PI ? std::min(c1, c2) : std::max(c1, c2);
+}
+
+RasterImage::RasterImage(int width, int height)
+    : m_width(wxMax(0, width))
+    , m_height(wxMax(0, height))
+    , m_pixels(static_cast<size_t>(m_width) * m_height * 4, 0)
+{
+}
+
+void RasterImage::Blend(int x, int y, const raster_color& c, double coverage)
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return;
+    }
+    const double sa = c.a / 255.0 * coverage;
+    if (sa <= 0.0) {
+        return;
+    }
+    uint8_t* p = &m_pixels[(static_cast<size_t>(y) * m_width + x) * 4];
+    const double da = p[3] / 255.0;
+    const double oa = sa + da * (1.0 - sa);
+    p[0] = static_cast<uint8_t>(
+        lround((c.r * sa + p[0] * da * (1.0 - sa)) / oa));
+    p[1] = static_cast<uint8_t>(
+        lround((c.g * sa + p[1] * da * (1.0 - sa)) / oa));
+    p[2] = static_cast<uint8_t>(
+        lround((c.b * sa + p[2] * da * (1.0 - sa)) / oa));
+    p[3] = static_cast<uint8_t>(lround(oa * 255.0));
+}
+
+raster_color RasterImage::GetPixel(int x, int y) const
+{
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+        return { 0, 0, 0, 0 };
+    }
+    const uint8_t* p = &m_pixels[(static_cast<size_t>(y) * m_width + x) * 4];
+    return { p[0], p[1], p[2], p[3] };
+}
+
+void RasterImage::Clear(const raster_color& c)
+{
+    for (size_t i = 0; i < m_pixels.size(); i += 4) {
+        m_pixels[i] = c.r;
+        m_pixels[i + 1] = c.g;
+        m_pixels[i + 2] = c.b;
+        m_pixels[i + 3] = c.a;
+    }
+}
+
+void RasterImage::FillRect(
+    double x, double y, double w, double h, const raster_color& c)
+{
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    const int x0 = wxMax(0, static_cast<int>(floor(x)));
+    const int y0 = wxMax(0, static_cast<int>(floor(y)));
+    const int x1 = wxMin(m_width, static_cast<int>(ceil(x + w)));
+    const int y1 = wxMin(m_height, static_cast<int>(ceil(y + h)));
+    for (int py = y0; py < y1; ++py) {
+        const double cy
+            = std::min<double>(py + 1, y + h) - std::max<double>(py, y);
+        for (int px = x0; px < x1; ++px) {
+            const double cx
+                = std::min<double>(px + 1, x + w) - std::max<double>(px, x);
+            Blend(px, py, c, cx * cy);
+        }
+    }
+}
+
+void RasterImage::FillCircle(
+    double xc, double yc, double r, const raster_color& c)
+{
+    FillSector(xc, yc, r, 0.0, 0.0, c);
+}
+
+void RasterImage::StrokeCircle(
+    double xc, double yc, double r, double width, const raster_color& c)
+{
+    const double reach = r + width / 2 + 1;
+    const int x0 = wxMax(0, static_cast<int>(floor(xc - reach)));
+    const int y0 = wxMax(0, static_cast<int>(floor(yc - reach)));
+    const int x1 = wxMin(m_width, static_cast<int>(ceil(xc + reach)));
+    const int y1 = wxMin(m_height, static_cast<int>(ceil(yc + reach)));
+    for (int py = y0; py < y1; ++py) {
+        for (int px = x0; px < x1; ++px) {
+            const double d = hypot(px + 0.5 - xc, py + 0.5 - yc);
+            const double cov = EdgeCoverage(fabs(d - r) - width / 2);
+            if (cov > 0.0) {
+                Blend(px, py, c, cov);
+            }
+        }
+    }
+}
+
+void RasterImage::FillSector(double xc, double yc, double r, double start,
+    double end, const raster_color& c)
+{
+    const double reach = r + 1;
+    const int x0 = wxMax(0, static_cast<int>(floor(xc - reach)));
+    const int y0 = wxMax(0, static_cast<int>(floor(yc - reach)));
+    const int x1 = wxMin(m_width, static_cast<int>(ceil(xc + reach)));
+    const int y1 = wxMin(m_height, static_cast<int>(ceil(yc + reach)));
+    for (int py = y0; py < y1; ++py) {
+        for (int px = x0; px < x1; ++px) {
+            const double dx = px + 0.5 - xc;
+            const double dy = py + 0.5 - yc;
+            double cov = EdgeCoverage(hypot(dx, dy) - r);
+            if (cov > 0.0) {
+                cov = std::min(cov, SectorCoverage(dx, dy, start, end));
+            }
+            if (cov > 0.0) {
+                Blend(px, py, c, cov);
+            }
+        }
+    }
+}
+
+void RasterImage::StrokeLine(double x0, double y0, double x1, double y1,
+    double width, const raster_color& c)
+{
+    const double reach = width / 2 + 1;
+    const int bx0
+        = wxMax(0, static_cast<int>(floor(std::min(x0, x1) - reach)));
+    const int by0
+        = wxMax(0, static_cast<int>(floor(std::min(y0, y1) - reach)));
+    const int bx1
+        = wxMin(m_width, static_cast<int>(ceil(std::max(x0, x1) + reach)));
+    const int by1
+        = wxMin(m_height, static_cast<int>(ceil(std::max(y0, y1) + reach)));
+    const double vx = x1 - x0;
+    const double vy = y1 - y0;
+    const double len2 = vx * vx + vy * vy;
+    for (int py = by0; py < by1; ++py) {
+        for (int px = bx0; px < bx1; ++px) {
+            const double wx = px + 0.5 - x0;
+            const double wy = py + 0.5 - y0;
+            double t = len2 > 0 ? (wx * vx + wy * vy) / len2 : 0.0;
+            t = std::min(1.0, std::max(0.0, t));
+            const double d = hypot(wx - t * vx, wy - t * vy);
+            const double cov = EdgeCoverage(d - width / 2);
+            if (cov > 0.0) {
+                Blend(px, py, c, cov);
+            }
+        }
+    }
+}
+
+void RasterImage::FillConvexPolygon(
+    const double* xs, const double* ys, size_t n, const raster_color& c)
+{
+    if (n < 3) {
+        return;
+    }
+    double area = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t j = (i + 1) % n;
+        area += xs[i] * ys[j] - xs[j] * ys[i];
+    }
+    if (fabs(area) < 1e-9) {
+        return;
+    }
+    const double orientation = area > 0 ? 1.0 : -1.0;
+    const int x0
+        = wxMax(0, static_cast<int>(floor(*std::min_element(xs, xs + n))));
+    const int y0
+        = wxMax(0, static_cast<int>(floor(*std::min_element(ys, ys + n))));
+    const int x1 = wxMin(
+        m_width, static_cast<int>(ceil(*std::max_element(xs, xs + n))) + 1);
+    const int y1 = wxMin(
+        m_height, static_cast<int>(ceil(*std::max_element(ys, ys + n))) + 1);
+    for (int py = y0; py < y1; ++py) {
+        for (int px = x0; px < x1; ++px) {
+            double cov = 1.0;
+            for (size_t i = 0; i < n && cov > 0.0; ++i) {
+                const size_t j = (i + 1) % n;
+                const double ex = xs[j] - xs[i];
+                const double ey = ys[j] - ys[i];
+                const double len = hypot(ex, ey);
+                if (len < 1e-9) {
+                    continue;
+                }
+                // Signed distance from the edge, positive inside
+                const double d = orientation
+                    * (ex * (py + 0.5 - ys[i]) - ey * (px + 0.5 - xs[i])) / len;
+                cov = std::min(cov, EdgeCoverage(-d));
+            }
+            if (cov > 0.0) {
+                Blend(px, py, c, cov);
+            }
+        }
+    }
+}
+
+void RasterImage::DrawMask(
+    const raster_mask& mask, int x, int y, const raster_color& c)
+{
+    for (int my = 0; my < mask.height; ++my) {
+        for (int mx = 0; mx < mask.width; ++mx) {
+            const uint8_t cov
+                = mask.coverage[static_cast<size_t>(my) * mask.width + mx];
+            if (cov > 0) {
+                Blend(x + mx, y + my, c, cov / 255.0);
+            }
+        }
+    }
+}
+
+dskRasterDC::dskRasterDC(int width, int height, FontCache& fonts)
+    : m_width(width)
+    , m_height(height)
+    , m_fonts(fonts)
+    , m_pen(*wxBLACK_PEN)
+    , m_brush(*wxWHITE_BRUSH)
+    , m_background(*wxTRANSPARENT_BRUSH)
+    , m_font(*wxNORMAL_FONT)
+    , m_text_color(*wxBLACK)
+    , m_image(0, 0)
+{
+}
+
+raster_color dskRasterDC::ToRaster(const wxColour& c)
+{
+    if (!c.IsOk()) {
+        return { 0, 0, 0, 0 };
+    }
+    return { c.Red(), c.Green(), c.Blue(), c.Alpha() };
+}
+
+bool dskRasterDC::HasPen() const
+{
+    return m_pen.IsOk() && m_pen.GetStyle() != wxPENSTYLE_TRANSPARENT
+        && m_pen.GetColour().Alpha() > 0;
+}
+
+bool dskRasterDC::HasBrush() const
+{
+    return m_brush.IsOk() && m_brush.GetStyle() != wxBRUSHSTYLE_TRANSPARENT
+        && m_brush.GetColour().Alpha() > 0;
+}
+
+double dskRasterDC::PenWidth() const { return wxMax(1, m_pen.GetWidth()); }
+
+void dskRasterDC::Clear()
+{
+    op o {};
+    o.type = op_type::clear;
+    if (m_background.IsOk()
+        && m_background.GetStyle() != wxBRUSHSTYLE_TRANSPARENT) {
+        o.color = ToRaster(m_background.GetColour());
+    }
+    // Clearing discards everything drawn so far
+    m_ops.clear();
+    m_poly_x.clear();
+    m_poly_y.clear();
+    m_masks.clear();
+    m_ops.push_back(o);
+}
+
+void dskRasterDC::DrawRectangle(wxCoord x, wxCoord y, wxCoord w, wxCoord h)
+{
+    if (HasBrush()) {
+        m_ops.push_back({ op_type::fill_rect, ToRaster(m_brush.GetColour()),
+            { double(x), double(y), double(w), double(h) }, 0, 0 });
+    }
+    if (HasPen()) {
+        // The outline is centered on the rectangle edges
+        const raster_color c = ToRaster(m_pen.GetColour());
+        const double pw = PenWidth();
+        const double l = x - pw / 2;
+        const double t = y - pw / 2;
+        m_ops.push_back({ op_type::fill_rect, c, { l, t, w + pw, pw }, 0, 0 });
+        m_ops.push_back(
+            { op_type::fill_rect, c, { l, t + h, w + pw, pw }, 0, 0 });
+        m_ops.push_back({ op_type::fill_rect, c, { l, t + pw, pw, h - pw }, 0,
+            0 });
+        m_ops.push_back({ op_type::fill_rect, c, { l + w, t + pw, pw, h - pw },
+            0, 0 });
+    }
+}
+
+void dskRasterDC::DrawCircle(wxCoord x, wxCoord y, wxCoord r)
+{
+    if (HasBrush()) {
+        m_ops.push_back({ op_type::fill_circle, ToRaster(m_brush.GetColour()),
+            { double(x), double(y), double(r) }, 0, 0 });
+    }
+    if (HasPen()) {
+        m_ops.push_back({ op_type::stroke_circle, ToRaster(m_pen.GetColour()),
+            { double(x), double(y), double(r), PenWidth() }, 0, 0 });
+    }
+}
+
+void dskRasterDC::DrawArc(wxCoord xStart, wxCoord yStart, wxCoord xEnd,
+    wxCoord yEnd, wxCoord xc, wxCoord yc)
+{
+    const double r = hypot(xStart - xc, yStart - yc);
+    const double start = atan2(-double(yStart - yc), double(xStart - xc));
+    const double end = atan2(-double(yEnd - yc), double(xEnd - xc));
+    const double pw = HasPen() ? PenWidth() : 0.0;
+    if (HasPen()) {
+        // The pen is centered on the rim, the brush fills the rest
+        m_ops.push_back({ op_type::fill_sector, ToRaster(m_pen.GetColour()),
+            { double(xc), double(yc), r + pw / 2, start, end }, 0, 0 });
+    }
+    if (HasBrush()) {
+        m_ops.push_back({ op_type::fill_sector, ToRaster(m_brush.GetColour()),
+            { double(xc), double(yc), r - pw / 2, start, end }, 0, 0 });
+    }
+    if (HasPen() && (xStart != xEnd || yStart != yEnd)) {
+        DrawLine(xc, yc, xStart, yStart);
+        DrawLine(xc, yc, xEnd, yEnd);
+    }
+}
+
+void dskRasterDC::DrawLine(wxCoord x1, wxCoord y1, wxCoord x2, wxCoord y2)
+{
+    if (!HasPen()) {
+        return;
+    }
+    m_ops.push_back({ op_type::stroke_line, ToRaster(m_pen.GetColour()),
+        { double(x1), double(y1), double(x2), double(y2), PenWidth() }, 0, 0 });
+}
+
+void dskRasterDC::DrawPolygon(
+    int n, const wxPoint points[], wxCoord xoffset, wxCoord yoffset)
+{
+    if (n < 2) {
+        return;
+    }
+    if (HasBrush() && n > 2) {
+        op o { op_type::fill_polygon, ToRaster(m_brush.GetColour()), {},
+            m_poly_x.size(), static_cast<size_t>(n) };
+        for (int i = 0; i < n; ++i) {
+            m_poly_x.push_back(points[i].x + xoffset);
+            m_poly_y.push_back(points[i].y + yoffset);
+        }
+        m_ops.push_back(o);
+    }
+    if (HasPen()) {
+        for (int i = 0; i < n; ++i) {
+            const wxPoint& a = points[i];
+            const wxPoint& b = points[(i + 1) % n];
+            DrawLine(
+                a.x + xoffset, a.y + yoffset, b.x + xoffset, b.y + yoffset);
+        }
+    }
+}
+
+void dskRasterDC::RecordText(
+    const wxString& text, wxCoord x, wxCoord y, double angle)
+{
+    if (text.IsEmpty() || !m_text_color.IsOk()) {
+        return;
+    }
+    std::shared_ptr<const text_mask> mask
+        = m_fonts.GetTextMask(m_font, text, angle);
+    if (!mask) {
+        return;
+    }
+    m_ops.push_back({ op_type::mask, ToRaster(m_text_color),
+        { double(x + mask->left), double(y + mask->top) }, m_masks.size(),
+        0 });
+    m_masks.emplace_back(std::move(mask));
+}
+
+void dskRasterDC::DrawText(const wxString& text, wxCoord x, wxCoord y)
+{
+    RecordText(text, x, y, 0.0);
+}
+
+void dskRasterDC::DrawRotatedText(
+    const wxString& text, wxCoord x, wxCoord y, double angle)
+{
+    RecordText(text, x, y, angle);
+}
+
+void dskRasterDC::DrawLabel(
+    const wxString& text, const wxRect& rect, int alignment)
+{
+    const wxSize ext = GetTextExtent(text);
+    wxCoord x = rect.GetX();
+    wxCoord y = rect.GetY();
+    if (alignment & wxALIGN_CENTER_HORIZONTAL) {
+        x += (rect.GetWidth() - ext.GetWidth()) / 2;
+    } else if (alignment & wxALIGN_RIGHT) {
+        x += rect.GetWidth() - ext.GetWidth();
+    }
+    if (alignment & wxALIGN_CENTER_VERTICAL) {
+        y += (rect.GetHeight() - ext.GetHeight()) / 2;
+    } else if (alignment & wxALIGN_BOTTOM) {
+        y += rect.GetHeight() - ext.GetHeight();
+    }
+    RecordText(text, x, y, 0.0);
+}
+
+wxSize dskRasterDC::GetTextExtent(const wxString& text) const
+{
+    wxCoord w;
+    wxCoord h;
+    GetTextExtent(text, &w, &h);
+    return wxSize(w, h);
+}
+
+void dskRasterDC::GetTextExtent(const wxString& text, wxCoord* w, wxCoord* h,
+    wxCoord* descent, wxCoord* external_leading, const wxFont* font) const
+{
+    const text_extent e = m_fonts.GetTextExtent(font ? *font : m_font, text);
+    *w = e.width;
+    *h = e.height;
+    if (descent) {
+        *descent = e.descent;
+    }
+    if (external_leading) {
+        // Not measured by the cache, no font used by the instruments has any
+        *external_leading = 0;
+    }
+}
+
+void dskRasterDC::Rasterize()
+{
+    m_image = RasterImage(m_width, m_height);
+    for (const op& o : m_ops) {
+        switch (o.type) {
+        case op_type::clear:
+            m_image.Clear(o.color);
+            break;
+        case op_type::fill_rect:
+            m_image.FillRect(o.p[0], o.p[1], o.p[2], o.p[3], o.color);
+            break;
+        case op_type::fill_circle:
+            m_image.FillCircle(o.p[0], o.p[1], o.p[2], o.color);
+            break;
+        case op_type::stroke_circle:
+            m_image.StrokeCircle(o.p[0], o.p[1], o.p[2], o.p[3], o.color);
+            break;
+        case op_type::fill_sector:
+            m_image.FillSector(
+                o.p[0], o.p[1], o.p[2], o.p[3], o.p[4], o.color);
+            break;
+        case op_type::stroke_line:
+            m_image.StrokeLine(
+                o.p[0], o.p[1], o.p[2], o.p[3], o.p[4], o.color);
+            break;
+        case op_type::fill_polygon:
+            m_image.FillConvexPolygon(&m_poly_x[o.index], &m_poly_y[o.index],
+                o.count, o.color);
+            break;
+        case op_type::mask:
+            m_image.DrawMask(m_masks[o.index]->mask,
+                static_cast<int>(o.p[0]), static_cast<int>(o.p[1]), o.color);
+            break;
+        }
+    }
+}
+
+wxBitmap dskRasterDC::ToBitmap() const
+{
+    const int w = m_image.GetWidth();
+    const int h = m_image.GetHeight();
+    if (w <= 0 || h <= 0) {
+        return wxNullBitmap;
+    }
+    wxImage img(w, h, false);
+    img.SetAlpha();
+    unsigned char* rgb = img.GetData();
+    unsigned char* alpha = img.GetAlpha();
+    const vector<uint8_t>& px = m_image.GetPixels();
+    for (size_t i = 0; i < static_cast<size_t>(w) * h; ++i) {
+        rgb[i * 3] = px[i * 4];
+        rgb[i * 3 + 1] = px[i * 4 + 1];
+        rgb[i * 3 + 2] = px[i * 4 + 2];
+        alpha[i] = px[i * 4 + 3];
+    }
+    return wxBitmap(img, 32);
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,506 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "expression.h"
+#include "dashboardsk.h"
+#include "filterservice.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Check whether a character may start a path
+static bool IsPathStart(wxUniChar c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+/// Check whether a character may continue a path
+static bool IsPathChar(wxUniChar c)
+{
+    return IsPathStart(c) || (c >= '0' && c <= '9') || c == '.' || c == ':';
+}
+
+/// Skip a source designation or a filter, which runs up to the next
+/// whitespace or operator other than the minus, with anything inside the
+/// parentheses, eg. priority(GPS-GP-RMC, ais.AI)
+///
+/// \param text The expression
+/// \param pos Position in the expression, moved behind the designation
+static void SkipDesignation(const wxString& text, size_t& pos)
+{
+    int depth = 0;
+    for (; pos < text.length(); ++pos) {
+        const wxUniChar c = text[pos];
+        if (c == '(') {
+            ++depth;
+        } else if (c == ')') {
+            if (depth == 0) {
+                return;
+            }
+            --depth;
+        } else if (depth == 0
+            && (c == ' ' || c == '\t' || c == '+' || c == '*' || c == '/'
+                || c == ',' || c == FILTER_SEPARATOR)) {
+            return;
+        }
+    }
+}
+
+/// Check whether a character is a digit
+static bool IsDigit(wxUniChar c) { return c >= '0' && c <= '9'; }
+
+/// Skip the whitespace of an expression
+static void SkipSpaces(const wxString& text, size_t& pos)
+{
+    while (pos < text.length() && (text[pos] == ' ' || text[pos] == '\t')) {
+        ++pos;
+    }
+}
+
+bool Expression::FindFunction(const wxString& name, opcode& op, int& args)
+{
+    static const struct {
+        const char* name;
+        opcode op;
+        int args;
+    } functions[] = { { "abs", opcode::abs, 1 }, { "sqrt", opcode::sqrt, 1 },
+        { "sin", opcode::sin, 1 }, { "cos", opcode::cos, 1 },
+        { "tan", opcode::tan, 1 }, { "atan2", opcode::atan2, 2 },
+        { "min", opcode::min, 2 }, { "max", opcode::max, 2 } };
+    for (const auto& f : functions) {
+        if (name.IsSameAs(f.name)) {
+            op = f.op;
+            args = f.args;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Expression::Emit(parser& p, const instruction& ins, size_t pops)
+{
+    m_program.push_back(ins);
+    p.depth = p.depth - pops + 1;
+    m_max_depth = std::max(m_max_depth, p.depth);
+}
+
+bool Expression::ParseSum(parser& p)
+{
+    if (!ParseProduct(p)) {
+        return false;
+    }
+    SkipSpaces(p.text, p.pos);
+    while (p.pos < p.text.length()
+        && (p.text[p.pos] == '+' || p.text[p.pos] == '-')) {
+        const opcode op = p.text[p.pos] == '+' ? opcode::add : opcode::sub;
+        ++p.pos;
+        if (!ParseProduct(p)) {
+            return false;
+        }
+        Emit(p, { op, 0, 0.0 }, 2);
+        SkipSpaces(p.text, p.pos);
+    }
+    return true;
+}
+
+bool Expression::ParseProduct(parser& p)
+{
+    if (!ParseFactor(p)) {
+        return false;
+    }
+    SkipSpaces(p.text, p.pos);
+    while (p.pos < p.text.length()
+        && (p.text[p.pos] == '*' || p.text[p.pos] == '/')) {
+        const opcode op = p.text[p.pos] == '*' ? opcode::mul : opcode::div;
+        ++p.pos;
+        if (!ParseFactor(p)) {
+            return false;
+        }
+        Emit(p, { op, 0, 0.0 }, 2);
+        SkipSpaces(p.text, p.pos);
+    }
+    return true;
+}
+
+bool Expression::ParseFactor(parser& p)
+{
+    SkipSpaces(p.text, p.pos);
+    if (p.pos >= p.text.length()) {
+        p.error = _("Unexpected end of the expression");
+        return false;
+    }
+    const wxUniChar c = p.text[p.pos];
+    if (c == '-') {
+        ++p.pos;
+        if (!ParseFactor(p)) {
+            return false;
+        }
+        Emit(p, { opcode::neg, 0, 0.0 }, 1);
+        return true;
+    }
+    if (c == '(') {
+        ++p.pos;
+        if (!ParseSum(p)) {
+            return false;
+        }
+        SkipSpaces(p.text, p.pos);
+        if (p.pos >= p.text.length() || p.text[p.pos] != ')') {
+            p.error = _("Missing closing parenthesis");
+            return false;
+        }
+        ++p.pos;
+        return true;
+    }
+    if (IsDigit(c) || c == '.') {
+        const size_t start = p.pos;
+        while (p.pos < p.text.length()
+            && (IsDigit(p.text[p.pos]) || p.text[p.pos] == '.')) {
+            ++p.pos;
+        }
+        if (p.pos < p.text.length()
+            && (p.text[p.pos] == 'e' || p.text[p.pos] == 'E')) {
+            ++p.pos;
+            if (p.pos < p.text.length()
+                && (p.text[p.pos] == '+' || p.text[p.pos] == '-')) {
+                ++p.pos;
+            }
+            while (p.pos < p.text.length() && IsDigit(p.text[p.pos])) {
+                ++p.pos;
+            }
+        }
+        double value;
+        if (!p.text.Mid(start, p.pos - start).ToCDouble(&value)) {
+            p.error = _("Invalid number ") + p.text.Mid(start, p.pos - start);
+            return false;
+        }
+        Emit(p, { opcode::push, 0, value }, 0);
+        return true;
+    }
+    if (!IsPathStart(c)) {
+        p.error = _("Unexpected character ") + wxString(c);
+        return false;
+    }
+    const size_t start = p.pos;
+    // A path with a source designation or filters is never a function
+    bool designated = false;
+    while (p.pos < p.text.length() && IsPathChar(p.text[p.pos])) {
+        if (p.text[p.pos] == '.'
+            && p.text.Mid(p.pos + 1).StartsWith(SRC_MAGIC_STRING)) {
+            p.pos += 1 + strlen(SRC_MAGIC_STRING);
+            SkipDesignation(p.text, p.pos);
+            designated = true;
+            break;
+        }
+        ++p.pos;
+    }
+    while (p.pos < p.text.length() && p.text[p.pos] == FILTER_SEPARATOR) {
+        ++p.pos;
+        SkipDesignation(p.text, p.pos);
+        designated = true;
+    }
+    const wxString name = p.text.Mid(start, p.pos - start);
+    SkipSpaces(p.text, p.pos);
+    if (!designated && p.pos < p.text.length() && p.text[p.pos] == '(') {
+        opcode op;
+        int args;
+        if (!FindFunction(name, op, args)) {
+            p.error = _("Unknown function ") + name;
+            return false;
+        }
+        ++p.pos;
+        for (int i = 0; i < args; i++) {
+            if (i > 0) {
+                SkipSpaces(p.text, p.pos);
+                if (p.pos >= p.text.length() || p.text[p.pos] != ',') {
+                    p.error = wxString::Format(
+                        _("Function %s takes %i arguments"), name.c_str(),
+                        args);
+                    return false;
+                }
+                ++p.pos;
+            }
+            if (!ParseSum(p)) {
+                return false;
+            }
+        }
+        SkipSpaces(p.text, p.pos);
+        if (p.pos >= p.text.length() || p.text[p.pos] != ')') {
+            p.error = wxString::Format(
+                _("Function %s takes %i arguments"), name.c_str(), args);
+            return false;
+        }
+        ++p.pos;
+        Emit(p, { op, 0, 0.0 }, args);
+        return true;
+    }
+    // The same path is loaded from the same slot
+    auto it = std::find(m_paths.begin(), m_paths.end(), name);
+    if (it == m_paths.end()) {
+        it = m_paths.insert(m_paths.end(), name);
+    }
+    Emit(p, { opcode::load, static_cast<uint32_t>(it - m_paths.begin()), 0.0 },
+        0);
+    return true;
+}
+
+bool Expression::Compile(const wxString& text, wxString* error)
+{
+    m_program.clear();
+    m_paths.clear();
+    m_max_depth = 0;
+    parser p;
+    p.text = IsExpression(text) ? text.Mid(1) : text;
+    p.pos = 0;
+    p.depth = 0;
+    bool ok = ParseSum(p);
+    SkipSpaces(p.text, p.pos);
+    if (ok && p.pos < p.text.length()) {
+        p.error = _("Unexpected character ") + wxString(p.text[p.pos]);
+        ok = false;
+    }
+    if (!ok) {
+        m_program.clear();
+        m_paths.clear();
+        if (error) {
+            *error = p.error;
+        }
+    }
+    m_stack.assign(ok ? m_max_depth : 0, 0.0);
+    return ok;
+}
+
+bool Expression::Evaluate(const reader_t& read, double& result) const
+{
+    if (m_program.empty()) {
+        return false;
+    }
+    // Number of the values on the stack
+    size_t depth = 0;
+    for (const auto& ins : m_program) {
+        double value;
+        switch (ins.op) {
+        case opcode::push:
+            m_stack[depth++] = ins.value;
+            continue;
+        case opcode::load:
+            if (!read(ins.index, value)) {
+                return false;
+            }
+            m_stack[depth++] = value;
+            continue;
+        case opcode::neg:
+            m_stack[depth - 1] = -m_stack[depth - 1];
+            continue;
+        case opcode::abs:
+            m_stack[depth - 1] = std::abs(m_stack[depth - 1]);
+            continue;
+        case opcode::sqrt:
+            m_stack[depth - 1] = std::sqrt(m_stack[depth - 1]);
+            continue;
+        case opcode::sin:
+            m_stack[depth - 1] = std::sin(m_stack[depth - 1]);
+            continue;
+        case opcode::cos:
+            m_stack[depth - 1] = std::cos(m_stack[depth - 1]);
+            continue;
+        case opcode::tan:
+            m_stack[depth - 1] = std::tan(m_stack[depth - 1]);
+            continue;
+        default:
+            break;
+        }
+        // Binary operations take the right operand from the top
+        const double right = m_stack[--depth];
+        double& left = m_stack[depth - 1];
+        switch (ins.op) {
+        case opcode::add:
+            left += right;
+            break;
+        case opcode::sub:
+            left -= right;
+            break;
+        case opcode::mul:
+            left *= right;
+            break;
+        case opcode::div:
+            left /= right;
+            break;
+        case opcode::atan2:
+            left = std::atan2(left, right);
+            break;
+        case opcode::min:
+            left = std::min(left, right);
+            break;
+        case opcode::max:
+            left = std::max(left, right);
+            break;
+        default:
+            break;
+        }
+    }
+    result = m_stack[0];
+    return std::isfinite(result);
+}
+
+bool ExpressionService::Subscribe(const wxString& key, const void* owner)
+{
+    auto it = m_expressions.find(UNORDERED_KEY(key));
+    if (it == m_expressions.end()) {
+        compiled c;
+        if (!c.expression.Compile(key)) {
+            return false;
+        }
+        it = m_expressions.emplace(UNORDERED_KEY(key), std::move(c)).first;
+        Qualify(it->second);
+    }
+    vector<const void*>& owners = it->second.owners;
+    if (std::find(owners.begin(), owners.end(), owner) == owners.end()) {
+        owners.push_back(owner);
+    }
+    return true;
+}
+
+void ExpressionService::Qualify(compiled& c)
+{
+    c.inputs.clear();
+    for (const auto& path : c.expression.GetPaths()) {
+        const bool absolute
+            = path.StartsWith("vessels.") || m_context.IsEmpty();
+        c.inputs.push_back(absolute ? path : m_context + "." + path);
+    }
+    for (const auto& input : c.inputs) {
+        vector<compiled*>& users
+            = m_by_input[UNORDERED_KEY(FilterService::BasePath(input))];
+        if (std::find(users.begin(), users.end(), &c) == users.end()) {
+            users.push_back(&c);
+        }
+    }
+    c.dirty = true;
+}
+
+void ExpressionService::SetContext(
+    const wxString& context, const relocator_t& relocate)
+{
+    if (context == m_context) {
+        return;
+    }
+    m_context = context;
+    m_by_input.clear();
+    for (auto& e : m_expressions) {
+        compiled& c = e.second;
+        const vector<wxString> previous(c.inputs);
+        Qualify(c);
+        for (size_t i = 0; relocate && i < previous.size(); i++) {
+            if (previous[i] == c.inputs[i]) {
+                continue;
+            }
+            for (const void* owner : c.owners) {
+                relocate(owner, previous[i], c.inputs[i]);
+            }
+        }
+    }
+}
+
+void ExpressionService::Unsubscribe(const void* owner)
+{
+    for (auto it = m_expressions.begin(); it != m_expressions.end();) {
+        compiled& c = it->second;
+        c.owners.erase(std::remove(c.owners.begin(), c.owners.end(), owner),
+            c.owners.end());
+        if (!c.owners.empty()) {
+            ++it;
+            continue;
+        }
+        for (const auto& input : c.inputs) {
+            const wxString base = FilterService::BasePath(input);
+            auto users = m_by_input.find(UNORDERED_KEY(base));
+            if (users == m_by_input.end()) {
+                continue;
+            }
+            users->second.erase(
+                std::remove(users->second.begin(), users->second.end(), &c),
+                users->second.end());
+            if (users->second.empty()) {
+                m_by_input.erase(users);
+            }
+        }
+        it = m_expressions.erase(it);
+    }
+}
+
+vector<wxString> ExpressionService::GetInputs(const wxString& key) const
+{
+    auto it = m_expressions.find(UNORDERED_KEY(key));
+    return it == m_expressions.end() ? vector<wxString>() : it->second.inputs;
+}
+
+void ExpressionService::Update(const path_key_t& base)
+{
+    auto it = m_by_input.find(base);
+    if (it == m_by_input.end()) {
+        return;
+    }
+    for (compiled* c : it->second) {
+        c->dirty = true;
+    }
+}
+
+const Json::Value* ExpressionService::Get(const wxString& key)
+{
+    auto it = m_expressions.find(UNORDERED_KEY(key));
+    if (it == m_expressions.end()) {
+        return nullptr;
+    }
+    compiled& c = it->second;
+    if (c.dirty) {
+        c.dirty = false;
+        double result;
+        const bool ok = c.expression.Evaluate(
+            [this, &c](size_t index, double& value) {
+                const Json::Value* node = m_reader(c.inputs[index]);
+                if (!node) {
+                    return false;
+                }
+                const Json::Value& v = node->get("value", *node);
+                if (!v.isNumeric()) {
+                    return false;
+                }
+                value = v.asDouble();
+                return true;
+            },
+            result);
+        c.output = ok ? Json::Value(Json::objectValue) : Json::Value();
+        if (ok) {
+            c.output["value"] = result;
+        }
+    }
+    return c.output.isObject() ? &c.output : nullptr;
+}
+
+PLUGIN_END_NAMESPACE
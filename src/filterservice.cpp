@@ -0,0 +1,278 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "filterservice.h"
+#include "dashboardsk.h"
+
+#include <wx/tokenzr.h>
+
+#include <algorithm>
+#include <cmath>
+
+PLUGIN_BEGIN_NAMESPACE
+
+wxString FilterService::BasePath(const wxString& key)
+{
+    wxString base = key.BeforeFirst(FILTER_SEPARATOR);
+    const int src_pos = base.Find(SRC_MAGIC_STRING);
+    if (src_pos != wxNOT_FOUND) {
+        base = base.Left(src_pos - 1);
+    }
+    return base;
+}
+
+bool FilterService::ParseStage(const wxString& spec, stage& s)
+{
+    const wxString name = spec.BeforeFirst('(').Trim(true).Trim(false);
+    if (!spec.EndsWith(")")) {
+        return false;
+    }
+    wxString arg = spec.AfterFirst('(').BeforeLast(')');
+    if (!arg.Trim(true).Trim(false).ToCDouble(&s.param) || s.param <= 0.0) {
+        return false;
+    }
+    if (name == "ema") {
+        s.kind = stage::type::ema;
+    } else if (name == "median") {
+        s.kind = stage::type::median;
+    } else if (name == "circmean") {
+        s.kind = stage::type::circmean;
+    } else if (name == "ratelimit") {
+        s.kind = stage::type::ratelimit;
+    } else if (name == "mean") {
+        s.kind = stage::type::mean;
+    } else if (name == "min") {
+        s.kind = stage::type::min;
+    } else if (name == "max") {
+        s.kind = stage::type::max;
+    } else {
+        return false;
+    }
+    if (s.kind == stage::type::median || s.kind == stage::type::circmean) {
+        const size_t n = std::min(
+            MAX_WINDOW, std::max(static_cast<size_t>(1), size_t(s.param)));
+        s.window.assign(n, 0.0);
+        if (s.kind == stage::type::median) {
+            s.sorted.reserve(n);
+        }
+    }
+    return true;
+}
+
+double FilterService::Apply(stage& s, double value,
+    Clock::base_clock::duration dt, Clock::time_point now)
+{
+    switch (s.kind) {
+    case stage::type::ema:
+        // The usual N-sample smoothing factor
+        s.state = s.primed ? s.state + 2.0 / (s.param + 1.0) * (value - s.state)
+                           : value;
+        break;
+    case stage::type::median:
+        s.window[s.pos] = value;
+        s.pos = (s.pos + 1) % s.window.size();
+        s.count = std::min(s.count + 1, s.window.size());
+        s.sorted.assign(s.window.begin(), s.window.begin() + s.count);
+        std::nth_element(
+            s.sorted.begin(), s.sorted.begin() + s.count / 2, s.sorted.end());
+        s.state = s.sorted[s.count / 2];
+        if (s.count % 2 == 0) {
+            // Mean of the two middle samples
+            s.state = (s.state
+                          + *std::max_element(s.sorted.begin(),
+                              s.sorted.begin() + s.count / 2))
+                / 2.0;
+        }
+        break;
+    case stage::type::circmean:
+        if (s.count == s.window.size()) {
+            s.sin_sum -= sin(s.window[s.pos]);
+            s.cos_sum -= cos(s.window[s.pos]);
+            s.negatives -= s.window[s.pos] < 0.0 ? 1 : 0;
+        }
+        s.window[s.pos] = value;
+        s.sin_sum += sin(value);
+        s.cos_sum += cos(value);
+        s.negatives += value < 0.0 ? 1 : 0;
+        s.pos = (s.pos + 1) % s.window.size();
+        s.count = std::min(s.count + 1, s.window.size());
+        s.state = atan2(s.sin_sum, s.cos_sum);
+        if (s.state < 0.0 && s.negatives == 0) {
+            // Keep the range of the input, eg. 0 to 2PI for headings, a
+            // single negative sample makes it a signed angle like the AWA
+            s.state += 2.0 * M_PI;
+        }
+        break;
+    case stage::type::ratelimit: {
+        const double max_change
+            = s.param * std::chrono::duration<double>(dt).count();
+        const double change = value - s.state;
+        s.state = s.primed
+            ? s.state + std::max(-max_change, std::min(max_change, change))
+            : value;
+        break;
+    }
+    case stage::type::mean:
+    case stage::type::min:
+    case stage::type::max: {
+        if (s.kind == stage::type::mean) {
+            s.sum += value;
+        } else {
+            // The samples which can no longer be the extreme, as the new one
+            // is as extreme and stays in the window longer
+            while (!s.samples.empty()
+                && (s.kind == stage::type::min
+                        ? s.samples.back().value >= value
+                        : s.samples.back().value <= value)) {
+                s.samples.pop_back();
+            }
+        }
+        s.samples.push_back({ now, value, ++s.seq });
+        const auto oldest = now
+            - std::chrono::duration_cast<Clock::base_clock::duration>(
+                std::chrono::duration<double>(s.param));
+        while (s.samples.size() > 1
+            && (s.samples.front().time < oldest
+                || s.seq - s.samples.front().seq >= MAX_WINDOW)) {
+            if (s.kind == stage::type::mean) {
+                s.sum -= s.samples.front().value;
+            }
+            s.samples.pop_front();
+        }
+        s.state = s.kind == stage::type::mean ? s.sum / s.samples.size()
+                                              : s.samples.front().value;
+        break;
+    }
+    }
+    s.primed = true;
+    return s.state;
+}
+
+bool FilterService::Subscribe(const wxString& key, const void* owner)
+{
+    auto it = m_pipelines.find(UNORDERED_KEY(key));
+    if (it == m_pipelines.end()) {
+        if (!IsFiltered(key)) {
+            return false;
+        }
+        pipeline p;
+        p.input = key.BeforeFirst(FILTER_SEPARATOR);
+        p.base = UNORDERED_KEY(BasePath(key));
+        wxStringTokenizer tokenizer(key.AfterFirst(FILTER_SEPARATOR),
+            wxString(FILTER_SEPARATOR));
+        while (tokenizer.HasMoreTokens()) {
+            stage s;
+            if (!ParseStage(tokenizer.GetNextToken(), s)) {
+                return false;
+            }
+            p.stages.push_back(std::move(s));
+        }
+        if (p.stages.empty()) {
+            return false;
+        }
+        it = m_pipelines.emplace(UNORDERED_KEY(key), std::move(p)).first;
+        m_by_base[it->second.base].push_back(&it->second);
+    }
+    vector<const void*>& owners = it->second.owners;
+    if (std::find(owners.begin(), owners.end(), owner) == owners.end()) {
+        owners.push_back(owner);
+    }
+    return true;
+}
+
+void FilterService::Unsubscribe(const void* owner)
+{
+    for (auto it = m_pipelines.begin(); it != m_pipelines.end();) {
+        pipeline& p = it->second;
+        p.owners.erase(
+            std::remove(p.owners.begin(), p.owners.end(), owner),
+            p.owners.end());
+        if (!p.owners.empty()) {
+            ++it;
+            continue;
+        }
+        auto base = m_by_base.find(p.base);
+        base->second.erase(
+            std::find(base->second.begin(), base->second.end(), &p));
+        if (base->second.empty()) {
+            m_by_base.erase(base);
+        }
+        it = m_pipelines.erase(it);
+    }
+}
+
+void FilterService::Update(
+    const path_key_t& base, const Json::Value* node, Clock::time_point now)
+{
+    auto it = m_by_base.find(base);
+    if (it == m_by_base.end()) {
+        return;
+    }
+    for (pipeline* p : it->second) {
+        const Json::Value* in = m_reader(p->input);
+        if (!in || in != node) {
+            continue;
+        }
+        const Json::Value* value = in->find("value", "value" + 5);
+        if (!value) {
+            value = in;
+        }
+        if (!value->isNumeric()) {
+            continue;
+        }
+        const Clock::base_clock::duration dt = now - p->last_input;
+        if (dt > RESET_GAP) {
+            for (auto& s : p->stages) {
+                s.primed = false;
+                s.pos = 0;
+                s.count = 0;
+                s.sin_sum = 0.0;
+                s.cos_sum = 0.0;
+                s.negatives = 0;
+                s.samples.clear();
+                s.seq = 0;
+                s.sum = 0.0;
+            }
+        }
+        p->last_input = now;
+        double out = value->asDouble();
+        for (auto& s : p->stages) {
+            out = Apply(s, out, dt, now);
+        }
+        p->output["value"] = out;
+    }
+}
+
+const Json::Value* FilterService::Get(const wxString& key) const
+{
+    auto it = m_pipelines.find(UNORDERED_KEY(key));
+    if (it == m_pipelines.end() || !it->second.output.isObject()) {
+        return nullptr;
+    }
+    return &it->second.output;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,156 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "fontcache.h"
+
+#include <wx/image.h>
+
+#include <algorithm>
+#include <cmath>
+
+PLUGIN_BEGIN_NAMESPACE
+
+FontCache::font_key FontCache::Key(const wxFont& font)
+{
+    return font_key(font.GetPointSize(), static_cast<int>(font.GetFamily()),
+        static_cast<int>(font.GetStyle()), static_cast<int>(font.GetWeight()));
+}
+
+const wxFont& FontCache::GetFont(int point_size, wxFontFamily family,
+    wxFontWeight weight, wxFontStyle style)
+{
+    font_key key(point_size, static_cast<int>(family), static_cast<int>(style),
+        static_cast<int>(weight));
+    auto it = m_fonts.find(key);
+    if (it == m_fonts.end()) {
+        it = m_fonts
+                 .emplace(key, wxFont(point_size, family, style, weight))
+                 .first;
+    }
+    return it->second;
+}
+
+const wxFont& FontCache::GetFont(const wxFont& font, int point_size)
+{
+    return GetFont(
+        point_size, font.GetFamily(), font.GetWeight(), font.GetStyle());
+}
+
+text_extent FontCache::GetTextExtent(const wxFont& font, const wxString& text)
+{
+    auto key = std::make_pair(Key(font), text);
+    auto it = m_extents.find(key);
+    if (it != m_extents.end()) {
+        return it->second;
+    }
+    if (m_extents.size() >= MAX_EXTENTS) {
+        m_extents.clear();
+    }
+    if (!m_dc) {
+        m_dc = std::make_unique<wxMemoryDC>();
+    }
+    text_extent e { 0, 0, 0 };
+    m_dc->GetTextExtent(text, &e.width, &e.height, &e.descent, nullptr, &font);
+    return m_extents.emplace(key, e).first->second;
+}
+
+std::shared_ptr<const text_mask> FontCache::GetTextMask(
+    const wxFont& font, const wxString& text, double angle)
+{
+    auto key = std::make_tuple(Key(font), angle, text);
+    auto it = m_masks.find(key);
+    if (it != m_masks.end()) {
+        return it->second;
+    }
+    const text_extent e = GetTextExtent(font, text);
+    if (e.width <= 0 || e.height <= 0) {
+        return nullptr;
+    }
+    // Bounding box of the text rectangle rotated counterclockwise around its
+    // origin
+    const double c = cos(deg2rad(angle));
+    const double s = sin(deg2rad(angle));
+    const double cx[4] = { 0.0, double(e.width), 0.0, double(e.width) };
+    const double cy[4] = { 0.0, 0.0, double(e.height), double(e.height) };
+    double min_x = 0.0;
+    double min_y = 0.0;
+    double max_x = 0.0;
+    double max_y = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        const double rx = cx[i] * c + cy[i] * s;
+        const double ry = -cx[i] * s + cy[i] * c;
+        min_x = std::min(min_x, rx);
+        min_y = std::min(min_y, ry);
+        max_x = std::max(max_x, rx);
+        max_y = std::max(max_y, ry);
+    }
+    auto m = std::make_shared<text_mask>();
+    m->left = static_cast<int>(floor(min_x)) - 1;
+    m->top = static_cast<int>(floor(min_y)) - 1;
+    const int bw = static_cast<int>(ceil(max_x)) - m->left + 2;
+    const int bh = static_cast<int>(ceil(max_y)) - m->top + 2;
+
+    // White text on black background, the luminance is the coverage
+    wxBitmap bmp(bw, bh, 24);
+    wxMemoryDC mdc(bmp);
+    mdc.SetBackground(*wxBLACK_BRUSH);
+    mdc.Clear();
+    mdc.SetFont(font);
+    mdc.SetTextForeground(*wxWHITE);
+    if (angle == 0.0) {
+        mdc.DrawText(text, -m->left, -m->top);
+    } else {
+        mdc.DrawRotatedText(text, -m->left, -m->top, angle);
+    }
+    mdc.SelectObject(wxNullBitmap);
+    const wxImage img = bmp.ConvertToImage();
+    const unsigned char* data = img.GetData();
+
+    m->mask = { bw, bh, vector<uint8_t>(static_cast<size_t>(bw) * bh) };
+    for (size_t i = 0; i < m->mask.coverage.size(); ++i) {
+        m->mask.coverage[i] = std::max(
+            data[i * 3], std::max(data[i * 3 + 1], data[i * 3 + 2]));
+    }
+    if (m_masks.size() >= MAX_MASKS) {
+        m_masks.clear();
+    }
+    return m_masks.emplace(key, std::move(m)).first->second;
+}
+
+void FontCache::Clear()
+{
+    m_fonts.clear();
+    m_extents.clear();
+    m_masks.clear();
+}
+
+FontCache& FontCache::Fallback()
+{
+    static FontCache cache;
+    return cache;
+}
+
+PLUGIN_END_NAMESPACE
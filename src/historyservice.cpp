@@ -0,0 +1,163 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "historyservice.h"
+#include "filterservice.h"
+
+#include <algorithm>
+
+PLUGIN_BEGIN_NAMESPACE
+
+void History::Add(const double& value, Clock::time_point now)
+{
+    Add(value, 1, now);
+}
+
+void History::Add(const double& sum, size_t count, Clock::time_point now)
+{
+    if (m_last_minute.empty() || m_last_minute.back().OlderThan(1s, now)) {
+        m_last_minute.push_back(HistoryValue(now));
+    }
+    m_last_minute.back().Add(sum, count);
+    if (m_last_minute.size() > HISTORY_1S) {
+        m_last_minute.pop_front();
+    }
+    if (m_last_hour.empty() || m_last_hour.back().OlderThan(10s, now)) {
+        m_last_hour.push_back(HistoryValue(now));
+    }
+    m_last_hour.back().Add(sum, count);
+    if (m_last_hour.size() > HISTORY_10S) {
+        m_last_hour.pop_front();
+    }
+    if (m_last_3days.empty() || m_last_3days.back().OlderThan(300s, now)) {
+        m_last_3days.push_back(HistoryValue(now));
+    }
+    m_last_3days.back().Add(sum, count);
+    if (m_last_3days.size() > HISTORY_5M) {
+        m_last_3days.pop_front();
+    }
+}
+
+std::shared_ptr<const History> HistoryService::Acquire(const wxString& key)
+{
+    auto it = m_histories.find(UNORDERED_KEY(key));
+    if (it == m_histories.end()) {
+        entry e;
+        e.key = key;
+        const wxString base = FilterService::BasePath(key);
+        e.base = UNORDERED_KEY(base);
+        e.plain = base.IsSameAs(key);
+        it = m_histories.emplace(UNORDERED_KEY(key), std::move(e)).first;
+        m_by_base[it->second.base].push_back(&it->second);
+    }
+    std::shared_ptr<History> history = it->second.history.lock();
+    if (!history) {
+        history = std::make_shared<History>();
+        it->second.history = history;
+    }
+    return history;
+}
+
+void HistoryService::Remove(const path_key_t& key)
+{
+    auto it = m_histories.find(key);
+    if (it == m_histories.end()) {
+        return;
+    }
+    auto base = m_by_base.find(it->second.base);
+    base->second.erase(
+        std::find(base->second.begin(), base->second.end(), &it->second));
+    if (base->second.empty()) {
+        m_by_base.erase(base);
+    }
+    m_histories.erase(it);
+}
+
+void HistoryService::Update(const path_key_t& base, Clock::time_point now)
+{
+    auto it = m_by_base.find(base);
+    if (it == m_by_base.end()) {
+        return;
+    }
+    vector<path_key_t> expired;
+    for (entry* e : it->second) {
+        std::shared_ptr<History> history = e->history.lock();
+        if (!history) {
+            expired.push_back(UNORDERED_KEY(e->key));
+            continue;
+        }
+        const Json::Value* node = m_reader(e->key);
+        if (!node) {
+            continue;
+        }
+        const Json::Value& value = node->get("value", *node);
+        if (value.isNumeric()) {
+            history->Add(value.asDouble(), now);
+        }
+    }
+    for (const auto& key : expired) {
+        Remove(key);
+    }
+}
+
+void HistoryService::AddSuperseded(const path_key_t& base, double sum,
+    size_t count, Clock::time_point now)
+{
+    auto it = m_by_base.find(base);
+    if (it == m_by_base.end()) {
+        return;
+    }
+    for (entry* e : it->second) {
+        std::shared_ptr<History> history = e->history.lock();
+        if (history && e->plain) {
+            history->Add(sum, count, now);
+        }
+    }
+}
+
+vector<std::pair<wxString, std::shared_ptr<const History>>>
+HistoryService::GetHistories() const
+{
+    vector<std::pair<wxString, std::shared_ptr<const History>>> histories;
+    for (const auto& e : m_histories) {
+        std::shared_ptr<const History> history = e.second.history.lock();
+        if (history) {
+            histories.emplace_back(e.second.key, history);
+        }
+    }
+    return histories;
+}
+
+size_t HistoryService::GetHistoryCount() const
+{
+    size_t count = 0;
+    for (const auto& e : m_histories) {
+        count += e.second.history.expired() ? 0 : 1;
+    }
+    return count;
+}
+
+PLUGIN_END_NAMESPACE
@@ -29,6 +29,7 @@
 #endif
 #include "dashboard.h"
 #include "instrument.h"
+#include <atomic>
 
 PLUGIN_BEGIN_NAMESPACE
 
@@ -39,17 +40,86 @@ Instrument::~Instrument()
     }
 }
 
+/// Cached system font scaling factor, 0 until first read. Atomic as the
+/// instruments may be rasterized on worker threads
+static std::atomic<double> s_font_scaling_factor { 0.0 };
+/// Callback notified when the system font scaling factor changes
+static std::function<void()> s_font_scaling_watcher;
+#if defined(DASHBOARDSK_USE_GIOMM)
+#define FONT_SCALING_SCHEMA "org.gnome.desktop.interface"
+#define FONT_SCALING_KEY "text-scaling-factor"
+/// Settings object kept alive for the change notifications
+static Glib::RefPtr<Gio::Settings> s_font_settings;
+/// Connection of the change notification handler
+static sigc::connection s_font_settings_connection;
+
+static Glib::RefPtr<Gio::Settings> FontSettings()
+{
+    if (!s_font_settings) {
+        s_font_settings = Gio::Settings::create(FONT_SCALING_SCHEMA);
+    }
+    return s_font_settings;
+}
+#endif
+
 double Instrument::GetSystemFontScalingFactor()
 {
+    double factor = s_font_scaling_factor.load(std::memory_order_relaxed);
+    if (factor > 0.0) {
+        return factor;
+    }
 #if defined(DASHBOARDSK_USE_GIOMM)
-    Glib::RefPtr<Gio::Settings> s
-        = Gio::Settings::create("org.gnome.desktop.interface");
-    return s->get_double("text-scaling-factor");
-#else
-    return 1.0;
+    factor = FontSettings()->get_double(FONT_SCALING_KEY);
+#endif
+    if (factor <= 0.0) {
+        factor = 1.0;
+    }
+    s_font_scaling_factor.store(factor, std::memory_order_relaxed);
+    return factor;
+}
+
+bool Instrument::SetSystemFontScalingFactor(double factor)
+{
+    if (factor <= 0.0) {
+        factor = 1.0;
+    }
+    if (s_font_scaling_factor.exchange(factor) == factor) {
+        return false;
+    }
+    if (s_font_scaling_watcher) {
+        s_font_scaling_watcher();
+    }
+    return true;
+}
+
+void Instrument::WatchSystemFontScalingFactor(std::function<void()> on_change)
+{
+    UnwatchSystemFontScalingFactor();
+    s_font_scaling_watcher = std::move(on_change);
+    // Make sure the value is cached so that the first notification compares
+    // against what has actually been used for rendering
+    GetSystemFontScalingFactor();
+#if defined(DASHBOARDSK_USE_GIOMM)
+    // GSettings notifications are dispatched from the GLib main loop, which
+    // is the GUI thread on wxGTK
+    s_font_settings_connection = FontSettings()->signal_changed().connect(
+        [](const Glib::ustring& key) {
+            if (key == FONT_SCALING_KEY) {
+                SetSystemFontScalingFactor(
+                    FontSettings()->get_double(FONT_SCALING_KEY));
+            }
+        });
 #endif
 }
 
+void Instrument::UnwatchSystemFontScalingFactor()
+{
+#if defined(DASHBOARDSK_USE_GIOMM)
+    s_font_settings_connection.disconnect();
+#endif
+    s_font_scaling_watcher = nullptr;
+}
+
 wxColor Instrument::GetDimedColor(const wxColor& c) const
 {
     switch (m_color_scheme) {
@@ -78,10 +148,16 @@ void Instrument::ReadConfig(Json::Value& config)
     }
     if (config.isMember("allowed_age")) {
         m_allowed_age_sec = config["allowed_age"].asInt();
+        TimeoutChanged();
+    }
+    if (config.isMember("max_rate")) {
+        m_max_rate = config["max_rate"].asDouble();
+        MaxRateChanged();
     }
     if (config.isMember(DSK_SETTING_ZONES)) {
         m_zones = Zone::ParseZonesFromString(
             fromJsonVal(config[DSK_SETTING_ZONES].asString()));
+        ZonesChanged();
     }
     if (config.isMember("locked_source")) {
         m_locked_source = fromJsonVal(config["locked_source"].asString());
@@ -95,7 +171,7 @@ void Instrument::ReadConfig(Json::Value& config)
         for (const auto& path : config["locked_sources"].getMemberNames()) {
             m_source_locks[fromJsonVal(path)]
                 = { fromJsonVal(config["locked_sources"][path].asString()),
-                      std::chrono::system_clock::now() };
+                      Now() };
         }
     } else if (!m_locked_source.IsEmpty() && !m_locked_source_path.IsEmpty()) {
         m_source_locks[m_locked_source_path]
@@ -110,6 +186,9 @@ Json::Value Instrument::GenerateJSONConfig()
     v["title"] = toJson(m_title);
     v["class"] = toJson(GetClass());
     v["allowed_age"] = m_allowed_age_sec;
+    if (m_max_rate > 0.0) {
+        v["max_rate"] = m_max_rate;
+    }
     v[DSK_SETTING_ZONES] = toJson(Zone::ZonesToString(m_zones));
     const wxString key = GetPrimarySKKey();
     if (!m_locked_source.IsEmpty() && key.EndsWith(".SRC:lockpersist")
@@ -136,25 +215,73 @@ void Instrument::SetSetting(const wxString& key, const wxString& value)
         m_title = value;
     } else if (key == "allowed_age") {
         m_allowed_age_sec = IntFromString(value);
+        TimeoutChanged();
+    } else if (key == "max_rate") {
+        m_max_rate = DoubleFromString(value);
+        MaxRateChanged();
     } else if (key == DSK_SETTING_ZONES) {
         m_zones = Zone::ParseZonesFromString(value);
+        ZonesChanged();
     } else {
         m_config_vals[UNORDERED_KEY(key)] = value;
     }
+    UpdateTypedSetting(key, value);
     m_needs_redraw = true;
 }
 
 void Instrument::SetSetting(const wxString& key, const wxColor& value)
 {
     m_config_vals[UNORDERED_KEY(key)] = value.GetAsString(wxC2S_HTML_SYNTAX);
+    UpdateTypedSetting(key, m_config_vals[UNORDERED_KEY(key)]);
 }
 
 void Instrument::SetSetting(const wxString& key, const int& value)
 {
     if (key == "allowed_age") {
         m_allowed_age_sec = value;
+        TimeoutChanged();
+    } else if (key == "max_rate") {
+        m_max_rate = value;
+        MaxRateChanged();
     } else {
         m_config_vals[UNORDERED_KEY(key)] = wxString::Format("%i", value);
+        UpdateTypedSetting(key, m_config_vals[UNORDERED_KEY(key)]);
+    }
+}
+
+void Instrument::RegisterTypedSetting(
+    size_t index, const wxString& key, dskConfigCtrl control)
+{
+    if (m_typed_vals.size() <= index) {
+        m_typed_vals.resize(index + 1);
+    }
+    m_typed_vals[index].is_color = control == dskConfigCtrl::ColourPickerCtrl;
+    m_typed_index[UNORDERED_KEY(key)] = index;
+}
+
+void Instrument::UpdateTypedSetting(const wxString& key, const wxString& value)
+{
+    auto it = m_typed_index.find(UNORDERED_KEY(key));
+    if (it == m_typed_index.end()) {
+        return;
+    }
+    typed_setting& ts = m_typed_vals[it->second];
+    ts.str = value;
+#if (wxCHECK_VERSION(3, 1, 6))
+    if (!value.ToInt(&ts.int_val)) {
+        ts.int_val = 0;
+    }
+    if (!value.ToDouble(&ts.double_val)) {
+        ts.double_val = 0.0;
+    }
+#else
+    ts.int_val = wxAtoi(value);
+    ts.double_val = wxAtof(value);
+#endif
+    if (ts.is_color) {
+        wxColor col;
+        wxFromString(value, &col);
+        ts.color_val = col;
     }
 }
 
@@ -198,34 +325,29 @@ const wxColor Instrument::AdjustColorForZone(const double& val,
     const wxColor& alert_color, const wxColor& warn_color,
     const wxColor& alarm_color, const wxColor& emergency_color)
 {
-    wxColor c = nominal_color;
-    Zone::state high_state = Zone::state::nominal;
-    for (auto& zone : m_zones) {
-        if (high_state < Zone::state::emergency && val >= zone.GetLowerLimit()
-            && val <= zone.GetUpperLimit() && high_state < zone.GetState()) {
-            high_state = zone.GetState();
-            switch (high_state) {
-            case Zone::state::normal:
-                c = normal_color;
-                break;
-            case Zone::state::alert:
-                c = alert_color;
-                break;
-            case Zone::state::warn:
-                c = warn_color;
-                break;
-            case Zone::state::alarm:
-                c = alarm_color;
-                break;
-            case Zone::state::emergency:
-                c = emergency_color;
-                break;
-            default:
-                c = nominal_color;
-            }
-        }
+    return AdjustColorForZone(GetZoneState(val), nominal_color, normal_color,
+        alert_color, warn_color, alarm_color, emergency_color);
+}
+
+const wxColor& Instrument::AdjustColorForZone(const Zone::state st,
+    const wxColor& nominal_color, const wxColor& normal_color,
+    const wxColor& alert_color, const wxColor& warn_color,
+    const wxColor& alarm_color, const wxColor& emergency_color)
+{
+    switch (st) {
+    case Zone::state::normal:
+        return normal_color;
+    case Zone::state::alert:
+        return alert_color;
+    case Zone::state::warn:
+        return warn_color;
+    case Zone::state::alarm:
+        return alarm_color;
+    case Zone::state::emergency:
+        return emergency_color;
+    default:
+        return nominal_color;
     }
-    return c;
 }
 
 wxBitmap Instrument::Render(double scale)
@@ -234,6 +356,23 @@ wxBitmap Instrument::Render(double scale)
     return wxNullBitmap;
 }
 
+FontCache& Instrument::GetFontCache()
+{
+    return m_parent_dashboard ? m_parent_dashboard->GetFontCache()
+                              : FontCache::Fallback();
+}
+
+wxBitmap Instrument::TakeRaster()
+{
+    if (!m_raster) {
+        return wxNullBitmap;
+    }
+    wxBitmap bmp = m_raster->ToBitmap();
+    m_raster.reset();
+    m_raster_committed = true;
+    return bmp;
+}
+
 const wxColor Instrument::ColorFromString(const wxString& color)
 {
     wxColor clr;
@@ -306,6 +445,10 @@ double Instrument::GetDoubleSetting(const wxString& key)
 
 wxColor Instrument::GetColorSetting(const wxString& key)
 {
+    auto it = m_typed_index.find(UNORDERED_KEY(key));
+    if (it != m_typed_index.end() && m_typed_vals[it->second].is_color) {
+        return m_typed_vals[it->second].color_val;
+    }
     if (m_config_vals.find(UNORDERED_KEY(key)) != m_config_vals.end()) {
         wxColor col;
         wxFromString(m_config_vals[UNORDERED_KEY(key)], &col);
@@ -391,124 +534,121 @@ void Instrument::ConfigureFromMeta(Json::Value& sk_meta)
         m_name = fromJsonVal(sk_meta["longName"].asString());
     }
     if (sk_meta.isMember("zones") && sk_meta["zones"].isArray()) {
-        for (int i = 0; i < (int)sk_meta["zones"].size(); i++) {
-            m_zones.emplace_back(Zone(sk_meta["zones"][i]["lower"].asDouble(),
-                sk_meta["zones"][i]["upper"].asDouble(),
-                Zone::StateFromString(
-                    fromJsonVal(sk_meta["zones"][i]["state"].asString())),
-                sk_meta["zones"][i].isMember("message")
-                    ? fromJsonVal(sk_meta["zones"][i]["message"].asString())
-                    : wxString()));
+        for (const auto& zone : Zone::ParseZonesFromJson(sk_meta["zones"])) {
+            m_zones.emplace_back(zone);
         }
+        ZonesChanged();
     }
     // TODO: displayScale (not universal, do in SimpleGauge where we need it or
     // make universal as it may be needed on many places?)
 }
 
-void Instrument::ConfigureFromKey(const wxString& key)
+void Instrument::SetLockedSource(const wxString& source)
 {
-    if (!key.IsEmpty() && m_title == DUMMY_TITLE) {
-        m_title = key.AfterLast('.');
+    m_locked_source = source;
+    m_locked_source_time = Now();
+    if (!m_locked_source_path.IsEmpty()) {
+        m_source_locks[m_locked_source_path]
+            = { m_locked_source, m_locked_source_time };
+        if (m_parent_dashboard) {
+            m_parent_dashboard->LockSource(m_locked_source_path,
+                source.IsSameAs("direct") ? wxString() : source);
+        }
     }
-    if (!key.IsEmpty() && m_name.StartsWith("New ")) {
-        m_name = key.AfterLast('.');
+}
+
+void Instrument::SourceChanged(const source_event& e)
+{
+    source_lock& lock = m_source_locks[e.path];
+    lock.source = e.to.IsEmpty() ? wxString("direct") : e.to;
+    lock.time = e.time;
+    if (e.path.IsSameAs(m_locked_source_path)) {
+        m_locked_source = lock.source;
+        m_locked_source_time = lock.time;
     }
 }
 
-const Json::Value* Instrument::GetSKDataResolved(const wxString& path)
+Clock::time_point Instrument::Now() const
 {
-    // ponytail: check for magic source modes and apply locking logic
     if (!m_parent_dashboard) {
-        return nullptr;
+        return Clock::System().Now();
     }
+    return m_parent_dashboard->Now();
+}
 
-    int srcPos = path.Find("SRC:");
-    if (srcPos == wxNOT_FOUND) {
-        // No source designation - use base path
-        return m_parent_dashboard->GetSKData(path);
+void Instrument::ZonesChanged()
+{
+    m_zone_index.Build(m_zones);
+    if (m_parent_dashboard) {
+        m_parent_dashboard->InvalidateAlarmWatches();
     }
+}
 
-    wxString srcDesignation = path.Mid(srcPos + 4); // Skip "SRC:"
-
-    if (srcDesignation == "any") {
-        // ponytail: for "any" mode, just scan and return first available source
-        // (no locking, returns first available each time)
-        return m_parent_dashboard->GetSKData(path);
-    } else if (srcDesignation == "lockfirst"
-        || srcDesignation == "lockpersist") {
-        wxString basePath = path.Left(srcPos - 1);
-        source_lock& lock = m_source_locks[path];
-        if (lock.time.time_since_epoch().count() == 0) {
-            lock.time = std::chrono::system_clock::now();
-        }
-        m_locked_source_path = path;
-        m_locked_source = lock.source;
-        m_locked_source_time = lock.time;
+void Instrument::TransformationChanged()
+{
+    if (m_parent_dashboard) {
+        m_parent_dashboard->InvalidateAlarmWatches();
+    }
+}
 
-        if (!lock.source.IsEmpty()) {
-            const Json::Value* lockedValue = lock.source.IsSameAs("direct")
-                ? m_parent_dashboard->GetSKData(basePath)
-                : m_parent_dashboard->GetSKData(
-                      basePath + ".SRC:" + lock.source);
-            if (lockedValue) {
-                lock.time = std::chrono::system_clock::now();
-                m_locked_source_time = lock.time;
-                return lockedValue;
-            }
-            if (srcDesignation == "lockfirst") {
-                return nullptr;
-            }
+void Instrument::TimeoutChanged()
+{
+    if (m_parent_dashboard) {
+        m_parent_dashboard->SetTimeout(this, m_allowed_age_sec);
+    }
+}
 
-            const auto age = std::chrono::duration_cast<std::chrono::seconds>(
-                std::chrono::system_clock::now() - lock.time);
-            if (age.count() < m_allowed_age_sec) {
-                return nullptr;
-            }
-            lock.source.Clear();
-            m_locked_source.Clear();
-        }
+void Instrument::MaxRateChanged()
+{
+    if (m_parent_dashboard) {
+        m_parent_dashboard->SetMaxRate(this, m_max_rate);
+    }
+}
 
-        // Lock not established - find first available source and lock to it
-        const Json::Value* baseValue = m_parent_dashboard->GetSKData(basePath);
-        if (!baseValue) {
-            return nullptr;
-        }
+void Instrument::ConfigureFromKey(const wxString& key)
+{
+    if (!key.IsEmpty() && m_title == DUMMY_TITLE) {
+        m_title = key.AfterLast('.');
+    }
+    if (!key.IsEmpty() && m_name.StartsWith("New ")) {
+        m_name = key.AfterLast('.');
+    }
+}
 
-        // Try direct value first, then scan for SRC: entries
-        if (baseValue->isMember("value")) {
-            // Direct value exists - lock to it (empty source = direct)
-            lock.source = "direct";
-            lock.time = std::chrono::system_clock::now();
-            m_locked_source = lock.source;
-            m_locked_source_time = lock.time;
-            return baseValue;
-        }
+void Instrument::ArbitrateSource(const wxString& path)
+{
+    const int srcPos = path.Find("SRC:");
+    SourceArbiter::policy mode;
+    if (!m_parent_dashboard || srcPos == wxNOT_FOUND
+        || !SourceArbiter::ParsePolicy(path.Mid(srcPos + 4), mode)) {
+        return;
+    }
+    // The source is chosen centrally for all the instruments showing the
+    // path, we only offer our persisted lock and follow the choice
+    static const wxString NO_SOURCE;
+    source_lock& lock = m_source_locks[path];
+    if (lock.time.time_since_epoch().count() == 0) {
+        lock.time = Now();
+    }
+    m_locked_source_path = path;
+    const wxString* preferred = nullptr;
+    if (!lock.source.IsEmpty()) {
+        preferred = lock.source.IsSameAs("direct") ? &NO_SOURCE : &lock.source;
+    }
+    m_parent_dashboard->ArbitrateSource(path, this,
+        [this](const source_event& e) { SourceChanged(e); }, preferred);
+    m_locked_source = lock.source;
+    m_locked_source_time = lock.time;
+}
 
-        // Scan for first available SRC: entry
-        for (const auto& name : baseValue->getMemberNames()) {
-            if (name.find("SRC:") == 0) {
-                const Json::Value* candidate = &(*baseValue)[name];
-                // Return this source container if it has any data (value for
-                // scalars, or nested data for complex types like position with
-                // latitude/longitude)
-                if (candidate->isMember("value")
-                    || !candidate->getMemberNames().empty()) {
-                    // Found first available source - lock to it
-                    wxString srcName(name);
-                    wxString srcValue = srcName.Mid(4); // Skip "SRC:"
-                    lock.source = srcValue;
-                    lock.time = std::chrono::system_clock::now();
-                    m_locked_source = lock.source;
-                    m_locked_source_time = lock.time;
-                    return candidate;
-                }
-            }
-        }
+const Json::Value* Instrument::GetSKDataResolved(const wxString& path)
+{
+    if (!m_parent_dashboard) {
         return nullptr;
-    } else {
-        // Exact source designation - delegate to base GetSKData
-        return m_parent_dashboard->GetSKData(path);
     }
+    // The arbitrated sources were subscribed to along with the path, the
+    // expressions, pipelines and source designations are resolved centrally
+    return m_parent_dashboard->GetSKData(path);
 }
 
 PLUGIN_END_NAMESPACE
@@ -0,0 +1,119 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "instrumentstats.h"
+
+#include <algorithm>
+
+PLUGIN_BEGIN_NAMESPACE
+
+void InstrumentStats::Reset()
+{
+    m_renders = 0;
+    m_skipped = 0;
+    m_total_us = 0.0;
+    m_samples.fill(0.0f);
+    m_sample_count = 0;
+    m_sample_pos = 0;
+    m_raster_us = 0.0;
+    m_bitmap_bytes = 0;
+    m_last_bitmap = nullptr;
+    m_notifications = 0;
+    m_window_start = std::chrono::system_clock::time_point();
+    m_window_notifications = 0;
+    m_notification_rate = 0.0;
+}
+
+void InstrumentStats::AddRender(timer::duration elapsed, const wxBitmap& bmp)
+{
+    m_renders++;
+    if (!bmp.IsOk() || bmp.GetRefData() == m_last_bitmap) {
+        m_skipped++;
+        return;
+    }
+    m_last_bitmap = bmp.GetRefData();
+    const int depth = bmp.GetDepth() > 0 ? bmp.GetDepth() : 32;
+    m_bitmap_bytes = static_cast<size_t>(bmp.GetWidth()) * bmp.GetHeight()
+        * depth / 8;
+    const double us
+        = std::chrono::duration<double, std::micro>(elapsed).count()
+        + m_raster_us;
+    m_raster_us = 0.0;
+    m_total_us += us;
+    m_samples[m_sample_pos] = static_cast<float>(us);
+    m_sample_pos = (m_sample_pos + 1) % SAMPLES;
+    m_sample_count = std::min(m_sample_count + 1, SAMPLES);
+}
+
+void InstrumentStats::AddRasterTime(timer::duration elapsed)
+{
+    m_raster_us += std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+void InstrumentStats::AddNotification(std::chrono::system_clock::time_point now)
+{
+    m_notifications++;
+    if (m_window_start == std::chrono::system_clock::time_point()) {
+        m_window_start = now;
+        return;
+    }
+    m_window_notifications++;
+    const auto window = now - m_window_start;
+    if (window >= std::chrono::seconds(1)) {
+        m_notification_rate = m_window_notifications
+            / std::chrono::duration<double>(window).count();
+        m_window_start = now;
+        m_window_notifications = 0;
+    }
+}
+
+double InstrumentStats::GetMeanRenderTime() const
+{
+    const size_t rendered = m_renders - m_skipped;
+    return rendered > 0 ? m_total_us / rendered : 0.0;
+}
+
+double InstrumentStats::GetP99RenderTime() const
+{
+    if (m_sample_count == 0) {
+        return 0.0;
+    }
+    std::array<float, SAMPLES> sorted = m_samples;
+    const size_t n = (m_sample_count * 99 + 99) / 100 - 1;
+    std::nth_element(
+        sorted.begin(), sorted.begin() + n, sorted.begin() + m_sample_count);
+    return sorted[n];
+}
+
+wxString InstrumentStats::ToString() const
+{
+    return wxString::Format("%zu/%zu skip, %.2f/%.2f ms, %zu kB, %.1f/s",
+        m_skipped, m_renders, GetMeanRenderTime() / 1000.0,
+        GetP99RenderTime() / 1000.0, m_bitmap_bytes / 1024,
+        m_notification_rate);
+}
+
+PLUGIN_END_NAMESPACE
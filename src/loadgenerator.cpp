@@ -0,0 +1,286 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "loadgenerator.h"
+#include "dashboardsk.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include <wx/tokenzr.h>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Paths generated for each vessel, the rest are synthetic sensors
+static const struct {
+    const char* path;
+    const char* units;
+    double min;
+    double max;
+} LOAD_PATHS[] = { { "navigation.speedOverGround", "m/s", 0.0, 5.0 },
+    { "navigation.courseOverGroundTrue", "rad", 0.0, 6.283 },
+    { "navigation.headingMagnetic", "rad", 0.0, 6.283 },
+    { "navigation.speedThroughWater", "m/s", 0.0, 5.0 },
+    { "environment.wind.angleApparent", "rad", -3.141, 3.141 },
+    { "environment.wind.speedApparent", "m/s", 0.0, 20.0 },
+    { "environment.depth.belowTransducer", "m", 1.0, 50.0 },
+    { "environment.water.temperature", "K", 280.0, 300.0 },
+    { "environment.outside.pressure", "Pa", 98000.0, 103000.0 },
+    { "electrical.batteries.house.voltage", "V", 11.5, 14.4 },
+    { "steering.rudderAngle", "rad", -0.6, 0.6 },
+    { "propulsion.main.revolutions", "Hz", 0.0, 50.0 } };
+
+load_profile load_profile::Parse(const wxString& spec)
+{
+    load_profile p;
+    wxStringTokenizer tokenizer(spec, ",");
+    while (tokenizer.HasMoreTokens()) {
+        wxString token = tokenizer.GetNextToken();
+        wxString key = token.BeforeFirst('=').Trim().Trim(false);
+        double val;
+        if (!token.AfterFirst('=').Trim().Trim(false).ToCDouble(&val)
+            || val < 0.0) {
+            LOG_INFO("DashboardSK_pi: Ignoring load profile setting " + token);
+            continue;
+        }
+        if (key == "vessels") {
+            p.vessels = std::max(1, static_cast<int>(val));
+        } else if (key == "paths") {
+            p.paths = std::max(1, static_cast<int>(val));
+        } else if (key == "sources") {
+            p.sources = std::max(1, static_cast<int>(val));
+        } else if (key == "rate") {
+            p.rate = val > 0.0 ? val : 1.0;
+        } else if (key == "meta") {
+            p.meta_interval = val;
+        } else if (key == "seed") {
+            p.seed = static_cast<unsigned int>(val);
+        } else {
+            LOG_INFO("DashboardSK_pi: Unknown load profile setting " + key);
+        }
+    }
+    return p;
+}
+
+/// Format a time as an ISO 8601 UTC timestamp with milliseconds
+///
+/// \param tp The time
+/// \return The timestamp
+static wxString IsoTimestamp(Clock::time_point tp)
+{
+    using namespace std::chrono;
+    const int64_t ms
+        = duration_cast<milliseconds>(tp.time_since_epoch()).count();
+    int64_t days = ms / 86400000;
+    int64_t rem = ms % 86400000;
+    if (rem < 0) {
+        rem += 86400000;
+        days--;
+    }
+    // Civil date from the days since the epoch (proleptic Gregorian calendar)
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const int64_t doe = days - era * 146097;
+    const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int64_t mp = (5 * doy + 2) / 153;
+    const int day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    const int month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    const int year = static_cast<int>(yoe + era * 400 + (month <= 2));
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", year,
+        month, day, static_cast<int>(rem / 3600000),
+        static_cast<int>(rem / 60000 % 60), static_cast<int>(rem / 1000 % 60),
+        static_cast<int>(rem % 1000));
+    return wxString(buf);
+}
+
+LoadGenerator::LoadGenerator(const load_profile& profile)
+    : m_profile(profile)
+    , m_rng(profile.seed)
+    , m_started(false)
+    , m_messages(0)
+    , m_values_sent(0)
+    , m_dropped_ticks(0)
+{
+    const size_t known = sizeof(LOAD_PATHS) / sizeof(LOAD_PATHS[0]);
+    for (int i = 0; i < m_profile.paths; i++) {
+        if (static_cast<size_t>(i) < known) {
+            m_paths.push_back({ LOAD_PATHS[i].path, LOAD_PATHS[i].units,
+                LOAD_PATHS[i].min, LOAD_PATHS[i].max });
+        } else {
+            m_paths.push_back({ wxString::Format("sensors.synthetic.p%i", i),
+                "ratio", 0.0, 1.0 });
+        }
+    }
+    std::uniform_real_distribution<double> start(0.0, 1.0);
+    m_values.resize(static_cast<size_t>(m_profile.vessels)
+        * m_profile.sources * m_paths.size());
+    for (size_t i = 0; i < m_values.size(); i++) {
+        const path_def& def = m_paths[i % m_paths.size()];
+        m_values[i] = def.min + (def.max - def.min) * start(m_rng);
+    }
+}
+
+Clock::base_clock::duration LoadGenerator::Period() const
+{
+    return std::chrono::duration_cast<Clock::base_clock::duration>(
+        std::chrono::duration<double>(1.0 / m_profile.rate));
+}
+
+wxString LoadGenerator::Context(int vessel)
+{
+    return wxString::Format("vessels.urn:mrn:imo:mmsi:2000%05i", vessel);
+}
+
+Json::Value LoadGenerator::MakeDelta(
+    int vessel, int source, Clock::time_point ts)
+{
+    Json::Value update;
+    Json::Value& src = update["source"];
+    if (source % 2 == 0) {
+        src["type"] = "NMEA0183";
+        src["label"] = toJson(wxString::Format("GPS-%i", source));
+        src["talker"] = "GP";
+        src["sentence"] = "RMC";
+    } else {
+        src["type"] = "NMEA2000";
+        src["label"] = toJson(wxString::Format("N2K-%i", source));
+        src["src"] = toJson(wxString::Format("%i", source));
+        src["pgn"] = 128267;
+    }
+    update["timestamp"] = toJson(IsoTimestamp(ts));
+    std::normal_distribution<double> step(0.0, 0.01);
+    const size_t base
+        = (static_cast<size_t>(vessel) * m_profile.sources + source)
+        * m_paths.size();
+    Json::Value& values = update["values"];
+    for (size_t i = 0; i < m_paths.size(); i++) {
+        const path_def& def = m_paths[i];
+        double& val = m_values[base + i];
+        val = std::min(def.max,
+            std::max(def.min, val + (def.max - def.min) * step(m_rng)));
+        Json::Value v;
+        v["path"] = toJson(def.path);
+        v["value"] = val;
+        values.append(v);
+    }
+    Json::Value delta;
+    delta["context"] = toJson(Context(vessel));
+    delta["updates"].append(update);
+    return delta;
+}
+
+Json::Value LoadGenerator::MakeMeta(int vessel) const
+{
+    Json::Value update;
+    Json::Value& meta = update["meta"];
+    for (const auto& def : m_paths) {
+        Json::Value m;
+        m["path"] = toJson(def.path);
+        m["value"]["units"] = toJson(def.units);
+        m["value"]["displayName"] = toJson(def.path.AfterLast('.'));
+        // Alarm at the bottom tenth of the range to keep the alarm engine
+        // busy as the values wander around
+        Json::Value zone;
+        zone["lower"] = def.min;
+        zone["upper"] = def.min + (def.max - def.min) / 10;
+        zone["state"] = "alarm";
+        m["value"]["zones"].append(zone);
+        meta.append(m);
+    }
+    Json::Value delta;
+    delta["context"] = toJson(Context(vessel));
+    delta["updates"].append(update);
+    return delta;
+}
+
+size_t LoadGenerator::Tick(DashboardSK& dsk, Clock::time_point ts)
+{
+    if (m_clock) {
+        m_clock->Set(ts);
+    }
+    size_t sent = 0;
+    if (!m_started || (m_profile.meta_interval > 0.0 && ts >= m_next_meta)) {
+        for (int vessel = 0; vessel < m_profile.vessels; vessel++) {
+            Json::Value meta = MakeMeta(vessel);
+            dsk.SendSKDelta(meta);
+            sent++;
+        }
+        m_next_meta = ts
+            + std::chrono::duration_cast<Clock::base_clock::duration>(
+                std::chrono::duration<double>(m_profile.meta_interval));
+    }
+    m_started = true;
+    for (int vessel = 0; vessel < m_profile.vessels; vessel++) {
+        for (int source = 0; source < m_profile.sources; source++) {
+            Json::Value delta = MakeDelta(vessel, source, ts);
+            dsk.SendSKDelta(delta);
+            sent++;
+        }
+    }
+    m_values_sent += static_cast<size_t>(m_profile.vessels)
+        * m_profile.sources * m_paths.size();
+    m_messages += sent;
+    if (m_clock) {
+        dsk.ProcessData();
+    }
+    return sent;
+}
+
+size_t LoadGenerator::Pump(DashboardSK& dsk, Clock::time_point now)
+{
+    if (!m_started) {
+        m_next_tick = now;
+    }
+    const Clock::base_clock::duration period = Period();
+    if (now - m_next_tick > std::chrono::seconds(1)) {
+        // We can't keep up, skip ahead instead of trying to catch up forever
+        const auto behind = (now - m_next_tick) / period;
+        m_dropped_ticks += behind;
+        m_next_tick += behind * period;
+    }
+    size_t sent = 0;
+    for (size_t ticks = 0; ticks < MAX_BATCH && m_next_tick <= now; ticks++) {
+        sent += Tick(dsk, m_next_tick);
+        m_next_tick += period;
+    }
+    return sent;
+}
+
+size_t LoadGenerator::Run(DashboardSK& dsk, Clock::time_point start,
+    Clock::base_clock::duration span)
+{
+    const Clock::base_clock::duration period = Period();
+    size_t sent = 0;
+    for (Clock::time_point ts = start; ts < start + span; ts += period) {
+        sent += Tick(dsk, ts);
+    }
+    return sent;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,149 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "memoryreport.h"
+#include "dashboardsk.h"
+
+#include <wx/ffile.h>
+
+#include <algorithm>
+#include <limits>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// Overhead of a member of a JSON object or array, the node of the map
+/// holding it (three pointers and the color of the red-black tree) and its key
+/// (a pointer to the name and its length)
+static constexpr size_t JSON_MEMBER_OVERHEAD
+    = 4 * sizeof(void*) + sizeof(void*) + 2 * sizeof(unsigned);
+
+/// Titles of the sections of the report
+static const char* const SECTION_TITLES[] = { "SignalK data by context",
+    "SignalK data by path", "Instrument histories", "Instrument bitmaps" };
+
+/// Names of the items counted in the sections of the report
+static const char* const SECTION_ITEMS[]
+    = { "nodes", "nodes", "samples", "pixels" };
+
+size_t MemoryReport::EstimateJSON(const Json::Value& value, size_t& nodes)
+{
+    ++nodes;
+    size_t bytes = sizeof(Json::Value);
+    if (value.isString()) {
+        const char* begin;
+        const char* end;
+        if (value.getString(&begin, &end)) {
+            // Stored with its length and a terminating NUL
+            bytes += static_cast<size_t>(end - begin) + sizeof(unsigned) + 1;
+        }
+    } else if (value.isObject() || value.isArray()) {
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            bytes += JSON_MEMBER_OVERHEAD;
+            const char* end;
+            const char* name = it.memberName(&end);
+            if (name) {
+                bytes += static_cast<size_t>(end - name) + sizeof(unsigned) + 1;
+            }
+            // The value itself is stored in the node, do not count it twice
+            bytes += EstimateJSON(*it, nodes) - sizeof(Json::Value);
+        }
+    }
+    return bytes;
+}
+
+void MemoryReport::Add(
+    section s, const wxString& name, size_t bytes, size_t items)
+{
+    vector<memory_entry>& entries = m_entries[static_cast<size_t>(s)];
+    auto it = std::find_if(entries.begin(), entries.end(),
+        [&name](const memory_entry& e) { return e.name == name; });
+    if (it == entries.end()) {
+        entries.push_back({ name, bytes, items });
+    } else {
+        it->bytes += bytes;
+        it->items += items;
+    }
+}
+
+vector<memory_entry> MemoryReport::GetEntries(section s) const
+{
+    vector<memory_entry> entries = m_entries[static_cast<size_t>(s)];
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const memory_entry& a, const memory_entry& b) {
+            return a.bytes > b.bytes;
+        });
+    return entries;
+}
+
+size_t MemoryReport::GetBytes(section s) const
+{
+    size_t bytes = 0;
+    for (const auto& e : m_entries[static_cast<size_t>(s)]) {
+        bytes += e.bytes;
+    }
+    return bytes;
+}
+
+size_t MemoryReport::GetTotalBytes() const
+{
+    return GetBytes(section::contexts) + GetBytes(section::histories)
+        + GetBytes(section::bitmaps);
+}
+
+wxString MemoryReport::ToString(size_t max_entries) const
+{
+    wxString report = wxString::Format(
+        "Total: %.1f kB\n", static_cast<double>(GetTotalBytes()) / 1024.0);
+    for (size_t i = 0; i < static_cast<size_t>(section::count); i++) {
+        const section s = static_cast<section>(i);
+        const vector<memory_entry> entries = GetEntries(s);
+        report.Append(wxString::Format("\n%s: %.1f kB in %zu entries\n",
+            SECTION_TITLES[i], static_cast<double>(GetBytes(s)) / 1024.0,
+            entries.size()));
+        for (size_t e = 0; e < entries.size() && e < max_entries; e++) {
+            report.Append(wxString::Format("%10.1f kB %8zu %-7s %s\n",
+                static_cast<double>(entries[e].bytes) / 1024.0,
+                entries[e].items, SECTION_ITEMS[i], entries[e].name.c_str()));
+        }
+        if (entries.size() > max_entries) {
+            report.Append(wxString::Format(
+                "%13s %zu more\n", "...", entries.size() - max_entries));
+        }
+    }
+    return report;
+}
+
+bool MemoryReport::Save(const wxString& path) const
+{
+    wxFFile f(path, "w");
+    if (!f.IsOpened()) {
+        LOG_VERBOSE("DashboardSK_pi: Can't save memory report to " + path);
+        return false;
+    }
+    return f.Write(ToString(std::numeric_limits<size_t>::max()), wxConvUTF8);
+}
+
+PLUGIN_END_NAMESPACE
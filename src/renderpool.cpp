@@ -0,0 +1,104 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "renderpool.h"
+
+PLUGIN_BEGIN_NAMESPACE
+
+RenderPool::RenderPool(size_t threads)
+    : m_jobs(nullptr)
+    , m_next(0)
+    , m_pending(0)
+    , m_stop(false)
+{
+    for (size_t i = 0; i < threads; ++i) {
+        m_threads.emplace_back(&RenderPool::Worker, this);
+    }
+}
+
+RenderPool::~RenderPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (auto& t : m_threads) {
+        t.join();
+    }
+}
+
+size_t RenderPool::DefaultThreadCount()
+{
+    size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void RenderPool::Drain(std::unique_lock<std::mutex>& lock)
+{
+    while (m_jobs && m_next < m_jobs->size()) {
+        const std::function<void()>& job = (*m_jobs)[m_next++];
+        lock.unlock();
+        job();
+        lock.lock();
+        if (--m_pending == 0) {
+            m_done_cv.notify_all();
+        }
+    }
+}
+
+void RenderPool::Worker()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_work_cv.wait(lock, [this] {
+            return m_stop || (m_jobs && m_next < m_jobs->size());
+        });
+        if (m_stop) {
+            return;
+        }
+        Drain(lock);
+    }
+}
+
+void RenderPool::Run(const vector<std::function<void()>>& jobs)
+{
+    if (jobs.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobs = &jobs;
+    m_next = 0;
+    m_pending = jobs.size();
+    if (jobs.size() > 1) {
+        m_work_cv.notify_all();
+    }
+    Drain(lock);
+    m_done_cv.wait(lock, [this] { return m_pending == 0; });
+    m_jobs = nullptr;
+}
+
+PLUGIN_END_NAMESPACE
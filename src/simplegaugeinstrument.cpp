@@ -36,9 +36,6 @@ void SimpleGaugeInstrument::Init()
 #define X(a, b, c) m_supported_formats.Add(b);
     DSK_VALUE_FORMATS
 #undef X
-#define X(a, b, c) m_format_strings.Add(c);
-    DSK_VALUE_FORMATS
-#undef X
 #define X(a, b) m_supported_transforms.Add(b);
     DSK_UNIT_TRANSFORMATIONS
 #undef X
@@ -61,6 +58,11 @@ void SimpleGaugeInstrument::Init()
     m_max_val = std::numeric_limits<double>::min();
     m_min_val = std::numeric_limits<double>::max();
 
+#define X(a, b, c, d, e, f, g, h)                                              \
+    RegisterTypedSetting(b##_IDX, b, dskConfigCtrl::e);
+    DSK_SGI_SETTINGS
+#undef X
+
 #define X(a, b, c, d, e, f, g, h) SetSetting(b, c);
     DSK_SGI_SETTINGS
 #undef X
@@ -78,10 +80,7 @@ void SimpleGaugeInstrument::SetSetting(
     Instrument::SetSetting(key, value);
     if (key == DSK_SETTING_SK_KEY && !m_sk_key.IsSameAs(value)) {
         m_sk_key = wxString(value);
-        if (m_parent_dashboard) {
-            m_parent_dashboard->Unsubscribe(this);
-            m_parent_dashboard->Subscribe(m_sk_key, this);
-        }
+        UpdateDataKey();
     } else if (key.IsSameAs(DSK_SETTING_FORMAT)
         || key.IsSameAs(DSK_SETTING_TRANSFORMATION)
         || key.IsSameAs(DSK_SETTING_SMOOTHING)
@@ -110,17 +109,42 @@ void SimpleGaugeInstrument::SetSetting(const wxString& key, const int& value)
         m_format_index = value;
     } else if (key.IsSameAs(DSK_SETTING_TRANSFORMATION)) {
         m_transformation = static_cast<transformation>(value);
+        TransformationChanged();
     } else if (key.IsSameAs(DSK_SETTING_INSTR_SIZE)) {
         m_instrument_size = value;
     } else if (key.IsSameAs(DSK_SGI_GAUGE_TYPE)) {
         m_gauge_type = static_cast<gauge_type>(value);
     } else if (key.IsSameAs(DSK_SETTING_SMOOTHING)) {
         m_smoothing = value;
+        UpdateDataKey();
+    }
+}
+
+void SimpleGaugeInstrument::UpdateDataKey()
+{
+    wxString key = m_sk_key;
+    if (m_smoothing > 0 && !m_sk_key.IsEmpty()
+        && !Expression::IsExpression(m_sk_key)) {
+        // EMA with the same weight of the newest value as the smoothing ratio
+        const double n = 2.0 * (DSK_SGI_SMOOTHING_MAX + 1)
+                / (DSK_SGI_SMOOTHING_MAX - m_smoothing + 1)
+            - 1.0;
+        key += wxString(FILTER_SEPARATOR) + wxString::Format("ema(%g)", n);
+    }
+    if (key.IsSameAs(m_data_key)) {
+        return;
+    }
+    m_data_key = key;
+    m_old_value = std::numeric_limits<double>::min();
+    if (m_parent_dashboard) {
+        m_parent_dashboard->Unsubscribe(this);
+        m_parent_dashboard->Subscribe(m_data_key, this);
     }
 }
 
 // Counterclockwise
-void SimpleGaugeInstrument::DrawArc(wxDC& dc, const int& start_angle,
+template <class DC>
+void SimpleGaugeInstrument::DrawArc(DC& dc, const int& start_angle,
     const int& end_angle, const wxCoord& xc, const wxCoord& yc,
     const wxCoord& r)
 {
@@ -132,7 +156,8 @@ void SimpleGaugeInstrument::DrawArc(wxDC& dc, const int& start_angle,
     dc.DrawArc(xStart, yStart, xEnd, yEnd, xc, yc);
 }
 
-void SimpleGaugeInstrument::DrawTicks(wxDC& dc, const int& start_angle,
+template <class DC>
+void SimpleGaugeInstrument::DrawTicks(DC& dc, const int& start_angle,
     const int& angle_step, const wxCoord& xc, const wxCoord& yc,
     const wxCoord& r, const wxCoord& length, bool labels, int except_every,
     bool relative, int draw_from, int draw_to, int labels_from, int labels_step)
@@ -177,7 +202,8 @@ void SimpleGaugeInstrument::DrawTicks(wxDC& dc, const int& start_angle,
     }
 }
 
-void SimpleGaugeInstrument::DrawNeedle(wxDC& dc, const wxCoord& xc,
+template <class DC>
+void SimpleGaugeInstrument::DrawNeedle(DC& dc, const wxCoord& xc,
     const wxCoord& yc, const wxCoord& r, const wxCoord& angle,
     const int& perc_length, const int& perc_width, const int& start_angle)
 {
@@ -202,150 +228,105 @@ void SimpleGaugeInstrument::DrawNeedle(wxDC& dc, const wxCoord& xc,
     dc.DrawPolygon(3, needle, xc, yc);
 }
 
-wxBitmap SimpleGaugeInstrument::RenderAngle(double scale, bool relative)
+template <class DC>
+void SimpleGaugeInstrument::PaintAngle(
+    DC& dc, const wxString& value, bool relative)
 {
-    wxString value = "---";
-
-    if (m_new_data) {
-        m_new_data = false;
-        if (!m_timed_out) {
-            value = FormatCenterValue();
-        }
-    } else {
-        if (!m_timed_out && m_bmp.IsOk()) {
-            return m_bmp;
-        }
-    }
-
-    wxMemoryDC mdc;
-
-    wxCoord size_x = m_instrument_size * scale;
-    wxCoord size_y = m_instrument_size * scale;
+    wxCoord size_x = dc.GetSize().GetWidth();
+    wxCoord size_y = dc.GetSize().GetHeight();
     wxCoord xc = size_x / 2;
     wxCoord yc = size_y / 2;
     wxCoord r = size_y / 2 - size_x / 200 - 1;
 
-#if defined(__WXGTK__) || defined(__WXQT__)
-    m_bmp = wxBitmap(size_x, size_y, 32);
-#else
-    m_bmp = wxBitmap(size_x, size_y);
-    m_bmp.UseAlpha();
-#endif
-    mdc.SelectObject(m_bmp);
-#if wxUSE_GRAPHICS_CONTEXT
-    wxGCDC dc(mdc);
-#else
-    wxMemoryDC& dc(mdc);
-#endif
     dc.SetBackground(*wxTRANSPARENT_BRUSH);
     dc.Clear();
 
     // Gauge background
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_NOMINAL))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR))));
+    dc.SetBrush(
+        wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX))));
+    dc.SetPen(
+        wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r);
     if (relative) {
         // Arcs
-        dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_DEAD))));
-        dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_RIM_DEAD))));
+        dc.SetBrush(
+            wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_DEAD_IDX))));
+        dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_DEAD_IDX))));
         DrawArc(dc, 15, -15, xc, yc, r);
-        dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_STBD))));
-        dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_RIM_STBD))));
+        dc.SetBrush(
+            wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_STBD_IDX))));
+        dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_STBD_IDX))));
         DrawArc(dc, 60, 15, xc, yc, r);
-        dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_PORT))));
-        dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_RIM_PORT))));
+        dc.SetBrush(
+            wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_PORT_IDX))));
+        dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_PORT_IDX))));
         DrawArc(dc, -15, -60, xc, yc, r);
     }
     // Face
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
+    dc.SetBrush(wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r * 0.85);
     // Ticks
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_SGI_TICK_LEGEND)));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 200));
+    dc.SetTextForeground(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 200));
     DrawTicks(dc, 0, 30, xc, yc, r, r * 0.15, true, 90, relative);
     DrawTicks(dc, 0, 10, xc, yc, r, r * 0.1);
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 100));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 100));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     DrawTicks(dc, 0, 90, xc, yc, r, r * 0.2, true, 0, relative);
     // Border
     dc.SetBrush(*wxTRANSPARENT_BRUSH);
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR)),
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX)),
         size_x / 100 + 1));
     dc.DrawCircle(xc, yc, r);
     // Needle
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG)), 3));
+    dc.SetBrush(wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX))));
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX)), 3));
     DrawNeedle(dc, xc, yc, r * 0.9, m_old_value, 30);
     // Text
     // Label
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::title)));
-    dc.SetFont(wxFont(size_x / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    const Zone::state zs = GetZoneState(m_old_value);
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::title)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 8 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     dc.DrawText(m_title, xc - dc.GetTextExtent(m_title).GetX() / 2,
         yc - dc.GetTextExtent(m_title).GetY() * 1.5);
     // Data
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::value)));
-    dc.SetFont(wxFont(size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
-        wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::value)));
+    dc.SetFont(GetFontCache().GetFont(
+        size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     dc.DrawText(value, xc - dc.GetTextExtent(value).GetX() / 2,
         yc
             - (wxCoord)round(
                   dc.GetTextExtent(value).GetY() * AUTO_TEXT_SHIFT_COEF)
                 / 4);
-    mdc.SelectObject(wxNullBitmap);
-    return m_bmp;
 }
 
-wxBitmap SimpleGaugeInstrument::RenderAdaptive(double scale)
+template <class DC>
+void SimpleGaugeInstrument::PaintAdaptive(
+    DC& dc, const wxString& value, bool has_value)
 {
 #define PERC 30
-    wxString value = "----";
-    bool has_value = false;
-
-    if (m_new_data) {
-        m_new_data = false;
-        if (!m_timed_out) {
-            has_value = true;
-            value = FormatCenterValue();
-        }
-    } else {
-        if (!m_timed_out && m_bmp.IsOk()) {
-            return m_bmp;
-        }
-    }
-
-    wxCoord size_x = m_instrument_size * scale;
-    wxCoord size_y = m_instrument_size * scale * (50 + PERC) / 100;
+    wxCoord size_x = dc.GetSize().GetWidth();
+    wxCoord size_y = dc.GetSize().GetHeight();
     wxCoord xc = size_x / 2;
-    wxCoord yc = m_instrument_size * scale / 2;
+    wxCoord yc = size_x / 2;
     wxCoord r = size_x / 2 - size_x / 200 - 1;
 
-#if defined(__WXGTK__) || defined(__WXQT__)
-    m_bmp = wxBitmap(size_x, size_y, 32);
-#else
-    m_bmp = wxBitmap(size_x, size_y);
-    m_bmp.UseAlpha();
-#endif
-    wxMemoryDC mdc;
-    mdc.SelectObject(m_bmp);
-#if wxUSE_GRAPHICS_CONTEXT
-    wxGCDC dc(mdc);
-#else
-    wxMemoryDC& dc(mdc);
-#endif
     dc.SetBackground(*wxTRANSPARENT_BRUSH);
     dc.Clear();
     // Gauge background
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_NOMINAL))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR))));
+    dc.SetBrush(
+        wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX))));
+    dc.SetPen(
+        wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r);
 
     int magnitude = -3;
@@ -408,23 +389,24 @@ wxBitmap SimpleGaugeInstrument::RenderAdaptive(double scale)
         DrawArc(dc, angle_to, angle_from, xc, yc, r);
     }
     // Face
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
+    dc.SetBrush(wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r * 0.85);
     // Ticks
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_SGI_TICK_LEGEND)));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 200));
+    dc.SetTextForeground(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 200));
     DrawTicks(dc, 0, 20, xc, yc, r, r * 0.15, false, 90, false, 0, 120);
     DrawTicks(dc, 0, 10, xc, yc, r, r * 0.1, false, 90, false, 0, 120);
     DrawTicks(dc, 0, 20, xc, yc, r, r * 0.15, false, 90, false, 240, 360);
     DrawTicks(dc, 0, 10, xc, yc, r, r * 0.1, false, 90, false, 240, 360);
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 100));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 100));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
 
     if (has_value) {
         DrawTicks(dc, 0, 40, xc, yc, r, r * 0.2, true, 0, false, 0, 120,
@@ -438,7 +420,7 @@ wxBitmap SimpleGaugeInstrument::RenderAdaptive(double scale)
     // Border
     dc.SetBrush(*wxTRANSPARENT_BRUSH);
     int border_width = size_x / 100 + 1;
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR)),
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX)),
         border_width));
     dc.DrawCircle(xc, yc, r);
     int shift = r - sqrt(r * r - r * 2 * PERC * r * 2 * PERC / 10000);
@@ -446,8 +428,10 @@ wxBitmap SimpleGaugeInstrument::RenderAdaptive(double scale)
         size_x - shift - border_width, size_y - border_width / 2);
     // Needle
     if (has_value) {
-        dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG))));
-        dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG)), 3));
+        dc.SetBrush(
+            wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX))));
+        dc.SetPen(
+            wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX)), 3));
         DrawNeedle(dc, xc, yc, r * 0.9,
             (m_old_value - lower) * 240 / (upper - lower) - 90, 30, 20, 240);
     }
@@ -461,66 +445,40 @@ wxBitmap SimpleGaugeInstrument::RenderAdaptive(double scale)
     }
     dc.DrawText(sscale, xc - dc.GetTextExtent(sscale).GetX() / 2, r * 0.5);
     // Label
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::title)));
-    dc.SetFont(wxFont(size_x / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    const Zone::state zs = GetZoneState(m_old_value);
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::title)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 8 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     dc.DrawText(m_title, xc - dc.GetTextExtent(m_title).GetX() / 2,
         yc - dc.GetTextExtent(m_title).GetY() * 1.1);
     // Data
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::value)));
-    dc.SetFont(wxFont(size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
-        wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::value)));
+    dc.SetFont(GetFontCache().GetFont(
+        size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     dc.DrawText(value, xc - dc.GetTextExtent(value).GetX() / 2,
         yc / AUTO_TEXT_SHIFT_COEF);
-    mdc.SelectObject(wxNullBitmap);
-    return m_bmp;
 #undef PERC
 }
 
-wxBitmap SimpleGaugeInstrument::RenderFixed(double scale)
+template <class DC>
+void SimpleGaugeInstrument::PaintFixed(
+    DC& dc, const wxString& value, bool has_value)
 {
 #define PERC 30
-    wxString value = "----";
-    bool has_value = false;
-
-    if (m_new_data) {
-        m_new_data = false;
-        if (!m_timed_out) {
-            has_value = true;
-            value = FormatCenterValue();
-        }
-    } else {
-        if (!m_timed_out && m_bmp.IsOk()) {
-            return m_bmp;
-        }
-    }
-
-    wxCoord size_x = m_instrument_size * scale;
-    wxCoord size_y = m_instrument_size * scale * (50 + PERC) / 100;
+    wxCoord size_x = dc.GetSize().GetWidth();
+    wxCoord size_y = dc.GetSize().GetHeight();
     wxCoord xc = size_x / 2;
-    wxCoord yc = m_instrument_size * scale / 2;
+    wxCoord yc = size_x / 2;
     wxCoord r = size_x / 2 - size_x / 200 - 1;
 
-#if defined(__WXGTK__) || defined(__WXQT__)
-    m_bmp = wxBitmap(size_x, size_y, 32);
-#else
-    m_bmp = wxBitmap(size_x, size_y);
-    m_bmp.UseAlpha();
-#endif
-    wxMemoryDC mdc;
-    mdc.SelectObject(m_bmp);
-#if wxUSE_GRAPHICS_CONTEXT
-    wxGCDC dc(mdc);
-#else
-    wxMemoryDC& dc(mdc);
-#endif
     dc.SetBackground(*wxTRANSPARENT_BRUSH);
     dc.Clear();
     // Gauge background
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_NOMINAL))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR))));
+    dc.SetBrush(
+        wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX))));
+    dc.SetPen(
+        wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r);
 
     int magnitude = 0;
@@ -585,23 +543,24 @@ wxBitmap SimpleGaugeInstrument::RenderFixed(double scale)
         DrawArc(dc, angle_to, angle_from, xc, yc, r);
     }
     // Face
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
+    dc.SetBrush(wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r * 0.85);
     // Ticks
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_SGI_TICK_LEGEND)));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 200));
+    dc.SetTextForeground(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 200));
     DrawTicks(dc, 0, 20, xc, yc, r, r * 0.15, false, 90, false, 0, 120);
     DrawTicks(dc, 0, 10, xc, yc, r, r * 0.1, false, 90, false, 0, 120);
     DrawTicks(dc, 0, 20, xc, yc, r, r * 0.15, false, 90, false, 240, 360);
     DrawTicks(dc, 0, 10, xc, yc, r, r * 0.1, false, 90, false, 240, 360);
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 100));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 100));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
 
     DrawTicks(dc, 0, 40, xc, yc, r, r * 0.2, true, 0, false, 0, 120,
         lower / pow(10, magnitude) + 3 * step,
@@ -613,7 +572,7 @@ wxBitmap SimpleGaugeInstrument::RenderFixed(double scale)
     // Border
     dc.SetBrush(*wxTRANSPARENT_BRUSH);
     int border_width = size_x / 100 + 1;
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR)),
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX)),
         border_width));
     dc.DrawCircle(xc, yc, r);
     int shift = r - sqrt(r * r - r * 2 * PERC * r * 2 * PERC / 10000);
@@ -621,8 +580,10 @@ wxBitmap SimpleGaugeInstrument::RenderFixed(double scale)
         size_x - shift - border_width, size_y - border_width / 2);
     // Needle
     if (has_value && m_old_value >= lower && m_old_value <= upper) {
-        dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG))));
-        dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG)), 3));
+        dc.SetBrush(
+            wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX))));
+        dc.SetPen(
+            wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX)), 3));
         DrawNeedle(dc, xc, yc, r * 0.9,
             (m_old_value - lower) * 240 / (upper - lower) - 90, 30, 20, 240);
     }
@@ -636,65 +597,39 @@ wxBitmap SimpleGaugeInstrument::RenderFixed(double scale)
     }
     dc.DrawText(sscale, xc - dc.GetTextExtent(sscale).GetX() / 2, r * 0.5);
     // Label
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::title)));
-    dc.SetFont(wxFont(size_x / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    const Zone::state zs = GetZoneState(m_old_value);
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::title)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 8 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     dc.DrawText(m_title, xc - dc.GetTextExtent(m_title).GetX() / 2,
         yc - dc.GetTextExtent(m_title).GetY() * 1.1);
     // Data
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::value)));
-    dc.SetFont(wxFont(size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
-        wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::value)));
+    dc.SetFont(GetFontCache().GetFont(
+        size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     dc.DrawText(value, xc - dc.GetTextExtent(value).GetX() / 2,
         yc / AUTO_TEXT_SHIFT_COEF);
-    mdc.SelectObject(wxNullBitmap);
-    return m_bmp;
 #undef PERC
 }
 
-wxBitmap SimpleGaugeInstrument::RenderPercent(double scale)
+template <class DC>
+void SimpleGaugeInstrument::PaintPercent(DC& dc, const wxString& value)
 {
 #define PERC 10
-    wxString value = "---";
-
-    if (m_new_data) {
-        m_new_data = false;
-        if (!m_timed_out) {
-            value = FormatCenterValue();
-        }
-    } else {
-        if (!m_timed_out && m_bmp.IsOk()) {
-            return m_bmp;
-        }
-    }
-
-    wxMemoryDC mdc;
-
-    wxCoord size_x = m_instrument_size * scale;
-    wxCoord size_y = m_instrument_size * scale * (50 + PERC) / 100;
+    wxCoord size_x = dc.GetSize().GetWidth();
+    wxCoord size_y = dc.GetSize().GetHeight();
     wxCoord xc = size_x / 2;
-    wxCoord yc = m_instrument_size * scale / 2;
+    wxCoord yc = size_x / 2;
     wxCoord r = size_x / 2 - size_x / 200 - 1;
 
-#if defined(__WXGTK__) || defined(__WXQT__)
-    m_bmp = wxBitmap(size_x, size_y, 32);
-#else
-    m_bmp = wxBitmap(size_x, size_y);
-    m_bmp.UseAlpha();
-#endif
-    mdc.SelectObject(m_bmp);
-#if wxUSE_GRAPHICS_CONTEXT
-    wxGCDC dc(mdc);
-#else
-    wxMemoryDC& dc(mdc);
-#endif
     dc.SetBackground(*wxTRANSPARENT_BRUSH);
     dc.Clear();
     // Gauge background
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_RIM_NOMINAL))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR))));
+    dc.SetBrush(
+        wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX))));
+    dc.SetPen(
+        wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r);
     // Arcs for zones
     for (auto& zone : m_zones) {
@@ -726,55 +661,54 @@ wxBitmap SimpleGaugeInstrument::RenderPercent(double scale)
         DrawArc(dc, angle_to, angle_from, xc, yc, r);
     }
     // Face
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_DIAL_COLOR))));
+    dc.SetBrush(wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX))));
     dc.DrawCircle(xc, yc, r * 0.85);
     // Ticks
-    dc.SetTextForeground(GetDimedColor(GetColorSetting(DSK_SGI_TICK_LEGEND)));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 200));
+    dc.SetTextForeground(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 200));
     DrawTicks(dc, 0, 18, xc, yc, r, r * 0.15, false, 90, false, 0, 90);
     DrawTicks(dc, 0, 9, xc, yc, r, r * 0.1, false, 90, false, 0, 90);
     DrawTicks(dc, 0, 18, xc, yc, r, r * 0.15, false, 90, false, 270, 360);
     DrawTicks(dc, 0, 9, xc, yc, r, r * 0.1, false, 90, false, 270, 360);
-    dc.SetPen(
-        wxPen(GetDimedColor(GetColorSetting(DSK_SGI_TICK_FG)), size_x / 100));
-    dc.SetFont(wxFont(size_x / 12 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetPen(wxPen(
+        GetDimedColor(ColorSettingAt(DSK_SGI_TICK_FG_IDX)), size_x / 100));
+    dc.SetFont(GetFontCache().GetFont(size_x / 12 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     DrawTicks(dc, 0, 90, xc, yc, r, r * 0.2, false, 0, false, 0, 90);
     DrawTicks(dc, 0, 90, xc, yc, r, r * 0.2, false, 0, false, 270, 360);
     // Border
     dc.SetBrush(*wxTRANSPARENT_BRUSH);
     int border_width = size_x / 100 + 1;
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR)),
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX)),
         border_width));
     dc.DrawCircle(xc, yc, r);
     int shift = r - sqrt(r * r - r * 2 * PERC * r * 2 * PERC / 100 / 100);
     dc.DrawLine(shift + border_width, size_y - border_width / 2,
         size_x - shift - border_width, size_y - border_width / 2);
     // Needle
-    dc.SetBrush(wxBrush(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG))));
-    dc.SetPen(wxPen(GetDimedColor(GetColorSetting(DSK_SGI_NEEDLE_FG)), 3));
+    dc.SetBrush(wxBrush(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX))));
+    dc.SetPen(wxPen(GetDimedColor(ColorSettingAt(DSK_SGI_NEEDLE_FG_IDX)), 3));
     DrawNeedle(dc, xc, yc, r * 0.9, m_old_value * 1.8 - 90, 30);
     // Text
     // Label
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::title)));
-    dc.SetFont(wxFont(size_x / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    const Zone::state zs = GetZoneState(m_old_value);
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::title)));
+    dc.SetFont(GetFontCache().GetFont(size_x / 8 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     dc.DrawText(m_title, xc - dc.GetTextExtent(m_title).GetX() / 2,
         yc - dc.GetTextExtent(m_title).GetY() * 2.2);
     // Data
-    dc.SetTextForeground(
-        GetDimedColor(GetColor(m_old_value, color_item::value)));
-    dc.SetFont(wxFont(size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
-        wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+    dc.SetTextForeground(GetDimedColor(GetColor(zs, color_item::value)));
+    dc.SetFont(GetFontCache().GetFont(
+        size_x / m_value_font_divisor / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
     dc.DrawText(value, xc - dc.GetTextExtent(value).GetX() / 2,
         yc - dc.GetTextExtent(value).GetY() / 1.8 * AUTO_TEXT_SHIFT_COEF);
-    mdc.SelectObject(wxNullBitmap);
-    return m_bmp;
 #undef PERC
 }
 
@@ -784,7 +718,7 @@ void SimpleGaugeInstrument::ProcessData()
         if (!m_timed_out
             && (m_allowed_age_sec > 0
                 && std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now() - m_last_change)
+                       Now() - m_last_change)
                         .count()
                     > m_allowed_age_sec)) {
             m_needs_redraw = true;
@@ -793,9 +727,9 @@ void SimpleGaugeInstrument::ProcessData()
         }
     } else {
         m_needs_redraw = true;
-        m_last_change = std::chrono::system_clock::now();
+        m_last_change = Now();
         m_timed_out = false;
-        const Json::Value* val = GetSKDataResolved(m_sk_key);
+        const Json::Value* val = GetSKDataResolved(m_data_key);
         if (val) {
             Json::Value v = val->get("value", *val);
 
@@ -803,11 +737,6 @@ void SimpleGaugeInstrument::ProcessData()
                     : v.isInt64()                ? v.asInt64()
                                                  : 0.0,
                 m_transformation);
-            if (m_old_value > std::numeric_limits<double>::min()) {
-                dval = (m_smoothing * m_old_value
-                           + (DSK_SGI_SMOOTHING_MAX - m_smoothing + 1) * dval)
-                    / (DSK_SGI_SMOOTHING_MAX + 1);
-            }
             m_old_value = dval;
             m_min_val = wxMin(dval, m_min_val);
             m_max_val = wxMax(dval, m_max_val);
@@ -815,27 +744,130 @@ void SimpleGaugeInstrument::ProcessData()
     }
 }
 
-wxBitmap SimpleGaugeInstrument::Render(double scale)
+bool SimpleGaugeInstrument::TakeFrameValue(wxString& value, bool& has_value)
 {
-    ProcessData();
+    has_value = false;
+    value = (m_gauge_type == gauge_type::ranged_adaptive
+                || m_gauge_type == gauge_type::ranged_fixed)
+        ? "----"
+        : "---";
 
-    if (!m_needs_redraw) {
-        return m_bmp;
+    if (m_new_data) {
+        m_new_data = false;
+        if (!m_timed_out) {
+            has_value = true;
+            value = FormatCenterValue();
+        }
+    } else {
+        if (!m_timed_out && m_bmp.IsOk()) {
+            return false;
+        }
     }
+    return true;
+}
+
+wxSize SimpleGaugeInstrument::FrameSize(double scale) const
+{
     switch (m_gauge_type) {
     case gauge_type::relative_angle:
-        return RenderAngle(scale, true);
     case gauge_type::direction:
-        return RenderAngle(scale, false);
+        return wxSize(m_instrument_size * scale, m_instrument_size * scale);
     case gauge_type::percent:
-        return RenderPercent(scale);
+        return wxSize(m_instrument_size * scale,
+            m_instrument_size * scale * (50 + 10) / 100);
     case gauge_type::ranged_adaptive:
-        return RenderAdaptive(scale);
     case gauge_type::ranged_fixed:
-        return RenderFixed(scale);
+        return wxSize(m_instrument_size * scale,
+            m_instrument_size * scale * (50 + 30) / 100);
     default:
+        return wxSize(0, 0);
+    }
+}
+
+template <class DC>
+void SimpleGaugeInstrument::Paint(
+    DC& dc, const wxString& value, bool has_value)
+{
+    switch (m_gauge_type) {
+    case gauge_type::relative_angle:
+        PaintAngle(dc, value, true);
+        break;
+    case gauge_type::direction:
+        PaintAngle(dc, value, false);
+        break;
+    case gauge_type::percent:
+        PaintPercent(dc, value);
+        break;
+    case gauge_type::ranged_adaptive:
+        PaintAdaptive(dc, value, has_value);
+        break;
+    case gauge_type::ranged_fixed:
+        PaintFixed(dc, value, has_value);
+        break;
+    default:
+        break;
+    }
+}
+
+wxBitmap SimpleGaugeInstrument::Render(double scale)
+{
+    ProcessData();
+
+    if (m_raster_committed) {
+        m_raster_committed = false;
+        return m_bmp;
+    }
+    if (!m_needs_redraw) {
+        return m_bmp;
+    }
+    wxSize size = FrameSize(scale);
+    if (size.GetWidth() <= 0 || size.GetHeight() <= 0) {
         return wxNullBitmap;
     }
+    wxString value;
+    bool has_value;
+    if (!TakeFrameValue(value, has_value)) {
+        return m_bmp;
+    }
+
+#if defined(__WXGTK__) || defined(__WXQT__)
+    m_bmp = wxBitmap(size.GetWidth(), size.GetHeight(), 32);
+#else
+    m_bmp = wxBitmap(size.GetWidth(), size.GetHeight());
+    m_bmp.UseAlpha();
+#endif
+    wxMemoryDC mdc;
+    mdc.SelectObject(m_bmp);
+#if wxUSE_GRAPHICS_CONTEXT
+    wxGCDC dc(mdc);
+#else
+    wxMemoryDC& dc(mdc);
+#endif
+    Paint(dc, value, has_value);
+    mdc.SelectObject(wxNullBitmap);
+    return m_bmp;
+}
+
+bool SimpleGaugeInstrument::PrepareRaster(double scale)
+{
+    ProcessData();
+
+    if (!m_needs_redraw) {
+        return false;
+    }
+    wxSize size = FrameSize(scale);
+    if (size.GetWidth() <= 0 || size.GetHeight() <= 0) {
+        return false;
+    }
+    wxString value;
+    bool has_value;
+    if (!TakeFrameValue(value, has_value)) {
+        return false;
+    }
+    m_raster = std::make_unique<dskRasterDC>(
+        size.GetWidth(), size.GetHeight(), GetFontCache());
+    Paint(*m_raster, value, has_value);
+    return true;
 }
 
 void SimpleGaugeInstrument::ReadConfig(Json::Value& config)
@@ -864,87 +896,89 @@ Json::Value SimpleGaugeInstrument::GenerateJSONConfig()
 }
 
 const wxColor SimpleGaugeInstrument::GetColor(
-    const double& val, const color_item item)
+    const Zone::state st, const color_item item)
 {
     wxColor c;
     switch (item) {
     case color_item::title:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX));
         break;
     case color_item::value:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_NOMINAL_FG),
-            GetColorSetting(DSK_SETTING_NOMINAL_FG),
-            GetColorSetting(DSK_SETTING_NOMINAL_FG),
-            GetColorSetting(DSK_SETTING_NOMINAL_FG),
-            GetColorSetting(DSK_SETTING_NOMINAL_FG),
-            GetColorSetting(DSK_SETTING_NOMINAL_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_NOMINAL_FG_IDX),
+            ColorSettingAt(DSK_SETTING_NOMINAL_FG_IDX),
+            ColorSettingAt(DSK_SETTING_NOMINAL_FG_IDX),
+            ColorSettingAt(DSK_SETTING_NOMINAL_FG_IDX),
+            ColorSettingAt(DSK_SETTING_NOMINAL_FG_IDX),
+            ColorSettingAt(DSK_SETTING_NOMINAL_FG_IDX));
         break;
     case color_item::dial:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_DIAL_COLOR),
-            GetColorSetting(DSK_SGI_DIAL_COLOR),
-            GetColorSetting(DSK_SGI_DIAL_COLOR),
-            GetColorSetting(DSK_SGI_DIAL_COLOR),
-            GetColorSetting(DSK_SGI_DIAL_COLOR),
-            GetColorSetting(DSK_SGI_DIAL_COLOR));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX),
+            ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX),
+            ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX),
+            ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX),
+            ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX),
+            ColorSettingAt(DSK_SGI_DIAL_COLOR_IDX));
         break;
     case color_item::tick:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_TICK_FG),
-            GetColorSetting(DSK_SGI_TICK_FG), GetColorSetting(DSK_SGI_TICK_FG),
-            GetColorSetting(DSK_SGI_TICK_FG), GetColorSetting(DSK_SGI_TICK_FG),
-            GetColorSetting(DSK_SGI_TICK_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_TICK_FG_IDX),
+            ColorSettingAt(DSK_SGI_TICK_FG_IDX),
+            ColorSettingAt(DSK_SGI_TICK_FG_IDX),
+            ColorSettingAt(DSK_SGI_TICK_FG_IDX),
+            ColorSettingAt(DSK_SGI_TICK_FG_IDX),
+            ColorSettingAt(DSK_SGI_TICK_FG_IDX));
         break;
     case color_item::legend:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_TICK_LEGEND),
-            GetColorSetting(DSK_SGI_TICK_LEGEND),
-            GetColorSetting(DSK_SGI_TICK_LEGEND),
-            GetColorSetting(DSK_SGI_TICK_LEGEND),
-            GetColorSetting(DSK_SGI_TICK_LEGEND),
-            GetColorSetting(DSK_SGI_TICK_LEGEND));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX),
+            ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX),
+            ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX),
+            ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX),
+            ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX),
+            ColorSettingAt(DSK_SGI_TICK_LEGEND_IDX));
         break;
     case color_item::rim:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_RIM_NOMINAL),
-            GetColorSetting(DSK_SGI_RIM_NOMINAL),
-            GetColorSetting(DSK_SGI_RIM_NOMINAL),
-            GetColorSetting(DSK_SGI_RIM_NOMINAL),
-            GetColorSetting(DSK_SGI_RIM_NOMINAL),
-            GetColorSetting(DSK_SGI_RIM_NOMINAL));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX),
+            ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX),
+            ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX),
+            ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX),
+            ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX),
+            ColorSettingAt(DSK_SGI_RIM_NOMINAL_IDX));
         break;
     case color_item::rim_dead:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_RIM_DEAD),
-            GetColorSetting(DSK_SGI_RIM_DEAD),
-            GetColorSetting(DSK_SGI_RIM_DEAD),
-            GetColorSetting(DSK_SGI_RIM_DEAD),
-            GetColorSetting(DSK_SGI_RIM_DEAD),
-            GetColorSetting(DSK_SGI_RIM_DEAD));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_RIM_DEAD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_DEAD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_DEAD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_DEAD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_DEAD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_DEAD_IDX));
         break;
     case color_item::rim_stbd:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_RIM_STBD),
-            GetColorSetting(DSK_SGI_RIM_STBD),
-            GetColorSetting(DSK_SGI_RIM_STBD),
-            GetColorSetting(DSK_SGI_RIM_STBD),
-            GetColorSetting(DSK_SGI_RIM_STBD),
-            GetColorSetting(DSK_SGI_RIM_STBD));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_RIM_STBD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_STBD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_STBD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_STBD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_STBD_IDX),
+            ColorSettingAt(DSK_SGI_RIM_STBD_IDX));
         break;
     case color_item::rim_port:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SGI_RIM_PORT),
-            GetColorSetting(DSK_SGI_RIM_PORT),
-            GetColorSetting(DSK_SGI_RIM_PORT),
-            GetColorSetting(DSK_SGI_RIM_PORT),
-            GetColorSetting(DSK_SGI_RIM_PORT),
-            GetColorSetting(DSK_SGI_RIM_PORT));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SGI_RIM_PORT_IDX),
+            ColorSettingAt(DSK_SGI_RIM_PORT_IDX),
+            ColorSettingAt(DSK_SGI_RIM_PORT_IDX),
+            ColorSettingAt(DSK_SGI_RIM_PORT_IDX),
+            ColorSettingAt(DSK_SGI_RIM_PORT_IDX),
+            ColorSettingAt(DSK_SGI_RIM_PORT_IDX));
         break;
     case color_item::border:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX));
         break;
     }
     return c;
@@ -952,13 +986,9 @@ const wxColor SimpleGaugeInstrument::GetColor(
 
 wxString SimpleGaugeInstrument::FormatCenterValue()
 {
-    wxString value
-        = wxString::Format(m_format_strings[m_format_index], abs(m_old_value));
-    if (m_old_value < 0
-        && !m_supported_formats[m_format_index].StartsWith("ABS")) {
-        value.Prepend("-");
-    }
-    return value.Append(m_value_suffix);
+    return ValueFormatter::Get(m_format_index)
+        .Format(m_old_value)
+        .Append(m_value_suffix);
 }
 
 PLUGIN_END_NAMESPACE
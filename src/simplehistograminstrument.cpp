@@ -31,39 +31,6 @@
 
 PLUGIN_BEGIN_NAMESPACE
 
-#define HISTORY_1S 60
-#define HISTORY_10S 360
-#define HISTORY_5M 864
-
-void History::Add(const double& value)
-{
-    if (m_last_minute.empty() || m_last_minute.back().OlderThan(1s)) {
-        HistoryValue h(value);
-        m_last_minute.push_back(h);
-    } else {
-        m_last_minute.back().Add(value);
-    }
-    if (m_last_minute.size() > HISTORY_1S) {
-        m_last_minute.pop_front();
-    }
-    if (m_last_hour.empty() || m_last_hour.back().OlderThan(10s)) {
-        m_last_hour.push_back(HistoryValue(value));
-    } else {
-        m_last_hour.back().Add(value);
-    }
-    if (m_last_hour.size() > HISTORY_10S) {
-        m_last_hour.pop_front();
-    }
-    if (m_last_3days.empty() || m_last_3days.back().OlderThan(300s)) {
-        m_last_3days.push_back(HistoryValue(value));
-    } else {
-        m_last_3days.back().Add(value);
-    }
-    if (m_last_3days.size() > HISTORY_5M) {
-        m_last_3days.pop_front();
-    }
-}
-
 void SimpleHistogramInstrument::Init()
 {
     // Define formatting and transformation data to be shared between settings
@@ -71,9 +38,6 @@ void SimpleHistogramInstrument::Init()
 #define X(a, b, c) m_supported_formats.Add(b);
     DSK_VALUE_FORMATS
 #undef X
-#define X(a, b, c) m_format_strings.Add(c);
-    DSK_VALUE_FORMATS
-#undef X
 #define X(a, b) m_supported_transforms.Add(b);
     DSK_UNIT_TRANSFORMATIONS
 #undef X
@@ -99,6 +63,11 @@ void SimpleHistogramInstrument::Init()
     m_instrument_width = 200;
     m_instrument_height = 100;
 
+#define X(a, b, c, d, e, f, g, h)                                              \
+    RegisterTypedSetting(b##_IDX, b, dskConfigCtrl::e);
+    DSK_SHI_SETTINGS
+#undef X
+
 #define X(a, b, c, d, e, f, g, h) SetSetting(b, c);
     DSK_SHI_SETTINGS
 #undef X
@@ -119,6 +88,7 @@ void SimpleHistogramInstrument::SetSetting(
         if (m_parent_dashboard) {
             m_parent_dashboard->Unsubscribe(this);
             m_parent_dashboard->Subscribe(m_sk_key, this);
+            m_history = m_parent_dashboard->AcquireHistory(m_sk_key);
         }
     } else if (key.IsSameAs(DSK_SETTING_FORMAT)
         || key.IsSameAs(DSK_SETTING_TRANSFORMATION)
@@ -147,6 +117,7 @@ void SimpleHistogramInstrument::SetSetting(
         m_format_index = value;
     } else if (key.IsSameAs(DSK_SETTING_TRANSFORMATION)) {
         m_transformation = static_cast<transformation>(value);
+        TransformationChanged();
     } else if (key.IsSameAs(DSK_SETTING_TITLE_FONT)) {
         m_title_font.SetPointSize(value);
     } else if (key.IsSameAs(DSK_SETTING_BODY_FONT)) {
@@ -168,7 +139,7 @@ void SimpleHistogramInstrument::ProcessData()
         if (!m_timed_out
             && (m_allowed_age_sec > 0
                 && std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now() - m_last_change)
+                       Now() - m_last_change)
                         .count()
                     > m_allowed_age_sec)) {
             m_needs_redraw = true;
@@ -176,7 +147,7 @@ void SimpleHistogramInstrument::ProcessData()
             m_old_value = std::numeric_limits<double>::min();
         } else {
             if (std::chrono::duration_cast<std::chrono::seconds>(
-                    std::chrono::system_clock::now() - m_last_change)
+                    Now() - m_last_change)
                     .count()
                 > 5) {
                 // Even timed out we want to redraw from time to time to shift
@@ -187,7 +158,7 @@ void SimpleHistogramInstrument::ProcessData()
     } else {
         m_new_data = false;
         m_needs_redraw = true;
-        m_last_change = std::chrono::system_clock::now();
+        m_last_change = Now();
         m_timed_out = false;
         const Json::Value* val = GetSKDataResolved(m_sk_key);
         if (val) {
@@ -196,7 +167,6 @@ void SimpleHistogramInstrument::ProcessData()
                     : v.isInt64()                ? v.asInt64()
                                                  : 0.0);
             m_old_value = dval;
-            m_history.Add(dval);
         }
     }
 }
@@ -228,84 +198,91 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
     dc.SetBackground(GetDimedColor(GetColor(color_item::body_bg)));
     dc.Clear();
     // Draw graph
+    static const History NO_HISTORY;
+    const History& history = m_history ? *m_history : NO_HISTORY;
+    const Clock::time_point now = Now();
     std::vector<HistoryValue> vals;
     double min = std::numeric_limits<double>::max();
     double max = -std::numeric_limits<double>::max();
     if (m_timed_out) {
         // If we are timed out, we still want to push the graph off the screen
-        HistoryValue dummy;
+        HistoryValue dummy(now);
         vals.push_back(dummy);
     }
-    for (auto it = m_history.m_last_minute.rbegin();
-        it != m_history.m_last_minute.rend(); ++it) {
+    for (auto it = history.m_last_minute.rbegin();
+        it != history.m_last_minute.rend(); ++it) {
         if (m_history_length == history_length::len_1min
-            && it->OlderThan(60s)) {
+            && it->OlderThan(60s, now)) {
             break;
         }
-        if (it->GetMean() > max) {
-            max = it->GetMean();
+        // The shared history keeps the values as received
+        const HistoryValue val(Transform(it->GetMean()), it->ts);
+        if (val.GetMean() > max) {
+            max = val.GetMean();
         }
-        if (it->GetMean() < min) {
-            min = it->GetMean();
+        if (val.GetMean() < min) {
+            min = val.GetMean();
         }
-        vals.push_back(*it);
+        vals.push_back(val);
     }
-    if (m_history.m_last_minute.size() == HISTORY_1S
+    if (history.m_last_minute.size() == HISTORY_1S
         && m_history_length > history_length::len_1min) {
-        for (auto it = m_history.m_last_hour.rbegin();
-            it != m_history.m_last_hour.rend(); ++it) {
+        for (auto it = history.m_last_hour.rbegin();
+            it != history.m_last_hour.rend(); ++it) {
             if (it->OlderThan(vals.back())) { // Skip the values we have with
                                               // better precision
                 continue;
             }
             if (m_history_length == history_length::len_5min
-                && it->OlderThan(300s)) {
+                && it->OlderThan(300s, now)) {
                 break;
             }
             if (m_history_length == history_length::len_15min
-                && it->OlderThan(900s)) {
+                && it->OlderThan(900s, now)) {
                 break;
             }
             if (m_history_length == history_length::len_30min
-                && it->OlderThan(1800s)) {
+                && it->OlderThan(1800s, now)) {
                 break;
             }
             if (m_history_length == history_length::len_1hour
-                && it->OlderThan(3600s)) {
+                && it->OlderThan(3600s, now)) {
                 break;
             }
-            if (it->GetMean() > max) {
-                max = it->GetMean();
+            const HistoryValue val(Transform(it->GetMean()), it->ts);
+            if (val.GetMean() > max) {
+                max = val.GetMean();
             }
-            if (it->GetMean() < min) {
-                min = it->GetMean();
+            if (val.GetMean() < min) {
+                min = val.GetMean();
             }
-            vals.push_back(*it);
+            vals.push_back(val);
         }
     }
-    if (m_history.m_last_hour.size() == HISTORY_10S
+    if (history.m_last_hour.size() == HISTORY_10S
         && m_history_length > history_length::len_1hour) {
-        for (auto it = m_history.m_last_3days.rbegin();
-            it != m_history.m_last_3days.rend(); ++it) {
+        for (auto it = history.m_last_3days.rbegin();
+            it != history.m_last_3days.rend(); ++it) {
             if (it->OlderThan(vals.back())) { // Skip the values we have with
                                               // better precision
                 continue;
             }
             if (m_history_length == history_length::len_1day
-                && it->OlderThan(86400s)) {
+                && it->OlderThan(86400s, now)) {
                 break;
             }
             if (m_history_length == history_length::len_3days
-                && it->OlderThan(259200s)) {
+                && it->OlderThan(259200s, now)) {
                 break;
             }
-            if (it->GetMean() > max) {
-                max = it->GetMean();
+            const HistoryValue val(Transform(it->GetMean()), it->ts);
+            if (val.GetMean() > max) {
+                max = val.GetMean();
             }
-            if (it->GetMean() < min) {
-                min = it->GetMean();
+            if (val.GetMean() < min) {
+                min = val.GetMean();
             }
-            vals.push_back(*it);
+            vals.push_back(val);
         }
     }
     if (vals.size() <= 1) {
@@ -317,7 +294,7 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
         = range != 0.0 ? static_cast<double>(height) / range : 1.0;
     height_coef *= 0.9;
     wxCoord vertical_shift = (height - height * 0.9) / 2;
-    HistoryValue lastval;
+    HistoryValue lastval(now);
     double sum = 0.0;
     size_t cnt = 0;
     double pps = 0.0;
@@ -329,8 +306,8 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
     dc.SetPen(wxPen(GetDimedColor(GetColor(color_item::body_fg)),
         BORDER_LINE_WIDTH * 2, wxPENSTYLE_SOLID));
     dc.SetTextForeground(GetDimedColor(GetColor(color_item::time_fg)));
-    dc.SetFont(wxFont(height / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.SetFont(GetFontCache().GetFont(height / 8 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     int max_labels = width / (dc.GetTextExtent("100s").GetWidth() * 1.5);
     int current_label = 1;
     for (auto& v : vals) {
@@ -382,8 +359,8 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
     }
     if (m_timed_out) {
         dc.SetTextForeground(GetDimedColor(GetColor(color_item::mean_fg)));
-        dc.SetFont(wxFont(height / 4 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-            wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
+        dc.SetFont(GetFontCache().GetFont(height / 4 / AUTO_TEXT_SIZE_COEF,
+            wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD));
         wxString s = _("NO DATA");
         dc.DrawText(s, (width - dc.GetTextExtent(s).GetWidth()) / 2,
             (height - dc.GetTextExtent(s).GetHeight()) / 2);
@@ -402,8 +379,8 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
                 height - (vertical_shift + (sum / cnt - min) * height_coef));
         }
         dc.SetTextForeground(GetDimedColor(GetColor(color_item::mean_fg)));
-        dc.SetFont(wxFont(height / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-            wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+        dc.SetFont(GetFontCache().GetFont(height / 8 / AUTO_TEXT_SIZE_COEF,
+            wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
         if (m_value_order == value_order::lowest_highest) {
             dc.DrawText(FormatValue(sum / cnt), BORDER_LINE_WIDTH,
                 (sum / cnt - min) * height_coef);
@@ -415,8 +392,8 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
 
     // Labels for Y-axis
     dc.SetTextForeground(GetDimedColor(GetColor(color_item::body_fg)));
-    dc.SetFont(wxFont(height / 8 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.SetFont(GetFontCache().GetFont(height / 8 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     wxString lbl_btm;
     wxString lbl_top;
     if (m_value_order == value_order::lowest_highest) {
@@ -432,8 +409,8 @@ wxBitmap SimpleHistogramInstrument::Render(double scale)
 
     // Title
     dc.SetTextForeground(GetDimedColor(GetColor(color_item::title_fg)));
-    dc.SetFont(wxFont(height / 6 / AUTO_TEXT_SIZE_COEF, wxFONTFAMILY_SWISS,
-        wxFONTSTYLE_NORMAL, wxFONTWEIGHT_NORMAL));
+    dc.SetFont(GetFontCache().GetFont(height / 6 / AUTO_TEXT_SIZE_COEF,
+        wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
     dc.DrawText(m_title,
         width - dc.GetTextExtent(m_title).GetWidth() - BORDER_LINE_WIDTH,
         BORDER_LINE_WIDTH);
@@ -486,22 +463,22 @@ const wxColor SimpleHistogramInstrument::GetColor(const color_item item)
         c = GetColorSetting(DSK_SETTING_TITLE_BG);
         break;
     case color_item::title_fg:
-        c = GetColorSetting(DSK_SETTING_TITLE_FG);
+        c = ColorSettingAt(DSK_SETTING_TITLE_FG_IDX);
         break;
     case color_item::body_bg:
-        c = GetColorSetting(DSK_SETTING_BODY_BG);
+        c = ColorSettingAt(DSK_SETTING_BODY_BG_IDX);
         break;
     case color_item::body_fg:
-        c = GetColorSetting(DSK_SETTING_BODY_FG);
+        c = ColorSettingAt(DSK_SETTING_BODY_FG_IDX);
         break;
     case color_item::border:
-        c = GetColorSetting(DSK_SETTING_BORDER_COLOR);
+        c = ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX);
         break;
     case color_item::mean_fg:
-        c = GetColorSetting(DSK_SETTING_MEAN_FG);
+        c = ColorSettingAt(DSK_SETTING_MEAN_FG_IDX);
         break;
     case color_item::time_fg:
-        c = GetColorSetting(DSK_SETTING_TIME_FG);
+        c = ColorSettingAt(DSK_SETTING_TIME_FG_IDX);
         break;
     }
     return c;
@@ -38,9 +38,6 @@ void SimpleNumberInstrument::Init()
 #define X(a, b, c) m_supported_formats.Add(b);
     DSK_VALUE_FORMATS
 #undef X
-#define X(a, b, c) m_format_strings.Add(c);
-    DSK_VALUE_FORMATS
-#undef X
 #define X(a, b) m_supported_transforms.Add(b);
     DSK_UNIT_TRANSFORMATIONS
 #undef X
@@ -61,6 +58,11 @@ void SimpleNumberInstrument::Init()
     m_smoothing = 0;
     m_old_value = std::numeric_limits<double>::min();
 
+#define X(a, b, c, d, e, f, g, h)                                              \
+    RegisterTypedSetting(b##_IDX, b, dskConfigCtrl::e);
+    DSK_SNI_SETTINGS
+#undef X
+
 #define X(a, b, c, d, e, f, g, h) SetSetting(b, c);
     DSK_SNI_SETTINGS
 #undef X
@@ -78,10 +80,7 @@ void SimpleNumberInstrument::SetSetting(
     Instrument::SetSetting(key, value);
     if (key == DSK_SETTING_SK_KEY && !m_sk_key.IsSameAs(value)) {
         m_sk_key = wxString(value);
-        if (m_parent_dashboard) {
-            m_parent_dashboard->Unsubscribe(this);
-            m_parent_dashboard->Subscribe(m_sk_key, this);
-        }
+        UpdateDataKey();
     } else if (key.IsSameAs(DSK_SETTING_FORMAT)
         || key.IsSameAs(DSK_SETTING_TRANSFORMATION)
         || key.IsSameAs(DSK_SETTING_SMOOTHING)
@@ -111,6 +110,7 @@ void SimpleNumberInstrument::SetSetting(const wxString& key, const int& value)
         m_format_index = value;
     } else if (key.IsSameAs(DSK_SETTING_TRANSFORMATION)) {
         m_transformation = static_cast<transformation>(value);
+        TransformationChanged();
     } else if (key.IsSameAs(DSK_SETTING_TITLE_FONT)) {
         m_title_font.SetPointSize(value);
     } else if (key.IsSameAs(DSK_SETTING_SUFFIX_FONT)) {
@@ -119,6 +119,29 @@ void SimpleNumberInstrument::SetSetting(const wxString& key, const int& value)
         m_body_font.SetPointSize(value);
     } else if (key.IsSameAs(DSK_SETTING_SMOOTHING)) {
         m_smoothing = value;
+        UpdateDataKey();
+    }
+}
+
+void SimpleNumberInstrument::UpdateDataKey()
+{
+    wxString key = m_sk_key;
+    if (m_smoothing > 0 && !m_sk_key.IsEmpty()
+        && !Expression::IsExpression(m_sk_key)) {
+        // EMA with the same weight of the newest value as the smoothing ratio
+        const double n = 2.0 * (DSK_SNI_SMOOTHING_MAX + 1)
+                / (DSK_SNI_SMOOTHING_MAX - m_smoothing + 1)
+            - 1.0;
+        key += wxString(FILTER_SEPARATOR) + wxString::Format("ema(%g)", n);
+    }
+    if (key.IsSameAs(m_data_key)) {
+        return;
+    }
+    m_data_key = key;
+    m_old_value = std::numeric_limits<double>::min();
+    if (m_parent_dashboard) {
+        m_parent_dashboard->Unsubscribe(this);
+        m_parent_dashboard->Subscribe(m_data_key, this);
     }
 }
 
@@ -128,7 +151,7 @@ void SimpleNumberInstrument::ProcessData()
         if (!m_timed_out
             && (m_allowed_age_sec > 0
                 && std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now() - m_last_change)
+                       Now() - m_last_change)
                         .count()
                     > m_allowed_age_sec)) {
             m_needs_redraw = true;
@@ -138,125 +161,152 @@ void SimpleNumberInstrument::ProcessData()
     } else {
         m_new_data = false;
         m_needs_redraw = true;
-        m_last_change = std::chrono::system_clock::now();
+        m_last_change = Now();
         m_timed_out = false;
-        const Json::Value* val = GetSKDataResolved(m_sk_key);
+        const Json::Value* val = GetSKDataResolved(m_data_key);
         if (val) {
             Json::Value v = val->get("value", *val);
-            if ((unsigned)m_format_index < m_format_strings.GetCount()) {
+            if ((unsigned)m_format_index < ValueFormatter::Count()) {
                 double dval
                     = Transform(v.isDouble() ? v.asDouble() : v.asInt64());
-                if (m_old_value > std::numeric_limits<double>::min()) {
-                    dval = (m_smoothing * m_old_value
-                               + (DSK_SNI_SMOOTHING_MAX - m_smoothing + 1)
-                                   * dval)
-                        / (DSK_SNI_SMOOTHING_MAX + 1);
-                }
                 m_old_value = dval;
             }
         }
     }
 }
 
-wxBitmap SimpleNumberInstrument::Render(double scale)
+bool SimpleNumberInstrument::PrepareFrame(double scale)
 {
     wxString value;
-    wxColor ctb = GetDimedColor(GetColorSetting(DSK_SETTING_TITLE_BG));
-    wxColor ctf = GetDimedColor(GetColorSetting(DSK_SETTING_TITLE_FG));
-    wxColor cbb = GetDimedColor(GetColorSetting(DSK_SETTING_BODY_BG));
-    wxColor cbf = GetDimedColor(GetColorSetting(DSK_SETTING_BODY_FG));
-    wxColor cb = GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR));
+    wxColor ctb = GetDimedColor(ColorSettingAt(DSK_SETTING_TITLE_BG_IDX));
+    wxColor ctf = GetDimedColor(ColorSettingAt(DSK_SETTING_TITLE_FG_IDX));
+    wxColor cbb = GetDimedColor(ColorSettingAt(DSK_SETTING_BODY_BG_IDX));
+    wxColor cbf = GetDimedColor(ColorSettingAt(DSK_SETTING_BODY_FG_IDX));
+    wxColor cb = GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX));
+    // The placeholder is only assigned for a redraw, an unchanged frame must
+    // not allocate
+    const bool no_data = !m_new_data;
     if (!m_new_data) {
-        value = "-----";
-        cbb = GetDimedColor(GetColorSetting(DSK_SETTING_BODY_BG));
-        cbf = GetDimedColor(GetColorSetting(DSK_SETTING_BODY_FG));
+        cbb = GetDimedColor(ColorSettingAt(DSK_SETTING_BODY_BG_IDX));
+        cbf = GetDimedColor(ColorSettingAt(DSK_SETTING_BODY_FG_IDX));
         if (!m_timed_out
             && (m_allowed_age_sec > 0
                 && std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now() - m_last_change)
+                       Now() - m_last_change)
                         .count()
                     > m_allowed_age_sec)) {
             m_needs_redraw = true;
             m_timed_out = true;
             m_old_value = std::numeric_limits<double>::min();
-            cbb = GetDimedColor(GetColorSetting(DSK_SETTING_ALERT_BG));
-            cbf = GetDimedColor(GetColorSetting(DSK_SETTING_ALERT_FG));
+            cbb = GetDimedColor(ColorSettingAt(DSK_SETTING_ALERT_BG_IDX));
+            cbf = GetDimedColor(ColorSettingAt(DSK_SETTING_ALERT_FG_IDX));
         }
     } else {
         m_new_data = false;
         m_needs_redraw = true;
-        m_last_change = std::chrono::system_clock::now();
+        m_last_change = Now();
         m_timed_out = false;
-        const Json::Value* val = GetSKDataResolved(m_sk_key);
+        const Json::Value* val = GetSKDataResolved(m_data_key);
         if (val) {
             Json::Value v = val->get("value", *val);
-            if ((unsigned)m_format_index >= m_format_strings.GetCount()) {
+            if ((unsigned)m_format_index >= ValueFormatter::Count()) {
                 value = wxString::Format(
-                    "E: format", m_format_index, m_format_strings.GetCount());
-                cbb = GetDimedColor(GetColorSetting(DSK_SETTING_ALERT_BG));
-                cbf = GetDimedColor(GetColorSetting(DSK_SETTING_ALERT_FG));
+                    "E: format", m_format_index, ValueFormatter::Count());
+                cbb = GetDimedColor(ColorSettingAt(DSK_SETTING_ALERT_BG_IDX));
+                cbf = GetDimedColor(ColorSettingAt(DSK_SETTING_ALERT_FG_IDX));
             } else {
                 double dval
                     = Transform(v.isDouble() ? v.asDouble() : v.asInt64());
-                if (m_old_value > std::numeric_limits<double>::min()) {
-                    dval = (m_smoothing * m_old_value
-                               + (DSK_SNI_SMOOTHING_MAX - m_smoothing + 1)
-                                   * dval)
-                        / (DSK_SNI_SMOOTHING_MAX + 1);
-                }
                 m_old_value = dval;
-                value = wxString::Format(
-                    m_format_strings[m_format_index], abs(dval));
-                if (dval < 0
-                    && !m_supported_formats[m_format_index].StartsWith("ABS")) {
-                    value.Prepend("-");
-                }
-                ctb = GetDimedColor(GetColor(dval, color_item::title_bg));
-                ctf = GetDimedColor(GetColor(dval, color_item::title_fg));
-                cbb = GetDimedColor(GetColor(dval, color_item::body_bg));
-                cbf = GetDimedColor(GetColor(dval, color_item::body_fg));
-                cb = GetDimedColor(GetColor(dval, color_item::border));
+                value = ValueFormatter::Get(m_format_index).Format(dval);
+                const Zone::state zs = GetZoneState(dval);
+                ctb = GetDimedColor(GetColor(zs, color_item::title_bg));
+                ctf = GetDimedColor(GetColor(zs, color_item::title_fg));
+                cbb = GetDimedColor(GetColor(zs, color_item::body_bg));
+                cbf = GetDimedColor(GetColor(zs, color_item::body_fg));
+                cb = GetDimedColor(GetColor(zs, color_item::border));
             }
         } else {
             value = _("Error!");
-            cbb = GetDimedColor(GetColorSetting(DSK_SETTING_ALERT_BG));
-            cbf = GetDimedColor(GetColorSetting(DSK_SETTING_ALERT_FG));
+            cbb = GetDimedColor(ColorSettingAt(DSK_SETTING_ALERT_BG_IDX));
+            cbf = GetDimedColor(ColorSettingAt(DSK_SETTING_ALERT_FG_IDX));
         }
     }
 
     if (!m_needs_redraw) {
-        return m_bmp;
+        return false;
     }
     m_needs_redraw = false;
+    if (no_data) {
+        value = "-----";
+    }
     wxString dummy_str(
         "9999"); // dummy string to size the instrument consistently
-    wxCoord size_x, size_y;
-    wxCoord title_x, title_y;
-    wxCoord body_x, body_y, body_d;
-    wxCoord suffix_x, suffix_y, suffix_d;
-    wxCoord dummy_x, dummy_y;
-    wxMemoryDC mdc;
+    FontCache& fc = GetFontCache();
+    const wxFont& tf
+        = fc.GetFont(m_title_font, m_title_font.GetPointSize() * scale);
+    const wxFont& sf
+        = fc.GetFont(m_suffix_font, m_suffix_font.GetPointSize() * scale);
+    const wxFont& bf
+        = fc.GetFont(m_body_font, m_body_font.GetPointSize() * scale);
+    const text_extent title = fc.GetTextExtent(tf, m_title);
+    const text_extent dummy = fc.GetTextExtent(bf, dummy_str);
+    const text_extent body = fc.GetTextExtent(bf, value);
+    const text_extent suffix = fc.GetTextExtent(sf, m_value_suffix);
+    wxCoord size_x = wxMax(title.width,
+                         wxMax(body.width + suffix.width, dummy.width))
+        + 2 * BORDER_SIZE;
+    wxCoord size_y
+        = title.height + wxMax(body.height, suffix.height) + 4 * BORDER_SIZE;
+    m_frame = { scale, value, ctb, ctf, cbb, cbf, cb, tf, sf, bf, size_x,
+        size_y, title.width, title.height, body.width, body.height,
+        body.descent, suffix.width, suffix.height, suffix.descent };
+    return true;
+}
+
+template <class DC> void SimpleNumberInstrument::Paint(DC& dc)
+{
+    const frame& f = m_frame;
+    const double scale = f.scale;
+    dc.SetBackground(*wxTRANSPARENT_BRUSH);
+    dc.Clear();
+    // Draw stuff
+    dc.SetBrush(wxBrush(f.cbb));
+    dc.DrawRectangle(0, 0, f.size_x, f.size_y);
+    dc.SetBrush(wxBrush(f.ctb));
+    dc.DrawRectangle(0, 0, f.size_x, f.title_y + 2 * BORDER_SIZE);
+    dc.SetFont(f.tf);
+    dc.SetTextForeground(f.ctf);
+    dc.DrawText(m_title, (f.size_x - f.title_x) / 2, BORDER_SIZE);
+    dc.SetFont(f.bf);
+    dc.SetTextForeground(f.cbf);
+    dc.DrawLabel(f.value,
+        wxRect((f.size_x - (f.body_x + f.suffix_x)) / 2,
+            f.title_y + 3 * BORDER_SIZE + wxMin(f.body_d, f.suffix_d),
+            f.body_x, wxMax(f.body_y, f.suffix_y) - f.suffix_d),
+        wxALIGN_CENTER_HORIZONTAL | wxALIGN_BOTTOM);
+    dc.SetFont(f.sf);
+    dc.DrawLabel(m_value_suffix,
+        wxRect((f.size_x - (f.body_x + f.suffix_x)) / 2 + f.body_x,
+            f.title_y + 3 * BORDER_SIZE + wxMin(f.body_d, f.suffix_d),
+            f.suffix_x, wxMax(f.body_y, f.suffix_y) - f.body_d),
+        wxALIGN_CENTER_HORIZONTAL | wxALIGN_BOTTOM);
+    dc.SetPen(wxPen(f.cb, BORDER_LINE_WIDTH, wxPENSTYLE_SOLID));
+    dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    dc.DrawRectangle(BORDER_LINE_WIDTH / 2, BORDER_LINE_WIDTH / 2,
+        f.size_x - BORDER_LINE_WIDTH, f.size_y - BORDER_LINE_WIDTH);
+}
 
-    wxFont tf = m_title_font;
-    wxFont sf = m_suffix_font;
-    wxFont bf = m_body_font;
-    tf.SetPointSize(m_title_font.GetPointSize() * scale);
-    sf.SetPointSize(m_suffix_font.GetPointSize() * scale);
-    mdc.SetFont(tf);
-    mdc.GetTextExtent(m_title, &title_x, &title_y);
-    bf.SetPointSize(m_body_font.GetPointSize() * scale);
-    mdc.SetFont(bf);
-    mdc.GetTextExtent(dummy_str, &dummy_x, &dummy_y);
-    mdc.GetTextExtent(value, &body_x, &body_y, &body_d);
-    mdc.GetTextExtent(
-        m_value_suffix, &suffix_x, &suffix_y, &suffix_d, NULL, &sf);
-    size_x
-        = wxMax(title_x, wxMax(body_x + suffix_x, dummy_x)) + 2 * BORDER_SIZE;
-    size_y = title_y + wxMax(body_y, suffix_y) + 4 * BORDER_SIZE;
+wxBitmap SimpleNumberInstrument::Render(double scale)
+{
+    if (!PrepareFrame(scale)) {
+        return m_bmp;
+    }
+    wxMemoryDC mdc;
 #if defined(__WXGTK__) || defined(__WXQT__)
-    m_bmp = wxBitmap(size_x, size_y, 32);
+    m_bmp = wxBitmap(m_frame.size_x, m_frame.size_y, 32);
 #else
-    m_bmp = wxBitmap(size_x, size_y);
+    m_bmp = wxBitmap(m_frame.size_x, m_frame.size_y);
     m_bmp.UseAlpha();
 #endif
     mdc.SelectObject(m_bmp);
@@ -265,38 +315,23 @@ wxBitmap SimpleNumberInstrument::Render(double scale)
 #else
     wxMemoryDC& dc(mdc);
 #endif
-    dc.SetBackground(*wxTRANSPARENT_BRUSH);
-    dc.Clear();
-    // Draw stuff
-    dc.SetBrush(wxBrush(cbb));
-    dc.DrawRectangle(0, 0, size_x, size_y);
-    dc.SetBrush(wxBrush(ctb));
-    dc.DrawRectangle(0, 0, size_x, title_y + 2 * BORDER_SIZE);
-    dc.SetFont(tf);
-    dc.SetTextForeground(ctf);
-    dc.DrawText(m_title, (size_x - title_x) / 2, BORDER_SIZE);
-    dc.SetFont(bf);
-    dc.SetTextForeground(cbf);
-    dc.DrawLabel(value,
-        wxRect((size_x - (body_x + suffix_x)) / 2,
-            title_y + 3 * BORDER_SIZE + wxMin(body_d, suffix_d), body_x,
-            wxMax(body_y, suffix_y) - suffix_d),
-        wxALIGN_CENTER_HORIZONTAL | wxALIGN_BOTTOM);
-    dc.SetFont(sf);
-    dc.DrawLabel(m_value_suffix,
-        wxRect((size_x - (body_x + suffix_x)) / 2 + body_x,
-            title_y + 3 * BORDER_SIZE + wxMin(body_d, suffix_d), suffix_x,
-            wxMax(body_y, suffix_y) - body_d),
-        wxALIGN_CENTER_HORIZONTAL | wxALIGN_BOTTOM);
-    dc.SetPen(wxPen(cb, BORDER_LINE_WIDTH, wxPENSTYLE_SOLID));
-    dc.SetBrush(*wxTRANSPARENT_BRUSH);
-    dc.DrawRectangle(BORDER_LINE_WIDTH / 2, BORDER_LINE_WIDTH / 2,
-        size_x - BORDER_LINE_WIDTH, size_y - BORDER_LINE_WIDTH);
+    Paint(dc);
     // Done drawing
     mdc.SelectObject(wxNullBitmap);
     return m_bmp;
 }
 
+bool SimpleNumberInstrument::PrepareRaster(double scale)
+{
+    if (!PrepareFrame(scale)) {
+        return false;
+    }
+    m_raster = std::make_unique<dskRasterDC>(
+        m_frame.size_x, m_frame.size_y, GetFontCache());
+    Paint(*m_raster);
+    return true;
+}
+
 void SimpleNumberInstrument::ReadConfig(Json::Value& config)
 {
     Instrument::ReadConfig(config);
@@ -328,49 +363,49 @@ double SimpleNumberInstrument::Transform(const double& val)
 }
 
 const wxColor SimpleNumberInstrument::GetColor(
-    const double& val, const color_item item)
+    const Zone::state st, const color_item item)
 {
     wxColor c;
     switch (item) {
     case color_item::title_bg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX));
         break;
     case color_item::title_fg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX));
         break;
     case color_item::body_bg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_ALERT_BG),
-            GetColorSetting(DSK_SETTING_WARN_BG),
-            GetColorSetting(DSK_SETTING_ALRM_BG),
-            GetColorSetting(DSK_SETTING_EMERG_BG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_ALERT_BG_IDX),
+            ColorSettingAt(DSK_SETTING_WARN_BG_IDX),
+            ColorSettingAt(DSK_SETTING_ALRM_BG_IDX),
+            ColorSettingAt(DSK_SETTING_EMERG_BG_IDX));
         break;
     case color_item::body_fg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_ALERT_FG),
-            GetColorSetting(DSK_SETTING_WARN_FG),
-            GetColorSetting(DSK_SETTING_ALRM_FG),
-            GetColorSetting(DSK_SETTING_EMERG_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_ALERT_FG_IDX),
+            ColorSettingAt(DSK_SETTING_WARN_FG_IDX),
+            ColorSettingAt(DSK_SETTING_ALRM_FG_IDX),
+            ColorSettingAt(DSK_SETTING_EMERG_FG_IDX));
         break;
     case color_item::border:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX));
         break;
     }
     return c;
@@ -45,6 +45,11 @@ void SimpleTextInstrument::Init()
     m_body_font
         = wxFont(15, wxFONTFAMILY_SWISS, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD);
 
+#define X(a, b, c, d, e, f, g, h)                                              \
+    RegisterTypedSetting(b##_IDX, b, dskConfigCtrl::e);
+    DSK_STI_SETTINGS
+#undef X
+
 #define X(a, b, c, d, e, f, g, h) SetSetting(b, c);
     DSK_STI_SETTINGS
 #undef X
@@ -98,7 +103,7 @@ void SimpleTextInstrument::ProcessData()
         if (!m_timed_out
             && (m_allowed_age_sec > 0
                 && std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now() - m_last_change)
+                       Now() - m_last_change)
                         .count()
                     > m_allowed_age_sec)) {
             m_needs_redraw = true;
@@ -107,19 +112,22 @@ void SimpleTextInstrument::ProcessData()
     } else {
         m_new_data = false;
         m_needs_redraw = true;
-        m_last_change = std::chrono::system_clock::now();
+        m_last_change = Now();
         m_timed_out = false;
     }
 }
 
 wxBitmap SimpleTextInstrument::Render(double scale)
 {
-    wxString value = "----";
+    // The placeholder is only assigned for a redraw, an unchanged frame must
+    // not allocate
+    wxString value;
+    bool has_value = false;
     if (!m_new_data) {
         if (!m_timed_out
             && (m_allowed_age_sec > 0
                 && std::chrono::duration_cast<std::chrono::seconds>(
-                       std::chrono::system_clock::now() - m_last_change)
+                       Now() - m_last_change)
                         .count()
                     > m_allowed_age_sec)) {
             m_needs_redraw = true;
@@ -128,16 +136,17 @@ wxBitmap SimpleTextInstrument::Render(double scale)
     } else {
         m_new_data = false;
         m_needs_redraw = true;
-        m_last_change = std::chrono::system_clock::now();
+        m_last_change = Now();
         m_timed_out = false;
         const Json::Value* val = GetSKDataResolved(m_sk_key);
         if (val) {
-            m_last_change = std::chrono::system_clock::now();
-            Json::Value v = val->get("value", toJson(value));
+            m_last_change = Now();
+            const Json::Value& v = (*val)["value"];
             // jsoncpp asString() throws on object/array values (e.g. a
             // complex/position path); only convert scalar leaves.
-            if (!v.isObject() && !v.isArray()) {
+            if (!v.isNull() && !v.isObject() && !v.isArray()) {
                 value = fromJsonVal(v.asString());
+                has_value = true;
             }
         }
     }
@@ -146,26 +155,32 @@ wxBitmap SimpleTextInstrument::Render(double scale)
         return m_bmp;
     }
     m_needs_redraw = false;
+    if (!has_value) {
+        value = "----";
+    }
 
-    wxColor ctb = GetDimedColor(GetColorSetting(DSK_SETTING_TITLE_BG));
-    wxColor ctf = GetDimedColor(GetColorSetting(DSK_SETTING_TITLE_FG));
-    wxColor cbb = GetDimedColor(GetColorSetting(DSK_SETTING_BODY_BG));
-    wxColor cbf = GetDimedColor(GetColorSetting(DSK_SETTING_BODY_FG));
-    wxColor cb = GetDimedColor(GetColorSetting(DSK_SETTING_BORDER_COLOR));
+    wxColor ctb = GetDimedColor(ColorSettingAt(DSK_SETTING_TITLE_BG_IDX));
+    wxColor ctf = GetDimedColor(ColorSettingAt(DSK_SETTING_TITLE_FG_IDX));
+    wxColor cbb = GetDimedColor(ColorSettingAt(DSK_SETTING_BODY_BG_IDX));
+    wxColor cbf = GetDimedColor(ColorSettingAt(DSK_SETTING_BODY_FG_IDX));
+    wxColor cb = GetDimedColor(ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX));
     wxCoord title_x, title_y;
     wxCoord body_x, body_y;
     wxCoord size_x, size_y;
 
     wxMemoryDC mdc;
 
-    wxFont tf = m_title_font;
-    tf.SetPointSize(m_title_font.GetPointSize() * scale);
-    mdc.SetFont(tf);
-    mdc.GetTextExtent(m_title, &title_x, &title_y);
-    wxFont bf = m_body_font;
-    bf.SetPointSize(m_body_font.GetPointSize() * scale);
-    mdc.SetFont(bf);
-    mdc.GetTextExtent(value, &body_x, &body_y);
+    FontCache& fc = GetFontCache();
+    const wxFont& tf
+        = fc.GetFont(m_title_font, m_title_font.GetPointSize() * scale);
+    text_extent extent = fc.GetTextExtent(tf, m_title);
+    title_x = extent.width;
+    title_y = extent.height;
+    const wxFont& bf
+        = fc.GetFont(m_body_font, m_body_font.GetPointSize() * scale);
+    extent = fc.GetTextExtent(bf, value);
+    body_x = extent.width;
+    body_y = extent.height;
     size_x = (wxMax(title_x + 3 * BORDER_SIZE, body_x) + 4 * BORDER_SIZE);
     size_y = (title_y + body_y + 3 * BORDER_SIZE);
 #if defined(__WXGTK__) || defined(__WXQT__)
@@ -226,49 +241,49 @@ Json::Value SimpleTextInstrument::GenerateJSONConfig()
 }
 
 const wxColor SimpleTextInstrument::GetColor(
-    const double& val, const color_item item)
+    const Zone::state st, const color_item item)
 {
     wxColor c;
     switch (item) {
     case color_item::title_bg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG),
-            GetColorSetting(DSK_SETTING_TITLE_BG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_BG_IDX));
         break;
     case color_item::title_fg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG),
-            GetColorSetting(DSK_SETTING_TITLE_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX),
+            ColorSettingAt(DSK_SETTING_TITLE_FG_IDX));
         break;
     case color_item::body_bg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_BODY_BG),
-            GetColorSetting(DSK_SETTING_BODY_BG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_BG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_BG_IDX));
         break;
     case color_item::body_fg:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_BODY_FG),
-            GetColorSetting(DSK_SETTING_BODY_FG));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_FG_IDX),
+            ColorSettingAt(DSK_SETTING_BODY_FG_IDX));
         break;
     case color_item::border:
-        c = AdjustColorForZone(val, GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR),
-            GetColorSetting(DSK_SETTING_BORDER_COLOR));
+        c = AdjustColorForZone(st, ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX),
+            ColorSettingAt(DSK_SETTING_BORDER_COLOR_IDX));
         break;
     }
     return c;
@@ -0,0 +1,353 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "sourcearbiter.h"
+#include "dashboardsk.h"
+
+#include <wx/tokenzr.h>
+
+#include <algorithm>
+
+PLUGIN_BEGIN_NAMESPACE
+
+bool SourceArbiter::ParsePolicy(const wxString& designation, policy& mode,
+    vector<wxString>* priorities)
+{
+    if (designation == "lockfirst") {
+        mode = policy::first;
+    } else if (designation == "lockpersist") {
+        mode = policy::persist;
+    } else if (designation == "freshest") {
+        mode = policy::freshest;
+    } else if (designation.StartsWith("priority(")
+        && designation.EndsWith(")")) {
+        mode = policy::priority;
+        if (priorities) {
+            priorities->clear();
+            wxStringTokenizer tokenizer(
+                designation.Mid(9, designation.length() - 10), ",");
+            while (tokenizer.HasMoreTokens()) {
+                wxString name = tokenizer.GetNextToken();
+                name.Trim(true).Trim(false);
+                if (!name.IsEmpty()) {
+                    priorities->push_back(name);
+                }
+            }
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/// Check whether a source matches a name from a priority list, the dots in
+/// the names may be written as dashes like in the SRC: nodes of the data tree
+/// and the value received without a source is called direct
+///
+/// \param id Id of the source
+/// \param name The listed name
+/// \return true if the name designates the source
+static bool SameSource(const wxString& id, const wxString& name)
+{
+    if (id.IsEmpty()) {
+        return name.IsSameAs("direct");
+    }
+    if (id.length() != name.length()) {
+        return false;
+    }
+    for (size_t i = 0; i < id.length(); i++) {
+        const wxUniChar a = id[i];
+        const wxUniChar b = name[i];
+        if (a != b && !((a == '.' || a == '-') && (b == '.' || b == '-'))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SourceArbiter::IsAlive(
+    const sk_source& s, clock::duration grace, Clock::time_point now)
+{
+    if (!s.HasData()) {
+        return false;
+    }
+    const clock::duration silence = now - s.last_update;
+    if (grace > clock::duration::zero() && silence > grace) {
+        return false;
+    }
+    return s.updates < 2 || silence <= s.interval * STALE_INTERVALS;
+}
+
+size_t SourceArbiter::Rank(const arbitration& a, const sk_source& s)
+{
+    for (size_t i = 0; i < a.priorities.size(); i++) {
+        if (SameSource(s.id, a.priorities[i])) {
+            return i;
+        }
+    }
+    return a.priorities.size();
+}
+
+SourceArbiter::clock::duration SourceArbiter::Staleness(const sk_source& s)
+{
+    if (s.updates < 2) {
+        return clock::duration::max();
+    }
+    return s.interval / 2 + s.lag;
+}
+
+const sk_source* SourceArbiter::Best(const arbitration& a,
+    const SourceRegistry::sources_t& sources, clock::duration grace,
+    Clock::time_point now)
+{
+    const sk_source* best = nullptr;
+    for (const auto& s : sources) {
+        if (!IsAlive(s, grace, now)) {
+            continue;
+        }
+        if (!best
+            || (a.mode == policy::priority ? Rank(a, s) < Rank(a, *best)
+                                           : Staleness(s) < Staleness(*best))) {
+            best = &s;
+        }
+    }
+    return best;
+}
+
+SourceArbiter::clock::duration SourceArbiter::GracePeriod(const arbitration& a)
+{
+    int grace = 0;
+    for (const auto& s : a.subscribers) {
+        if (s.grace_sec > 0 && (grace == 0 || s.grace_sec < grace)) {
+            grace = s.grace_sec;
+        }
+    }
+    return std::chrono::seconds(grace);
+}
+
+void SourceArbiter::Choose(arbitration& a, source_event::type kind,
+    const wxString& source, Clock::time_point now)
+{
+    const source_event e { kind, a.path, a.locked ? a.source : wxString(),
+        source, now };
+    a.locked = true;
+    a.source = source;
+    a.last_seen = now;
+    for (const auto& s : a.subscribers) {
+        s.listener(e);
+    }
+    for (const auto& listener : m_listeners) {
+        listener(e);
+    }
+}
+
+void SourceArbiter::Evaluate(arbitration& a, Clock::time_point now)
+{
+    const SourceRegistry::sources_t* sources = m_registry.GetSources(a.base);
+    if (!sources) {
+        return;
+    }
+    if (!a.locked && (a.mode == policy::first || a.mode == policy::persist)) {
+        const sk_source* first = m_registry.GetFirstAvailable(a.base);
+        if (first) {
+            Choose(a, source_event::type::locked, first->id, now);
+        }
+        return;
+    }
+    if (a.mode == policy::first) {
+        return;
+    }
+
+    const clock::duration grace = GracePeriod(a);
+    const sk_source* current = nullptr;
+    for (const auto& s : *sources) {
+        if (s.id == a.source && s.HasData()) {
+            current = &s;
+            a.last_seen = std::max(a.last_seen, s.last_update);
+            break;
+        }
+    }
+    if (a.mode == policy::persist) {
+        // Fail over to the most recently updated other source
+        const sk_source* best = nullptr;
+        for (const auto& s : *sources) {
+            if (&s != current && s.HasData()
+                && (!best || s.last_update > best->last_update)) {
+                best = &s;
+            }
+        }
+        if (!best || best->last_update <= a.last_seen) {
+            return;
+        }
+        const bool stale = grace == clock::duration::zero()
+            ? !current
+            : now - a.last_seen > grace;
+        if (stale) {
+            Choose(a, source_event::type::failover, best->id, now);
+        }
+        return;
+    }
+
+    const sk_source* best = Best(a, *sources, grace, now);
+    if (!best || best == current) {
+        return;
+    }
+    if (!a.locked) {
+        Choose(a, source_event::type::locked, best->id, now);
+    } else if (!current || !IsAlive(*current, grace, now)) {
+        Choose(a, source_event::type::failover, best->id, now);
+    } else if (a.mode == policy::priority
+            ? Rank(a, *best) < Rank(a, *current)
+            : Staleness(*best)
+                < Staleness(*current) / 100 * (100 - MIN_IMPROVEMENT_PCT)) {
+        Choose(a, source_event::type::switched, best->id, now);
+    }
+}
+
+bool SourceArbiter::Subscribe(const wxString& path, const void* owner,
+    int grace_sec, const listener_t& listener, Clock::time_point now,
+    const wxString* preferred)
+{
+    auto it = m_arbitrations.find(UNORDERED_KEY(path));
+    if (it == m_arbitrations.end()) {
+        const int src_pos = path.Find(SRC_MAGIC_STRING);
+        policy mode;
+        vector<wxString> priorities;
+        if (src_pos == wxNOT_FOUND
+            || !ParsePolicy(path.Mid(src_pos + strlen(SRC_MAGIC_STRING)),
+                mode, &priorities)) {
+            return false;
+        }
+        it = m_arbitrations.emplace(UNORDERED_KEY(path), arbitration()).first;
+        arbitration& a = it->second;
+        a.path = path;
+        a.base = UNORDERED_KEY(path.Left(src_pos - 1));
+        a.mode = mode;
+        a.priorities = std::move(priorities);
+        a.last_seen = now;
+        m_by_base[a.base].push_back(&a);
+    }
+    arbitration& a = it->second;
+    for (auto& s : a.subscribers) {
+        if (s.owner == owner) {
+            s.grace_sec = grace_sec;
+            return true;
+        }
+    }
+    a.subscribers.push_back({ owner, grace_sec, listener });
+    if (a.locked) {
+        // Tell the newcomer what the others already use
+        listener({ source_event::type::locked, a.path, wxString(), a.source,
+            a.last_seen });
+    } else if (preferred) {
+        Choose(a, source_event::type::locked, *preferred, now);
+    } else {
+        Evaluate(a, now);
+    }
+    return true;
+}
+
+void SourceArbiter::SetGrace(const void* owner, int grace_sec)
+{
+    for (auto& entry : m_arbitrations) {
+        for (auto& s : entry.second.subscribers) {
+            if (s.owner == owner) {
+                s.grace_sec = grace_sec;
+            }
+        }
+    }
+}
+
+void SourceArbiter::Unsubscribe(const void* owner)
+{
+    for (auto it = m_arbitrations.begin(); it != m_arbitrations.end();) {
+        arbitration& a = it->second;
+        a.subscribers.erase(std::remove_if(a.subscribers.begin(),
+                                a.subscribers.end(),
+                                [owner](const subscriber& s) {
+                                    return s.owner == owner;
+                                }),
+            a.subscribers.end());
+        if (!a.subscribers.empty()) {
+            ++it;
+            continue;
+        }
+        auto base = m_by_base.find(a.base);
+        base->second.erase(
+            std::find(base->second.begin(), base->second.end(), &a));
+        if (base->second.empty()) {
+            m_by_base.erase(base);
+        }
+        it = m_arbitrations.erase(it);
+    }
+}
+
+void SourceArbiter::Lock(
+    const wxString& path, const wxString& source, Clock::time_point now)
+{
+    auto it = m_arbitrations.find(UNORDERED_KEY(path));
+    if (it == m_arbitrations.end()) {
+        return;
+    }
+    arbitration& a = it->second;
+    if (a.locked && a.source == source) {
+        a.last_seen = now;
+        return;
+    }
+    Choose(a, source_event::type::locked, source, now);
+}
+
+void SourceArbiter::Update(const path_key_t& base, Clock::time_point now)
+{
+    auto it = m_by_base.find(base);
+    if (it == m_by_base.end()) {
+        return;
+    }
+    for (arbitration* a : it->second) {
+        Evaluate(*a, now);
+    }
+}
+
+const sk_source* SourceArbiter::Resolve(const wxString& path) const
+{
+    auto it = m_arbitrations.find(UNORDERED_KEY(path));
+    if (it == m_arbitrations.end() || !it->second.locked) {
+        return nullptr;
+    }
+    const arbitration& a = it->second;
+    const SourceRegistry::sources_t* sources = m_registry.GetSources(a.base);
+    if (!sources) {
+        return nullptr;
+    }
+    for (const auto& s : *sources) {
+        if (s.id == a.source) {
+            return s.HasData() ? &s : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+PLUGIN_END_NAMESPACE
@@ -0,0 +1,165 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "sourceregistry.h"
+
+#include <algorithm>
+
+PLUGIN_BEGIN_NAMESPACE
+
+void SourceRegistry::Update(const path_key_t& path, const wxString& source,
+    const Json::Value* node, Clock::time_point now, Clock::time_point timestamp)
+{
+    const Clock::base_clock::duration lag = now - timestamp;
+    sources_t& sources = m_paths[path];
+    for (auto& s : sources) {
+        if (s.id == source) {
+            const Clock::base_clock::duration interval = now - s.last_update;
+            s.interval = s.updates > 1
+                ? s.interval + (interval - s.interval) / STATS_SMOOTHING
+                : interval;
+            s.lag += (lag - s.lag) / STATS_SMOOTHING;
+            s.node = node;
+            s.last_update = now;
+            s.updates++;
+            return;
+        }
+    }
+    sources.push_back(
+        { source, node, now, Clock::base_clock::duration::zero(), lag, 1 });
+}
+
+const SourceRegistry::sources_t* SourceRegistry::GetSources(
+    const path_key_t& path) const
+{
+    const auto it = m_paths.find(path);
+    return it == m_paths.end() ? nullptr : &it->second;
+}
+
+const sk_source* SourceRegistry::GetFirstAvailable(
+    const path_key_t& path) const
+{
+    const sources_t* sources = GetSources(path);
+    if (!sources) {
+        return nullptr;
+    }
+    const sk_source* first = nullptr;
+    for (const auto& s : *sources) {
+        if (!s.HasData()) {
+            continue;
+        }
+        if (s.id.IsEmpty()) {
+            return &s;
+        }
+        if (!first) {
+            first = &s;
+        }
+    }
+    return first;
+}
+
+void SourceRegistry::RemoveContext(const wxString& context)
+{
+    const path_key_t prefix = UNORDERED_KEY(wxString(context + "."));
+    const path_key_t exact = UNORDERED_KEY(context);
+    for (auto it = m_paths.begin(); it != m_paths.end();) {
+        const path_key_t& key = it->first;
+        if (key == exact || key.compare(0, prefix.length(), prefix) == 0) {
+            it = m_paths.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SourceRegistry::RemoveSubtree(const wxString& path)
+{
+    const path_key_t prefix = UNORDERED_KEY(wxString(path + "."));
+    const path_key_t exact = UNORDERED_KEY(path);
+    for (auto it = m_paths.begin(); it != m_paths.end();) {
+        const path_key_t& key = it->first;
+        if (key == exact) {
+            sources_t& sources = it->second;
+            auto sourced = [](const sk_source& s) { return !s.id.IsEmpty(); };
+            sources.erase(
+                std::remove_if(sources.begin(), sources.end(), sourced),
+                sources.end());
+        } else if (key.compare(0, prefix.length(), prefix) == 0) {
+            it = m_paths.erase(it);
+            continue;
+        }
+        ++it;
+    }
+}
+
+void SourceRegistry::Expire(Clock::time_point deadline, const path_key_t& keep,
+    vector<source_key_t>& expired)
+{
+    if (m_paths.empty()) {
+        return;
+    }
+    // The buckets serve as the cursor, as the order of the paths changes when
+    // the map grows. A path moved by a rehash is checked on a later round.
+    const size_t buckets = m_paths.bucket_count();
+    const auto is_stale
+        = [deadline](const sk_source& s) { return s.last_update < deadline; };
+    vector<path_key_t> stale;
+    size_t checked = 0;
+    for (size_t n = 0; n < buckets && checked < EXPIRY_BATCH; n++) {
+        m_cursor = m_cursor < buckets ? m_cursor : 0;
+        for (auto it = m_paths.cbegin(m_cursor); it != m_paths.cend(m_cursor);
+            ++it) {
+            ++checked;
+            const path_key_t& key = it->first;
+            if (!keep.empty() && key.compare(0, keep.length(), keep) == 0) {
+                continue;
+            }
+            const sources_t& sources = it->second;
+            if (sources.empty()
+                || std::any_of(sources.cbegin(), sources.cend(), is_stale)) {
+                stale.push_back(key);
+            }
+        }
+        m_cursor++;
+    }
+    for (const auto& key : stale) {
+        auto it = m_paths.find(key);
+        sources_t& sources = it->second;
+        for (auto s = sources.begin(); s != sources.end();) {
+            if (is_stale(*s)) {
+                expired.emplace_back(key, s->id);
+                s = sources.erase(s);
+            } else {
+                ++s;
+            }
+        }
+        if (sources.empty()) {
+            m_paths.erase(it);
+        }
+    }
+}
+
+PLUGIN_END_NAMESPACE
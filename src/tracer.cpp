@@ -0,0 +1,275 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "tracer.h"
+
+#include <wx/ffile.h>
+
+#include <array>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+PLUGIN_BEGIN_NAMESPACE
+
+/// A recorded span
+struct trace_event {
+    /// Name of the span
+    const char* name;
+    /// Start in microseconds
+    int64_t start;
+    /// Duration in microseconds
+    int64_t duration;
+    /// Index of the canvas, -1 if none
+    int canvas;
+    /// UTF-8 encoded detail, NUL terminated
+    char detail[Tracer::DETAIL_LEN];
+};
+
+/// Ring buffer of the spans of a single thread. Only the owning thread
+/// pushes, only the flush pops.
+struct trace_buffer {
+    /// Sequential id of the thread in the trace
+    int tid;
+    /// Next position to write, only advanced by the owning thread
+    std::atomic<size_t> head { 0 };
+    /// Next position to read, only advanced by the flush
+    std::atomic<size_t> tail { 0 };
+    /// Number of the spans dropped because the buffer was full
+    std::atomic<size_t> dropped { 0 };
+    /// The spans
+    std::array<trace_event, Tracer::BUFFER_SIZE> events;
+};
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+/// Shared state of the tracer, only touched when a thread records its first
+/// span and by the flush
+static struct {
+    /// Guards the members of the state, never held while recording a span
+    std::mutex mutex;
+    /// Buffers of all the threads that ever recorded a span, kept alive after
+    /// the thread ends until they are flushed
+    vector<std::shared_ptr<trace_buffer>> buffers;
+    /// The trace file
+    wxFFile file;
+    /// Number of the events written to the file
+    size_t written = 0;
+} s_trace;
+
+/// Get the buffer of the calling thread, creating it on the first use
+///
+/// \return The buffer
+static trace_buffer& ThreadBuffer()
+{
+    thread_local std::shared_ptr<trace_buffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<trace_buffer>();
+        std::lock_guard<std::mutex> lock(s_trace.mutex);
+        buffer->tid = static_cast<int>(s_trace.buffers.size()) + 1;
+        s_trace.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+/// Append a string to a JSON document as a string value
+///
+/// \param out The document
+/// \param s UTF-8 encoded string
+static void AppendJSONString(std::string& out, const char* s)
+{
+    out += '"';
+    for (; *s; s++) {
+        const unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += *s;
+        } else if (c < 0x20) {
+            char esc[8];
+            snprintf(esc, sizeof(esc), "\\u%04x", c);
+            out += esc;
+        } else {
+            out += *s;
+        }
+    }
+    out += '"';
+}
+
+/// Encode a string as UTF-8 into a fixed size buffer without allocating,
+/// cutting it at a character boundary if it does not fit
+///
+/// \param str The string
+/// \param out The buffer, NUL terminated
+/// \param size Size of the buffer
+static void EncodeUTF8(const wxString& str, char* out, size_t size)
+{
+    size_t len = 0;
+    uint32_t high = 0;
+    for (auto it = str.begin(); it != str.end(); ++it) {
+        uint32_t c = (*it).GetValue();
+        // Surrogate pairs of the UTF-16 strings on Windows
+        if (c >= 0xD800 && c < 0xDC00) {
+            high = c;
+            continue;
+        }
+        if (c >= 0xDC00 && c < 0xE000) {
+            if (!high) {
+                continue;
+            }
+            c = 0x10000 + ((high - 0xD800) << 10) + (c - 0xDC00);
+        }
+        high = 0;
+        char seq[4];
+        size_t n;
+        if (c < 0x80) {
+            seq[0] = static_cast<char>(c);
+            n = 1;
+        } else if (c < 0x800) {
+            seq[0] = static_cast<char>(0xC0 | (c >> 6));
+            seq[1] = static_cast<char>(0x80 | (c & 0x3F));
+            n = 2;
+        } else if (c < 0x10000) {
+            seq[0] = static_cast<char>(0xE0 | (c >> 12));
+            seq[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            seq[2] = static_cast<char>(0x80 | (c & 0x3F));
+            n = 3;
+        } else {
+            seq[0] = static_cast<char>(0xF0 | (c >> 18));
+            seq[1] = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            seq[2] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            seq[3] = static_cast<char>(0x80 | (c & 0x3F));
+            n = 4;
+        }
+        if (len + n >= size) {
+            break;
+        }
+        memcpy(out + len, seq, n);
+        len += n;
+    }
+    out[len] = '\0';
+}
+
+bool Tracer::Start(const wxString& path)
+{
+    Stop();
+    std::lock_guard<std::mutex> lock(s_trace.mutex);
+    if (!s_trace.file.Open(path, "w")) {
+        LOG_INFO("DashboardSK_pi: Can't open trace file " + path);
+        return false;
+    }
+    s_trace.file.Write("[\n", 2);
+    s_trace.written = 0;
+    // Forget whatever was recorded since the last trace was stopped
+    for (auto& buffer : s_trace.buffers) {
+        buffer->tail.store(buffer->head.load(std::memory_order_acquire),
+            std::memory_order_release);
+        buffer->dropped = 0;
+    }
+    s_enabled.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void Tracer::Stop()
+{
+    if (!s_enabled.exchange(false)) {
+        return;
+    }
+    Flush();
+    std::lock_guard<std::mutex> lock(s_trace.mutex);
+    s_trace.file.Write("\n]\n", 3);
+    s_trace.file.Close();
+}
+
+size_t Tracer::Flush()
+{
+    std::lock_guard<std::mutex> lock(s_trace.mutex);
+    if (!s_trace.file.IsOpened()) {
+        return 0;
+    }
+    size_t count = 0;
+    std::string out;
+    for (auto& buffer : s_trace.buffers) {
+        const size_t head = buffer->head.load(std::memory_order_acquire);
+        size_t tail = buffer->tail.load(std::memory_order_relaxed);
+        for (; tail != head; tail++) {
+            const trace_event& e = buffer->events[tail % BUFFER_SIZE];
+            if (s_trace.written + count > 0) {
+                out += ",\n";
+            }
+            out += "{\"name\":";
+            AppendJSONString(out, e.name);
+            out += ",\"cat\":\"dsk\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+                + std::to_string(buffer->tid)
+                + ",\"ts\":" + std::to_string(e.start)
+                + ",\"dur\":" + std::to_string(e.duration) + ",\"args\":{";
+            if (e.canvas >= 0) {
+                out += "\"canvas\":" + std::to_string(e.canvas);
+            }
+            if (e.detail[0]) {
+                out += e.canvas >= 0 ? ",\"detail\":" : "\"detail\":";
+                AppendJSONString(out, e.detail);
+            }
+            out += "}}";
+            count++;
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+    if (!out.empty()) {
+        s_trace.file.Write(out.data(), out.size());
+    }
+    s_trace.written += count;
+    return count;
+}
+
+size_t Tracer::GetDroppedCount()
+{
+    std::lock_guard<std::mutex> lock(s_trace.mutex);
+    size_t dropped = 0;
+    for (auto& buffer : s_trace.buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+void Tracer::Record(const char* name, int64_t start, int64_t end, int canvas,
+    const wxString& detail)
+{
+    trace_buffer& buffer = ThreadBuffer();
+    const size_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= BUFFER_SIZE) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    trace_event& e = buffer.events[head % BUFFER_SIZE];
+    e.name = name;
+    e.start = start;
+    e.duration = end - start;
+    e.canvas = canvas;
+    EncodeUTF8(detail, e.detail, sizeof(e.detail));
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+PLUGIN_END_NAMESPACE
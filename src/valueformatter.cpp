@@ -0,0 +1,135 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "valueformatter.h"
+#include "instrument.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+// Floating point std::to_chars needs libstdc++ from GCC 11 and libc++ marks it
+// unavailable before macOS 13.3, older than the deployment target of the
+// macOS builds
+#if defined(__cpp_lib_to_chars) && !defined(__APPLE__)
+#define DSK_FP_TO_CHARS
+#endif
+
+PLUGIN_BEGIN_NAMESPACE
+
+ValueFormatter ValueFormatter::Compile(
+    const wxString& label, const wxString& format)
+{
+    int width = 0;
+    int precision = 6;
+    bool zero_pad = false;
+    const std::string f = format.ToStdString();
+    size_t i = f.find('%');
+    if (i != std::string::npos) {
+        i++;
+        if (i < f.size() && f[i] == '0') {
+            zero_pad = true;
+            i++;
+        }
+        while (i < f.size() && isdigit(f[i])) {
+            width = width * 10 + (f[i++] - '0');
+        }
+        if (i < f.size() && f[i] == '.') {
+            i++;
+            precision = 0;
+            while (i < f.size() && isdigit(f[i])) {
+                precision = precision * 10 + (f[i++] - '0');
+            }
+        }
+    }
+    return ValueFormatter(width, precision, zero_pad, label.StartsWith("ABS"));
+}
+
+size_t ValueFormatter::Format(double value, char* buf, size_t size) const
+{
+    char digits[BUFFER_SIZE];
+    const double v = std::abs(value);
+#ifdef DSK_FP_TO_CHARS
+    auto res = std::to_chars(digits, digits + sizeof(digits), v,
+        std::chars_format::fixed, m_precision);
+    if (res.ec != std::errc()) {
+        return 0;
+    }
+    const size_t len = res.ptr - digits;
+#else
+    const int written
+        = snprintf(digits, sizeof(digits), "%.*f", m_precision, v);
+    if (written < 0 || static_cast<size_t>(written) >= sizeof(digits)) {
+        return 0;
+    }
+    const size_t len = written;
+#endif
+    const size_t pad = len < static_cast<size_t>(m_width) ? m_width - len : 0;
+    // Like the "-" prepended to the printf output, the sign goes before the
+    // padding
+    const bool negative = value < 0 && !m_abs;
+    const size_t total = (negative ? 1 : 0) + pad + len;
+    if (total > size) {
+        return 0;
+    }
+    char* p = buf;
+    if (negative) {
+        *p++ = '-';
+    }
+    // printf never pads infinity and NaN with zeros
+    memset(p, m_zero_pad && std::isfinite(v) ? '0' : ' ', pad);
+    memcpy(p + pad, digits, len);
+    return total;
+}
+
+wxString ValueFormatter::Format(double value) const
+{
+    char buf[BUFFER_SIZE];
+    return wxString::FromAscii(buf, Format(value, buf, sizeof(buf)));
+}
+
+const vector<ValueFormatter>& ValueFormatter::Formats()
+{
+    static const vector<ValueFormatter> formats = {
+#define X(a, b, c) Compile(b, c),
+        DSK_VALUE_FORMATS
+#undef X
+    };
+    return formats;
+}
+
+const ValueFormatter& ValueFormatter::Get(int index)
+{
+    if (index < 0 || static_cast<size_t>(index) >= Formats().size()) {
+        return Formats()[0];
+    }
+    return Formats()[index];
+}
+
+size_t ValueFormatter::Count() { return Formats().size(); }
+
+PLUGIN_END_NAMESPACE
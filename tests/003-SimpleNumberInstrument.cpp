@@ -67,3 +67,23 @@ TEST_CASE("SimpleNumberInstrument Configuration Storage - if JSON not "
     REQUIRE(v[DSK_SETTING_TITLE_FONT].asInt() > 1);
     REQUIRE(v[DSK_SETTING_TITLE_FONT].asInt() < 30);
 }
+
+TEST_CASE("SimpleNumberInstrument Configuration Storage - typed settings "
+          "follow the string values")
+{
+    SimpleNumberInstrument i(nullptr);
+    Json::Value v;
+
+    REQUIRE(i.GetColorSetting(DSK_SETTING_TITLE_BG) == DSK_SNI_COLOR_TITLE_BG);
+    ParseJSON("{ \"title_background\": \"#102030\", \"format\": 2 }", v);
+    i.ReadConfig(v);
+    REQUIRE(i.GetColorSetting(DSK_SETTING_TITLE_BG) == wxColor(16, 32, 48));
+    REQUIRE(i.GetIntSetting(DSK_SETTING_FORMAT) == 2);
+    i.SetSetting(DSK_SETTING_BODY_FG, wxColor(1, 2, 3));
+    REQUIRE(i.GetColorSetting(DSK_SETTING_BODY_FG) == wxColor(1, 2, 3));
+    v = i.GenerateJSONConfig();
+    REQUIRE(fromJsonVal(v[DSK_SETTING_TITLE_BG].asString())
+            .IsSameAs("#102030"));
+    REQUIRE(fromJsonVal(v[DSK_SETTING_BODY_FG].asString())
+            .IsSameAs("#010203"));
+}
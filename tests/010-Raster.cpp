@@ -0,0 +1,156 @@
+/******************************************************************************
+ * DashboardSK raster backend and parallel rendering tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboard.h"
+#include "dashboardsk.h"
+#include "dskraster.h"
+#include "fontcache.h"
+#include "renderpool.h"
+#include "simplegaugeinstrument.h"
+#include "simplenumberinstrument.h"
+
+#include <atomic>
+
+using namespace DashboardSKPlugin;
+
+TEST_CASE("Raster image primitives")
+{
+    RasterImage img(20, 20);
+    img.Clear({ 0, 0, 0, 0 });
+    REQUIRE(img.GetPixel(0, 0).a == 0);
+
+    img.FillRect(2, 2, 4, 4, { 255, 0, 0, 255 });
+    REQUIRE(img.GetPixel(3, 3).r == 255);
+    REQUIRE(img.GetPixel(3, 3).a == 255);
+    REQUIRE(img.GetPixel(7, 7).a == 0);
+
+    // Half transparent blue over the opaque red
+    img.FillRect(2, 2, 4, 4, { 0, 0, 255, 128 });
+    raster_color c = img.GetPixel(3, 3);
+    REQUIRE(c.a == 255);
+    REQUIRE(c.r > 100);
+    REQUIRE(c.r < 155);
+    REQUIRE(c.b > 100);
+
+    img.FillCircle(14, 14, 4.5, { 0, 255, 0, 255 });
+    REQUIRE(img.GetPixel(14, 14).g == 255);
+    REQUIRE(img.GetPixel(19, 19).a == 0);
+    // Antialiased edge is partially covered
+    REQUIRE(img.GetPixel(18, 14).a > 0);
+    REQUIRE(img.GetPixel(18, 14).a < 255);
+}
+
+TEST_CASE("Raster image sectors")
+{
+    RasterImage img(40, 40);
+    img.Clear({ 0, 0, 0, 0 });
+    // Upper half of the circle (counterclockwise on the screen from 0 to PI)
+    img.FillSector(20, 20, 15, 0, PI, { 255, 255, 255, 255 });
+    REQUIRE(img.GetPixel(20, 10).a == 255);
+    REQUIRE(img.GetPixel(20, 30).a == 0);
+    // Equal angles fill the full circle
+    img.FillSector(20, 20, 15, 1, 1, { 255, 255, 255, 255 });
+    REQUIRE(img.GetPixel(20, 30).a == 255);
+}
+
+TEST_CASE("Raster DC replays the recorded operations")
+{
+    FontCache fonts;
+    dskRasterDC dc(10, 10, fonts);
+    dc.SetBackground(*wxTRANSPARENT_BRUSH);
+    dc.Clear();
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(wxBrush(wxColour(0, 0, 255)));
+    dc.DrawRectangle(0, 0, 5, 10);
+    dc.Rasterize();
+    REQUIRE(dc.GetImage().GetPixel(2, 5).b == 255);
+    REQUIRE(dc.GetImage().GetPixel(7, 5).a == 0);
+    wxBitmap bmp = dc.ToBitmap();
+    REQUIRE(bmp.IsOk());
+    REQUIRE(bmp.GetWidth() == 10);
+    REQUIRE(bmp.GetHeight() == 10);
+}
+
+TEST_CASE("Render pool executes every job exactly once")
+{
+    for (size_t threads : { 0, 1, 3 }) {
+        RenderPool pool(threads);
+        REQUIRE(pool.GetThreadCount() == threads);
+        std::atomic<int> sum(0);
+        vector<std::function<void()>> jobs;
+        for (int i = 1; i <= 100; ++i) {
+            jobs.emplace_back([&sum, i]() { sum += i; });
+        }
+        pool.Run(jobs);
+        REQUIRE(sum == 5050);
+        // The pool is reusable
+        pool.Run(jobs);
+        REQUIRE(sum == 10100);
+    }
+}
+
+TEST_CASE("Gauges and numbers rasterized off-thread match the serial size")
+{
+    DashboardSK dsk("");
+    Dashboard* dashboard = dsk.AddDashboard();
+    SimpleGaugeInstrument gauge(dashboard);
+    SimpleGaugeInstrument serial_gauge(dashboard);
+    SimpleNumberInstrument number(dashboard);
+    SimpleNumberInstrument serial_number(dashboard);
+    for (auto* i : { &gauge, &serial_gauge }) {
+        i->SetSetting(wxString(DSK_SETTING_SK_KEY), wxString("test.awa"));
+    }
+    for (auto* i : { &number, &serial_number }) {
+        i->SetSetting(wxString(DSK_SETTING_SK_KEY), wxString("test.awa"));
+    }
+
+    Json::Value update;
+    update["context"] = "test";
+    update["updates"][0]["values"][0]["path"] = "awa";
+    update["updates"][0]["values"][0]["value"] = 0.5;
+    dsk.SendSKDelta(update);
+
+    REQUIRE(gauge.PrepareRaster(1.0));
+    REQUIRE(number.PrepareRaster(1.0));
+    RenderPool pool(2);
+    pool.Run({ [&gauge]() { gauge.Rasterize(); },
+        [&number]() { number.Rasterize(); } });
+    gauge.CommitRaster();
+    number.CommitRaster();
+
+    wxBitmap parallel = gauge.Render(1.0);
+    wxBitmap serial = serial_gauge.Render(1.0);
+    REQUIRE(parallel.IsOk());
+    REQUIRE(parallel.GetWidth() == serial.GetWidth());
+    REQUIRE(parallel.GetHeight() == serial.GetHeight());
+
+    parallel = number.Render(1.0);
+    serial = serial_number.Render(1.0);
+    REQUIRE(parallel.IsOk());
+    REQUIRE(parallel.GetWidth() == serial.GetWidth());
+    REQUIRE(parallel.GetHeight() == serial.GetHeight());
+
+    // Nothing new arrived, there is nothing to rasterize
+    REQUIRE_FALSE(number.PrepareRaster(1.0));
+}
+
+TEST_CASE("Parallel rendering configuration round trip")
+{
+    DashboardSK dsk("");
+    REQUIRE_FALSE(dsk.GetParallelRendering());
+    Json::Value config;
+    config["signalk"]["self"] = "urn:mrn:imo:mmsi:123456789";
+    config["rendering"]["parallel"] = true;
+    config["rendering"]["threads"] = 3;
+    dsk.ReadConfig(config);
+    REQUIRE(dsk.GetParallelRendering());
+    REQUIRE(dsk.GetRenderThreads() == 3);
+    Json::Value stored = dsk.GenerateJSONConfig();
+    REQUIRE(stored["rendering"]["parallel"].asBool());
+    REQUIRE(stored["rendering"]["threads"].asInt() == 3);
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+ * DashboardSK font and text metrics cache tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboard.h"
+#include "dashboardsk.h"
+#include "dskraster.h"
+#include "fontcache.h"
+
+using namespace DashboardSKPlugin;
+
+TEST_CASE("Font cache reuses fonts and text extents")
+{
+    FontCache cache;
+    const wxFont& f1
+        = cache.GetFont(12, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL);
+    const wxFont& f2
+        = cache.GetFont(12, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL);
+    REQUIRE(&f1 == &f2);
+    REQUIRE(cache.GetFontCount() == 1);
+    cache.GetFont(12, wxFONTFAMILY_SWISS, wxFONTWEIGHT_BOLD);
+    cache.GetFont(14, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL);
+    REQUIRE(cache.GetFontCount() == 3);
+    // Scaled variant of a configured font shares the cache entry
+    REQUIRE(&cache.GetFont(f1, 14)
+        == &cache.GetFont(14, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL));
+
+    text_extent e1 = cache.GetTextExtent(f1, "12.3");
+    text_extent e2 = cache.GetTextExtent(f1, "12.3");
+    REQUIRE(cache.GetExtentCount() == 1);
+    REQUIRE(e1.width == e2.width);
+    REQUIRE(e1.height == e2.height);
+    REQUIRE(e1.width > 0);
+    cache.GetTextExtent(f1, "45.6");
+    REQUIRE(cache.GetExtentCount() == 2);
+
+    cache.Clear();
+    REQUIRE(cache.GetFontCount() == 0);
+    REQUIRE(cache.GetExtentCount() == 0);
+}
+
+TEST_CASE("Font cache renders each text only once")
+{
+    FontCache cache;
+    const wxFont& f
+        = cache.GetFont(12, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL);
+    auto m1 = cache.GetTextMask(f, "12.3", 0.0);
+    REQUIRE(m1);
+    REQUIRE(m1->mask.width > 0);
+    REQUIRE(m1->mask.coverage.size()
+        == static_cast<size_t>(m1->mask.width) * m1->mask.height);
+    REQUIRE(cache.GetTextMask(f, "12.3", 0.0) == m1);
+    REQUIRE(cache.GetMaskCount() == 1);
+    REQUIRE(cache.GetTextMask(f, "45.6", 0.0) != m1);
+    REQUIRE(cache.GetTextMask(f, "12.3", 90.0) != m1);
+    REQUIRE(cache.GetMaskCount() == 3);
+    REQUIRE_FALSE(cache.GetTextMask(f, "", 0.0));
+
+    // The raster DC draws the cached masks in any color
+    dskRasterDC dc(50, 50, cache);
+    dc.SetFont(f);
+    dc.SetTextForeground(*wxRED);
+    dc.DrawText("12.3", 0, 0);
+    dc.SetTextForeground(*wxGREEN);
+    dc.DrawText("12.3", 10, 10);
+    REQUIRE(cache.GetMaskCount() == 3);
+
+    cache.Clear();
+    REQUIRE(cache.GetMaskCount() == 0);
+    // Masks in use stay valid after the cache is cleared
+    REQUIRE(m1->mask.width > 0);
+}
+
+TEST_CASE("Font cache is invalidated on theme change")
+{
+    DashboardSK dsk("");
+    Dashboard* dashboard = dsk.AddDashboard();
+    REQUIRE(&dashboard->GetFontCache() == &dsk.GetFontCache());
+    dsk.GetFontCache().GetFont(10, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL);
+    REQUIRE(dsk.GetFontCache().GetFontCount() == 1);
+    dsk.SetColorScheme(2);
+    REQUIRE(dsk.GetFontCache().GetFontCount() == 0);
+}
+
+TEST_CASE("System font scaling change redraws only when it changes")
+{
+    DashboardSK dsk("");
+    Dashboard* dashboard = dsk.AddDashboard();
+    double factor = Instrument::GetSystemFontScalingFactor();
+    REQUIRE(factor > 0.0);
+    dsk.GetFontCache().GetFont(10, wxFONTFAMILY_SWISS, wxFONTWEIGHT_NORMAL);
+    REQUIRE_FALSE(Instrument::SetSystemFontScalingFactor(factor));
+    REQUIRE(dsk.GetFontCache().GetFontCount() == 1);
+    REQUIRE(Instrument::SetSystemFontScalingFactor(factor * 2));
+    REQUIRE(Instrument::GetSystemFontScalingFactor() == factor * 2);
+    REQUIRE(dsk.GetFontCache().GetFontCount() == 0);
+    REQUIRE(Instrument::SetSystemFontScalingFactor(factor));
+    REQUIRE(dashboard->GetFontCache().GetFontCount() == 0);
+}
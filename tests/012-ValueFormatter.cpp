@@ -0,0 +1,54 @@
+/******************************************************************************
+ * DashboardSK numeric value formatter tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "instrument.h"
+#include "valueformatter.h"
+
+#include <cmath>
+
+using namespace DashboardSKPlugin;
+
+TEST_CASE("Value formatters are compiled from DSK_VALUE_FORMATS")
+{
+    REQUIRE(ValueFormatter::Count() == 18);
+    const ValueFormatter& f = ValueFormatter::Get(8);
+    REQUIRE(f.GetWidth() == 6);
+    REQUIRE(f.GetPrecision() == 2);
+    REQUIRE(f.IsZeroPadded());
+    REQUIRE_FALSE(f.IsAbs());
+    REQUIRE(ValueFormatter::Get(17).IsAbs());
+    REQUIRE(&ValueFormatter::Get(-1) == &ValueFormatter::Get(0));
+    REQUIRE(&ValueFormatter::Get(100) == &ValueFormatter::Get(0));
+}
+
+TEST_CASE("Value formatters match printf formatting")
+{
+    const double values[] = { 0.0, 0.05, 0.25, 1.005, 2.5, -0.04, -1.25,
+        12.345, -123.456, 99999.99, 1e20, INFINITY };
+    int i = 0;
+#define X(a, b, c)                                                             \
+    for (double v : values) {                                                  \
+        wxString expected = wxString::Format(c, std::abs(v));                  \
+        if (v < 0 && !wxString(b).StartsWith("ABS")) {                         \
+            expected.Prepend("-");                                             \
+        }                                                                      \
+        REQUIRE(ValueFormatter::Get(i).Format(v) == expected);                 \
+    }                                                                          \
+    i++;
+    DSK_VALUE_FORMATS
+#undef X
+}
+
+TEST_CASE("Value formatter writes into a caller supplied buffer")
+{
+    ValueFormatter f(5, 1, true, false);
+    char buf[8];
+    REQUIRE(f.Format(-3.25, buf, sizeof(buf)) == 6);
+    REQUIRE(std::string(buf, 6) == "-003.2");
+    REQUIRE(f.Format(1234567.0, buf, sizeof(buf)) == 0);
+}
@@ -0,0 +1,63 @@
+/******************************************************************************
+ * DashboardSK zone index tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "zone.h"
+
+#include <cmath>
+#include <random>
+
+using namespace DashboardSKPlugin;
+
+/// Reference implementation - the linear scan the index replaces
+static Zone::state ScanZones(const vector<Zone>& zones, double val)
+{
+    Zone::state st = Zone::state::nominal;
+    for (const auto& zone : zones) {
+        if (val >= zone.GetLowerLimit() && val <= zone.GetUpperLimit()
+            && st < zone.GetState()) {
+            st = zone.GetState();
+        }
+    }
+    return st;
+}
+
+TEST_CASE("Zone index returns the highest severity state")
+{
+    vector<Zone> zones = Zone::ParseZonesFromString(
+        "0,10,normal;8,12,warn;12,20,alarm;15,16,alert");
+    ZoneIndex index(zones);
+    REQUIRE(index.GetState(-1.0) == Zone::state::nominal);
+    REQUIRE(index.GetState(0.0) == Zone::state::normal);
+    REQUIRE(index.GetState(7.9) == Zone::state::normal);
+    REQUIRE(index.GetState(8.0) == Zone::state::warn);
+    REQUIRE(index.GetState(12.0) == Zone::state::alarm);
+    REQUIRE(index.GetState(15.5) == Zone::state::alarm);
+    REQUIRE(index.GetState(20.0) == Zone::state::alarm);
+    REQUIRE(index.GetState(20.1) == Zone::state::nominal);
+    REQUIRE(index.GetState(NAN) == Zone::state::nominal);
+    REQUIRE(ZoneIndex().GetState(1.0) == Zone::state::nominal);
+    REQUIRE(ZoneIndex().IsEmpty());
+}
+
+TEST_CASE("Zone index matches scanning the zones")
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> limit(-20, 20);
+    std::uniform_int_distribution<int> state(0, 5);
+    for (int round = 0; round < 50; round++) {
+        vector<Zone> zones;
+        for (int i = 0; i < round % 7; i++) {
+            zones.emplace_back(Zone(limit(gen), limit(gen),
+                static_cast<Zone::state>(state(gen))));
+        }
+        ZoneIndex index(zones);
+        for (double v = -22.0; v <= 22.0; v += 0.25) {
+            REQUIRE(index.GetState(v) == ScanZones(zones, v));
+        }
+    }
+}
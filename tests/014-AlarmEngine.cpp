@@ -0,0 +1,201 @@
+/******************************************************************************
+ * DashboardSK alarm engine tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "alarmengine.h"
+#include "dashboardsk.h"
+#include "simplenumberinstrument.h"
+
+#include <cmath>
+
+using namespace DashboardSKPlugin;
+
+static const wxString PATH("vessels.urn:mrn:imo:mmsi:234567890.environment."
+                           "depth.belowKeel");
+
+/// Engine monitoring #PATH with zones between 0 and 100
+static void Setup(AlarmEngine& engine, vector<alarm_transition>& published)
+{
+    engine.AddListener(
+        [&published](const alarm_transition& t) { published.push_back(t); });
+    AlarmEngine::watches_t watches;
+    watches[UNORDERED_KEY(PATH)].zones
+        = Zone::ParseZonesFromString("0,2,alarm;2,5,warn;5,100,normal");
+    engine.SetWatches(watches);
+}
+
+TEST_CASE("Alarm engine publishes transitions of monitored paths only")
+{
+    AlarmEngine engine;
+    engine.SetDebounce(AlarmEngine::clock::duration::zero());
+    vector<alarm_transition> published;
+    Setup(engine, published);
+    auto now = AlarmEngine::clock::now();
+
+    engine.Update("vessels.self.other", 1.0, now);
+    REQUIRE(published.empty());
+    REQUIRE_FALSE(engine.IsWatched("vessels.self.other"));
+
+    engine.Update(PATH, 10.0, now);
+    REQUIRE(published.size() == 1);
+    REQUIRE(published[0].from == Zone::state::nominal);
+    REQUIRE(published[0].to == Zone::state::normal);
+    engine.Update(PATH, 11.0, now);
+    REQUIRE(published.size() == 1);
+
+    engine.Update(PATH, 1.0, now);
+    REQUIRE(published.size() == 2);
+    REQUIRE(published[1].to == Zone::state::alarm);
+    REQUIRE(published[1].value == 1.0);
+    REQUIRE(engine.GetState(PATH) == Zone::state::alarm);
+}
+
+TEST_CASE("Alarm engine applies hysteresis when the severity drops")
+{
+    AlarmEngine engine;
+    engine.SetDebounce(AlarmEngine::clock::duration::zero());
+    engine.SetHysteresis(0.01); // 1 with zones spanning 0-100
+    vector<alarm_transition> published;
+    Setup(engine, published);
+    auto now = AlarmEngine::clock::now();
+
+    engine.Update(PATH, 1.5, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::alarm);
+    // Just above the alarm zone, still within the hysteresis
+    engine.Update(PATH, 2.5, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::alarm);
+    engine.Update(PATH, 3.5, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::warn);
+    // Escalation is immediate
+    engine.Update(PATH, 1.9, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::alarm);
+    REQUIRE(published.size() == 3);
+}
+
+TEST_CASE("Alarm engine debounces state changes")
+{
+    AlarmEngine engine;
+    engine.SetHysteresis(0.0);
+    engine.SetDebounce(std::chrono::milliseconds(1000));
+    vector<alarm_transition> published;
+    Setup(engine, published);
+    auto start = AlarmEngine::clock::now();
+
+    engine.Update(PATH, 1.0, start);
+    REQUIRE(published.empty());
+    // Short spike back to the nominal state restarts the debouncing
+    engine.Update(PATH, 200.0, start + std::chrono::milliseconds(500));
+    engine.Update(PATH, 1.0, start + std::chrono::milliseconds(600));
+    engine.Update(PATH, 1.0, start + std::chrono::milliseconds(1500));
+    REQUIRE(published.empty());
+    // No new data needed for the pending state to be published
+    engine.Tick(start + std::chrono::milliseconds(1599));
+    REQUIRE(published.empty());
+    engine.Tick(start + std::chrono::milliseconds(1600));
+    REQUIRE(published.size() == 1);
+    REQUIRE(published[0].to == Zone::state::alarm);
+    engine.Tick(start + std::chrono::milliseconds(5000));
+    REQUIRE(published.size() == 1);
+}
+
+TEST_CASE("Alarm engine falls back to the metadata zones")
+{
+    AlarmEngine engine;
+    engine.SetDebounce(AlarmEngine::clock::duration::zero());
+    vector<alarm_transition> published;
+    engine.AddListener(
+        [&published](const alarm_transition& t) { published.push_back(t); });
+    engine.SetMetaZones(PATH, Zone::ParseZonesFromString("0,3,emergency"));
+    auto now = AlarmEngine::clock::now();
+
+    // Metadata alone does not make the path monitored
+    engine.Update(PATH, 1.0, now);
+    REQUIRE(published.empty());
+
+    AlarmEngine::watches_t watches;
+    watches[UNORDERED_KEY(PATH)] = AlarmEngine::watch();
+    engine.SetWatches(watches);
+    engine.Update(PATH, 1.0, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::emergency);
+
+    // Configured zones take precedence
+    watches[UNORDERED_KEY(PATH)].zones
+        = Zone::ParseZonesFromString("0,3,alert");
+    engine.SetWatches(watches);
+    engine.Update(PATH, 1.0, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::alert);
+
+    // Dropping the watch clears the state
+    engine.SetWatches(AlarmEngine::watches_t());
+    REQUIRE(engine.GetState(PATH) == Zone::state::nominal);
+    REQUIRE(published.back().to == Zone::state::nominal);
+    REQUIRE(std::isnan(published.back().value));
+    REQUIRE_FALSE(engine.IsWatched(PATH));
+}
+
+TEST_CASE("Alarm engine converts the values to the units of the zones")
+{
+    AlarmEngine engine;
+    engine.SetDebounce(AlarmEngine::clock::duration::zero());
+    engine.SetMetaZones(PATH, Zone::ParseZonesFromString("0,3,emergency"));
+    AlarmEngine::watches_t watches;
+    // Zones configured in feet for a value in meters
+    watches[UNORDERED_KEY(PATH)].zones
+        = Zone::ParseZonesFromString("0,5,alarm;5,100,normal");
+    watches[UNORDERED_KEY(PATH)].transform
+        = [](double v) { return 3.28084 * v; };
+    engine.SetWatches(watches);
+    auto now = AlarmEngine::clock::now();
+
+    engine.Update(PATH, 2.0, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::normal);
+    engine.Update(PATH, 1.0, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::alarm);
+
+    // The metadata zones are in the SignalK units already
+    watches[UNORDERED_KEY(PATH)].zones.clear();
+    engine.SetWatches(watches);
+    engine.Update(PATH, 2.0, now);
+    REQUIRE(engine.GetState(PATH) == Zone::state::emergency);
+}
+
+TEST_CASE("Alarms evaluate the value shown by the instrument")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:234567890");
+    dsk.GetAlarmEngine().SetDebounce(AlarmEngine::clock::duration::zero());
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleNumberInstrument(db);
+    // Depth from the sounder shown in feet
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY), PATH + ".SRC:sounder");
+    instr->SetSetting(wxString(DSK_SETTING_TRANSFORMATION),
+        static_cast<int>(Instrument::transformation::m2ft));
+    instr->SetSetting(
+        wxString(DSK_SETTING_ZONES), wxString("0,10,alarm;10,1000,normal"));
+    db->AddInstrument(instr);
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:234567890";
+    Json::Value& update = delta["updates"][0];
+    update["$source"] = "sounder";
+    update["values"][0]["path"] = "environment.depth.belowKeel";
+    update["values"][0]["value"] = 5.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE(dsk.GetAlarmEngine().GetState(PATH) == Zone::state::normal);
+
+    // The other sources of the path are not shown by the instrument
+    update["$source"] = "chartplotter";
+    update["values"][0]["value"] = 1.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE(dsk.GetAlarmEngine().GetState(PATH) == Zone::state::normal);
+
+    // 2 m is below the 10 ft of the configured alarm zone
+    update["$source"] = "sounder";
+    update["values"][0]["value"] = 2.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE(dsk.GetAlarmEngine().GetState(PATH) == Zone::state::alarm);
+}
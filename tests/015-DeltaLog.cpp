@@ -0,0 +1,99 @@
+/******************************************************************************
+ * DashboardSK delta log tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "deltalog.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+
+static const wxString LOG_FILE("015-DeltaLog.dsklog");
+
+/// Message setting the speed over ground of a vessel
+static wxString SogDelta(int i)
+{
+    return wxString("{\"context\":\"vessels.urn:mrn:imo:mmsi:234567890\","
+                    "\"updates\":[{\"values\":[{\"path\":"
+                    "\"navigation.speedOverGround\",\"value\":")
+        + wxString(std::to_string(i)) + "}]}]}";
+}
+
+/// Record the same messages with timestamps 100 ms apart
+static void RecordLog(bool compress, int count)
+{
+    DeltaRecorder rec;
+    REQUIRE(rec.Open(LOG_FILE, compress));
+    for (int i = 0; i < count; i++) {
+        rec.Record(SogDelta(i), 1700000000000 + i * 100);
+    }
+    REQUIRE(rec.GetCount() == static_cast<size_t>(count));
+    rec.Close();
+    REQUIRE_FALSE(rec.IsRecording());
+}
+
+TEST_CASE("Delta log round trip")
+{
+    for (bool compress : { false, true }) {
+        RecordLog(compress, 50);
+        DeltaReplayer rep;
+        REQUIRE(rep.Open(LOG_FILE));
+        delta_record r;
+        for (int i = 0; i < 50; i++) {
+            REQUIRE(rep.Next(r));
+            REQUIRE(r.timestamp == 1700000000000 + i * 100);
+            REQUIRE(r.message == SogDelta(i));
+        }
+        REQUIRE_FALSE(rep.Next(r));
+        REQUIRE_FALSE(rep.IsOpen());
+    }
+}
+
+TEST_CASE("Delta log rejects foreign files")
+{
+    wxFileOutputStream f(LOG_FILE);
+    f.Write("{\"json\":true}", 13);
+    f.Close();
+    DeltaReplayer rep;
+    REQUIRE_FALSE(rep.Open(LOG_FILE));
+    REQUIRE_FALSE(rep.IsOpen());
+}
+
+TEST_CASE("Delta log playback keeps the recorded pace")
+{
+    RecordLog(true, 10);
+    DashboardSK d(wxEmptyString);
+    DeltaReplayer rep;
+    REQUIRE(rep.Open(LOG_FILE));
+    rep.SetSpeed(2.0);
+    auto start = DeltaReplayer::clock::now();
+    // First message is sent immediately, the next one is due after 50 ms
+    REQUIRE(rep.Pump(d, start) == 1);
+    REQUIRE(rep.Pump(d, start + std::chrono::milliseconds(49)) == 0);
+    REQUIRE(rep.Pump(d, start + std::chrono::milliseconds(200)) == 4);
+    REQUIRE((*d.GetSignalKTree())["vessels"]["urn:mrn:imo:mmsi:234567890"]
+                                 ["navigation"]["speedOverGround"]["value"]
+                                     .asInt()
+        == 4);
+    REQUIRE(rep.IsOpen());
+}
+
+TEST_CASE("Delta log playback as fast as possible")
+{
+    RecordLog(false, 10);
+    DashboardSK d(wxEmptyString);
+    DeltaReplayer rep;
+    REQUIRE(rep.Open(LOG_FILE));
+    rep.SetSpeed(0.0);
+    REQUIRE(rep.Replay(d) == 10);
+    REQUIRE_FALSE(rep.IsOpen());
+    REQUIRE((*d.GetSignalKTree())["vessels"]["urn:mrn:imo:mmsi:234567890"]
+                                 ["navigation"]["speedOverGround"]["value"]
+                                     .asInt()
+        == 9);
+}
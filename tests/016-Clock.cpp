@@ -0,0 +1,76 @@
+/******************************************************************************
+ * DashboardSK clock tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "clock.h"
+#include "dashboard.h"
+#include "dashboardsk.h"
+#include "deltalog.h"
+#include "simplenumberinstrument.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono_literals;
+
+/// 2024-01-01T00:00:00Z
+static const Clock::time_point EPOCH_2024(1704067200s);
+
+TEST_CASE("Manual clock only moves when told to")
+{
+    ManualClock clock(EPOCH_2024);
+    REQUIRE(clock.Now() == EPOCH_2024);
+    clock.Advance(90s);
+    REQUIRE(clock.Now() == EPOCH_2024 + 90s);
+    clock.Set(EPOCH_2024 - 1h);
+    REQUIRE(clock.Now() == EPOCH_2024 - 1h);
+}
+
+TEST_CASE("Instruments take the time from the dashboard clock")
+{
+    auto clock = std::make_shared<ManualClock>(EPOCH_2024);
+    DashboardSK dsk("");
+    dsk.SetClock(clock);
+    Dashboard* db = dsk.AddDashboard();
+    REQUIRE(db->Now() == EPOCH_2024);
+
+    SimpleNumberInstrument instr(db);
+    clock->Advance(3 * 24h);
+    instr.SetLockedSource("test");
+    REQUIRE(instr.GetLockedSourceTime() == EPOCH_2024 + 3 * 24h);
+
+    dsk.SetClock(nullptr);
+    REQUIRE(db->Now() > EPOCH_2024 + 3 * 24h);
+}
+
+TEST_CASE("Replay drives the dashboard clock by the recorded time")
+{
+    const wxString log_file("016-Clock.dsklog");
+    const int64_t start_ms = EPOCH_2024.time_since_epoch() / 1ms;
+    {
+        DeltaRecorder rec;
+        REQUIRE(rec.Open(log_file));
+        // One message per hour over three days
+        for (int i = 0; i <= 72; i++) {
+            rec.Record("{\"context\":\"vessels.urn:mrn:imo:mmsi:234567890\","
+                       "\"updates\":[{\"values\":[{\"path\":"
+                       "\"environment.depth.belowKeel\",\"value\":10}]}]}",
+                start_ms + i * 3600000LL);
+        }
+    }
+    auto clock = std::make_shared<ManualClock>();
+    DashboardSK dsk("");
+    dsk.SetClock(clock);
+    DeltaReplayer rep;
+    REQUIRE(rep.Open(log_file));
+    rep.SetSpeed(0.0);
+    rep.SetClock(clock);
+    auto wall_start = std::chrono::steady_clock::now();
+    REQUIRE(rep.Replay(dsk) == 73);
+    REQUIRE(std::chrono::steady_clock::now() - wall_start < 60s);
+    REQUIRE(clock->Now() == EPOCH_2024 + 72h);
+}
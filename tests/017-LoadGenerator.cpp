@@ -0,0 +1,91 @@
+/******************************************************************************
+ * DashboardSK load generator tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "loadgenerator.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+
+static const Clock::time_point START(std::chrono::milliseconds(1700000000000));
+
+TEST_CASE("Load profile parsing")
+{
+    load_profile p = load_profile::Parse(
+        "vessels=10, paths=50,sources=2,rate=10,meta=60,seed=3,bogus=1");
+    REQUIRE(p.vessels == 10);
+    REQUIRE(p.paths == 50);
+    REQUIRE(p.sources == 2);
+    REQUIRE(p.rate == 10.0);
+    REQUIRE(p.meta_interval == 60.0);
+    REQUIRE(p.seed == 3);
+    p = load_profile::Parse("rate=0,vessels=x");
+    REQUIRE(p.vessels == 1);
+    REQUIRE(p.rate == 1.0);
+}
+
+TEST_CASE("Load generator deltas")
+{
+    load_profile p;
+    p.paths = 15;
+    p.sources = 2;
+    LoadGenerator gen(p);
+    Json::Value d = gen.MakeDelta(0, 0, START);
+    REQUIRE(d["context"].asString() == "vessels.urn:mrn:imo:mmsi:200000000");
+    REQUIRE(d["updates"][0]["timestamp"].asString()
+        == "2023-11-14T22:13:20.000Z");
+    REQUIRE(d["updates"][0]["source"]["type"].asString() == "NMEA0183");
+    REQUIRE(d["updates"][0]["values"].size() == 15);
+    REQUIRE(d["updates"][0]["values"][14]["path"].asString()
+        == "sensors.synthetic.p14");
+    d = gen.MakeDelta(0, 1, START + std::chrono::milliseconds(1500));
+    REQUIRE(d["updates"][0]["timestamp"].asString()
+        == "2023-11-14T22:13:21.500Z");
+    REQUIRE(d["updates"][0]["source"]["type"].asString() == "NMEA2000");
+    Json::Value m = gen.MakeMeta(0);
+    REQUIRE(m["updates"][0]["meta"].size() == 15);
+    REQUIRE(m["updates"][0]["meta"][0]["value"]["zones"].size() == 1);
+}
+
+TEST_CASE("Load generator pacing")
+{
+    load_profile p;
+    p.vessels = 2;
+    p.sources = 2;
+    p.rate = 10.0;
+    DashboardSK d(wxEmptyString);
+    LoadGenerator gen(p);
+    // Metadata of both vessels and a delta per vessel and source
+    REQUIRE(gen.Pump(d, START) == 6);
+    REQUIRE(gen.Pump(d, START + std::chrono::milliseconds(50)) == 0);
+    REQUIRE(gen.Pump(d, START + std::chrono::milliseconds(250)) == 8);
+    REQUIRE(gen.GetMessageCount() == 14);
+    REQUIRE(gen.GetValueCount() == 3 * 4 * p.paths);
+    REQUIRE(gen.GetDroppedTicks() == 0);
+    REQUIRE((*d.GetSignalKTree())["vessels"]["urn:mrn:imo:mmsi:200000001"]
+                                 ["navigation"]
+                                     .isMember("speedOverGround"));
+    // Falling far behind drops the ticks instead of catching up
+    gen.Pump(d, START + std::chrono::seconds(10));
+    REQUIRE(gen.GetDroppedTicks() > 0);
+    REQUIRE(gen.GetMessageCount() < 14 + 100 * 4);
+}
+
+TEST_CASE("Load generator drives a manual clock")
+{
+    load_profile p;
+    p.rate = 5.0;
+    DashboardSK d(wxEmptyString);
+    auto clock = std::make_shared<ManualClock>(START);
+    d.SetClock(clock);
+    LoadGenerator gen(p);
+    gen.SetClock(clock);
+    REQUIRE(gen.Run(d, START, std::chrono::seconds(2)) == 11);
+    REQUIRE(clock->Now() == START + std::chrono::milliseconds(1800));
+}
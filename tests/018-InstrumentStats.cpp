@@ -0,0 +1,96 @@
+/******************************************************************************
+ * DashboardSK instrument statistics tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "instrumentstats.h"
+#include "simplenumberinstrument.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+TEST_CASE("Instrument statistics count renders and skipped renders")
+{
+    InstrumentStats stats;
+    wxBitmap a(10, 20, 32);
+    wxBitmap b(10, 20, 32);
+    stats.AddRender(milliseconds(2), a);
+    // The cached bitmap returned again
+    stats.AddRender(microseconds(10), a);
+    stats.AddRender(milliseconds(4), b);
+    stats.AddRender(microseconds(10), wxNullBitmap);
+    REQUIRE(stats.GetRenderCount() == 4);
+    REQUIRE(stats.GetSkippedCount() == 2);
+    REQUIRE(stats.GetMeanRenderTime() == 3000.0);
+    REQUIRE(stats.GetP99RenderTime() == 4000.0);
+    REQUIRE(stats.GetBitmapBytes() == 10 * 20 * 4);
+    stats.Reset();
+    REQUIRE(stats.GetRenderCount() == 0);
+    REQUIRE(stats.GetMeanRenderTime() == 0.0);
+    REQUIRE(stats.GetP99RenderTime() == 0.0);
+}
+
+TEST_CASE("Instrument statistics percentile")
+{
+    InstrumentStats stats;
+    // More renders than kept samples, only the recent ones count
+    for (size_t i = 0; i < InstrumentStats::SAMPLES * 2; i++) {
+        wxBitmap bmp(1, 1, 32);
+        stats.AddRender(microseconds(i < InstrumentStats::SAMPLES ? 5000 : 100),
+            bmp);
+    }
+    REQUIRE(stats.GetP99RenderTime() == 100.0);
+    // The slowest 1 % of the samples
+    for (int i = 0; i < 3; i++) {
+        wxBitmap slow(1, 1, 32);
+        stats.AddRender(microseconds(900), slow);
+        REQUIRE(stats.GetP99RenderTime() == (i < 2 ? 100.0 : 900.0));
+    }
+}
+
+TEST_CASE("Instrument statistics include the parallel rasterization")
+{
+    InstrumentStats stats;
+    wxBitmap bmp(1, 1, 32);
+    stats.AddRasterTime(microseconds(700));
+    stats.AddRender(microseconds(300), bmp);
+    REQUIRE(stats.GetMeanRenderTime() == 1000.0);
+}
+
+TEST_CASE("Instrument statistics notification rate")
+{
+    InstrumentStats stats;
+    const system_clock::time_point start(seconds(1700000000));
+    for (int i = 0; i <= 20; i++) {
+        stats.AddNotification(start + milliseconds(i * 100));
+    }
+    REQUIRE(stats.GetNotificationCount() == 21);
+    REQUIRE(stats.GetNotificationRate() == 10.0);
+}
+
+TEST_CASE("Instrument statistics are fed by the SignalK data")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleNumberInstrument(db);
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY),
+        wxString("vessels.urn:mrn:imo:mmsi:265599691.navigation."
+                 "speedOverGround"));
+    db->AddInstrument(instr);
+    Json::Value update;
+    update["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    update["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    update["updates"][0]["values"][0]["value"] = 1.5;
+    dsk.SendSKDelta(update);
+    dsk.SendSKDelta(update);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 2);
+    dsk.ResetStats();
+    REQUIRE(instr->GetStats().GetNotificationCount() == 0);
+}
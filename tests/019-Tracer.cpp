@@ -0,0 +1,100 @@
+/******************************************************************************
+ * DashboardSK tracer tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "tracer.h"
+
+#include <thread>
+
+using namespace DashboardSKPlugin;
+
+static const std::string TRACE_FILE("019-Tracer.json");
+
+/// Read the trace file written by the tracer
+static Json::Value ReadTrace()
+{
+    Json::Value trace;
+    REQUIRE(ParseJSONFile(TRACE_FILE, trace));
+    REQUIRE(trace.isArray());
+    return trace;
+}
+
+TEST_CASE("Tracer does nothing unless started")
+{
+    REQUIRE_FALSE(Tracer::IsEnabled());
+    TraceSpan span("Idle");
+    REQUIRE_FALSE(span.IsActive());
+    REQUIRE(Tracer::Flush() == 0);
+}
+
+TEST_CASE("Tracer writes complete events")
+{
+    REQUIRE(Tracer::Start(TRACE_FILE));
+    REQUIRE(Tracer::IsEnabled());
+    {
+        TraceSpan span("Render", 1);
+        REQUIRE(span.IsActive());
+        span.SetDetail("Speed \"SOG\"");
+    }
+    { TraceSpan span("SendSKDelta"); }
+    std::thread worker([]() { TraceSpan span("Rasterize", 0); });
+    worker.join();
+    REQUIRE(Tracer::Flush() == 3);
+    { TraceSpan span("Dashboard::Draw", 1); }
+    Tracer::Stop();
+    REQUIRE_FALSE(Tracer::IsEnabled());
+
+    Json::Value trace = ReadTrace();
+    REQUIRE(trace.size() == 4);
+    REQUIRE(trace[0]["name"].asString() == "Render");
+    REQUIRE(trace[0]["ph"].asString() == "X");
+    REQUIRE(trace[0]["dur"].asInt64() >= 0);
+    REQUIRE(trace[0]["args"]["canvas"].asInt() == 1);
+    REQUIRE(trace[0]["args"]["detail"].asString() == "Speed \"SOG\"");
+    REQUIRE(trace[1]["name"].asString() == "SendSKDelta");
+    REQUIRE_FALSE(trace[1]["args"].isMember("canvas"));
+    REQUIRE(trace[2]["name"].asString() == "Rasterize");
+    REQUIRE(trace[2]["tid"].asInt() != trace[0]["tid"].asInt());
+    REQUIRE(trace[3]["name"].asString() == "Dashboard::Draw");
+}
+
+TEST_CASE("Tracer cuts long details at a character boundary")
+{
+    REQUIRE(Tracer::Start(TRACE_FILE));
+    wxString detail;
+    for (int i = 0; i < 30; i++) {
+        detail += wxString::FromUTF8("\xc3\xa9");
+    }
+    {
+        TraceSpan span("Render");
+        span.SetDetail(detail);
+    }
+    Tracer::Stop();
+
+    // 23 two byte characters fit in the detail with its terminator
+    std::string expected;
+    for (int i = 0; i < 23; i++) {
+        expected += "\xc3\xa9";
+    }
+    Json::Value trace = ReadTrace();
+    REQUIRE(trace.size() == 1);
+    REQUIRE(trace[0]["args"]["detail"].asString() == expected);
+}
+
+TEST_CASE("Tracer drops spans when the buffer is full")
+{
+    REQUIRE(Tracer::Start(TRACE_FILE));
+    REQUIRE(Tracer::GetDroppedCount() == 0);
+    for (size_t i = 0; i < Tracer::BUFFER_SIZE + 10; i++) {
+        TraceSpan span("Instrument::ProcessData");
+    }
+    REQUIRE(Tracer::GetDroppedCount() == 10);
+    REQUIRE(Tracer::Flush() == Tracer::BUFFER_SIZE);
+    { TraceSpan span("Instrument::ProcessData"); }
+    Tracer::Stop();
+    REQUIRE(ReadTrace().size() == Tracer::BUFFER_SIZE + 1);
+}
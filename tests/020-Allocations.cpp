@@ -0,0 +1,204 @@
+/******************************************************************************
+ * DashboardSK heap allocation budget tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "alloccounter.h"
+#include "dashboardsk.h"
+#include "dskdc.h"
+#include "instrumentstats.h"
+#include "simplenumberinstrument.h"
+#include "tracer.h"
+
+#include <wx/dcmemory.h>
+#include <wx/filename.h>
+
+#include <chrono>
+#include <memory>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+// Budgets of the ingest paths. The counts must not grow between two identical
+// calls, and must stay within these ceilings, which are only ever lowered as
+// the paths get cheaper. The JSON tree and the wxString conversions of the
+// paths still allocate there, the frames must not allocate at all.
+
+/// Allocations of SendSKDelta updating one value of a known path
+constexpr size_t DELTA_ALLOCATION_BUDGET = 150;
+/// Allocations of looking up a known path with the "any" source designation
+constexpr size_t LOOKUP_ALLOCATION_BUDGET = 40;
+
+static const wxString SELF("urn:mrn:imo:mmsi:265599691");
+static const wxString SOG_KEY(
+    "vessels.urn:mrn:imo:mmsi:265599691.navigation.speedOverGround");
+
+/// Run a function a few times and get the number of allocations of each run
+///
+/// \param f The function
+/// \return Allocations of the runs after the first two, which may populate
+/// the caches
+template <typename F> static vector<size_t> SteadyStateAllocations(F f)
+{
+    f();
+    f();
+    vector<size_t> counts(3);
+    for (auto& count : counts) {
+        AllocationCounter counter;
+        f();
+        count = counter.GetCount();
+    }
+    return counts;
+}
+
+/// Delta updating the speed over ground of our vessel from a NMEA0183 source
+static Json::Value SogDelta()
+{
+    Json::Value delta;
+    delta["context"] = "vessels.self";
+    delta["updates"][0]["source"]["type"] = "NMEA0183";
+    delta["updates"][0]["source"]["label"] = "GPS";
+    delta["updates"][0]["source"]["talker"] = "GP";
+    delta["updates"][0]["source"]["sentence"] = "RMC";
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    delta["updates"][0]["values"][0]["value"] = 3.2;
+    return delta;
+}
+
+TEST_CASE("Allocation counter counts the allocations of the thread")
+{
+    vector<std::unique_ptr<int>> v;
+    size_t count;
+    {
+        AllocationCounter counter;
+        v.reserve(4);
+        v.emplace_back(std::make_unique<int>(42));
+        count = counter.GetCount();
+    }
+    REQUIRE(count == 2);
+    REQUIRE(*v[0] == 42);
+    REQUIRE(AllocationCounter::GetTotal() >= count);
+}
+
+TEST_CASE("Recording instrument statistics does not allocate")
+{
+    InstrumentStats stats;
+    wxBitmap bmp(10, 10, 32);
+    const system_clock::time_point start(seconds(1700000000));
+    AllocationCounter counter;
+    for (int i = 0; i < 1000; i++) {
+        stats.AddRender(microseconds(i), bmp);
+        stats.AddRasterTime(microseconds(i));
+        stats.AddNotification(start + milliseconds(i * 10));
+    }
+    const size_t count = counter.GetCount();
+    REQUIRE(count == 0);
+    REQUIRE(stats.GetRenderCount() == 1000);
+}
+
+TEST_CASE("Trace spans do not allocate")
+{
+    size_t count;
+    {
+        AllocationCounter counter;
+        TraceSpan span("Render", 0);
+        count = counter.GetCount();
+    }
+    REQUIRE(count == 0);
+    const wxString trace = wxFileName::CreateTempFileName("dsk");
+    REQUIRE(Tracer::Start(trace));
+    // The first span of the thread creates its buffer
+    { TraceSpan span("Render", 0); }
+    {
+        AllocationCounter counter;
+        for (int i = 0; i < 100; i++) {
+            TraceSpan span("Render", 0);
+        }
+        count = counter.GetCount();
+    }
+    Tracer::Stop();
+    wxRemoveFile(trace);
+    REQUIRE(count == 0);
+}
+
+TEST_CASE("Steady state delta ingest stays within the allocation budget")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf(SELF);
+    dsk.SetClock(std::make_shared<ManualClock>(
+        Clock::time_point(seconds(1700000000))));
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleNumberInstrument(db);
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY), SOG_KEY);
+    db->AddInstrument(instr);
+    Json::Value delta = SogDelta();
+
+    const vector<size_t> counts
+        = SteadyStateAllocations([&]() { dsk.SendSKDelta(delta); });
+    REQUIRE(counts[0] == counts[1]);
+    REQUIRE(counts[1] == counts[2]);
+    REQUIRE(counts[0] <= DELTA_ALLOCATION_BUDGET);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 5);
+}
+
+TEST_CASE("Source lookup stays within the allocation budget")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf(SELF);
+    Json::Value delta = SogDelta();
+    dsk.SendSKDelta(delta);
+    const wxString path = SOG_KEY + "." + SRC_MAGIC_STRING + "any";
+
+    const Json::Value* value = nullptr;
+    const vector<size_t> counts
+        = SteadyStateAllocations([&]() { value = dsk.GetSKData(path); });
+    REQUIRE(value);
+    REQUIRE((*value)["value"].asDouble() == 3.2);
+    REQUIRE(counts[0] == counts[1]);
+    REQUIRE(counts[1] == counts[2]);
+    REQUIRE(counts[0] <= LOOKUP_ALLOCATION_BUDGET);
+}
+
+TEST_CASE("Unchanged frames do not allocate")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf(SELF);
+    dsk.SetClock(std::make_shared<ManualClock>(
+        Clock::time_point(seconds(1700000000))));
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleNumberInstrument(db);
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY), SOG_KEY);
+    db->AddInstrument(instr);
+    Json::Value delta = SogDelta();
+    dsk.SendSKDelta(delta);
+
+    // The instrument returns its cached bitmap
+    wxBitmap bmp;
+    const vector<size_t> renders
+        = SteadyStateAllocations([&]() { bmp = instr->Render(1.0); });
+    REQUIRE(bmp.IsOk());
+    REQUIRE(renders == vector<size_t>(3, 0));
+
+    wxBitmap target(800, 600, 32);
+    wxMemoryDC mdc(target);
+    dskDC dc(mdc);
+    PlugIn_ViewPort vp;
+    vp.pix_width = target.GetWidth();
+    vp.pix_height = target.GetHeight();
+    vp.rotation = 0.0;
+
+    // Whatever the DC allocates to blit the bitmap is the cost of the
+    // toolkit, the dashboard must not add anything on top of it
+    const vector<size_t> blits = SteadyStateAllocations(
+        [&]() { dc.DrawBitmap(bmp, 0, 0, bmp.HasAlpha()); });
+    const vector<size_t> frames = SteadyStateAllocations([&]() {
+        Dashboard::ClearOffsets();
+        db->Draw(&dc, &vp, 0);
+    });
+    REQUIRE(frames == blits);
+    REQUIRE(instr->GetStats().GetRenderCount() == 5);
+    mdc.SelectObject(wxNullBitmap);
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * DashboardSK memory report tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "memoryreport.h"
+#include "simplehistograminstrument.h"
+
+#include <wx/ffile.h>
+
+#include <algorithm>
+
+using namespace DashboardSKPlugin;
+
+typedef MemoryReport::section section;
+
+/// Delta setting the speed over ground of a vessel
+static Json::Value SogDelta(const std::string& mmsi, double sog)
+{
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:" + mmsi;
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    delta["updates"][0]["values"][0]["value"] = sog;
+    return delta;
+}
+
+TEST_CASE("Memory report estimates JSON values")
+{
+    size_t nodes = 0;
+    const size_t scalar = MemoryReport::EstimateJSON(Json::Value(1.5), nodes);
+    REQUIRE(nodes == 1);
+    REQUIRE(scalar == sizeof(Json::Value));
+
+    nodes = 0;
+    const size_t str = MemoryReport::EstimateJSON(
+        Json::Value(std::string(100, 'x')), nodes);
+    REQUIRE(nodes == 1);
+    REQUIRE(str > scalar + 100);
+
+    Json::Value obj;
+    obj["a"] = 1;
+    obj["b"]["c"] = std::string(100, 'x');
+    nodes = 0;
+    const size_t bytes = MemoryReport::EstimateJSON(obj, nodes);
+    REQUIRE(nodes == 4);
+    REQUIRE(bytes > str + 2 * scalar);
+}
+
+TEST_CASE("Memory report sums and sorts the entries")
+{
+    MemoryReport report;
+    report.Add(section::contexts, "vessels.a", 100, 1);
+    report.Add(section::contexts, "vessels.b", 300, 3);
+    report.Add(section::contexts, "vessels.a", 250, 2);
+    report.Add(section::paths, "vessels.*.navigation", 650, 6);
+    report.Add(section::bitmaps, "Dashboard / Speed", 4000, 1000);
+    const vector<memory_entry> contexts = report.GetEntries(section::contexts);
+    REQUIRE(contexts.size() == 2);
+    REQUIRE(contexts[0].name == "vessels.a");
+    REQUIRE(contexts[0].bytes == 350);
+    REQUIRE(contexts[0].items == 3);
+    REQUIRE(contexts[1].name == "vessels.b");
+    REQUIRE(report.GetBytes(section::contexts) == 650);
+    REQUIRE(report.GetBytes(section::histories) == 0);
+    // The paths are another view of the contexts and are not counted twice
+    REQUIRE(report.GetTotalBytes() == 4650);
+    const wxString text = report.ToString(1);
+    REQUIRE(text.Contains("vessels.a"));
+    REQUIRE_FALSE(text.Contains("vessels.b"));
+    REQUIRE(text.Contains("1 more"));
+}
+
+TEST_CASE("Memory report of the dashboards")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleHistogramInstrument(db);
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY),
+        wxString("vessels.urn:mrn:imo:mmsi:265599691.navigation."
+                 "speedOverGround"));
+    db->AddInstrument(instr);
+    for (int i = 0; i < 10; i++) {
+        Json::Value own = SogDelta("265599691", i);
+        dsk.SendSKDelta(own);
+        Json::Value ais = SogDelta("211234567", i);
+        dsk.SendSKDelta(ais);
+    }
+    instr->ProcessData();
+
+    const MemoryReport report = dsk.GetMemoryReport();
+    const vector<memory_entry> contexts = report.GetEntries(section::contexts);
+    REQUIRE(contexts.size() >= 2);
+    bool own = false;
+    bool ais = false;
+    for (const auto& e : contexts) {
+        own |= e.name == "vessels.urn:mrn:imo:mmsi:265599691";
+        ais |= e.name == "vessels.urn:mrn:imo:mmsi:211234567";
+        REQUIRE(e.bytes > 0);
+    }
+    REQUIRE(own);
+    REQUIRE(ais);
+    const vector<memory_entry> paths = report.GetEntries(section::paths);
+    REQUIRE_FALSE(paths.empty());
+    REQUIRE(std::any_of(paths.begin(), paths.end(), [](const memory_entry& e) {
+        return e.name == "vessels.*.navigation";
+    }));
+    const vector<memory_entry> histories
+        = report.GetEntries(section::histories);
+    REQUIRE(histories.size() == 1);
+    REQUIRE(histories[0].items == instr->GetHistory()->GetSampleCount());
+
+    REQUIRE(report.Save("021-MemoryReport.txt"));
+    wxFFile f("021-MemoryReport.txt");
+    wxString text;
+    REQUIRE(f.ReadAll(&text));
+    REQUIRE(text.Contains("SignalK data by context"));
+    REQUIRE(text.Contains("vessels.urn:mrn:imo:mmsi:211234567"));
+}
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * DashboardSK context eviction tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "contextevictor.h"
+#include "dashboardsk.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+typedef ContextEvictor::clock evictor_clock;
+
+static const std::string SELF("urn:mrn:imo:mmsi:265599691");
+static const evictor_clock::time_point T0(seconds(1700000000));
+
+/// Id of an AIS target
+static std::string Target(int i)
+{
+    return "urn:mrn:imo:mmsi:2" + std::to_string(10000000 + i);
+}
+
+/// Add a context with some data to the tree and record its update
+static void AddContext(Json::Value& tree, ContextEvictor& evictor,
+    const std::string& id, evictor_clock::time_point now)
+{
+    tree["vessels"][id]["navigation"]["speedOverGround"]["value"] = 5.0;
+    tree["vessels"][id]["name"]["value"] = std::string(200, 'x');
+    evictor.Touch("vessels", id, now);
+}
+
+TEST_CASE("Contexts without updates expire")
+{
+    Json::Value tree;
+    ContextEvictor evictor;
+    evictor.SetTTL(minutes(30));
+    AddContext(tree, evictor, SELF, T0);
+    AddContext(tree, evictor, Target(1), T0);
+    AddContext(tree, evictor, Target(2), T0 + minutes(20));
+    REQUIRE(evictor.GetContextCount() == 3);
+
+    REQUIRE(evictor.Tick(tree, SELF, T0 + minutes(10)) == 0);
+    REQUIRE(evictor.GetTotalBytes() > 0);
+    REQUIRE(evictor.Tick(tree, SELF, T0 + minutes(31)) == 1);
+    REQUIRE(tree["vessels"].isMember(SELF));
+    REQUIRE_FALSE(tree["vessels"].isMember(Target(1)));
+    REQUIRE(tree["vessels"].isMember(Target(2)));
+    // Updated again, so not expired
+    evictor.Touch("vessels", Target(2), T0 + minutes(40));
+    REQUIRE(evictor.Tick(tree, SELF, T0 + minutes(60)) == 0);
+    // The own vessel never expires
+    REQUIRE(evictor.Tick(tree, SELF, T0 + minutes(600)) == 1);
+    REQUIRE(tree["vessels"].isMember(SELF));
+    REQUIRE(evictor.GetEvictedCount() == 2);
+}
+
+TEST_CASE("Context eviction runs at most once a second")
+{
+    Json::Value tree;
+    ContextEvictor evictor;
+    AddContext(tree, evictor, Target(1), T0);
+    REQUIRE(evictor.Tick(tree, SELF, T0) == 0);
+    AddContext(tree, evictor, Target(2), T0);
+    REQUIRE(evictor.Tick(tree, SELF, T0 + hours(1)) == 2);
+    AddContext(tree, evictor, Target(3), T0);
+    REQUIRE(evictor.Tick(tree, SELF, T0 + hours(1) + milliseconds(500)) == 0);
+    REQUIRE(evictor.Tick(tree, SELF, T0 + hours(1) + seconds(1)) == 1);
+}
+
+TEST_CASE("Context eviction is spread over the ticks")
+{
+    Json::Value tree;
+    ContextEvictor evictor;
+    const int count = static_cast<int>(ContextEvictor::BATCH) * 3;
+    for (int i = 0; i < count; i++) {
+        AddContext(tree, evictor, Target(i), T0);
+    }
+    evictor_clock::time_point now = T0 + hours(1);
+    size_t ticks = 0;
+    while (evictor.GetContextCount() > 0) {
+        REQUIRE(evictor.Tick(tree, SELF, now) <= ContextEvictor::BATCH);
+        now += seconds(1);
+        ticks++;
+    }
+    REQUIRE(ticks == 3);
+    REQUIRE(tree["vessels"].empty());
+}
+
+TEST_CASE("Least recently updated contexts are evicted over the memory limit")
+{
+    Json::Value tree;
+    ContextEvictor evictor;
+    evictor.SetTTL(evictor_clock::duration::zero());
+    evictor.SetMaxBytes(0);
+    AddContext(tree, evictor, SELF, T0);
+    for (int i = 0; i < 10; i++) {
+        AddContext(tree, evictor, Target(i), T0 + seconds(i));
+    }
+    REQUIRE(evictor.Tick(tree, SELF, T0 + hours(1)) == 0);
+    const size_t per_context = evictor.GetTotalBytes() / 10;
+    // Room for four targets, the own vessel does not count
+    evictor.SetMaxBytes(per_context * 4 + per_context / 2);
+    REQUIRE(evictor.Tick(tree, SELF, T0 + hours(2)) == 6);
+    REQUIRE(tree["vessels"].isMember(SELF));
+    for (int i = 0; i < 10; i++) {
+        REQUIRE(tree["vessels"].isMember(Target(i)) == (i >= 6));
+    }
+    REQUIRE(evictor.GetTotalBytes() <= evictor.GetMaxBytes());
+}
+
+TEST_CASE("Dashboards evict the stale AIS targets")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf(SELF);
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Json::Value delta;
+    delta["context"] = "vessels." + Target(1);
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    delta["updates"][0]["values"][0]["value"] = 4.2;
+    dsk.SendSKDelta(delta);
+    delta["context"] = "vessels.self";
+    dsk.SendSKDelta(delta);
+    REQUIRE(dsk.GetContextEvictor().GetContextCount() == 1);
+    REQUIRE((*dsk.GetSignalKTree())["vessels"].isMember(Target(1)));
+
+    clk->Advance(minutes(ContextEvictor::DEFAULT_TTL_MIN + 1));
+    dsk.ProcessData();
+    REQUIRE_FALSE((*dsk.GetSignalKTree())["vessels"].isMember(Target(1)));
+    REQUIRE((*dsk.GetSignalKTree())["vessels"].isMember(SELF));
+    REQUIRE(dsk.GetContextEvictor().GetEvictedCount() == 1);
+}
+
+TEST_CASE("Paths without updates expire from the live contexts")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf(SELF);
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Json::Value name;
+    name["context"] = "vessels." + Target(1);
+    name["updates"][0]["values"][0]["path"] = "name";
+    name["updates"][0]["values"][0]["value"] = "TARGET";
+    dsk.SendSKDelta(name);
+    name["context"] = "vessels.self";
+    dsk.SendSKDelta(name);
+    Json::Value sog;
+    sog["context"] = "vessels." + Target(1);
+    sog["updates"][0]["$source"] = "ais.AB";
+    sog["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    sog["updates"][0]["values"][0]["value"] = 4.2;
+    dsk.SendSKDelta(sog);
+    sog["updates"][0]["$source"] = "ais.AI";
+    dsk.SendSKDelta(sog);
+
+    // Only one of the sources keeps the target alive
+    clk->Advance(minutes(ContextEvictor::DEFAULT_TTL_MIN - 10));
+    dsk.SendSKDelta(sog);
+    clk->Advance(minutes(15));
+    dsk.ProcessData();
+    const Json::Value& vessels = (*dsk.GetSignalKTree())["vessels"];
+    REQUIRE(vessels.isMember(Target(1)));
+    const Json::Value& target = vessels[Target(1)];
+    REQUIRE_FALSE(target.isMember("name"));
+    REQUIRE(target["navigation"]["speedOverGround"].isMember("SRC:ais-AI"));
+    REQUIRE_FALSE(
+        target["navigation"]["speedOverGround"].isMember("SRC:ais-AB"));
+    REQUIRE(dsk.GetSources().GetPathCount() == 2);
+    // The paths of the own vessel are kept
+    REQUIRE(vessels[SELF].isMember("name"));
+}
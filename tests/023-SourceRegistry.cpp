@@ -0,0 +1,203 @@
+/******************************************************************************
+ * DashboardSK source registry tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "sourceregistry.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+static const Clock::time_point T0(seconds(1700000000));
+static const wxString SOG_PATH(
+    "vessels.urn:mrn:imo:mmsi:211234567.navigation.speedOverGround");
+
+/// Node holding a value, like the ones stored by DashboardSK::SendSKDelta
+static Json::Value ValueNode(double value)
+{
+    Json::Value node;
+    node["value"] = value;
+    return node;
+}
+
+TEST_CASE("Sources are kept in the order they were first seen")
+{
+    SourceRegistry registry;
+    Json::Value gps = ValueNode(5.1);
+    Json::Value log = ValueNode(5.3);
+    registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &gps, T0, T0);
+    registry.Update(UNORDERED_KEY(SOG_PATH), "LOG", &log, T0, T0);
+    registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &gps, T0 + seconds(1),
+        T0 + seconds(1));
+
+    const SourceRegistry::sources_t* sources
+        = registry.GetSources(UNORDERED_KEY(SOG_PATH));
+    REQUIRE(sources);
+    REQUIRE(sources->size() == 2);
+    REQUIRE((*sources)[0].id.IsSameAs("GPS"));
+    REQUIRE((*sources)[0].last_update == T0 + seconds(1));
+    REQUIRE((*sources)[1].id.IsSameAs("LOG"));
+    REQUIRE(registry.GetPathCount() == 1);
+    REQUIRE_FALSE(registry.GetSources(UNORDERED_KEY(wxString("nothing"))));
+}
+
+TEST_CASE("Sources measure their update interval and lag")
+{
+    SourceRegistry registry;
+    Json::Value node = ValueNode(1.0);
+    for (int i = 0; i < 100; i++) {
+        const Clock::time_point now = T0 + milliseconds(100 * i);
+        registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &node, now,
+            now - milliseconds(30));
+    }
+    const sk_source& gps = registry.GetSources(UNORDERED_KEY(SOG_PATH))->at(0);
+    REQUIRE(gps.updates == 100);
+    REQUIRE(gps.interval == milliseconds(100));
+    REQUIRE(gps.lag == milliseconds(30));
+}
+
+TEST_CASE("The direct value is the preferred source")
+{
+    SourceRegistry registry;
+    Json::Value empty(Json::objectValue);
+    Json::Value log = ValueNode(5.3);
+    Json::Value direct(Json::objectValue);
+    registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &empty, T0, T0);
+    REQUIRE_FALSE(registry.GetFirstAvailable(UNORDERED_KEY(SOG_PATH)));
+
+    registry.Update(UNORDERED_KEY(SOG_PATH), "LOG", &log, T0, T0);
+    registry.Update(UNORDERED_KEY(SOG_PATH), wxEmptyString, &direct, T0, T0);
+    REQUIRE(registry.GetFirstAvailable(UNORDERED_KEY(SOG_PATH))->id.IsSameAs(
+        "LOG"));
+
+    direct["value"] = 5.2;
+    const sk_source* src = registry.GetFirstAvailable(UNORDERED_KEY(SOG_PATH));
+    REQUIRE(src->id.IsEmpty());
+    REQUIRE(src->node == &direct);
+}
+
+TEST_CASE("Removing a context forgets only its paths")
+{
+    SourceRegistry registry;
+    Json::Value node = ValueNode(1.0);
+    registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &node, T0, T0);
+    registry.Update(UNORDERED_KEY(wxString(
+                        "vessels.urn:mrn:imo:mmsi:2112345678.navigation.log")),
+        "LOG", &node, T0, T0);
+    registry.RemoveContext("vessels.urn:mrn:imo:mmsi:211234567");
+    REQUIRE(registry.GetPathCount() == 1);
+    REQUIRE_FALSE(registry.GetSources(UNORDERED_KEY(SOG_PATH)));
+    registry.Clear();
+    REQUIRE(registry.GetPathCount() == 0);
+}
+
+TEST_CASE("Sources without updates expire except the kept ones")
+{
+    SourceRegistry registry;
+    Json::Value node = ValueNode(1.0);
+    const wxString self("vessels.urn:mrn:imo:mmsi:265599691.");
+    const wxString self_sog(self + "navigation.speedOverGround");
+    registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &node, T0, T0);
+    registry.Update(
+        UNORDERED_KEY(SOG_PATH), "LOG", &node, T0 + minutes(10), T0);
+    registry.Update(UNORDERED_KEY(self_sog), "GPS", &node, T0, T0);
+
+    vector<SourceRegistry::source_key_t> expired;
+    registry.Expire(T0 + minutes(5), UNORDERED_KEY(self), expired);
+    REQUIRE(expired.size() == 1);
+    REQUIRE(expired[0].first == UNORDERED_KEY(SOG_PATH));
+    REQUIRE(expired[0].second.IsSameAs("GPS"));
+    REQUIRE(registry.GetSources(UNORDERED_KEY(SOG_PATH))->size() == 1);
+
+    registry.Expire(T0 + minutes(15), UNORDERED_KEY(self), expired);
+    REQUIRE(expired.size() == 2);
+    REQUIRE_FALSE(registry.GetSources(UNORDERED_KEY(SOG_PATH)));
+    REQUIRE(registry.GetSources(UNORDERED_KEY(self_sog)));
+    REQUIRE(registry.GetPathCount() == 1);
+}
+
+TEST_CASE("Removing a subtree keeps only the direct value of its root")
+{
+    SourceRegistry registry;
+    Json::Value node = ValueNode(1.0);
+    const wxString attitude(
+        "vessels.urn:mrn:imo:mmsi:211234567.navigation.attitude");
+    const wxString roll(attitude + ".roll");
+    registry.Update(UNORDERED_KEY(attitude), wxEmptyString, &node, T0, T0);
+    registry.Update(UNORDERED_KEY(attitude), "IMU", &node, T0, T0);
+    registry.Update(UNORDERED_KEY(roll), "IMU", &node, T0, T0);
+    registry.Update(UNORDERED_KEY(SOG_PATH), "GPS", &node, T0, T0);
+    registry.RemoveSubtree(attitude);
+    REQUIRE(registry.GetPathCount() == 2);
+    const SourceRegistry::sources_t* sources
+        = registry.GetSources(UNORDERED_KEY(attitude));
+    REQUIRE(sources);
+    REQUIRE(sources->size() == 1);
+    REQUIRE(sources->at(0).id.IsEmpty());
+    REQUIRE_FALSE(registry.GetSources(UNORDERED_KEY(roll)));
+    REQUIRE(registry.GetSources(UNORDERED_KEY(SOG_PATH)));
+}
+
+TEST_CASE("Complex values replacing a branch do not leave dangling nodes")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:211234567");
+    const wxString roll(
+        "vessels.urn:mrn:imo:mmsi:211234567.navigation.attitude.roll");
+    Json::Value imu;
+    imu["context"] = "vessels.self";
+    imu["updates"][0]["$source"] = "IMU";
+    imu["updates"][0]["values"][0]["path"] = "navigation.attitude.roll";
+    imu["updates"][0]["values"][0]["value"] = 0.1;
+    dsk.SendSKDelta(imu);
+    REQUIRE((*dsk.GetSKData(roll + ".SRC:any"))["value"].asDouble() == 0.1);
+
+    // The whole attitude without a source replaces the node of the roll
+    // together with its sources
+    Json::Value attitude;
+    attitude["context"] = "vessels.self";
+    attitude["updates"][0]["values"][0]["path"] = "navigation.attitude";
+    attitude["updates"][0]["values"][0]["value"]["roll"] = 0.3;
+    attitude["updates"][0]["values"][0]["value"]["pitch"] = 0.0;
+    dsk.SendSKDelta(attitude);
+    REQUIRE_FALSE(dsk.GetSKData(roll + ".SRC:IMU"));
+    REQUIRE_FALSE(dsk.GetSKData(roll + ".SRC:any"));
+    REQUIRE((*dsk.GetSKData(roll))["value"].asDouble() == 0.3);
+
+    imu["updates"][0]["values"][0]["value"] = 0.2;
+    dsk.SendSKDelta(imu);
+    REQUIRE((*dsk.GetSKData(roll + ".SRC:any"))["value"].asDouble() == 0.2);
+    REQUIRE((*dsk.GetSKData(roll + ".SRC:IMU"))["value"].asDouble() == 0.2);
+}
+
+TEST_CASE("Dashboards resolve the magic sources from the registry")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:211234567";
+    delta["updates"][0]["$source"] = "GPS.GP";
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    delta["updates"][0]["values"][0]["value"] = 4.2;
+    dsk.SendSKDelta(delta);
+
+    const Json::Value* any = dsk.GetSKData(SOG_PATH + ".SRC:any");
+    REQUIRE(any);
+    REQUIRE((*any)["value"].asDouble() == 4.2);
+    REQUIRE(any == dsk.GetSKData(SOG_PATH + ".SRC:GPS.GP"));
+    REQUIRE(dsk.GetSources().GetPathCount() == 1);
+
+    // The evicted context must not leave dangling nodes in the registry
+    clk->Advance(minutes(ContextEvictor::DEFAULT_TTL_MIN + 1));
+    dsk.ProcessData();
+    REQUIRE(dsk.GetSources().GetPathCount() == 0);
+    REQUIRE_FALSE(dsk.GetSKData(SOG_PATH + ".SRC:lockfirst"));
+}
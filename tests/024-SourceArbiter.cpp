@@ -0,0 +1,284 @@
+/******************************************************************************
+ * DashboardSK source arbitration tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "simplenumberinstrument.h"
+#include "sourcearbiter.h"
+#include "sourceregistry.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+static const Clock::time_point T0(seconds(1700000000));
+static const wxString HDG_PATH(
+    "vessels.urn:mrn:imo:mmsi:265599691.navigation.headingTrue");
+static const wxString PERSIST_PATH(HDG_PATH + ".SRC:lockpersist");
+static const wxString FIRST_PATH(HDG_PATH + ".SRC:lockfirst");
+
+/// Source registry with heading values from several sources
+struct Sources {
+    SourceRegistry registry;
+    std::map<wxString, Json::Value> nodes;
+
+    /// Record an update of the heading from a source
+    void Update(const wxString& source, Clock::time_point now,
+        milliseconds lag = milliseconds(0))
+    {
+        nodes[source]["value"] = 1.0;
+        registry.Update(
+            UNORDERED_KEY(HDG_PATH), source, &nodes[source], now, now - lag);
+    }
+};
+
+TEST_CASE("Arbitrated paths lock to the first available source")
+{
+    Sources s;
+    SourceArbiter arbiter(s.registry);
+    SourceArbiter::policy mode;
+    REQUIRE(SourceArbiter::ParsePolicy("lockpersist", mode));
+    REQUIRE(mode == SourceArbiter::policy::persist);
+    REQUIRE_FALSE(SourceArbiter::ParsePolicy("any", mode));
+
+    vector<source_event> events;
+    const auto listener = [&events](const source_event& e) {
+        events.push_back(e);
+    };
+    int owner;
+    REQUIRE_FALSE(arbiter.Subscribe(HDG_PATH + ".SRC:any", &owner, 3,
+        listener, T0));
+    REQUIRE(arbiter.Subscribe(FIRST_PATH, &owner, 3, listener, T0));
+    REQUIRE(events.empty());
+    REQUIRE_FALSE(arbiter.Resolve(FIRST_PATH));
+
+    s.Update("GPS", T0);
+    arbiter.Update(UNORDERED_KEY(HDG_PATH), T0);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].kind == source_event::type::locked);
+    REQUIRE(events[0].to.IsSameAs("GPS"));
+    REQUIRE(arbiter.Resolve(FIRST_PATH)->id.IsSameAs("GPS"));
+
+    // lockfirst never fails over
+    s.Update("COMPASS", T0 + seconds(60));
+    arbiter.Update(UNORDERED_KEY(HDG_PATH), T0 + seconds(60));
+    REQUIRE(events.size() == 1);
+    REQUIRE(arbiter.Resolve(FIRST_PATH)->id.IsSameAs("GPS"));
+
+    // A late subscriber is told the source the others use
+    int late;
+    vector<source_event> late_events;
+    arbiter.Subscribe(FIRST_PATH, &late, 3,
+        [&late_events](const source_event& e) { late_events.push_back(e); },
+        T0 + seconds(61));
+    REQUIRE(late_events.size() == 1);
+    REQUIRE(late_events[0].to.IsSameAs("GPS"));
+
+    arbiter.Unsubscribe(&owner);
+    REQUIRE(arbiter.IsArbitrated(FIRST_PATH));
+    arbiter.Unsubscribe(&late);
+    REQUIRE_FALSE(arbiter.IsArbitrated(FIRST_PATH));
+    REQUIRE(arbiter.GetPathCount() == 0);
+}
+
+TEST_CASE("Persistent locks fail over after the grace period")
+{
+    Sources s;
+    SourceArbiter arbiter(s.registry);
+    vector<source_event> events;
+    const auto listener = [&events](const source_event& e) {
+        events.push_back(e);
+    };
+    int patient;
+    int impatient;
+    arbiter.Subscribe(PERSIST_PATH, &patient, 30, listener, T0);
+    arbiter.Subscribe(PERSIST_PATH, &impatient, 5, listener, T0);
+
+    for (int i = 0; i <= 5; i++) {
+        const Clock::time_point now = T0 + seconds(i);
+        if (i == 0) {
+            s.Update("GPS", now);
+        }
+        s.Update("COMPASS", now);
+        arbiter.Update(UNORDERED_KEY(HDG_PATH), now);
+    }
+    // The GPS has been silent for 5 seconds, which is not over the shortest
+    // grace period yet
+    REQUIRE(arbiter.Resolve(PERSIST_PATH)->id.IsSameAs("GPS"));
+    REQUIRE(events.size() == 2);
+
+    s.Update("COMPASS", T0 + seconds(6));
+    arbiter.Update(UNORDERED_KEY(HDG_PATH), T0 + seconds(6));
+    REQUIRE(arbiter.Resolve(PERSIST_PATH)->id.IsSameAs("COMPASS"));
+    REQUIRE(events.size() == 4);
+    REQUIRE(events[3].kind == source_event::type::failover);
+    REQUIRE(events[3].from.IsSameAs("GPS"));
+    REQUIRE(events[3].to.IsSameAs("COMPASS"));
+
+    // The GPS coming back does not take the lock over again
+    s.Update("GPS", T0 + seconds(7));
+    arbiter.Update(UNORDERED_KEY(HDG_PATH), T0 + seconds(7));
+    REQUIRE(arbiter.Resolve(PERSIST_PATH)->id.IsSameAs("COMPASS"));
+}
+
+TEST_CASE("The persisted source is preferred until it goes stale")
+{
+    Sources s;
+    SourceArbiter arbiter(s.registry);
+    s.Update("GPS", T0);
+    const wxString preferred("COMPASS");
+    int owner;
+    arbiter.Subscribe(PERSIST_PATH, &owner, 3, [](const source_event&) {},
+        T0, &preferred);
+    REQUIRE_FALSE(arbiter.Resolve(PERSIST_PATH));
+
+    s.Update("GPS", T0 + seconds(4));
+    arbiter.Update(UNORDERED_KEY(HDG_PATH), T0 + seconds(4));
+    REQUIRE(arbiter.Resolve(PERSIST_PATH)->id.IsSameAs("GPS"));
+}
+
+TEST_CASE("Priority lists prefer the first alive source")
+{
+    Sources s;
+    SourceArbiter arbiter(s.registry);
+    const wxString path(HDG_PATH + ".SRC:priority(can0-115, GPS)");
+    SourceArbiter::policy mode;
+    vector<wxString> priorities;
+    REQUIRE(SourceArbiter::ParsePolicy(
+        "priority(can0-115, GPS)", mode, &priorities));
+    REQUIRE(mode == SourceArbiter::policy::priority);
+    REQUIRE(priorities.size() == 2);
+    REQUIRE(priorities[1].IsSameAs("GPS"));
+
+    vector<source_event> events;
+    int owner;
+    arbiter.Subscribe(path, &owner, 3,
+        [&events](const source_event& e) { events.push_back(e); }, T0);
+    const auto update = [&s, &arbiter](const wxString& source, int sec) {
+        s.Update(source, T0 + seconds(sec));
+        arbiter.Update(UNORDERED_KEY(HDG_PATH), T0 + seconds(sec));
+    };
+    update("OTHER", 0);
+    update("GPS", 0);
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("GPS"));
+    // The dots in the source names may be written as dashes
+    update("can0.115", 1);
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("can0.115"));
+    REQUIRE(events.back().kind == source_event::type::switched);
+
+    // The preferred source goes silent for longer than the grace period
+    for (int sec = 2; sec <= 5; sec++) {
+        update("GPS", sec);
+    }
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("GPS"));
+    REQUIRE(events.back().kind == source_event::type::failover);
+    update("can0.115", 6);
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("can0.115"));
+    REQUIRE(events.size() == 5);
+}
+
+TEST_CASE("The freshest source is chosen automatically")
+{
+    Sources s;
+    SourceArbiter arbiter(s.registry);
+    const wxString path(HDG_PATH + ".SRC:freshest");
+    int owner;
+    arbiter.Subscribe(path, &owner, 0, [](const source_event&) {}, T0);
+
+    // The same heading at 1, 5 and 10 Hz
+    const auto run = [&s, &arbiter](int from_ms, int to_ms, bool fast) {
+        for (int ms = from_ms; ms < to_ms; ms += 100) {
+            const Clock::time_point now = T0 + milliseconds(ms);
+            if (ms % 1000 == 0) {
+                s.Update("COMPASS", now);
+            }
+            if (ms % 200 == 0) {
+                s.Update("AHRS", now, milliseconds(10));
+            }
+            if (fast) {
+                s.Update("GYRO", now, milliseconds(20));
+            }
+            arbiter.Update(UNORDERED_KEY(HDG_PATH), now);
+        }
+    };
+    run(0, 3000, true);
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("GYRO"));
+    // The fastest source stops, the next best one takes over
+    run(3000, 4000, false);
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("AHRS"));
+    // And is replaced once the fastest one is back for a while
+    run(4000, 6000, true);
+    REQUIRE(arbiter.Resolve(path)->id.IsSameAs("GYRO"));
+}
+
+TEST_CASE("Instruments on the same path share the arbitrated source")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Dashboard* db = dsk.AddDashboard();
+    SimpleNumberInstrument first(db);
+    SimpleNumberInstrument second(db);
+    first.SetSetting(wxString(DSK_SETTING_SK_KEY), PERSIST_PATH);
+    second.SetSetting(wxString(DSK_SETTING_SK_KEY), PERSIST_PATH);
+    // The arbitration starts with the subscription, not with the first read
+    REQUIRE(dsk.GetSourceArbiter().IsArbitrated(PERSIST_PATH));
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["$source"] = "GPS";
+    delta["updates"][0]["values"][0]["path"] = "navigation.headingTrue";
+    delta["updates"][0]["values"][0]["value"] = 1.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE(second.GetLockedSource().IsSameAs("GPS"));
+    REQUIRE(first.GetSKDataResolved(PERSIST_PATH));
+
+    delta["updates"][0]["$source"] = "COMPASS";
+    dsk.SendSKDelta(delta);
+    REQUIRE(second.GetSKDataResolved(PERSIST_PATH));
+    REQUIRE(first.GetLockedSource().IsSameAs("GPS"));
+    REQUIRE(second.GetLockedSource().IsSameAs("GPS"));
+
+    // Only the compass keeps sending, both instruments follow the failover
+    clk->Advance(seconds(first.GetTimeout() + 1));
+    dsk.SendSKDelta(delta);
+    REQUIRE(first.GetLockedSource().IsSameAs("COMPASS"));
+    REQUIRE(second.GetLockedSource().IsSameAs("COMPASS"));
+    REQUIRE(first.GenerateJSONConfig()["locked_source"].asString()
+        == "COMPASS");
+}
+
+TEST_CASE("Changing the allowed data age applies to the arbitration")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Dashboard* db = dsk.AddDashboard();
+    SimpleNumberInstrument instr(db);
+    instr.SetSetting(wxString(DSK_SETTING_SK_KEY), PERSIST_PATH);
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["$source"] = "GPS";
+    delta["updates"][0]["values"][0]["path"] = "navigation.headingTrue";
+    delta["updates"][0]["values"][0]["value"] = 1.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE(instr.GetLockedSource().IsSameAs("GPS"));
+    instr.SetSetting(wxString("allowed_age"), wxString("10"));
+
+    // Silent for longer than the original 3 seconds but not the new 10
+    delta["updates"][0]["$source"] = "COMPASS";
+    clk->Advance(seconds(4));
+    dsk.SendSKDelta(delta);
+    REQUIRE(instr.GetLockedSource().IsSameAs("GPS"));
+    clk->Advance(seconds(7));
+    dsk.SendSKDelta(delta);
+    REQUIRE(instr.GetLockedSource().IsSameAs("COMPASS"));
+}
@@ -0,0 +1,209 @@
+/******************************************************************************
+ * DashboardSK filter pipeline tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "filterservice.h"
+#include "simplenumberinstrument.h"
+
+#include <chrono>
+#include <cmath>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+static const Clock::time_point T0(seconds(1700000000));
+static const wxString SOG_PATH(
+    "vessels.urn:mrn:imo:mmsi:265599691.navigation.speedOverGround");
+
+/// Filter service reading from a map of values
+struct Filters {
+    std::map<wxString, Json::Value> values;
+    FilterService service { [this](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    } };
+    Clock::time_point now = T0;
+
+    /// Set a new value of the path and feed it to the pipelines
+    void Feed(double value, milliseconds step = milliseconds(1000))
+    {
+        now += step;
+        values[SOG_PATH]["value"] = value;
+        service.Update(UNORDERED_KEY(SOG_PATH), &values[SOG_PATH], now);
+    }
+
+    /// Get the filtered value of a key
+    double Get(const wxString& key)
+    {
+        const Json::Value* v = service.Get(key);
+        REQUIRE(v);
+        return (*v)["value"].asDouble();
+    }
+};
+
+TEST_CASE("Filtered keys are parsed")
+{
+    REQUIRE_FALSE(FilterService::IsFiltered(SOG_PATH));
+    REQUIRE(FilterService::IsFiltered(SOG_PATH + "|ema(5)"));
+    REQUIRE(FilterService::BasePath(SOG_PATH + ".SRC:lockfirst|ema(5)")
+                .IsSameAs(SOG_PATH));
+    REQUIRE(FilterService::BasePath(SOG_PATH).IsSameAs(SOG_PATH));
+
+    Filters f;
+    int owner;
+    REQUIRE_FALSE(f.service.Subscribe(SOG_PATH, &owner));
+    REQUIRE_FALSE(f.service.Subscribe(SOG_PATH + "|ema(0)", &owner));
+    REQUIRE_FALSE(f.service.Subscribe(SOG_PATH + "|blur(5)", &owner));
+    REQUIRE_FALSE(f.service.Subscribe(SOG_PATH + "|ema(5", &owner));
+    REQUIRE(f.service.GetPipelineCount() == 0);
+    REQUIRE(f.service.Subscribe(SOG_PATH + "|median(3)|ema(5)", &owner));
+    REQUIRE(f.service.GetPipelineCount() == 1);
+    REQUIRE_FALSE(f.service.Get(SOG_PATH + "|median(3)|ema(5)"));
+}
+
+TEST_CASE("Moving average and median filters")
+{
+    Filters f;
+    int owner;
+    const wxString ema = SOG_PATH + "|ema(3)";
+    const wxString median = SOG_PATH + "|median(3)";
+    REQUIRE(f.service.Subscribe(ema, &owner));
+    REQUIRE(f.service.Subscribe(median, &owner));
+
+    f.Feed(10.0);
+    REQUIRE(f.Get(ema) == 10.0);
+    REQUIRE(f.Get(median) == 10.0);
+    f.Feed(20.0);
+    REQUIRE(f.Get(ema) == 15.0);
+    REQUIRE(f.Get(median) == 15.0);
+    f.Feed(100.0);
+    REQUIRE(f.Get(ema) == 57.5);
+    REQUIRE(f.Get(median) == 20.0);
+    f.Feed(11.0);
+    REQUIRE(f.Get(median) == 20.0);
+    f.Feed(12.0);
+    REQUIRE(f.Get(median) == 12.0);
+
+    // The filters start over after a gap in the data
+    f.Feed(50.0, milliseconds(4000));
+    REQUIRE(f.Get(ema) == 50.0);
+    REQUIRE(f.Get(median) == 50.0);
+}
+
+TEST_CASE("Circular mean and rate limit filters")
+{
+    Filters f;
+    int owner;
+    const wxString circ = SOG_PATH + "|circmean(2)";
+    const wxString limit = SOG_PATH + "|ratelimit(0.5)";
+    REQUIRE(f.service.Subscribe(circ, &owner));
+    REQUIRE(f.service.Subscribe(limit, &owner));
+
+    // The mean of 350 and 10 degrees is north, not south
+    f.Feed(350.0 * M_PI / 180.0);
+    f.Feed(10.0 * M_PI / 180.0);
+    const double mean = f.Get(circ);
+    REQUIRE(std::min(mean, 2 * M_PI - mean) < 1e-9);
+    f.Feed(30.0 * M_PI / 180.0);
+    REQUIRE(std::abs(f.Get(circ) - 20.0 * M_PI / 180.0) < 1e-9);
+
+    Filters r;
+    REQUIRE(r.service.Subscribe(limit, &owner));
+    r.Feed(1.0);
+    r.Feed(5.0, milliseconds(2000));
+    REQUIRE(r.Get(limit) == 2.0);
+    r.Feed(0.0, milliseconds(1000));
+    REQUIRE(r.Get(limit) == 1.5);
+
+    // The pipelines go away with their last subscriber
+    int other;
+    REQUIRE(r.service.Subscribe(limit, &other));
+    r.service.Unsubscribe(&owner);
+    REQUIRE(r.service.GetPipelineCount() == 1);
+    r.service.Unsubscribe(&other);
+    REQUIRE(r.service.GetPipelineCount() == 0);
+}
+
+TEST_CASE("Circular mean keeps the range of the whole window")
+{
+    Filters f;
+    int owner;
+    const wxString circ = SOG_PATH + "|circmean(2)";
+    REQUIRE(f.service.Subscribe(circ, &owner));
+
+    // An apparent wind angle around the bow stays signed whatever the sign
+    // of the last sample
+    f.Feed(-0.2);
+    f.Feed(0.1);
+    REQUIRE(std::abs(f.Get(circ) + 0.05) < 1e-9);
+    f.Feed(-0.1);
+    REQUIRE(std::abs(f.Get(circ)) < 1e-9);
+    f.Feed(0.3);
+    REQUIRE(std::abs(f.Get(circ) - 0.1) < 1e-9);
+
+    // A heading around north stays positive
+    Filters h;
+    REQUIRE(h.service.Subscribe(circ, &owner));
+    h.Feed(6.1);
+    h.Feed(0.1);
+    REQUIRE(std::abs(h.Get(circ) - (M_PI + 3.1)) < 1e-9);
+}
+
+TEST_CASE("Pipelines are only fed by the updates of their input")
+{
+    Filters f;
+    int owner;
+    const wxString gps = SOG_PATH + ".SRC:gps";
+    const wxString log = SOG_PATH + ".SRC:log";
+    const wxString mean = gps + "|mean(10)";
+    REQUIRE(f.service.Subscribe(mean, &owner));
+
+    f.values[gps]["value"] = 4.0;
+    f.service.Update(UNORDERED_KEY(SOG_PATH), &f.values[gps], f.now);
+    // The update of another source of the path is no new sample of ours
+    f.now += seconds(1);
+    f.values[log]["value"] = 0.0;
+    f.service.Update(UNORDERED_KEY(SOG_PATH), &f.values[log], f.now);
+    f.now += seconds(1);
+    f.values[gps]["value"] = 2.0;
+    f.service.Update(UNORDERED_KEY(SOG_PATH), &f.values[gps], f.now);
+    REQUIRE(f.Get(mean) == 3.0);
+}
+
+TEST_CASE("Instruments with the same smoothing share a pipeline")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Dashboard* db = dsk.AddDashboard();
+    SimpleNumberInstrument first(db);
+    SimpleNumberInstrument second(db);
+    first.SetSetting(wxString(DSK_SETTING_SK_KEY), SOG_PATH);
+    second.SetSetting(wxString(DSK_SETTING_SK_KEY), SOG_PATH);
+    first.SetSetting(wxString(DSK_SETTING_SMOOTHING), 5);
+    second.SetSetting(wxString(DSK_SETTING_SMOOTHING), 5);
+    REQUIRE(dsk.GetFilters().GetPipelineCount() == 1);
+
+    const wxString key = SOG_PATH + "|ema(3)";
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    delta["updates"][0]["values"][0]["value"] = 4.0;
+    dsk.SendSKDelta(delta);
+    clk->Advance(seconds(1));
+    delta["updates"][0]["values"][0]["value"] = 6.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE((*first.GetSKDataResolved(key))["value"].asDouble() == 5.0);
+    REQUIRE((*dsk.GetSKData(SOG_PATH))["value"].asDouble() == 6.0);
+
+    second.SetSetting(wxString(DSK_SETTING_SMOOTHING), 0);
+    REQUIRE(dsk.GetFilters().GetPipelineCount() == 1);
+    first.SetSetting(wxString(DSK_SETTING_SMOOTHING), 0);
+    REQUIRE(dsk.GetFilters().GetPipelineCount() == 0);
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * DashboardSK shared history tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "historyservice.h"
+#include "simplehistograminstrument.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+static const Clock::time_point T0(seconds(1700000000));
+static const wxString TWS_PATH(
+    "vessels.urn:mrn:imo:mmsi:265599691.environment.wind.speedTrue");
+
+TEST_CASE("Histories are shared by key and expire with their last holder")
+{
+    std::map<wxString, Json::Value> values;
+    HistoryService service([&values](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    });
+    REQUIRE(service.GetHistoryCount() == 0);
+
+    std::shared_ptr<const History> first = service.Acquire(TWS_PATH);
+    std::shared_ptr<const History> second = service.Acquire(TWS_PATH);
+    std::shared_ptr<const History> filtered
+        = service.Acquire(TWS_PATH + "|ema(5)");
+    REQUIRE(first == second);
+    REQUIRE(first != filtered);
+    REQUIRE(service.GetHistoryCount() == 2);
+
+    // Only the keys with a numeric value receive the update
+    values[TWS_PATH]["value"] = 5.0;
+    service.Update(UNORDERED_KEY(TWS_PATH), T0);
+    values[TWS_PATH]["value"] = "calm";
+    service.Update(UNORDERED_KEY(TWS_PATH), T0 + seconds(20));
+    REQUIRE(first->GetSampleCount() == 3);
+    REQUIRE(filtered->GetSampleCount() == 0);
+
+    values[TWS_PATH]["value"] = 7.0;
+    service.Update(UNORDERED_KEY(TWS_PATH), T0 + seconds(30));
+    REQUIRE(first->GetSampleCount() == 5);
+
+    filtered.reset();
+    REQUIRE(service.GetHistoryCount() == 1);
+    service.Update(UNORDERED_KEY(TWS_PATH), T0 + seconds(31));
+    REQUIRE(service.GetHistories().size() == 1);
+    REQUIRE(service.GetHistories()[0].first.IsSameAs(TWS_PATH));
+
+    first.reset();
+    second.reset();
+    REQUIRE(service.GetHistoryCount() == 0);
+    // A new holder starts from scratch
+    REQUIRE(service.Acquire(TWS_PATH)->GetSampleCount() == 0);
+}
+
+TEST_CASE("A new histogram shows the history received so far")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Dashboard* db = dsk.AddDashboard();
+    SimpleHistogramInstrument first(db);
+    first.SetSetting(wxString(DSK_SETTING_SK_KEY), TWS_PATH);
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["values"][0]["path"] = "environment.wind.speedTrue";
+    for (int i = 0; i < 5; i++) {
+        delta["updates"][0]["values"][0]["value"] = 5.0 + i;
+        dsk.SendSKDelta(delta);
+        clk->Advance(seconds(2));
+    }
+    REQUIRE(first.GetHistory()->GetSampleCount() == 7);
+
+    SimpleHistogramInstrument second(db);
+    second.SetSetting(wxString(DSK_SETTING_SK_KEY), TWS_PATH);
+    REQUIRE(second.GetHistory() == first.GetHistory());
+    REQUIRE(dsk.GetHistoryService().GetHistoryCount() == 1);
+}
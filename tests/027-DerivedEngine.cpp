@@ -0,0 +1,175 @@
+/******************************************************************************
+ * DashboardSK derived value tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "derivedengine.h"
+
+#include <cmath>
+
+using namespace DashboardSKPlugin;
+
+static const wxString SELF("vessels.urn:mrn:imo:mmsi:265599691");
+
+TEST_CASE("True wind and current computations")
+{
+    double twa;
+    double tws;
+    // Motoring at 5 into 10 of apparent headwind
+    DerivedEngine::TrueWind(0.0, 10.0, 5.0, twa, tws);
+    REQUIRE(std::abs(twa) < 1e-9);
+    REQUIRE(std::abs(tws - 5.0) < 1e-9);
+    // Apparent wind on the beam moves aft and strengthens when true
+    DerivedEngine::TrueWind(M_PI / 2, 5.0, 5.0, twa, tws);
+    REQUIRE(std::abs(twa - 3 * M_PI / 4) < 1e-9);
+    REQUIRE(std::abs(tws - 5.0 * sqrt(2.0)) < 1e-9);
+    DerivedEngine::TrueWind(-M_PI / 2, 5.0, 5.0, twa, tws);
+    REQUIRE(std::abs(twa + 3 * M_PI / 4) < 1e-9);
+
+    double set;
+    double drift;
+    // Heading north at 3, moving over ground east of north
+    DerivedEngine::Current(M_PI / 4, 3.0 * sqrt(2.0), 0.0, 3.0, set, drift);
+    REQUIRE(std::abs(set - M_PI / 2) < 1e-9);
+    REQUIRE(std::abs(drift - 3.0) < 1e-9);
+    DerivedEngine::Current(0.0, 2.0, 0.0, 3.0, set, drift);
+    REQUIRE(std::abs(set - M_PI) < 1e-9);
+    REQUIRE(std::abs(drift - 1.0) < 1e-9);
+}
+
+TEST_CASE("Derivations are recomputed once their inputs change")
+{
+    std::map<wxString, Json::Value> values;
+    DerivedEngine engine([&values](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    });
+    const size_t builtins = engine.GetDerivationCount();
+    REQUIRE(builtins > 0);
+    engine.Register(DERIVED_PATH_PREFIX "test.sum",
+        { "test.a", "test.b" }, [](const vector<double>& in, double& out) {
+            out = in[0] + in[1];
+            return true;
+        });
+    REQUIRE(engine.GetDerivationCount() == builtins + 1);
+
+    // Nothing is computed without the own vessel
+    engine.Update(UNORDERED_KEY(SELF + ".test.a"));
+    REQUIRE_FALSE(engine.IsPending());
+    engine.SetContext(SELF);
+    engine.Update(UNORDERED_KEY("vessels.other.test.a"));
+    REQUIRE_FALSE(engine.IsPending());
+
+    // Both inputs updated in one delta compute the sum once, the inputs
+    // without a designation are read from any source
+    values[SELF + ".test.a.SRC:any"]["value"] = 1.0;
+    engine.Update(UNORDERED_KEY(SELF + ".test.a"));
+    engine.Update(UNORDERED_KEY(SELF + ".test.b"));
+    REQUIRE(engine.IsPending());
+    REQUIRE(engine.Compute().empty());
+    REQUIRE_FALSE(engine.IsPending());
+
+    values[SELF + ".test.b.SRC:any"]["value"] = 2.0;
+    engine.Update(UNORDERED_KEY(SELF + ".test.a"));
+    engine.Update(UNORDERED_KEY(SELF + ".test.b"));
+    const Json::Value result = engine.Compute();
+    REQUIRE(result.size() == 1);
+    REQUIRE(result[0]["path"].asString() == "derived.test.sum");
+    REQUIRE(result[0]["value"].asDouble() == 3.0);
+}
+
+TEST_CASE("Designated inputs are read from the designated source")
+{
+    std::map<wxString, Json::Value> values;
+    DerivedEngine engine([&values](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    });
+    engine.Register(DERIVED_PATH_PREFIX "test.double", { "test.a.SRC:gps" },
+        [](const vector<double>& in, double& out) {
+            out = 2 * in[0];
+            return true;
+        });
+    engine.SetContext(SELF);
+    values[SELF + ".test.a.SRC:any"]["value"] = 1.0;
+    values[SELF + ".test.a.SRC:gps"]["value"] = 2.0;
+    // Updates of any source of the base path trigger the computation
+    engine.Update(UNORDERED_KEY(SELF + ".test.a"));
+    const Json::Value result = engine.Compute();
+    REQUIRE(result.size() == 1);
+    REQUIRE(result[0]["value"].asDouble() == 4.0);
+}
+
+TEST_CASE("Derived values are published as own vessel paths")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+
+    Json::Value delta;
+    delta["context"] = "vessels.self";
+    Json::Value& values = delta["updates"][0]["values"];
+    values[0]["path"] = "environment.wind.angleApparent";
+    values[0]["value"] = M_PI / 2;
+    values[1]["path"] = "environment.wind.speedApparent";
+    values[1]["value"] = 5.0;
+    values[2]["path"] = "navigation.speedThroughWater";
+    values[2]["value"] = 5.0;
+    dsk.SendSKDelta(delta);
+
+    const Json::Value* tws
+        = dsk.GetSKData(SELF + ".derived.environment.wind.speedTrue");
+    REQUIRE(tws);
+    REQUIRE(std::abs((*tws)["value"].asDouble() - 5.0 * sqrt(2.0)) < 1e-9);
+    // The VMG is chained on the derived true wind angle
+    const Json::Value* vmg
+        = dsk.GetSKData(SELF + ".derived.performance.velocityMadeGood");
+    REQUIRE(vmg);
+    REQUIRE(std::abs((*vmg)["value"].asDouble() + 5.0 * sqrt(0.5)) < 1e-9);
+    // No heading, no true wind direction
+    REQUIRE_FALSE(
+        dsk.GetSKData(SELF + ".derived.environment.wind.directionTrue"));
+}
+
+TEST_CASE("Derived values are computed from inputs with a source")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+
+    Json::Value delta;
+    delta["context"] = "vessels.self";
+    delta["updates"][0]["$source"] = "nmea0183.II";
+    Json::Value& values = delta["updates"][0]["values"];
+    values[0]["path"] = "environment.wind.angleApparent";
+    values[0]["value"] = M_PI / 2;
+    values[1]["path"] = "environment.wind.speedApparent";
+    values[1]["value"] = 5.0;
+    delta["updates"][1]["$source"] = "nmea2000.35";
+    delta["updates"][1]["values"][0]["path"] = "navigation.speedThroughWater";
+    delta["updates"][1]["values"][0]["value"] = 5.0;
+    delta["updates"][1]["values"][1]["path"] = "navigation.headingTrue";
+    delta["updates"][1]["values"][1]["value"] = 0.0;
+    dsk.SendSKDelta(delta);
+
+    // The inputs are stored only under their sources
+    const Json::Value* stw
+        = dsk.GetSKData(SELF + ".navigation.speedThroughWater");
+    REQUIRE(stw);
+    REQUIRE_FALSE(stw->isMember("value"));
+
+    const Json::Value* tws
+        = dsk.GetSKData(SELF + ".derived.environment.wind.speedTrue");
+    REQUIRE(tws);
+    REQUIRE(std::abs((*tws)["value"].asDouble() - 5.0 * sqrt(2.0)) < 1e-9);
+    const Json::Value* vmg
+        = dsk.GetSKData(SELF + ".derived.performance.velocityMadeGood");
+    REQUIRE(vmg);
+    REQUIRE(std::abs((*vmg)["value"].asDouble() + 5.0 * sqrt(0.5)) < 1e-9);
+    const Json::Value* twd
+        = dsk.GetSKData(SELF + ".derived.environment.wind.directionTrue");
+    REQUIRE(twd);
+    REQUIRE(std::abs((*twd)["value"].asDouble() - 3 * M_PI / 4) < 1e-9);
+}
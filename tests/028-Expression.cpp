@@ -0,0 +1,244 @@
+/******************************************************************************
+ * DashboardSK expression tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "expression.h"
+#include "simplenumberinstrument.h"
+
+#include <cmath>
+
+using namespace DashboardSKPlugin;
+
+static const wxString SELF("vessels.urn:mrn:imo:mmsi:265599691");
+
+/// Compile and evaluate an expression with the paths a, b and c.d
+static bool Eval(const wxString& text, double& result)
+{
+    Expression e;
+    if (!e.Compile(text)) {
+        return false;
+    }
+    return e.Evaluate(
+        [&e](size_t index, double& value) {
+            const wxString& path = e.GetPaths()[index];
+            if (path.IsSameAs("a")) {
+                value = 2.0;
+            } else if (path.IsSameAs("b")) {
+                value = 3.0;
+            } else if (path.IsSameAs("c.d")) {
+                value = -4.0;
+            } else {
+                return false;
+            }
+            return true;
+        },
+        result);
+}
+
+TEST_CASE("Expressions are compiled and evaluated")
+{
+    REQUIRE(Expression::IsExpression("=a"));
+    REQUIRE_FALSE(Expression::IsExpression("a"));
+    REQUIRE_FALSE(Expression::IsExpression(wxEmptyString));
+
+    double r;
+    REQUIRE(Eval("=1 + 2 * 3", r));
+    REQUIRE(r == 7.0);
+    REQUIRE(Eval("(1 + 2) * 3", r));
+    REQUIRE(r == 9.0);
+    REQUIRE(Eval("a - b - 1", r));
+    REQUIRE(r == -2.0);
+    REQUIRE(Eval("-a * -b / 4", r));
+    REQUIRE(r == 1.5);
+    REQUIRE(Eval("max(a, b) + min(a, c.d) + abs(c.d)", r));
+    REQUIRE(r == 3.0);
+    REQUIRE(Eval("sqrt(a * a + 5 * 1e0) + 2.5e-1", r));
+    REQUIRE(r == 3.25);
+    REQUIRE(Eval("atan2(1, 1) * 4", r));
+    REQUIRE(std::abs(r - M_PI) < 1e-12);
+    REQUIRE(Eval("a * a + a", r));
+    REQUIRE(r == 6.0);
+
+    Expression e;
+    REQUIRE(e.Compile("a * a + b"));
+    REQUIRE(e.GetPaths().size() == 2);
+
+    // Errors
+    wxString error;
+    REQUIRE_FALSE(e.Compile("a +", &error));
+    REQUIRE_FALSE(error.IsEmpty());
+    REQUIRE(e.GetPaths().empty());
+    REQUIRE_FALSE(e.Compile("(a + b"));
+    REQUIRE_FALSE(e.Compile("a b"));
+    REQUIRE_FALSE(e.Compile("pow(a, b)"));
+    REQUIRE_FALSE(e.Compile("max(a)"));
+    REQUIRE_FALSE(e.Compile("abs(a, b)"));
+    REQUIRE_FALSE(e.Compile("a # b"));
+    // Missing values and non-finite results
+    REQUIRE_FALSE(Eval("a + x", r));
+    REQUIRE_FALSE(Eval("a / 0", r));
+}
+
+TEST_CASE("Paths with source designations and filters are parsed")
+{
+    Expression e;
+    REQUIRE(e.Compile("navigation.headingTrue.SRC:GPS-GP-RMC * 2"));
+    REQUIRE(e.GetPaths().size() == 1);
+    REQUIRE(e.GetPaths()[0].IsSameAs("navigation.headingTrue.SRC:GPS-GP-RMC"));
+    REQUIRE(e.Compile("a.SRC:priority(GPS-GP-RMC, ais.AI) - a.SRC:ais.AI"));
+    REQUIRE(e.GetPaths().size() == 2);
+    REQUIRE(e.GetPaths()[0].IsSameAs("a.SRC:priority(GPS-GP-RMC, ais.AI)"));
+    REQUIRE(e.GetPaths()[1].IsSameAs("a.SRC:ais.AI"));
+    REQUIRE(e.Compile("max(a|ema(5), b|mean(0.5)|min(2))"));
+    REQUIRE(e.GetPaths().size() == 2);
+    REQUIRE(e.GetPaths()[0].IsSameAs("a|ema(5)"));
+    REQUIRE(e.GetPaths()[1].IsSameAs("b|mean(0.5)|min(2)"));
+    REQUIRE(e.Compile("(a.SRC:any|ema(3)/2)"));
+    REQUIRE(e.GetPaths()[0].IsSameAs("a.SRC:any|ema(3)"));
+
+    double r;
+    REQUIRE(e.Compile("a.SRC:GPS-GP-RMC - b|ema(5)"));
+    REQUIRE(e.Evaluate(
+        [](size_t index, double& value) {
+            value = index == 0 ? 5.0 : 2.0;
+            return true;
+        },
+        r));
+    REQUIRE(r == 3.0);
+}
+
+TEST_CASE("Expressions are evaluated after their inputs change")
+{
+    std::map<wxString, Json::Value> values;
+    size_t reads = 0;
+    ExpressionService service([&values, &reads](const wxString& path) {
+        ++reads;
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    });
+    service.SetContext(SELF);
+    const wxString key("=electrical.batteries.house.voltage - "
+                       "electrical.batteries.start.voltage");
+    int owner;
+    REQUIRE_FALSE(service.Subscribe("=a +", &owner));
+    REQUIRE(service.Subscribe(key, &owner));
+    REQUIRE(service.GetExpressionCount() == 1);
+    REQUIRE(service.GetInputs(key).size() == 2);
+    REQUIRE(service.GetInputs(key)[0].IsSameAs(
+        SELF + ".electrical.batteries.house.voltage"));
+
+    REQUIRE_FALSE(service.Get(key));
+    values[SELF + ".electrical.batteries.house.voltage"]["value"] = 13.0;
+    values[SELF + ".electrical.batteries.start.voltage"]["value"] = 12.5;
+    // Not evaluated again until an input is updated
+    REQUIRE_FALSE(service.Get(key));
+    service.Update(UNORDERED_KEY(SELF + ".electrical.batteries.house.voltage"));
+    REQUIRE((*service.Get(key))["value"].asDouble() == 0.5);
+    const size_t evaluated = reads;
+    REQUIRE((*service.Get(key))["value"].asDouble() == 0.5);
+    REQUIRE(reads == evaluated);
+
+    service.Unsubscribe(&owner);
+    REQUIRE(service.GetExpressionCount() == 0);
+    REQUIRE_FALSE(service.Get(key));
+}
+
+TEST_CASE("Expressions follow the context of the own vessel")
+{
+    std::map<wxString, Json::Value> values;
+    ExpressionService service([&values](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    });
+    const wxString key("=navigation.speedOverGround * 2");
+    int owner;
+    REQUIRE(service.Subscribe(key, &owner));
+    REQUIRE(service.GetInputs(key)[0].IsSameAs("navigation.speedOverGround"));
+
+    vector<wxString> moved;
+    service.SetContext(SELF,
+        [&](const void* o, const wxString& from, const wxString& to) {
+            REQUIRE(o == &owner);
+            REQUIRE(from.IsSameAs("navigation.speedOverGround"));
+            moved.push_back(to);
+        });
+    REQUIRE(moved.size() == 1);
+    REQUIRE(moved[0].IsSameAs(SELF + ".navigation.speedOverGround"));
+    REQUIRE(service.GetInputs(key)[0].IsSameAs(moved[0]));
+
+    values[moved[0]]["value"] = 3.0;
+    REQUIRE((*service.Get(key))["value"].asDouble() == 6.0);
+    values[moved[0]]["value"] = 4.0;
+    service.Update(UNORDERED_KEY(moved[0]));
+    REQUIRE((*service.Get(key))["value"].asDouble() == 8.0);
+}
+
+TEST_CASE("Instruments show expressions over SignalK paths")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    Dashboard* db = dsk.AddDashboard();
+    SimpleNumberInstrument instr(db);
+    const wxString key("=max(propulsion.port.revolutions, "
+                       "propulsion.starboard.revolutions) * 60");
+    instr.SetSetting(wxString(DSK_SETTING_SK_KEY), key);
+    REQUIRE(dsk.GetExpressions().GetExpressionCount() == 1);
+    SimpleNumberInstrument filtered(db);
+    const wxString filtered_key("=propulsion.port.revolutions|ema(1) + 1");
+    filtered.SetSetting(wxString(DSK_SETTING_SK_KEY), filtered_key);
+    REQUIRE(dsk.GetExpressions().GetExpressionCount() == 2);
+
+    Json::Value delta;
+    delta["context"] = "vessels.self";
+    Json::Value& values = delta["updates"][0]["values"];
+    values[0]["path"] = "propulsion.port.revolutions";
+    values[0]["value"] = 30.0;
+    values[1]["path"] = "propulsion.starboard.revolutions";
+    values[1]["value"] = 31.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE((*instr.GetSKDataResolved(key))["value"].asDouble() == 1860.0);
+    const Json::Value* smoothed = filtered.GetSKDataResolved(filtered_key);
+    REQUIRE(smoothed);
+    REQUIRE((*smoothed)["value"].asDouble() == 31.0);
+
+    instr.SetSetting(wxString(DSK_SETTING_SK_KEY), wxString("=a +"));
+    REQUIRE(dsk.GetExpressions().GetExpressionCount() == 1);
+    REQUIRE_FALSE(instr.GetSKDataResolved("=a +"));
+}
+
+TEST_CASE("Expressions use the arbitrated sources of their paths")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    Dashboard* db = dsk.AddDashboard();
+    SimpleNumberInstrument instr(db);
+    const wxString sog("navigation.speedOverGround.SRC:priority(GPS-GP-RMC, "
+                       "log)");
+    const wxString key("=" + sog + " * 2");
+    instr.SetSetting(wxString(DSK_SETTING_SK_KEY), key);
+    REQUIRE(dsk.GetSourceArbiter().IsArbitrated(SELF + "." + sog));
+
+    Json::Value delta;
+    delta["context"] = "vessels.self";
+    Json::Value& update = delta["updates"][0];
+    update["$source"] = "log";
+    update["values"][0]["path"] = "navigation.speedOverGround";
+    update["values"][0]["value"] = 3.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE((*instr.GetSKDataResolved(key))["value"].asDouble() == 6.0);
+
+    // The preferred source takes over and keeps the value once it appears
+    update["$source"] = "GPS.GP.RMC";
+    update["values"][0]["value"] = 4.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE((*instr.GetSKDataResolved(key))["value"].asDouble() == 8.0);
+    update["$source"] = "log";
+    update["values"][0]["value"] = 5.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE((*instr.GetSKDataResolved(key))["value"].asDouble() == 8.0);
+}
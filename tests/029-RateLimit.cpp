@@ -0,0 +1,161 @@
+/******************************************************************************
+ * DashboardSK notification rate limit and decimation tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "filterservice.h"
+#include "simplenumberinstrument.h"
+
+#include <chrono>
+#include <cmath>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+static const Clock::time_point T0(seconds(1700000000));
+static const wxString HDG_PATH(
+    "vessels.urn:mrn:imo:mmsi:265599691.navigation.headingTrue");
+
+/// Filter service reading from a map of values
+struct Filters {
+    std::map<wxString, Json::Value> values;
+    FilterService service { [this](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    } };
+    Clock::time_point now = T0;
+
+    /// Set a new value of the path and feed it to the pipelines
+    void Feed(double value, milliseconds step = milliseconds(100))
+    {
+        now += step;
+        values[HDG_PATH]["value"] = value;
+        service.Update(UNORDERED_KEY(HDG_PATH), &values[HDG_PATH], now);
+    }
+
+    /// Get the filtered value of a key
+    double Get(const wxString& key)
+    {
+        const Json::Value* v = service.Get(key);
+        REQUIRE(v);
+        return (*v)["value"].asDouble();
+    }
+};
+
+TEST_CASE("Aggregating filters decimate the samples of a time window")
+{
+    Filters f;
+    int owner;
+    const wxString mean = HDG_PATH + "|mean(0.5)";
+    const wxString min = HDG_PATH + "|min(0.5)";
+    const wxString max = HDG_PATH + "|max(0.5)";
+    REQUIRE(f.service.Subscribe(mean, &owner));
+    REQUIRE(f.service.Subscribe(min, &owner));
+    REQUIRE(f.service.Subscribe(max, &owner));
+    REQUIRE_FALSE(f.service.Subscribe(HDG_PATH + "|mean(0)", &owner));
+
+    for (double v : { 4.0, 1.0, 7.0, 4.0 }) {
+        f.Feed(v);
+    }
+    REQUIRE(f.Get(mean) == 4.0);
+    REQUIRE(f.Get(min) == 1.0);
+    REQUIRE(f.Get(max) == 7.0);
+
+    // The samples older than the window are forgotten
+    f.Feed(2.0, milliseconds(450));
+    REQUIRE(f.Get(mean) == 3.0);
+    REQUIRE(f.Get(min) == 2.0);
+    REQUIRE(f.Get(max) == 4.0);
+    f.Feed(8.0, milliseconds(1000));
+    REQUIRE(f.Get(mean) == 8.0);
+    REQUIRE(f.Get(min) == 8.0);
+}
+
+TEST_CASE("Notifications of a subscription with a limited rate are coalesced")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Dashboard* db = dsk.AddDashboard();
+    auto* limited = new SimpleNumberInstrument(db);
+    limited->SetSetting(wxString("max_rate"), wxString("2"));
+    REQUIRE(limited->GetMaxRate() == 2.0);
+    limited->SetSetting(wxString(DSK_SETTING_SK_KEY), HDG_PATH);
+    db->AddInstrument(limited);
+    auto* unlimited = new SimpleNumberInstrument(db);
+    unlimited->SetSetting(wxString(DSK_SETTING_SK_KEY), HDG_PATH);
+    db->AddInstrument(unlimited);
+    REQUIRE(limited->GenerateJSONConfig()["max_rate"].asDouble() == 2.0);
+    REQUIRE_FALSE(unlimited->GenerateJSONConfig().isMember("max_rate"));
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["values"][0]["path"] = "navigation.headingTrue";
+    // 10 Hz data for 0.4 seconds
+    for (int i = 0; i < 4; i++) {
+        delta["updates"][0]["values"][0]["value"] = 0.1 * i;
+        dsk.SendSKDelta(delta);
+        clk->Advance(milliseconds(100));
+    }
+    REQUIRE(unlimited->GetStats().GetNotificationCount() == 4);
+    REQUIRE(limited->GetStats().GetNotificationCount() == 1);
+
+    // Nothing is due before the interval elapses
+    dsk.ProcessData();
+    REQUIRE(limited->GetStats().GetNotificationCount() == 1);
+
+    // The coalesced updates are delivered once by the data tick
+    clk->Advance(milliseconds(100));
+    dsk.ProcessData();
+    REQUIRE(limited->GetStats().GetNotificationCount() == 2);
+    clk->Advance(milliseconds(500));
+    dsk.ProcessData();
+    REQUIRE(limited->GetStats().GetNotificationCount() == 2);
+
+    // An update after a quiet interval is delivered immediately
+    dsk.SendSKDelta(delta);
+    REQUIRE(limited->GetStats().GetNotificationCount() == 3);
+    REQUIRE(unlimited->GetStats().GetNotificationCount() == 5);
+}
+
+TEST_CASE("Changing the rate limit applies to the existing subscriptions")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleNumberInstrument(db);
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY), HDG_PATH);
+    db->AddInstrument(instr);
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["values"][0]["path"] = "navigation.headingTrue";
+    delta["updates"][0]["values"][0]["value"] = 0.1;
+    auto send = [&](int count) {
+        for (int i = 0; i < count; i++) {
+            dsk.SendSKDelta(delta);
+            clk->Advance(milliseconds(100));
+        }
+    };
+    send(4);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 4);
+
+    // Within a second of the last notification
+    instr->SetSetting(wxString("max_rate"), wxString("1"));
+    send(4);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 4);
+
+    // The coalesced update is delivered right away once the limit is lifted
+    instr->SetSetting(wxString("max_rate"), 0);
+    dsk.ProcessData();
+    REQUIRE(instr->GetStats().GetNotificationCount() == 5);
+    send(2);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 7);
+}
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * DashboardSK delta coalescing tests
+ * Copyright (C) 2026 Pavel Kalian
+ * License: GPLv3+
+ *****************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "dashboardsk.h"
+#include "historyservice.h"
+#include "simplenumberinstrument.h"
+
+#include <chrono>
+
+using namespace DashboardSKPlugin;
+using namespace std::chrono;
+
+static const Clock::time_point T0(seconds(1700000000));
+static const wxString SOG_PATH(
+    "vessels.urn:mrn:imo:mmsi:265599691.navigation.speedOverGround");
+
+TEST_CASE("Superseded values are added to the histories of the plain path")
+{
+    std::map<wxString, Json::Value> values;
+    HistoryService service([&values](const wxString& path) {
+        auto it = values.find(path);
+        return it == values.end() ? nullptr : &it->second;
+    });
+    std::shared_ptr<const History> plain = service.Acquire(SOG_PATH);
+    std::shared_ptr<const History> filtered
+        = service.Acquire(SOG_PATH + "|ema(3)");
+
+    values[SOG_PATH]["value"] = 6.0;
+    values[SOG_PATH + "|ema(3)"]["value"] = 4.0;
+    service.AddSuperseded(UNORDERED_KEY(SOG_PATH), 9.0, 3, T0);
+    service.Update(UNORDERED_KEY(SOG_PATH), T0);
+    REQUIRE(plain->GetLatest()->values == 4);
+    REQUIRE(plain->GetLatest()->GetMean() == 3.75);
+    REQUIRE(filtered->GetLatest()->values == 1);
+    REQUIRE(filtered->GetLatest()->GetMean() == 4.0);
+}
+
+TEST_CASE("Only the last value per path is applied at the data tick")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    auto clk = std::make_shared<ManualClock>(T0);
+    dsk.SetClock(clk);
+    dsk.SetCoalesceDeltas(true);
+    REQUIRE(dsk.GenerateJSONConfig()["signalk"]["coalesce"].asBool());
+    Dashboard* db = dsk.AddDashboard();
+    auto* instr = new SimpleNumberInstrument(db);
+    instr->SetSetting(wxString(DSK_SETTING_SK_KEY), SOG_PATH);
+    db->AddInstrument(instr);
+    std::shared_ptr<const History> history
+        = dsk.GetHistoryService().Acquire(SOG_PATH);
+
+    Json::Value delta;
+    delta["context"] = "vessels.urn:mrn:imo:mmsi:265599691";
+    delta["updates"][0]["$source"] = "gps";
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    for (int i = 1; i <= 5; i++) {
+        delta["updates"][0]["values"][0]["value"] = 1.0 * i;
+        dsk.SendSKDelta(delta);
+        clk->Advance(milliseconds(10));
+    }
+    Json::Value other;
+    other["context"] = "vessels.urn:mrn:imo:mmsi:230035780";
+    other["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    other["updates"][0]["values"][0]["value"] = 7.0;
+    dsk.SendSKDelta(other);
+    dsk.SendSKDelta(other);
+    REQUIRE(dsk.GetPendingUpdateCount() == 2);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 0);
+
+    dsk.ProcessData();
+    REQUIRE(dsk.GetPendingUpdateCount() == 0);
+    REQUIRE((*dsk.GetSKData(SOG_PATH))["value"].asDouble() == 5.0);
+    REQUIRE((*dsk.GetSKData("vessels.urn:mrn:imo:mmsi:230035780.navigation."
+                            "speedOverGround"))["value"]
+                .asDouble()
+        == 7.0);
+    REQUIRE(instr->GetStats().GetNotificationCount() == 1);
+    // The histories still get all the received values
+    REQUIRE(history->GetLatest()->values == 5);
+    REQUIRE(history->GetLatest()->GetMean() == 3.0);
+}
+
+TEST_CASE("Updates without values are processed right away")
+{
+    DashboardSK dsk(wxEmptyString);
+    dsk.SetSelf("urn:mrn:imo:mmsi:265599691");
+    dsk.SetCoalesceDeltas(true);
+
+    Json::Value meta;
+    meta["context"] = "vessels.self";
+    meta["updates"][0]["meta"][0]["path"] = "navigation.speedOverGround";
+    meta["updates"][0]["meta"][0]["value"]["units"] = "m/s";
+    dsk.SendSKDelta(meta);
+    REQUIRE(dsk.GetPendingUpdateCount() == 0);
+    REQUIRE((*dsk.GetSKData(SOG_PATH))["meta"]["units"].asString() == "m/s");
+
+    // Disabling the coalescing applies the buffered values
+    Json::Value delta;
+    delta["updates"][0]["values"][0]["path"] = "navigation.speedOverGround";
+    delta["updates"][0]["values"][0]["value"] = 3.0;
+    dsk.SendSKDelta(delta);
+    REQUIRE(dsk.GetPendingUpdateCount() == 1);
+    dsk.SetCoalesceDeltas(false);
+    REQUIRE(dsk.GetPendingUpdateCount() == 0);
+    REQUIRE((*dsk.GetSKData(SOG_PATH))["value"].asDouble() == 3.0);
+}
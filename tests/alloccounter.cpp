@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2026 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "alloccounter.h"
+
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+/// Number of allocations made by the thread, a plain integer so that it is
+/// usable from the replaced operator new without further allocations
+static thread_local size_t t_allocations = 0;
+
+AllocationCounter::AllocationCounter()
+    : m_start(t_allocations)
+{
+}
+
+size_t AllocationCounter::GetCount() const { return t_allocations - m_start; }
+
+size_t AllocationCounter::GetTotal() { return t_allocations; }
+
+/// Allocate memory and count the allocation
+///
+/// \param size Number of bytes to allocate
+/// \return Pointer to the memory or nullptr if it could not be allocated
+static void* CountedAlloc(size_t size)
+{
+    ++t_allocations;
+    return std::malloc(size ? size : 1);
+}
+
+/// Allocate aligned memory and count the allocation
+///
+/// \param size Number of bytes to allocate
+/// \param align Alignment of the memory
+/// \return Pointer to the memory or nullptr if it could not be allocated
+static void* CountedAlignedAlloc(size_t size, std::align_val_t align)
+{
+    ++t_allocations;
+    const size_t a = static_cast<size_t>(align);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    size = (size ? size + a - 1 : a) / a * a;
+#ifdef _WIN32
+    return _aligned_malloc(size, a);
+#else
+    return std::aligned_alloc(a, size);
+#endif
+}
+
+/// Free memory allocated by #CountedAlignedAlloc
+///
+/// \param p Pointer to the memory
+static void AlignedFree(void* p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+// Replacements of all the global allocation functions, including the aligned
+// and nothrow variants, so that no allocation escapes the count
+
+void* operator new(size_t size)
+{
+    void* p = CountedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAlloc(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete[](void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void* operator new(size_t size, std::align_val_t align)
+{
+    void* p = CountedAlignedAlloc(size, align);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    return operator new(size, align);
+}
+
+void* operator new(
+    size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return CountedAlignedAlloc(size, align);
+}
+
+void* operator new[](
+    size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return CountedAlignedAlloc(size, align);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+    AlignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+    AlignedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    AlignedFree(p);
+}
+
+void operator delete[](
+    void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    AlignedFree(p);
+}
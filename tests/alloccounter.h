@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2026 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef _ALLOCCOUNTER_H_
+#define _ALLOCCOUNTER_H_
+
+#include <cstddef>
+
+/// Counter of the heap allocations made by the calling thread during the
+/// lifetime of the object.
+///
+/// The counting is done by the replacement of the global \c operator \c new
+/// in alloccounter.cpp, which is only linked into the test executable, so the
+/// plugin itself is not affected. Used to assert the allocation budgets of
+/// the hot paths, eg. zero allocations to record a render in the statistics.
+///
+/// \code
+/// AllocationCounter counter;
+/// dsk.SendSKDelta(delta);
+/// REQUIRE(counter.GetCount() <= BUDGET);
+/// \endcode
+///
+/// Note that Catch2 allocates in the assertions, so the count has to be
+/// taken before asserting anything.
+class AllocationCounter {
+private:
+    /// Number of allocations of the thread when the counter was created
+    size_t m_start;
+
+public:
+    /// Constructor, starts counting
+    AllocationCounter();
+
+    /// Get the number of allocations since the counter was created
+    ///
+    /// \return Number of calls of \c operator \c new by the calling thread
+    size_t GetCount() const;
+
+    /// Get the number of allocations of the calling thread since it started
+    ///
+    /// \return Number of calls of \c operator \c new by the calling thread
+    static size_t GetTotal();
+};
+
+#endif //_ALLOCCOUNTER_H_
@@ -0,0 +1,374 @@
+/******************************************************************************
+ *
+ * Project:  OpenCPN
+ * Purpose:  DashboardSK Plugin
+ * Author:   Pavel Kalian
+ *
+ ******************************************************************************
+ * This file is part of the DashboardSK plugin
+ * (https://github.com/nohal/dashboardsk_pi).
+ *   Copyright (C) 2022 by Pavel Kalian
+ *   https://github.com/nohal
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later
+ * version of the license.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+// Headless renderer of the dashboards, used to benchmark the rendering and to
+// compare the rendered pixels with golden images without running OpenCPN.
+//
+// Usage: dashboardsk_render [options] config.json
+//   --deltas FILE     Delta log (see DeltaRecorder) or JSON file with a delta
+//                     or an array of deltas to feed the dashboards with
+//   --data DIR        Data directory of the plugin
+//   --scales LIST     Comma separated render scales (default 1)
+//   --schemes LIST    Comma separated color schemes, day, dusk and night
+//                     (default day)
+//   --repeat N        Number of timed renders of each instrument (default 10)
+//   --out DIR         Directory to write the PNG images to (default .)
+//   --compare DIR     Directory with the golden images to compare with
+//   --tolerance N     Allowed difference of a color channel (default 0)
+//
+// For every dashboard, scale and color scheme an image with the instruments
+// side by side is written and the render times of the instruments are
+// printed as tab separated values. When comparing, the exit code is 1 if any
+// image differs from its golden counterpart.
+
+#include "dashboardsk.h"
+#include "deltalog.h"
+#include "pi_common.h"
+
+#include <wx/app.h>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/image.h>
+#include <wx/init.h>
+#include <wx/tokenzr.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+using namespace DashboardSKPlugin;
+
+/// Command line options of the tool
+struct render_options {
+    wxString config;
+    wxString deltas;
+    wxString data_dir;
+    vector<double> scales { 1.0 };
+    vector<wxString> schemes { "day" };
+    int repeat = 10;
+    wxString out_dir = ".";
+    wxString compare_dir;
+    int tolerance = 0;
+};
+
+static void Usage()
+{
+    fprintf(stderr,
+        "Usage: dashboardsk_render [--deltas FILE] [--data DIR] "
+        "[--scales LIST]\n"
+        "                          [--schemes LIST] [--repeat N] [--out DIR]\n"
+        "                          [--compare DIR] [--tolerance N] "
+        "config.json\n");
+}
+
+static bool ParseOptions(int argc, char** argv, render_options& opts)
+{
+    for (int i = 1; i < argc; i++) {
+        const wxString arg(argv[i]);
+        if (!arg.StartsWith("--")) {
+            opts.config = arg;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const wxString val(argv[++i]);
+        if (arg == "--deltas") {
+            opts.deltas = val;
+        } else if (arg == "--data") {
+            opts.data_dir = val;
+        } else if (arg == "--scales") {
+            opts.scales.clear();
+            wxStringTokenizer tokenizer(val, ",");
+            while (tokenizer.HasMoreTokens()) {
+                double scale;
+                if (!tokenizer.GetNextToken().ToCDouble(&scale)
+                    || scale <= 0.0) {
+                    return false;
+                }
+                opts.scales.push_back(scale);
+            }
+        } else if (arg == "--schemes") {
+            opts.schemes.clear();
+            wxStringTokenizer tokenizer(val, ",");
+            while (tokenizer.HasMoreTokens()) {
+                opts.schemes.push_back(tokenizer.GetNextToken());
+            }
+        } else if (arg == "--repeat") {
+            opts.repeat = std::max(1, wxAtoi(val));
+        } else if (arg == "--out") {
+            opts.out_dir = val;
+        } else if (arg == "--compare") {
+            opts.compare_dir = val;
+        } else if (arg == "--tolerance") {
+            opts.tolerance = wxAtoi(val);
+        } else {
+            return false;
+        }
+    }
+    return !opts.config.IsEmpty() && !opts.scales.empty()
+        && !opts.schemes.empty();
+}
+
+/// Translate the name of a color scheme to the OpenCPN color scheme
+///
+/// \param name Name of the scheme
+/// \return The color scheme, -1 if unknown
+static int ColorScheme(const wxString& name)
+{
+    if (name == "day") {
+        return PI_GLOBAL_COLOR_SCHEME_DAY;
+    } else if (name == "dusk") {
+        return PI_GLOBAL_COLOR_SCHEME_DUSK;
+    } else if (name == "night") {
+        return PI_GLOBAL_COLOR_SCHEME_NIGHT;
+    }
+    return -1;
+}
+
+static bool ReadJSONFile(const wxString& path, Json::Value& out)
+{
+    wxFFile f(path);
+    wxString text;
+    return f.IsOpened() && f.ReadAll(&text, wxConvUTF8) && ParseJSON(text, out);
+}
+
+/// Feed the deltas to the dashboards, following the recorded time
+///
+/// \param dsk The dashboards
+/// \param path Delta log or JSON file with the deltas
+/// \return Number of the deltas sent, -1 on error
+static int FeedDeltas(DashboardSK& dsk, const wxString& path)
+{
+    auto clock = std::make_shared<ManualClock>();
+    dsk.SetClock(clock);
+    DeltaReplayer replayer;
+    if (replayer.Open(path)) {
+        replayer.SetSpeed(0.0);
+        replayer.SetClock(clock);
+        return static_cast<int>(replayer.Replay(dsk));
+    }
+    Json::Value deltas;
+    if (!ReadJSONFile(path, deltas)) {
+        return -1;
+    }
+    if (!deltas.isArray()) {
+        Json::Value single = deltas;
+        deltas = Json::Value(Json::arrayValue);
+        deltas.append(single);
+    }
+    for (auto& delta : deltas) {
+        dsk.SendSKDelta(delta);
+    }
+    dsk.ProcessData();
+    return static_cast<int>(deltas.size());
+}
+
+/// Compare an image with its golden counterpart
+///
+/// \param image The rendered image
+/// \param path Path to the golden image
+/// \param tolerance Allowed difference of a color channel
+/// \return Number of the differing pixels, -1 if the images can't be compared
+static long CompareImage(
+    const wxImage& image, const wxString& path, int tolerance)
+{
+    wxImage golden;
+    if (!golden.LoadFile(path, wxBITMAP_TYPE_PNG)
+        || golden.GetWidth() != image.GetWidth()
+        || golden.GetHeight() != image.GetHeight()) {
+        return -1;
+    }
+    long differ = 0;
+    const bool alpha = image.HasAlpha() && golden.HasAlpha();
+    for (int y = 0; y < image.GetHeight(); y++) {
+        for (int x = 0; x < image.GetWidth(); x++) {
+            if (std::abs(image.GetRed(x, y) - golden.GetRed(x, y)) > tolerance
+                || std::abs(image.GetGreen(x, y) - golden.GetGreen(x, y))
+                    > tolerance
+                || std::abs(image.GetBlue(x, y) - golden.GetBlue(x, y))
+                    > tolerance
+                || (alpha
+                    && std::abs(image.GetAlpha(x, y) - golden.GetAlpha(x, y))
+                        > tolerance)) {
+                differ++;
+            }
+        }
+    }
+    return differ;
+}
+
+/// Render the instruments of a dashboard side by side, printing their render
+/// times
+///
+/// \param dashboard The dashboard
+/// \param scale Render scale
+/// \param scheme_name Name of the color scheme for the report
+/// \param repeat Number of timed renders of each instrument
+/// \return The image of the dashboard
+static wxImage RenderDashboard(
+    Dashboard* dashboard, double scale, const wxString& scheme_name, int repeat)
+{
+    vector<wxImage> images;
+    int width = 0;
+    int height = 0;
+    const int count = static_cast<int>(dashboard->GetInstrumentNames().size());
+    for (int i = 0; i < count; i++) {
+        Instrument* instrument = dashboard->GetInstrument(i);
+        wxBitmap bmp;
+        double total_us = 0.0;
+        double min_us = 0.0;
+        for (int r = 0; r < repeat; r++) {
+            instrument->ForceRedraw();
+            const auto start = std::chrono::steady_clock::now();
+            bmp = instrument->Render(scale);
+            const double us = std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - start)
+                                  .count();
+            total_us += us;
+            min_us = r == 0 ? us : std::min(min_us, us);
+        }
+        printf("%s\t%s\t%s\t%s\t%g\t%.1f\t%.1f\n",
+            dashboard->GetName().utf8_str().data(),
+            instrument->GetName().utf8_str().data(),
+            instrument->GetClass().utf8_str().data(),
+            scheme_name.utf8_str().data(), scale, min_us, total_us / repeat);
+        if (!bmp.IsOk()) {
+            continue;
+        }
+        images.push_back(bmp.ConvertToImage());
+        if (!images.back().HasAlpha()) {
+            images.back().InitAlpha();
+        }
+        width += images.back().GetWidth();
+        height = std::max(height, images.back().GetHeight());
+    }
+    wxImage image(std::max(width, 1), std::max(height, 1));
+    image.InitAlpha();
+    memset(image.GetAlpha(), 0, image.GetWidth() * image.GetHeight());
+    int x = 0;
+    for (const auto& img : images) {
+        image.Paste(img, x, 0);
+        x += img.GetWidth();
+    }
+    return image;
+}
+
+/// Build a file name usable on any platform from a dashboard name
+///
+/// \param name The dashboard name
+/// \return The file name
+static wxString FileName(const wxString& name)
+{
+    wxString file;
+    for (auto c : name) {
+        file += wxIsalnum(c) || c == '-' || c == '_' ? wxString(c) : "_";
+    }
+    return file;
+}
+
+int main(int argc, char** argv)
+{
+    render_options opts;
+    if (!ParseOptions(argc, argv, opts)) {
+        Usage();
+        return 2;
+    }
+    for (const auto& scheme : opts.schemes) {
+        if (ColorScheme(scheme) < 0) {
+            fprintf(stderr, "Unknown color scheme %s\n",
+                scheme.utf8_str().data());
+            return 2;
+        }
+    }
+
+    // The instruments can't render without a fully initialized GUI toolkit,
+    // see WxInitListener in opencpn_mock.cpp
+    wxSetAssertHandler(nullptr);
+    wxApp::SetInstance(new wxApp());
+    int wx_argc = 0;
+    wxEntryStart(wx_argc, static_cast<wxChar**>(nullptr));
+    wxInitAllImageHandlers();
+
+    int ret = 0;
+    {
+        Json::Value config;
+        if (!ReadJSONFile(opts.config, config)) {
+            fprintf(stderr, "Can't read %s\n", opts.config.utf8_str().data());
+            wxEntryCleanup();
+            return 2;
+        }
+        // Accept both the plugin configuration file and just the DashboardSK
+        // part of it
+        if (config.isMember("dashboardsk")) {
+            config = Json::Value(config["dashboardsk"]);
+        }
+        DashboardSK dsk(opts.data_dir);
+        dsk.ReadConfig(config);
+        if (!opts.deltas.IsEmpty() && FeedDeltas(dsk, opts.deltas) < 0) {
+            fprintf(stderr, "Can't read %s\n", opts.deltas.utf8_str().data());
+            wxEntryCleanup();
+            return 2;
+        }
+
+        printf("dashboard\tinstrument\tclass\tscheme\tscale\t"
+               "min_us\tmean_us\n");
+        const wxArrayString names = dsk.GetDashboardNames();
+        for (int d = 0; d < static_cast<int>(names.size()); d++) {
+            Dashboard* dashboard = dsk.GetDashboard(d);
+            for (const auto& scheme : opts.schemes) {
+                dsk.SetColorScheme(ColorScheme(scheme));
+                for (const auto scale : opts.scales) {
+                    const wxImage image = RenderDashboard(
+                        dashboard, scale, scheme, opts.repeat);
+                    const wxString file = wxString::Format("%02d-%s-%s-%g.png",
+                        d, FileName(names[d]), scheme, scale);
+                    image.SaveFile(wxFileName(opts.out_dir, file).GetFullPath(),
+                        wxBITMAP_TYPE_PNG);
+                    if (opts.compare_dir.IsEmpty()) {
+                        continue;
+                    }
+                    const long differ = CompareImage(image,
+                        wxFileName(opts.compare_dir, file).GetFullPath(),
+                        opts.tolerance);
+                    if (differ < 0) {
+                        fprintf(stderr, "%s: no matching golden image\n",
+                            file.utf8_str().data());
+                        ret = 1;
+                    } else if (differ > 0) {
+                        fprintf(stderr, "%s: %ld pixels differ\n",
+                            file.utf8_str().data(), differ);
+                        ret = 1;
+                    }
+                }
+            }
+        }
+    }
+    wxEntryCleanup();
+    return ret;
+}
@@ -27,11 +27,15 @@
 #include "dashboardsk_pi.h"
 #include "pi_common.h"
 
-#include <catch2/reporters/catch_reporter_event_listener.hpp>
-#include <catch2/reporters/catch_reporter_registrars.hpp>
 #include <wx/app.h>
 #include <wx/init.h>
 
+// The mocks are also linked into the dashboardsk_render tool, which
+// initializes wxWidgets itself and doesn't use Catch2
+#ifndef DSK_RENDER_TOOL
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
 /// Initialize the wxWidgets library (and through it the underlying GUI
 /// toolkit) once for the whole test run, the instruments cannot render
 /// without it. A full GUI wxApp instance is needed, wxInitialize() alone
@@ -53,6 +57,7 @@ public:
     void testRunEnded(Catch::TestRunStats const&) override { wxEntryCleanup(); }
 };
 CATCH_REGISTER_LISTENER(WxInitListener)
+#endif
 
 // Mocks of the OpenCPN API functions actually accessed from our code
 // These functions are declared external DECL_EXP in ocpn_plugin.h and normally